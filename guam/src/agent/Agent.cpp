@@ -96,3 +96,40 @@ void Agent::InitializeAgent() {
 		agent->Initialize();
 	}
 }
+
+// Each agent is saved as index and state
+QByteArray Agent::SaveAgent() {
+	QByteArray data;
+	QDataStream out(&data, QIODevice::WriteOnly);
+	for(int i = 0; i < GuamInputOutput::AgentDeviceIndex_SIZE; i++) {
+		Agent *agent = allAgent[i];
+		if (agent == 0) continue;
+		if (agent->getFCBSize() == 0) continue;
+
+		QByteArray state;
+		{
+			QDataStream stateOut(&state, QIODevice::WriteOnly);
+			agent->saveState(stateOut);
+		}
+		out << (quint32)i << state;
+	}
+	return data;
+}
+void Agent::RestoreAgent(const QByteArray& data) {
+	QDataStream in(data);
+	while(!in.atEnd()) {
+		quint32    i;
+		QByteArray state;
+		in >> i >> state;
+		if (GuamInputOutput::AgentDeviceIndex_SIZE <= i) ERROR();
+		Agent *agent = allAgent[i];
+		if (agent == 0) {
+			logger.fatal("Unknown agent  index = %d", i);
+			ERROR();
+		}
+
+		QDataStream stateIn(state);
+		agent->restoreState(stateIn);
+		logger.info("Agent %2d %-10s  restore  %4d", i, agent->name, state.size());
+	}
+}
@@ -35,6 +35,8 @@ OF SUCH DAMAGE.
 #include "../mesa/Pilot.h"
 #include "../mesa/Constant.h"
 
+#include "InputQueue.h"
+
 class Agent {
 public:
 	// ioRegionLast: CARDINAL = 255;
@@ -57,6 +59,8 @@ public:
 	static Agent* getAgent(CARD16 index);
 
 	static void CallAgent(CARD16 index) {
+		// CallAgent is safe point to apply input event
+		InputQueue::apply();
 		Agent* agent = getAgent(index);
 		agent->Call();
 	}
@@ -74,6 +78,15 @@ public:
 	virtual void Initialize() = 0;
 	virtual void Call() = 0;
 
+	// Host side state of agent for snapshot. FCB is saved as part of memory.
+	//   saveState is called after all threads are stopped. restoreState is called after Initialize.
+	virtual void saveState(QDataStream& /*out*/) {}
+	virtual void restoreState(QDataStream& /*in*/) {}
+
+	// Save and restore host side state of all agent
+	static QByteArray SaveAgent();
+	static void       RestoreAgent(const QByteArray& data);
+
 	static CARD32 getIORegion() {
 		return ioRegion;
 	}
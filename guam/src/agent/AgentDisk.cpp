@@ -38,6 +38,7 @@ static log4cpp::Category& logger = Logger::getLogger("agentdisk");
 #include "../mesa/Pilot.h"
 #include "../mesa/Memory.h"
 #include "../mesa/MesaThread.h"
+#include "../mesa/Trace.h"
 
 #include "Agent.h"
 #include "AgentDisk.h"
@@ -100,6 +101,21 @@ void AgentDisk::IOThread::reset() {
 	ioQueue.clear();
 }
 
+void AgentDisk::IOThread::flush() {
+	QMutexLocker locker(&ioMutex);
+	int count = 0;
+	while(!ioQueue.isEmpty()) {
+		Item item = ioQueue.first();
+		ioQueue.removeFirst();
+		process(item.iocb, item.diskFile);
+		count++;
+	}
+	if (count) {
+		InterruptThread::notifyInterrupt(interruptSelector);
+		logger.info("AgentDisk::IOThread::flush  %d", count);
+	}
+}
+
 void AgentDisk::IOThread::setInterruptSelector(CARD16 interruptSelector) {
 	this->interruptSelector = interruptSelector;
 }
@@ -301,6 +317,10 @@ void AgentDisk::Call() {
 				logger.fatal("AGENT %s command = %d", name, command);
 				ERROR();
 			}
+		} else if (Trace::isEnabled()) {
+			// Process synchronously to complete IOCB at same instruction in record and replay
+			ioThread.process(iocb, diskFile);
+			Trace::verify(Trace::T_disk, iocb, sizeof(*iocb));
 		} else {
 			ioThread.enqueue(iocb, diskFile);
 		}
@@ -311,7 +331,7 @@ void AgentDisk::Call() {
 		iocb = (DiskIOFaceGuam::DiskIOCBType *)Store(nextIOCB);
 	}
 
-	if (DEBUG_DONT_USE_THREAD) {
+	if (DEBUG_DONT_USE_THREAD || Trace::isEnabled()) {
 		InterruptThread::notifyInterrupt(fcb->interruptSelector);
 	}
 
@@ -320,6 +340,17 @@ void AgentDisk::Call() {
 	//InterruptThread::notifyInterrupt(fcb->interruptSelector);
 }
 
+void AgentDisk::saveState(QDataStream& out) {
+	// Complete pending request. Its interrupt is saved in WP.
+	ioThread.flush();
+	out << (quint16)ioThread.getInterruptSelector();
+}
+void AgentDisk::restoreState(QDataStream& in) {
+	quint16 interruptSelector;
+	in >> interruptSelector;
+	ioThread.setInterruptSelector(interruptSelector);
+}
+
 void AgentDisk::addDiskFile(DiskFile* diskFile) {
 	diskFileList.append(diskFile);
 }
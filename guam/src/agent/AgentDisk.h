@@ -57,9 +57,14 @@ public:
 		void reset();
 
 		void setInterruptSelector(CARD16 interruptSelector);
+		CARD16 getInterruptSelector() {
+			return interruptSelector;
+		}
 
 		void enqueue(DiskIOFaceGuam::DiskIOCBType* iocb, DiskFile* diskFile);
 		void process(DiskIOFaceGuam::DiskIOCBType* iocb, DiskFile* diskFile);
+		// Process all queued request in caller thread. Used after thread is stopped.
+		void flush();
 
 	private:
 		class Item {
@@ -91,6 +96,9 @@ public:
 	void Initialize();
 	void Call();
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 	void addDiskFile(DiskFile* diskFile);
 
 private:
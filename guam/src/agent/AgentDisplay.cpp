@@ -43,8 +43,181 @@ static log4cpp::Category& logger = Logger::getLogger("agentdisplay");
 #include "Agent.h"
 #include "AgentDisplay.h"
 
-// TODO Implements colorType == DisplayIOFaceGuam::T_monochrome and DisplayIOFaceGuam::T_byteColor
-// TODO Provide Implementation for mono and 256
+// Display memory of monochrome display is stored as big endian. So byte order of display memory is same as pixel order.
+// Most significant bit of byte is left most pixel.
+
+// mask of bits in byte from bit x to right end
+static inline CARD8 maskLeft(int x) {
+	return (CARD8)(0xFF >> (x & 7));
+}
+// mask of bits in byte from left end to bit x
+static inline CARD8 maskRight(int x) {
+	return (CARD8)(0xFF << (7 - (x & 7)));
+}
+
+// Copy source rectangle to dest rectangle of monochrome display
+//   Overlapped rectangle is handled by choosing order of line and by copying source line before storing dest line.
+//   Pixel value of source is mapped with colorMapping.
+static void copyRectangleMono(CARD8* display, int bytesPerLine, int sx, int sy, int dx, int dy, int width, int height, const CARD16 colorMapping[2]) {
+	// mapping of source pixel  0 => colorMapping[0]  1 => colorMapping[1]
+	const int map0 = colorMapping[0] & 1;
+	const int map1 = colorMapping[1] & 1;
+	// If map0 == map1, rectangle is filled with constant value.
+	const CARD8 constant = map0 ? 0xFF : 0x00;
+	const int   invert   = (map0 == 1 && map1 == 0);
+	const int   fill     = (map0 == map1);
+
+	const int srcByte0 = sx >> 3;
+	const int dstByte0 = dx >> 3;
+	const int srcBytes = ((sx + width - 1) >> 3) - srcByte0 + 1;
+	const int dstBytes = ((dx + width - 1) >> 3) - dstByte0 + 1;
+	const int aligned  = (sx & 7) == (dx & 7);
+
+	CARD8 firstMask = maskLeft(dx);
+	CARD8 lastMask  = maskRight(dx + width - 1);
+	if (dstBytes == 1) firstMask = lastMask = (firstMask & lastMask);
+
+	// If dest is below source, copy from bottom line to avoid overwrite of source
+	const int bottomUp = sy < dy;
+	// Source line with one zero byte before and after
+	QVector<CARD8> buffer(qMax(srcBytes, dstBytes) + 3);
+
+	for(int i = 0; i < height; i++) {
+		const int y = bottomUp ? (height - 1 - i) : i;
+		const CARD8* src = display + (sy + y) * bytesPerLine + srcByte0;
+		CARD8*       dst = display + (dy + y) * bytesPerLine + dstByte0;
+
+		if (fill) {
+			dst[0] = (dst[0] & ~firstMask) | (constant & firstMask);
+			if (1 < dstBytes) {
+				memset(dst + 1, constant, dstBytes - 2);
+				dst[dstBytes - 1] = (dst[dstBytes - 1] & ~lastMask) | (constant & lastMask);
+			}
+			continue;
+		}
+
+		if (aligned && !invert) {
+			// fast path. Byte boundary of source and dest is same
+			const CARD8 first = src[0];
+			const CARD8 last  = src[dstBytes - 1];
+			if (2 < dstBytes) memmove(dst + 1, src + 1, dstBytes - 2);
+			dst[0] = (dst[0] & ~firstMask) | (first & firstMask);
+			if (1 < dstBytes) dst[dstBytes - 1] = (dst[dstBytes - 1] & ~lastMask) | (last & lastMask);
+			continue;
+		}
+
+		// general path. Copy source line to buffer and shift to bit position of dest
+		CARD8* b = buffer.data();
+		b[0] = 0;
+		memcpy(b + 1, src, srcBytes);
+		for(int j = srcBytes + 1; j < buffer.size(); j++) b[j] = 0;
+
+		const int shift = 8 + (sx & 7) - (dx & 7);
+		const CARD8 xorValue = invert ? 0xFF : 0x00;
+		for(int j = 0; j < dstBytes; j++) {
+			const int bit   = shift + j * 8;
+			const int index = bit >> 3;
+			CARD8 value = (CARD8)((((b[index] << 8) | b[index + 1]) << (bit & 7)) >> 8);
+			value ^= xorValue;
+
+			CARD8 mask = 0xFF;
+			if (j == 0)            mask = firstMask;
+			if (j == dstBytes - 1) mask = lastMask;
+			dst[j] = (dst[j] & ~mask) | (value & mask);
+		}
+	}
+}
+
+// Fill dest rectangle of monochrome display with pattern
+//   Pattern is 16 pixel wide and 4 line high. Pattern is aligned to origin of display.
+static void patternFillRectangleMono(CARD8* display, int bytesPerLine, int dx, int dy, int width, int height, const CARD16 pattern[4], CARD16 patternFillMode) {
+	const int dstByte0 = dx >> 3;
+	const int dstBytes = ((dx + width - 1) >> 3) - dstByte0 + 1;
+
+	CARD8 firstMask = maskLeft(dx);
+	CARD8 lastMask  = maskRight(dx + width - 1);
+	if (dstBytes == 1) firstMask = lastMask = (firstMask & lastMask);
+
+	for(int y = dy; y < (dy + height); y++) {
+		const CARD16 word = pattern[y & 3];
+		// byte of pattern for even and odd byte of display line
+		const CARD8 p[2] = {(CARD8)(word >> 8), (CARD8)word};
+		CARD8* dst = display + y * bytesPerLine + dstByte0;
+
+		for(int j = 0; j < dstBytes; j++) {
+			const CARD8 value = p[(dstByte0 + j) & 1];
+			CARD8 mask = 0xFF;
+			if (j == 0)            mask = firstMask;
+			if (j == dstBytes - 1) mask = lastMask;
+
+			CARD8 result;
+			switch(patternFillMode) {
+			case DisplayIOFaceGuam::PFM_copy:
+				result = value;
+				break;
+			case DisplayIOFaceGuam::PFM_and:
+				result = dst[j] & value;
+				break;
+			case DisplayIOFaceGuam::PFM_or:
+				result = dst[j] | value;
+				break;
+			case DisplayIOFaceGuam::PFM_xor:
+				result = dst[j] ^ value;
+				break;
+			default:
+				ERROR();
+				result = 0;
+				break;
+			}
+			dst[j] = (dst[j] & ~mask) | (result & mask);
+		}
+	}
+}
+
+
+// Display memory of byteColor display has one byte for each pixel. Value of pixel is index of color lookup table.
+
+// Copy source rectangle to dest rectangle of byteColor display
+//   Pixel value is copied as is. colorMapping is used only for bit source of ColorBlt.
+static void copyRectangleByte(CARD8* display, int bytesPerLine, int sx, int sy, int dx, int dy, int width, int height) {
+	// If dest is below source, copy from bottom line to avoid overwrite of source
+	const int bottomUp = sy < dy;
+
+	for(int i = 0; i < height; i++) {
+		const int y = bottomUp ? (height - 1 - i) : i;
+		// memmove takes care of overlap in same line
+		memmove(display + (dy + y) * bytesPerLine + dx, display + (sy + y) * bytesPerLine + sx, width);
+	}
+}
+
+// Fill dest rectangle of byteColor display with pattern
+//   Bit of pattern is mapped to pixel value with colorMapping. Pattern is aligned to origin of display.
+static void patternFillRectangleByte(CARD8* display, int bytesPerLine, int dx, int dy, int width, int height, const CARD16 pattern[4], const CARD16 colorMapping[2], CARD16 patternFillMode) {
+	for(int y = dy; y < (dy + height); y++) {
+		// expand pattern of this line to pixel
+		CARD8 p[16];
+		for(int i = 0; i < 16; i++) p[i] = (CARD8)colorMapping[(pattern[y & 3] >> (15 - i)) & 1];
+
+		CARD8* dst = display + y * bytesPerLine;
+		switch(patternFillMode) {
+		case DisplayIOFaceGuam::PFM_copy:
+			for(int x = dx; x < (dx + width); x++) dst[x] = p[x & 15];
+			break;
+		case DisplayIOFaceGuam::PFM_and:
+			for(int x = dx; x < (dx + width); x++) dst[x] &= p[x & 15];
+			break;
+		case DisplayIOFaceGuam::PFM_or:
+			for(int x = dx; x < (dx + width); x++) dst[x] |= p[x & 15];
+			break;
+		case DisplayIOFaceGuam::PFM_xor:
+			for(int x = dx; x < (dx + width); x++) dst[x] ^= p[x & 15];
+			break;
+		default:
+			ERROR();
+			break;
+		}
+	}
+}
 
 
 void AgentDisplay::Initialize() {
@@ -89,9 +262,51 @@ void AgentDisplay::Initialize() {
 	fcb->patternFillMode        = DisplayIOFaceGuam::PFM_copy;
 	fcb->complemented           = 0;
 	fcb->colorIndex             = 0;
-	fcb->displayType            = DisplayIOFaceGuam::T_monochrome;
+	fcb->displayType            = Memory::getDisplayType();
 	fcb->displayWidth           = this->displayWidth;
 	fcb->displayHeight          = this->displayHeight;
+
+	displayType = fcb->displayType;
+	if (displayType == DisplayIOFaceGuam::T_byteColor) {
+		// Initial color lookup table. 0 => white  others => black
+		for(int i = 0; i < CLT_SIZE; i++) {
+			const CARD8 value = (i == 0) ? 255 : 0;
+			clt[i].red      = value;
+			clt[i].green    = value;
+			clt[i].blue     = value;
+			clt[i].reserved = 0;
+			GuiOp::setColorLookupTable(i, clt[i].red, clt[i].green, clt[i].blue);
+		}
+	}
+}
+
+// Save color lookup table
+void AgentDisplay::saveState(QDataStream& out) {
+	out << QByteArray((const char*)clt, sizeof(clt));
+}
+void AgentDisplay::restoreState(QDataStream& in) {
+	QByteArray data;
+	in >> data;
+	if (data.size() != sizeof(clt)) ERROR();
+	memcpy(clt, data.constData(), sizeof(clt));
+	if (displayType == DisplayIOFaceGuam::T_byteColor) {
+		for(int i = 0; i < CLT_SIZE; i++) {
+			GuiOp::setColorLookupTable(i, clt[i].red, clt[i].green, clt[i].blue);
+		}
+	}
+	GuiOp::Rect rect(0, 0, displayWidth, displayHeight);
+	GuiOp::updateDisplay(&rect);
+}
+
+int AgentDisplay::isValidRectangle(const DisplayIOFaceGuam::DisplayCoordinate& origin, const DisplayIOFaceGuam::DisplayRectangle& rect) {
+	if (displayWidth  < (origin.x + rect.width))  return 0;
+	if (displayHeight < (origin.y + rect.height)) return 0;
+	return 1;
+}
+
+void AgentDisplay::updateDisplay(const DisplayIOFaceGuam::DisplayRectangle& rect) {
+	GuiOp::Rect data(rect.origin.x, rect.origin.y, rect.width, rect.height);
+	GuiOp::updateDisplay(&data);
 }
 
 void AgentDisplay::Call() {
@@ -100,12 +315,33 @@ void AgentDisplay::Call() {
 		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s nop", name);
 		break;
 	case DisplayIOFaceGuam::C_setCLTEntry:
-		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s setCLTEntry", name);
-		// TODO AgentDisplay::Call DisplayIOFaceGuam::C_setCLTEntry
+		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s setCLTEntry  colorIndex = %d  %3d %3d %3d", name, fcb->colorIndex, fcb->color.red, fcb->color.green, fcb->color.blue);
+		if (displayType == DisplayIOFaceGuam::T_byteColor) {
+			if (CLT_SIZE <= fcb->colorIndex) {
+				fcb->status = DisplayIOFaceGuam::S_invalidCLTIndex;
+				break;
+			}
+			clt[fcb->colorIndex] = fcb->color;
+			GuiOp::setColorLookupTable(fcb->colorIndex, fcb->color.red, fcb->color.green, fcb->color.blue);
+			{
+				// Appearance of all pixel that has colorIndex is changed
+				GuiOp::Rect rect(0, 0, displayWidth, displayHeight);
+				GuiOp::updateDisplay(&rect);
+			}
+			fcb->status = DisplayIOFaceGuam::S_success;
+		}
 		break;
 	case DisplayIOFaceGuam::C_getCLTEntry:
 		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s getCLTEntry  colorIndex = %d", name, fcb->colorIndex);
-		// TODO AgentDisplay::Call DisplayIOFaceGuam::C_getCLTEntry
+		if (displayType == DisplayIOFaceGuam::T_byteColor) {
+			if (CLT_SIZE <= fcb->colorIndex) {
+				fcb->status = DisplayIOFaceGuam::S_invalidCLTIndex;
+				break;
+			}
+			fcb->color  = clt[fcb->colorIndex];
+			fcb->status = DisplayIOFaceGuam::S_success;
+			break;
+		}
 	    if (1 < fcb->colorIndex) fcb->status = DisplayIOFaceGuam::S_readOnlyCLT;
 	    else {
 	        fcb->color.red      = 255;
@@ -140,19 +376,69 @@ void AgentDisplay::Call() {
 		}
 		break;
 	case DisplayIOFaceGuam::C_updateRectangle:
-		logger.fatal("AGENT %s updateRectangle", name);
-		ERROR();
-		// TODO AgentDisplay::Call DisplayIOFaceGuam::C_updateRectangle
+		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s updateRectangle  %4d %4d %4d %4d", name,
+			fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height);
+		if (!isValidRectangle(fcb->destRectangle.origin, fcb->destRectangle)) {
+			fcb->status = DisplayIOFaceGuam::S_invalidDestRectangle;
+			break;
+		}
+		// Display memory is already updated. Just notify to GuiOp.
+		updateDisplay(fcb->destRectangle);
+		fcb->status = DisplayIOFaceGuam::S_success;
 		break;
 	case DisplayIOFaceGuam::C_copyRectangle:
-		logger.fatal("AGENT %s copyRectangle", name);
-		ERROR();
-		// TODO AgentDisplay::Call DisplayIOFaceGuam::C_copyRectangle
+		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s copyRectangle  %4d %4d  %4d %4d %4d %4d", name,
+			fcb->sourceOrigin.x, fcb->sourceOrigin.y,
+			fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height);
+		if (!isValidRectangle(fcb->destRectangle.origin, fcb->destRectangle)) {
+			fcb->status = DisplayIOFaceGuam::S_invalidDestRectangle;
+			break;
+		}
+		if (!isValidRectangle(fcb->sourceOrigin, fcb->destRectangle)) {
+			fcb->status = DisplayIOFaceGuam::S_invalidSourceRectangle;
+			break;
+		}
+		if (fcb->destRectangle.width && fcb->destRectangle.height) {
+			if (displayType == DisplayIOFaceGuam::T_byteColor) {
+				copyRectangleByte((CARD8*)Memory::getDisplayPage()->word, Memory::getDisplayBytesPerLine(),
+					fcb->sourceOrigin.x, fcb->sourceOrigin.y,
+					fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height);
+			} else {
+				copyRectangleMono((CARD8*)Memory::getDisplayPage()->word, Memory::getDisplayBytesPerLine(),
+					fcb->sourceOrigin.x, fcb->sourceOrigin.y,
+					fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height,
+					fcb->colorMapping);
+			}
+			updateDisplay(fcb->destRectangle);
+		}
+		fcb->status = DisplayIOFaceGuam::S_success;
 		break;
 	case DisplayIOFaceGuam::C_patternFillRectangle:
-		logger.fatal("AGENT %s patternFillRectangle", name);
-		ERROR();
-		// TODO AgentDisplay::Call DisplayIOFaceGuam::C_patternFillRectangle
+		if (DEBUG_SHOW_AGENT_DISPLAY) logger.debug("AGENT %s patternFillRectangle  %4d %4d %4d %4d  %d  %04X %04X %04X %04X", name,
+			fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height,
+			fcb->patternFillMode, fcb->pattern[0], fcb->pattern[1], fcb->pattern[2], fcb->pattern[3]);
+		if (!isValidRectangle(fcb->destRectangle.origin, fcb->destRectangle)) {
+			fcb->status = DisplayIOFaceGuam::S_invalidDestRectangle;
+			break;
+		}
+		if (DisplayIOFaceGuam::PFM_xor < fcb->patternFillMode) {
+			logger.error("AGENT %s patternFillRectangle  patternFillMode = %d", name, fcb->patternFillMode);
+			fcb->status = DisplayIOFaceGuam::S_generalFailure;
+			break;
+		}
+		if (fcb->destRectangle.width && fcb->destRectangle.height) {
+			if (displayType == DisplayIOFaceGuam::T_byteColor) {
+				patternFillRectangleByte((CARD8*)Memory::getDisplayPage()->word, Memory::getDisplayBytesPerLine(),
+					fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height,
+					fcb->pattern, fcb->colorMapping, fcb->patternFillMode);
+			} else {
+				patternFillRectangleMono((CARD8*)Memory::getDisplayPage()->word, Memory::getDisplayBytesPerLine(),
+					fcb->destRectangle.origin.x, fcb->destRectangle.origin.y, fcb->destRectangle.width, fcb->destRectangle.height,
+					fcb->pattern, fcb->patternFillMode);
+			}
+			updateDisplay(fcb->destRectangle);
+		}
+		fcb->status = DisplayIOFaceGuam::S_success;
 		break;
 	default:
 		logger.fatal("AGENT %s %5d", name, fcb->command);
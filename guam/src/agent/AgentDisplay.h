@@ -40,6 +40,7 @@ public:
 		fcb                  = 0;
 		displayWidth         = 0;
 		displayHeight        = 0;
+		displayType          = DisplayIOFaceGuam::T_monochrome;
 	}
 
 	CARD32 getFCBSize() {
@@ -49,6 +50,9 @@ public:
 	void Initialize();
 	void Call();
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 	void setDisplayWidth(CARD16 newValue) {
 		this->displayWidth = newValue;
 	}
@@ -57,10 +61,20 @@ public:
 	}
 
 private:
+	// Return true if rectangle at origin is inside of display
+	int  isValidRectangle(const DisplayIOFaceGuam::DisplayCoordinate& origin, const DisplayIOFaceGuam::DisplayRectangle& rect);
+	// Notify change of display to GuiOp
+	void updateDisplay(const DisplayIOFaceGuam::DisplayRectangle& rect);
+
 	DisplayIOFaceGuam::DisplayFCBType *fcb;
 	//
 	CARD16 displayWidth;
 	CARD16 displayHeight;
+	CARD16 displayType;
+
+	// color lookup table of byteColor display
+	static const int CLT_SIZE = 256;
+	DisplayIOFaceGuam::LookupTableEntry clt[CLT_SIZE];
 };
 
 #endif
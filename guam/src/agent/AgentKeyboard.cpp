@@ -60,6 +60,9 @@ void AgentKeyboard::Call() {
 }
 
 void AgentKeyboard::keyPress(LevelVKeys::KeyName keyName) {
+	// Ignore event before Initialize
+	if (fcb == 0) return;
+
 	const int keyStates_SIZE = sizeof(fcb->keyStates) / sizeof(fcb->keyStates[0]);
 	const int a = keyName / WordSize;
 	const int b = keyName % WordSize;
@@ -73,6 +76,9 @@ void AgentKeyboard::keyPress(LevelVKeys::KeyName keyName) {
 	fcb->keyStates[a] &= ~mask;
 }
 void AgentKeyboard::keyRelease(LevelVKeys::KeyName keyName) {
+	// Ignore event before Initialize
+	if (fcb == 0) return;
+
 	const int keyStates_SIZE = sizeof(fcb->keyStates) / sizeof(fcb->keyStates[0]);
 	const int a = keyName / WordSize;
 	const int b = keyName % WordSize;
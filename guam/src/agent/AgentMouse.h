@@ -48,6 +48,8 @@ public:
 	void Call();
 
 	void setPosition(int x, int y) {
+		// Ignore event before Initialize
+		if (fcb == 0) return;
 		fcb->currentMousePosition.mouseXCoord = x;
 		fcb->currentMousePosition.mouseYCoord = y;
 	}
@@ -38,6 +38,7 @@ static log4cpp::Category& logger = Logger::getLogger("agentnet");
 #include "../mesa/Pilot.h"
 #include "../mesa/Memory.h"
 #include "../mesa/MesaThread.h"
+#include "../mesa/Trace.h"
 
 #include "Agent.h"
 #include "AgentNetwork.h"
@@ -99,6 +100,20 @@ void AgentNetwork::TransmitThread::reset() {
 	QMutexLocker locker(&transmitMutex);
 	transmitQueue.clear();
 }
+void AgentNetwork::TransmitThread::flush() {
+	QMutexLocker locker(&transmitMutex);
+	int count = 0;
+	while(!transmitQueue.isEmpty()) {
+		Item item = transmitQueue.first();
+		transmitQueue.removeFirst();
+		networkPacket->transmit(item.iocb);
+		count++;
+	}
+	if (count) {
+		InterruptThread::notifyInterrupt(interruptSelector);
+		logger.info("AgentNetwork::TransmitThread::flush  %d", count);
+	}
+}
 
 
 int AgentNetwork::ReceiveThread::stopThread;
@@ -115,13 +130,14 @@ void AgentNetwork::ReceiveThread::enqueue(EthernetIOFaceGuam::EthernetIOCBType*
 	// TODO Is this correct?
 	// Remove item which has same data
 	// Remove item that is waiting more than MAX_WAIT_SEC.
+	//   In trace mode, don't remove item by time to make receiveQueue deterministic.
 	{
 		CARD32 myBufferAddress = iocb->bufferAddress;
 		QMutableLinkedListIterator<Item> i(receiveQueue);
 		while(i.hasNext()) {
 			Item& item = i.next();
 			if (item.iocb->bufferAddress == myBufferAddress) i.remove();
-			if ((item.sec + MAX_WAIT_SEC) < sec) i.remove();
+			if (!Trace::isEnabled() && (item.sec + MAX_WAIT_SEC) < sec) i.remove();
 		}
 	}
 	Item item(sec, iocb);
@@ -159,7 +175,7 @@ void AgentNetwork::ReceiveThread::run() {
 			if (ret == 0) {
 				// data is not ready
 				// do queue maintenance
-				if (!receiveQueue.isEmpty()) {
+				if (!receiveQueue.isEmpty() && !Trace::isEnabled()) {
 					qint64 sec = getSec();
 					QMutableLinkedListIterator<Item> i(receiveQueue);
 					while(i.hasNext()) {
@@ -173,7 +189,17 @@ void AgentNetwork::ReceiveThread::run() {
 				continue;
 			} else {
 				// data is ready
-				if (receiveQueue.isEmpty()) {
+				if (Trace::isRecord()) {
+					// Keep frame until processor thread deliver it at safe point
+					CARD8 buffer[ETH_FRAME_LEN];
+					int opErrno = 0;
+					int ret = networkPacket->receive(buffer, sizeof(buffer), opErrno);
+					if (0 < ret) {
+						frameQueue.append(QByteArray((const char*)buffer, (ret + 1) & ~1));
+						ProcessorThread::requestRescheduleInterrupt();
+						receiveCount++;
+					}
+				} else if (receiveQueue.isEmpty()) {
 					// there is no item in queue, discard packet
 					networkPacket->discardOnePacket();
 				} else {
@@ -197,8 +223,39 @@ void AgentNetwork::ReceiveThread::run() {
 void AgentNetwork::ReceiveThread::reset() {
 	QMutexLocker locker(&receiveMutex);
 	receiveQueue.clear();
+	frameQueue.clear();
 	networkPacket->discardRecievedPacket();
 }
+void AgentNetwork::ReceiveThread::deliver() {
+	for(;;) {
+		QByteArray                            frame;
+		EthernetIOFaceGuam::EthernetIOCBType* iocb = 0;
+		if (Trace::isReplay()) {
+			if (!Trace::replay(Trace::T_receive, frame)) break;
+			QMutexLocker locker(&receiveMutex);
+			if (!receiveQueue.isEmpty()) iocb = receiveQueue.takeFirst().iocb;
+		} else {
+			QMutexLocker locker(&receiveMutex);
+			if (frameQueue.isEmpty()) break;
+			frame = frameQueue.takeFirst();
+			if (!receiveQueue.isEmpty()) iocb = receiveQueue.takeFirst().iocb;
+		}
+		// Record frame even if it is discarded, so that replay consumes same frame
+		if (Trace::isRecord()) Trace::record(Trace::T_receive, frame);
+
+		// there is no item in queue, discard packet
+		if (iocb == 0) continue;
+
+		if (iocb->bufferLength < (CARD32)frame.size()) {
+			iocb->status = EthernetIOFaceGuam::S_packetTooLong;
+		} else {
+			memcpy(Memory::getAddress(iocb->bufferAddress), frame.constData(), frame.size());
+			iocb->actualLength = frame.size();
+			iocb->status       = EthernetIOFaceGuam::S_completedOK;
+		}
+		InterruptThread::notifyInterrupt(interruptSelector);
+	}
+}
 
 
 
@@ -234,6 +291,29 @@ void AgentNetwork::Initialize() {
 	transmitThread.setAutoDelete(false);
 }
 
+void AgentNetwork::saveState(QDataStream& out) {
+	// Complete pending transmit. Its interrupt is saved in WP.
+	transmitThread.flush();
+	out << (quint16)receiveThread.getInterruptSelector() << (quint16)transmitThread.getInterruptSelector();
+}
+void AgentNetwork::restoreState(QDataStream& in) {
+	quint16 receiveInterruptSelector;
+	quint16 transmitInterruptSelector;
+	in >> receiveInterruptSelector >> transmitInterruptSelector;
+	receiveThread.setInterruptSelector(receiveInterruptSelector);
+	transmitThread.setInterruptSelector(transmitInterruptSelector);
+
+	// Queue of receive has pointer to host memory. Build queue again from IOCB chain in FCB.
+	if (!fcb->receiveStopped && fcb->receiveIOCB) {
+		EthernetIOFaceGuam::EthernetIOCBType* iocb = (EthernetIOFaceGuam::EthernetIOCBType*)Store(fcb->receiveIOCB);
+		for(;;) {
+			if (iocb->status == EthernetIOFaceGuam::S_inProgress) receiveThread.enqueue(iocb);
+			if (iocb->nextIOCB == 0) break;
+			iocb = (EthernetIOFaceGuam::EthernetIOCBType*)Store(iocb->nextIOCB);
+		}
+	}
+}
+
 void AgentNetwork::Call() {
 	if (fcb->stopAgent) {
 		if (!fcb->receiveStopped) {
@@ -279,7 +359,19 @@ void AgentNetwork::Call() {
 			if (packetType != EthernetIOFaceGuam::PT_transmit) ERROR();
 
 			if (DEBUG_SHOW_AGENT_NETWORK) logger.debug("AGENT %s  transmit status = %04X  nextIOCB = %08X", name, iocb->status, iocb->nextIOCB);
-			transmitThread.enqueue(iocb);
+			if (Trace::isEnabled()) {
+				// Transmit synchronously to complete IOCB at same instruction in record and replay
+				//   Replay doesn't send frame to network.
+				if (Trace::isRecord()) {
+					networkPacket->transmit(iocb);
+				} else {
+					iocb->status = EthernetIOFaceGuam::S_completedOK;
+				}
+				Trace::verify(Trace::T_transmit, iocb, sizeof(*iocb));
+				InterruptThread::notifyInterrupt(fcb->transmitInterruptSelector);
+			} else {
+				transmitThread.enqueue(iocb);
+			}
 			//
 			if (iocb->nextIOCB == 0) break;
 			iocb = (EthernetIOFaceGuam::EthernetIOCBType*)Store(iocb->nextIOCB);
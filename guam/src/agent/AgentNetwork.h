@@ -56,6 +56,9 @@ public:
 		void setInterruptSelector(CARD16 interruptSelector_) {
 			interruptSelector = interruptSelector_;
 		}
+		CARD16 getInterruptSelector() {
+			return interruptSelector;
+		}
 		void setNetworkPacket(NetworkPacket* networkPacket_) {
 			networkPacket = networkPacket_;
 		}
@@ -64,6 +67,8 @@ public:
 
 		void run();
 		void reset();
+		// Transmit all queued request in caller thread. Used after thread is stopped.
+		void flush();
 
 		quint64 getSec();
 
@@ -103,6 +108,9 @@ public:
 		void setInterruptSelector(CARD16 interruptSelector_) {
 			interruptSelector = interruptSelector_;
 		}
+		CARD16 getInterruptSelector() {
+			return interruptSelector;
+		}
 		void setNetworkPacket(NetworkPacket* networkPacket_) {
 			networkPacket = networkPacket_;
 		}
@@ -112,6 +120,10 @@ public:
 		void run();
 		void reset();
 
+		// Called from processor thread at safe point in trace mode.
+		//   Copy received frame to IOCB. Frame is recorded to or replayed from trace.
+		void deliver();
+
 		quint64 getSec();
 
 	private:
@@ -132,6 +144,8 @@ public:
 
 		QMutex            receiveMutex;
 		QLinkedList<Item> receiveQueue;
+		// Received frame waiting deliver in trace mode
+		QList<QByteArray> frameQueue;
 	};
 
 	ReceiveThread  receiveThread;
@@ -149,6 +163,9 @@ public:
 	void Initialize();
 	void Call();
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 	void poll();
 
 	void setNetworkPacket(NetworkPacket* networkPacket_) {
@@ -38,12 +38,14 @@ static log4cpp::Category& logger = Logger::getLogger("agentproc");
 #include "../mesa/Pilot.h"
 #include "../mesa/Memory.h"
 #include "../mesa/Constant.h"
+#include "../mesa/Trace.h"
 
 #include "Agent.h"
 #include "AgentProcessor.h"
 
 static quint32 getMesaTime() {
-	return Util::toMesaTime(Util::getUnixTime());
+	const quint32 time = Util::toMesaTime(Util::getUnixTime());
+	return Trace::isEnabled() ? Trace::value(Trace::T_time, time) : time;
 }
 
 void AgentProcessor::Initialize() {
@@ -64,6 +66,16 @@ void AgentProcessor::Initialize() {
 }
 
 static CARD32 gmtDifference = 0;
+
+void AgentProcessor::saveState(QDataStream& out) {
+	out << (quint32)gmtDifference;
+}
+void AgentProcessor::restoreState(QDataStream& in) {
+	quint32 value;
+	in >> value;
+	gmtDifference = value;
+}
+
 void AgentProcessor::Call() {
 	switch (fcb->command) {
 	case ProcessorIOFaceGuam::C_noop:
@@ -49,6 +49,9 @@ public:
 	void Initialize();
 	void Call();
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 	void setProcessorID(CARD16 processorID0_, CARD16 processorID1_, CARD16 processorID2_) {
 		processorID0 = processorID0_;
 		processorID1 = processorID1_;
@@ -111,6 +111,31 @@ quint16 StreamDummy::write  (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoP
 //				tr.bytesWritten, tr.bytesRead, tr.hTask, tr.interruptMesa, tr.buffer, tr.bufferSize, tr.writeLockedByMesa);
 //		}
 
+// Each stream is saved as serverID and state
+void AgentStream::saveState(QDataStream& out) {
+	for(Stream* stream: map.values()) {
+		QByteArray state;
+		{
+			QDataStream stateOut(&state, QIODevice::WriteOnly);
+			stream->saveState(stateOut);
+		}
+		out << (quint32)stream->serverID << state;
+	}
+}
+void AgentStream::restoreState(QDataStream& in) {
+	while(!in.atEnd()) {
+		quint32    serverID;
+		QByteArray state;
+		in >> serverID >> state;
+		if (!map.contains(serverID)) {
+			logger.fatal("Unknown serverID = %d", serverID);
+			ERROR();
+		}
+		QDataStream stateIn(state);
+		map[serverID]->restoreState(stateIn);
+	}
+}
+
 void AgentStream::addStream(Stream* stream) {
 	quint32 serverID = stream->serverID;
 	if (map.contains(serverID)) {
@@ -53,6 +53,10 @@ public:
 		virtual quint16 destroy(CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoProcessorIOFaceGuam::CoProcessorIOCBType *iocb) = 0;
 		virtual quint16 read   (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoProcessorIOFaceGuam::CoProcessorIOCBType *iocb) = 0;
 		virtual quint16 write  (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoProcessorIOFaceGuam::CoProcessorIOCBType *iocb) = 0;
+
+		// Host side state of stream for snapshot
+		virtual void saveState(QDataStream& /*out*/) {}
+		virtual void restoreState(QDataStream& /*in*/) {}
 	};
 
 
@@ -67,6 +71,9 @@ public:
 	void Initialize();
 	void Call();
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 	void addStream(Stream* stream);
 
 private:
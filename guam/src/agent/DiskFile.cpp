@@ -63,6 +63,24 @@ int DiskFile::verifyPage(CARD32 block, CARD16 *buffer) {
 	return memcmp(page + block, buffer, sizeof(Page));
 }
 
+quint64 DiskFile::getHash() {
+	// FNV-1a of size and sampled blocks. Reading whole disk image takes too long for snapshot.
+	static const CARD32 SAMPLE_COUNT = 256;
+	quint64 hash = 14695981039346656037ULL;
+	hash ^= size;
+	hash *= 1099511628211ULL;
+	if (maxBlock == 0) return hash;
+	for(CARD32 i = 0; i < SAMPLE_COUNT; i++) {
+		const CARD32   block = (CARD32)(((quint64)maxBlock * i) / SAMPLE_COUNT);
+		const quint64* p     = (const quint64*)(page + block);
+		for(CARD32 j = 0; j < sizeof(Page) / sizeof(quint64); j++) {
+			hash ^= p[j];
+			hash *= 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
 void DiskFile::attach(const QString& path_) {
 	path = path_;
 	logger.info("DiskFile::attach %s", path.toLatin1().constData());
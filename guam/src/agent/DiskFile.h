@@ -85,6 +85,9 @@ public:
 		return path;
 	}
 
+	// Hash of size and sampled blocks to identify disk image of snapshot
+	quint64 getHash();
+
 	CARD32 getBlock(DiskIOFaceGuam::DiskIOCBType* iocb) {
 		const CARD32 C = iocb->diskAddress.cylinder;
 		const CARD32 H = iocb->diskAddress.head;
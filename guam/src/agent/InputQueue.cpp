@@ -0,0 +1,315 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+//
+// InputQueue.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("inputqueue");
+
+#include "../util/Debug.h"
+
+#include "Agent.h"
+#include "AgentKeyboard.h"
+#include "AgentMouse.h"
+#include "InputQueue.h"
+
+#include "../mesa/Trace.h"
+
+InputQueue::Slot InputQueue::queue[QUEUE_SIZE];
+QAtomicInt       InputQueue::putPosition;
+int              InputQueue::getPosition = 0;
+QElapsedTimer    InputQueue::clock;
+QFile*           InputQueue::recordFile  = 0;
+
+int InputQueue::ReplayThread::stopThread = 0;
+
+// statistics
+static QAtomicInt countLost;     // event lost because of queue full
+static long long  countEvent   = 0;
+static long long  countMove    = 0;
+static long long  countApply   = 0; // number of apply that has event
+static long long  totalLatency = 0; // msec from put to apply
+static long long  maxLatency   = 0;
+
+static inline int loadAcquire(QAtomicInt& atomic) {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+	return atomic.loadAcquire();
+#else
+	return (int)atomic;
+#endif
+}
+static inline void storeRelease(QAtomicInt& atomic, int newValue) {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+	atomic.storeRelease(newValue);
+#else
+	atomic.fetchAndStoreRelease(newValue);
+#endif
+}
+// Difference of position with wrap around
+static inline int diff(int a, int b) {
+	return (int)((quint32)a - (quint32)b);
+}
+
+void InputQueue::initialize(const QString& recordPath) {
+	for(int i = 0; i < QUEUE_SIZE; i++) {
+		storeRelease(queue[i].sequence, i);
+	}
+	storeRelease(putPosition, 0);
+	getPosition = 0;
+	clock.start();
+
+	if (!recordPath.isEmpty()) {
+		recordFile = new QFile(recordPath);
+		if (!recordFile->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+			logger.fatal("Cannot open record file  %s", qPrintable(recordPath));
+			ERROR();
+		}
+		logger.info("Record input event to %s", qPrintable(recordPath));
+	}
+}
+
+void InputQueue::put(Event& event) {
+	if (!clock.isValid()) return; // before initialize
+	event.time = clock.elapsed();
+
+	int position = loadAcquire(putPosition);
+	Slot* slot;
+	for(;;) {
+		slot = &queue[position & (QUEUE_SIZE - 1)];
+		const int d = diff(loadAcquire(slot->sequence), position);
+		if (d == 0) {
+			// slot is vacant. Try to reserve the slot
+			if (putPosition.testAndSetOrdered(position, position + 1)) break;
+		} else if (d < 0) {
+			// queue is full
+			countLost.fetchAndAddOrdered(1);
+			return;
+		}
+		// other producer took the slot
+		position = loadAcquire(putPosition);
+	}
+	slot->event = event;
+	storeRelease(slot->sequence, position + 1);
+}
+
+int InputQueue::get(Event& event) {
+	// In replay, event comes from trace instead of queue
+	if (Trace::isReplay()) {
+		QByteArray data;
+		if (!Trace::replay(Trace::T_input, data)) return 0;
+		if (data.size() != sizeof(event)) ERROR();
+		memcpy(&event, data.constData(), sizeof(event));
+		return 1;
+	}
+
+	if (!take(event)) return 0;
+	if (Trace::isRecord()) Trace::record(Trace::T_input, QByteArray((const char*)&event, sizeof(event)));
+	return 1;
+}
+
+int InputQueue::take(Event& event) {
+	Slot* slot = &queue[getPosition & (QUEUE_SIZE - 1)];
+	if (diff(loadAcquire(slot->sequence), getPosition + 1) < 0) return 0; // queue is empty
+
+	event = slot->event;
+	storeRelease(slot->sequence, getPosition + QUEUE_SIZE);
+	getPosition++;
+	return 1;
+}
+
+QByteArray InputQueue::save() {
+	QByteArray ret;
+	Event event;
+	while(take(event)) {
+		ret.append((const char*)&event, sizeof(event));
+	}
+	return ret;
+}
+void InputQueue::restore(const QByteArray& data) {
+	if (data.size() % sizeof(Event)) ERROR();
+	const int size = data.size() / sizeof(Event);
+	for(int i = 0; i < size; i++) {
+		Event event;
+		memcpy(&event, data.constData() + i * sizeof(Event), sizeof(Event));
+		put(event);
+	}
+	if (size) logger.info("Restore %d input event", size);
+}
+
+void InputQueue::keyPress(LevelVKeys::KeyName keyName) {
+	Event event;
+	event.type    = T_keyPress;
+	event.keyName = keyName;
+	event.x       = 0;
+	event.y       = 0;
+	put(event);
+}
+void InputQueue::keyRelease(LevelVKeys::KeyName keyName) {
+	Event event;
+	event.type    = T_keyRelease;
+	event.keyName = keyName;
+	event.x       = 0;
+	event.y       = 0;
+	put(event);
+}
+void InputQueue::mouseMove(int x, int y) {
+	Event event;
+	event.type    = T_mouseMove;
+	event.keyName = 0;
+	event.x       = x;
+	event.y       = y;
+	put(event);
+}
+
+void InputQueue::apply() {
+	Event event;
+	if (!get(event)) return;
+
+	AgentKeyboard* keyboard = (AgentKeyboard*)Agent::getAgent(GuamInputOutput::keyboard);
+	AgentMouse*    mouse    = (AgentMouse*)Agent::getAgent(GuamInputOutput::mouse);
+	const qint64   now      = clock.elapsed();
+
+	countApply++;
+	// Apply mouse move just before other event or at the end
+	int moved = 0;
+	int x     = 0;
+	int y     = 0;
+	do {
+		countEvent++;
+		const qint64 latency = now - event.time;
+		totalLatency += latency;
+		if (maxLatency < latency) maxLatency = latency;
+
+		switch(event.type) {
+		case T_keyPress:
+			if (moved) mouse->setPosition(x, y);
+			moved = 0;
+			if (DEBUG_SHOW_EVENT_KEY) logger.debug("%-12s  %3d", "keyPress", event.keyName);
+			keyboard->keyPress((LevelVKeys::KeyName)event.keyName);
+			if (recordFile) recordFile->write(QString("%1 press %2\n").arg(event.time).arg(event.keyName).toLatin1());
+			break;
+		case T_keyRelease:
+			if (moved) mouse->setPosition(x, y);
+			moved = 0;
+			if (DEBUG_SHOW_EVENT_KEY) logger.debug("%-12s  %3d", "keyRelease", event.keyName);
+			keyboard->keyRelease((LevelVKeys::KeyName)event.keyName);
+			if (recordFile) recordFile->write(QString("%1 release %2\n").arg(event.time).arg(event.keyName).toLatin1());
+			break;
+		case T_mouseMove:
+			countMove++;
+			moved = 1;
+			x     = event.x;
+			y     = event.y;
+			// Record all move to replay same motion
+			if (recordFile) recordFile->write(QString("%1 move %2 %3\n").arg(event.time).arg(event.x).arg(event.y).toLatin1());
+			break;
+		default:
+			logger.fatal("event.type = %d", event.type);
+			ERROR();
+			break;
+		}
+	} while(get(event));
+
+	if (moved) mouse->setPosition(x, y);
+	if (recordFile) recordFile->flush();
+}
+
+void InputQueue::stats() {
+	logger.info("InputQueue stats  event = %8lld  move = %8lld  apply = %8lld  lost = %d", countEvent, countMove, countApply, loadAcquire(countLost));
+	logger.info("InputQueue stats  latency = %8.2f ms  max = %lld ms", countEvent ? ((double)totalLatency / countEvent) : 0.0, maxLatency);
+}
+
+void InputQueue::ReplayThread::stop() {
+	logger.info("InputQueue::ReplayThread::stop");
+	stopThread = 1;
+}
+
+void InputQueue::ReplayThread::run() {
+	logger.info("InputQueue::ReplayThread::run START  %s", qPrintable(path));
+	stopThread = 0;
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		logger.fatal("Cannot open replay file  %s", qPrintable(path));
+		return;
+	}
+	QTextStream in(&file);
+
+	QElapsedTimer replayClock;
+	replayClock.start();
+
+	int count = 0;
+	while(!in.atEnd()) {
+		const QString line = in.readLine().trimmed();
+		// skip empty line and comment
+		if (line.isEmpty() || line.startsWith("#")) continue;
+
+		const QStringList fields = line.simplified().split(' ');
+		bool ok = fields.size() == 3 || fields.size() == 4;
+		bool okTime = false;
+		const qint64 time = ok ? fields[0].toLongLong(&okTime) : 0;
+
+		Event event;
+		event.keyName = 0;
+		event.x       = 0;
+		event.y       = 0;
+		if (ok && okTime && fields.size() == 3 && fields[1] == "press") {
+			event.type    = T_keyPress;
+			event.keyName = fields[2].toUInt(&ok);
+		} else if (ok && okTime && fields.size() == 3 && fields[1] == "release") {
+			event.type    = T_keyRelease;
+			event.keyName = fields[2].toUInt(&ok);
+		} else if (ok && okTime && fields.size() == 4 && fields[1] == "move") {
+			bool okY = false;
+			event.type = T_mouseMove;
+			event.x    = fields[2].toInt(&ok);
+			event.y    = fields[3].toInt(&okY);
+			ok = ok && okY;
+		} else {
+			ok = false;
+		}
+		if (!ok) {
+			logger.warn("Unexpected line in replay file  %s", qPrintable(line));
+			continue;
+		}
+
+		// wait until time of event
+		for(;;) {
+			if (stopThread) goto exitLoop;
+			const qint64 waitTime = time - replayClock.elapsed();
+			if (waitTime <= 0) break;
+			Util::msleep((quint32)qMin(waitTime, (qint64)WAIT_INTERVAL));
+		}
+
+		put(event);
+		count++;
+	}
+
+exitLoop:
+	logger.info("InputQueue::ReplayThread::run STOP  count = %d", count);
+}
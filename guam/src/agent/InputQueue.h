@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+//
+// InputQueue.h
+//
+
+#ifndef INPUTQUEUE_H__
+#define INPUTQUEUE_H__
+
+#include "../util/Util.h"
+
+#include "../mesa/Pilot.h"
+
+// InputQueue passes keyboard and mouse event from gui thread to processor thread.
+//   Any thread can put event to queue without lock.
+//   Processor thread applies event to FCB of AgentKeyboard and AgentMouse at safe point, CallAgent and reschedule.
+//   Consecutive mouse move is coalesced to last position.
+//   Event can be recorded to file and replayed from file with same timing.
+class InputQueue {
+public:
+	enum Type {
+		T_keyPress   = 1,
+		T_keyRelease = 2,
+		T_mouseMove  = 3,
+	};
+
+	class Event {
+	public:
+		quint32 type;
+		quint32 keyName; // LevelVKeys::KeyName for T_keyPress and T_keyRelease
+		qint32  x;       // position for T_mouseMove
+		qint32  y;
+		qint64  time;    // msec since initialize
+	};
+
+	// Replay event from file
+	//   Each line of file is one of below. time is msec since start of replay.
+	//     time press   keyName
+	//     time release keyName
+	//     time move    x y
+	class ReplayThread : public QRunnable {
+	public:
+		static const int WAIT_INTERVAL = 100;
+
+		static void stop();
+
+		void setPath(const QString& path_) {
+			path = path_;
+		}
+		void run();
+
+	private:
+		static int stopThread;
+		QString    path;
+	};
+
+	// recordPath is path of file to record event. Empty means no recording.
+	static void initialize(const QString& recordPath);
+
+	// Called from any thread
+	static void keyPress  (LevelVKeys::KeyName keyName);
+	static void keyRelease(LevelVKeys::KeyName keyName);
+	static void mouseMove (int x, int y);
+
+	// Called from processor thread
+	static void apply();
+	static void stats();
+
+	// Pending event for snapshot. Called while processor thread is stopped.
+	static QByteArray save();
+	static void       restore(const QByteArray& data);
+
+private:
+	// Bounded queue of multiple producer and single consumer.
+	//   sequence of slot tells the slot is ready for producer or consumer.
+	static const int QUEUE_SIZE = 1024; // must be power of 2
+
+	class Slot {
+	public:
+		QAtomicInt sequence;
+		Event      event;
+	};
+
+	static Slot          queue[QUEUE_SIZE];
+	static QAtomicInt    putPosition;
+	static int           getPosition; // Used only in consumer
+	static QElapsedTimer clock;
+	static QFile*        recordFile;
+
+	static void put (Event& event);
+	static int  get (Event& event);
+	// take event from queue
+	static int  take(Event& event);
+};
+
+#endif
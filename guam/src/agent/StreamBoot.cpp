@@ -128,3 +128,16 @@ quint16 StreamBoot::write  (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoPr
 
 	return CoProcessorIOFaceGuam::R_completed;
 }
+
+void StreamBoot::saveState(QDataStream& out) {
+	out << (quint32)pos;
+}
+void StreamBoot::restoreState(QDataStream& in) {
+	quint32 pos_;
+	in >> pos_;
+	if (mapSize < pos_) {
+		logger.fatal("pos = %d  mapSize = %d", pos_, mapSize);
+		ERROR();
+	}
+	pos = pos_;
+}
@@ -49,6 +49,9 @@ public:
 	quint16 read   (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoProcessorIOFaceGuam::CoProcessorIOCBType *iocb);
 	quint16 write  (CoProcessorIOFaceGuam::CoProcessorFCBType *fcb, CoProcessorIOFaceGuam::CoProcessorIOCBType *iocb);
 
+	void saveState(QDataStream& out);
+	void restoreState(QDataStream& in);
+
 private:
 	QString  path;
 	quint16* map;
@@ -14,6 +14,9 @@ SOURCES += Agent.cpp AgentBeep.cpp AgentDisk.cpp AgentDisplay.cpp AgentFloppy.cp
 HEADERS += AgentMouse.h   AgentNetwork.h   AgentProcessor.h   AgentStream.h   DiskFile.h   NetworkPacket.h
 SOURCES += AgentMouse.cpp AgentNetwork.cpp AgentProcessor.cpp AgentStream.cpp DiskFile.cpp
 
+HEADERS += InputQueue.h
+SOURCES += InputQueue.cpp
+
 HEADRES += StreamBoot.h   StreamCopyPaste.h   StreamPCFA.h   StreamTCP.h   StreamWWC.h
 SOURCES += StreamBoot.cpp StreamCopyPaste.cpp StreamPCFA.cpp StreamTCP.cpp StreamWWC.cpp
 
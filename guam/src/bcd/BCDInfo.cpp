@@ -295,8 +295,6 @@ void MTInfo::setJsonArray(QJsonArray& ja, const QList<MTInfo>& list) {
 // BCDInfo
 //
 
-static QCryptographicHash md5(QCryptographicHash::Algorithm::Md5);
-
 QString getHash(QString path) {
 	QFile file(path);
 	bool result = file.open(QIODevice::OpenModeFlag::ReadOnly);
@@ -308,7 +306,8 @@ QString getHash(QString path) {
 	QByteArray data = file.readAll();
 	file.close();
 
-	md5.reset();
+	// Use local object, BCDInfo can be created from more than one thread
+	QCryptographicHash md5(QCryptographicHash::Algorithm::Md5);
 	md5.addData(data);
 	return md5.result().toHex();
 }
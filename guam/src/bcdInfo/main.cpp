@@ -37,6 +37,9 @@ static log4cpp::Category& logger = Logger::getLogger("main");
 
 #include "../bcd/BCDInfo.h"
 
+#include "../util/Batch.h"
+#include "../util/BuildCache.h"
+
 // Define PageFault and WriteProtectFault for BCDFile
 void PageFault(CARD32 ptr) {
 	logger.fatal("%s %X", __FUNCTION__, ptr);
@@ -48,11 +51,12 @@ void WriteProtectFault(CARD32 ptr) {
 }
 
 
-void processFile(const QDir& outDir, const QFileInfo& fileInfo) {
+// Returns path of output file. Returns empty string if it is not BCD file.
+QString processFile(const QDir& outDir, const QFileInfo& fileInfo) {
 	BCD bcd(fileInfo.filePath());
 
 	// If it is not BCD file, just return
-	if (!bcd.isBCDFile()) return;
+	if (!bcd.isBCDFile()) return QString();
 
 	logger.info("%s %s", __FUNCTION__, fileInfo.filePath().toLocal8Bit().constData());
 
@@ -112,12 +116,13 @@ void processFile(const QDir& outDir, const QFileInfo& fileInfo) {
 	}
 
 	// Output jsonObect to file
+	QString outFilePath;
 	{
 		QJsonDocument jsonDoc(jsonObject);
 		QByteArray fileContents = jsonDoc.toJson(QJsonDocument::JsonFormat::Indented); // Compact or Indented
 
 		QFileInfo outFileInfo(outDir, QString("%1.json").arg(fileInfo.fileName()));
-		QString outFilePath = outFileInfo.filePath();
+		outFilePath = outFileInfo.absoluteFilePath();
 		QFile outFile(outFilePath);
 		if (!outFile.open(QIODevice::OpenModeFlag::WriteOnly)) {
 			logger.fatal("File open error %s", outFile.errorString().toLocal8Bit().constData());
@@ -130,30 +135,7 @@ void processFile(const QDir& outDir, const QFileInfo& fileInfo) {
 		}
 		outFile.close();
 	}
-}
-
-
-void processDir(const QDir& outDir, const QFileInfo& parentFileInfo) {
-	QDir parentDir(parentFileInfo.filePath());
-
-	QList<QFileInfo> childFileInfoList = parentDir.entryInfoList(QDir::Filter::NoFilter, QDir::SortFlag::Name);
-	for(QFileInfo childFileInfo: childFileInfoList) {
-		QString childFileName(childFileInfo.fileName());
-		if (childFileInfo.isDir()) {
-			// Return if file is . or ..
-			if (childFileName == ".") continue;
-			if (childFileName == "..") continue;
-
-			QFileInfo childOutFileInfo(outDir, childFileName);
-			QDir childOutDir(childOutFileInfo.filePath());
-			processDir(childOutDir, childFileInfo);
-		}
-		if (childFileInfo.isFile()) {
-			if (childFileName.endsWith(".bcd") || childFileName.endsWith(".symbols")) {
-				processFile(outDir, childFileInfo);
-			}
-		}
-	}
+	return outFilePath;
 }
 
 
@@ -172,35 +154,48 @@ int main(int argc, char** argv) {
 			ERROR();
 		}
 
+		QStringList pathList;
 		for(int i = 1; i < argc; i++) {
 			QString path = argv[i];
 			logger.info("path = %s", path.toLocal8Bit().constData());
-			QFileInfo fileInfo(path);
+			pathList.append(path);
+		}
 
-			// Sanity check
-			if (!fileInfo.exists()) {
-				logger.fatal("path doesn't exist = %s", fileInfo.filePath().toLocal8Bit().constData());
-				ERROR();
-			}
+		Batch batch;
+		QList<Batch::Entry> entryList = batch.scan(pathList, [](const QFileInfo& fileInfo) {
+			QString fileName(fileInfo.fileName());
+			return fileName.endsWith(".bcd") || fileName.endsWith(".symbols");
+		});
 
-			if (fileInfo.isFile()) {
-				processFile(outDir, fileInfo);
-			}
-			if (fileInfo.isDir()) {
-				QString fileName(fileInfo.fileName());
-				// Special case : trailing slash
-				if (fileName.length() == 0) {
-					fileInfo = QFileInfo(fileInfo.path());
-					fileName = fileInfo.fileName();
-				}
-
-				QFileInfo rootOutDirFileInfo(outDir, fileName);
-				QDir rootOutDir(rootOutDirFileInfo.filePath());
-
-				logger.info("rootOutDir = %s", rootOutDirFileInfo.filePath().toLocal8Bit().constData());
-				processDir(rootOutDir, fileInfo);
+		// Skip input that is not changed since last run.
+		//   Output of input that no longer exists is removed.
+		BuildCache cache(outDirPath + ".cache", argv[0]);
+		cache.load();
+		{
+			QSet<QString> relativePathSet;
+			for(const Batch::Entry& entry: entryList) relativePathSet += entry.relativePath;
+			for(QString output: cache.removeStale(relativePathSet)) {
+				logger.info("remove %s", output.toLocal8Bit().constData());
+				QFile::remove(output);
 			}
 		}
+
+		// Directory structure of input is kept in outDir
+		int failCount = batch.run(entryList, [&outDir, &cache](const Batch::Entry& entry) {
+			if (cache.isUpToDate(entry.relativePath, entry.fileInfo)) return QByteArray();
+
+			QFileInfo outFileInfo(outDir, entry.relativePath);
+			QString outFilePath = processFile(QDir(outFileInfo.path()), entry.fileInfo);
+			cache.update(entry.relativePath, entry.fileInfo, QString(), outFilePath.isEmpty() ? QStringList() : QStringList(outFilePath));
+			return QByteArray();
+		}, [](const Batch::Entry& /*entry*/, const QByteArray& /*output*/) {});
+		// Keep result of successful entry even if there is failure
+		cache.save();
+		logger.info("cache hit %d  miss %d", cache.getHit(), cache.getMiss());
+		if (failCount) {
+			logger.fatal("failCount = %d", failCount);
+			ERROR();
+		}
 	} catch (Error& e) {
 		logger.info("Error %s %d %s", e.file, e.line, e.func);
 		return -1;
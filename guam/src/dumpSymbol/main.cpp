@@ -36,6 +36,8 @@ static log4cpp::Category& logger = Logger::getLogger("main");
 #include "../symbols/Symbols.h"
 #include "../symbols/DumpSymbol.h"
 
+#include "../util/Batch.h"
+
 void PageFault(CARD32 ptr) {
 	logger.fatal("%s %X", __FUNCTION__, ptr);
 }
@@ -55,11 +57,56 @@ int main(int argc, char** argv) {
 		ERROR();
 	}
 
+	// -z     write compressed output (.symbol.gz)
+	// -bench run dumpSymbol of each file repeatedly with and without compression
+	bool compress = false;
+	bool bench    = false;
+	QStringList pathList;
 	for(int i = 1; i < argc; i++) {
-		QString filePath = argv[i];
-		logger.info("path = %s", filePath.toLocal8Bit().constData());
+		QString path = argv[i];
+		if (path == "-z") {
+			compress = true;
+			continue;
+		}
+		if (path == "-bench") {
+			bench = true;
+			continue;
+		}
+		logger.info("path = %s", path.toLocal8Bit().constData());
+		pathList.append(path);
+	}
+
+	if (bench) {
+		const int count = 10;
+		for(QString path: pathList) {
+			for(bool z: {false, true}) {
+				QElapsedTimer timer;
+				timer.start();
+				quint64 size = 0;
+				for(int i = 0; i < count; i++) {
+					size += DumpSymbol::dumpSymbol(path, outDirPath, z);
+				}
+				qint64 elapsed = timer.elapsed();
+				logger.info("bench %-4s %6lld ms  %8.2f MB/s  %10llu bytes  %s", z ? "gzip" : "text", elapsed, elapsed ? ((double)size / (1024 * 1024)) / (elapsed / 1000.0) : 0.0, size / count, path.toLocal8Bit().constData());
+			}
+		}
+		logger.info("STOP");
+		return 0;
+	}
+
+	Batch batch;
+	QList<Batch::Entry> entryList = batch.scan(pathList, [](const QFileInfo& fileInfo) {
+		QString fileName(fileInfo.fileName());
+		return fileName.endsWith(".bcd") || fileName.endsWith(".symbols");
+	});
 
-		DumpSymbol::dumpSymbol(filePath, outDirPath);
+	int failCount = batch.run(entryList, [&outDirPath, compress](const Batch::Entry& entry) {
+		DumpSymbol::dumpSymbol(entry.fileInfo.filePath(), outDirPath, compress);
+		return QByteArray();
+	}, [](const Batch::Entry& /*entry*/, const QByteArray& /*output*/) {});
+	if (failCount) {
+		logger.fatal("failCount = %d", failCount);
+		return -1;
 	}
 	
 	logger.info("STOP");
@@ -43,13 +43,13 @@ static log4cpp::Category& logger = Logger::getLogger("LoadGerm");
 
 #include "../simple-opcode/Interpreter.h"
 
+#include "RfbGuiOp.h"
+
 #include <QtCore>
 
 int main() {
 	logger.info("START");
 
-	GuiOp::setContext(new NullGuiOp);
-
 	Preference preference;
 
 	QString group            = preference.getAsString("Main", "Section");
@@ -57,6 +57,9 @@ int main() {
 
 	CARD32  displayWidth     = preference.getAsUINT32(group, "DisplayWidth");
 	CARD32  displayHeight    = preference.getAsUINT32(group, "DisplayHeight");
+	QString displayType      = preference.getAsString(group, "DisplayType");
+	// Empty DisplayType means monochrome same as MesaProcessor
+	if (displayType.isEmpty()) displayType = "monochrome";
 
 	QString diskPath         = preference.getAsString(group, "DiskPath");
 	QString germPath         = preference.getAsString(group, "GermPath");
@@ -69,9 +72,25 @@ int main() {
 	quint32 vmBits           = preference.getAsUINT32(group, "VMBits");
 	quint32 rmBits           = preference.getAsUINT32(group, "RMBits");
 
+	QString rfbAddress       = preference.getAsString("RFB", "Address");
+	quint32 rfbPort          = preference.getAsUINT32("RFB", "Port");
+
+	RfbGuiOp* rfbGuiOp = 0;
+	if (rfbPort) {
+		if (displayType != "monochrome") {
+			logger.fatal("RFB server supports monochrome display only.  displayType = %s", qPrintable(displayType));
+			ERROR();
+		}
+		rfbGuiOp = new RfbGuiOp(rfbAddress, rfbPort, displayWidth, displayHeight);
+		GuiOp::setContext(rfbGuiOp);
+	} else {
+		GuiOp::setContext(new NullGuiOp);
+	}
+
 	// stop at MP 8000
 	ProcessorThread::stopAtMP( 915);
-	ProcessorThread::stopAtMP(8000);
+	// Keep running after MP 8000 if display is served with RFB
+	if (rfbGuiOp == 0) ProcessorThread::stopAtMP(8000);
 
 //	ProcessorThread::stopAtMP( 940);
 //	ProcessorThread::stopMessageUntilMP(930);
@@ -87,10 +106,18 @@ int main() {
 
 	mesaProcessor.setMemorySize(vmBits, rmBits);
 	mesaProcessor.setDisplaySize(displayWidth, displayHeight);
+	mesaProcessor.setDisplayType(displayType);
 	mesaProcessor.setNetworkInterfaceName(networkInterface);
+	mesaProcessor.setInputRecordPath(preference.getAsString("Input", "Record"));
+	mesaProcessor.setInputReplayPath(preference.getAsString("Input", "Replay"));
+	mesaProcessor.setProfiler(preference.getAsUINT32("Profiler", "Interval"), preference.getAsString("Profiler", "Path"));
+	mesaProcessor.setTrace(preference.getAsString("Trace", "Mode"), preference.getAsString("Trace", "Path"));
+	mesaProcessor.setSnapshot(preference.getAsString("Snapshot", "Save"), preference.getAsString("Snapshot", "Restore"));
 
 	mesaProcessor.initialize();
 
+	if (rfbGuiOp) rfbGuiOp->start();
+
 	// measure elapsed time between boot and MP8000
 	QElapsedTimer elapsedTimer;
 	elapsedTimer.start();
@@ -98,11 +125,15 @@ int main() {
 	mesaProcessor.wait();
 	quint64 elapsedTime = elapsedTimer.nsecsElapsed();
 
+	if (rfbGuiOp) rfbGuiOp->stop();
+
 	Interpreter::stats();
 	Perf_log();
 	PageCache::stats();
 	CodeCache::stats();
 	LFCache::stats();
+	AVCache::stats();
+	GFTCache::stats();
 
 	//extern void MonoBlt_MemoryCache_stats();
 	//MonoBlt_MemoryCache_stats();
@@ -0,0 +1,464 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// RfbEncoder.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("rfbencoder");
+
+#include "../mesa/MesaBasic.h"
+
+#include "RfbEncoder.h"
+
+
+//
+// RfbEncoder::PixelFormat
+//
+void RfbEncoder::PixelFormat::read(const quint8* p) {
+	bitsPerPixel = p[0];
+	depth        = p[1];
+	bigEndian    = p[2];
+	trueColour   = p[3];
+	redMax       = (p[4] << 8) | p[5];
+	greenMax     = (p[6] << 8) | p[7];
+	blueMax      = (p[8] << 8) | p[9];
+	redShift     = p[10];
+	greenShift   = p[11];
+	blueShift    = p[12];
+	// p[13 .. 15] is padding
+}
+void RfbEncoder::PixelFormat::write(QByteArray& out) const {
+	put8 (out, bitsPerPixel);
+	put8 (out, depth);
+	put8 (out, bigEndian);
+	put8 (out, trueColour);
+	put16(out, redMax);
+	put16(out, greenMax);
+	put16(out, blueMax);
+	put8 (out, redShift);
+	put8 (out, greenShift);
+	put8 (out, blueShift);
+	// padding
+	put8 (out, 0);
+	put8 (out, 0);
+	put8 (out, 0);
+}
+int RfbEncoder::PixelFormat::isValid() const {
+	switch(bitsPerPixel) {
+	case 8:
+	case 16:
+	case 32:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+
+//
+// RfbEncoder
+//
+RfbEncoder::RfbEncoder() {
+	setPixelFormat(PixelFormat());
+
+	memset(&zstream, 0, sizeof(zstream));
+	int ret = deflateInit(&zstream, Z_DEFAULT_COMPRESSION);
+	if (ret != Z_OK) {
+		logger.fatal("deflateInit returns %d", ret);
+		ERROR();
+	}
+}
+RfbEncoder::~RfbEncoder() {
+	deflateEnd(&zstream);
+}
+
+void RfbEncoder::setPixelFormat(const PixelFormat& newValue) {
+	if (!newValue.isValid()) {
+		logger.fatal("bitsPerPixel = %d", newValue.bitsPerPixel);
+		ERROR();
+	}
+	pixelFormat = newValue;
+	if (pixelFormat.trueColour) {
+		// white
+		pixel[0] = (pixelFormat.redMax   << pixelFormat.redShift) |
+		           (pixelFormat.greenMax << pixelFormat.greenShift) |
+		           (pixelFormat.blueMax  << pixelFormat.blueShift);
+		// black
+		pixel[1] = 0;
+	} else {
+		// Use color map entry 0 for white and 1 for black. See RfbGuiOp::Client::setPixelFormat
+		pixel[0] = 0;
+		pixel[1] = 1;
+	}
+}
+
+int RfbEncoder::isSupported(qint32 encoding) {
+	switch(encoding) {
+	case E_RAW:
+	case E_RRE:
+	case E_HEXTILE:
+	case E_ZRLE:
+	case E_CURSOR:
+		return 1;
+	default:
+		return 0;
+	}
+}
+const char* RfbEncoder::getEncodingName(qint32 encoding) {
+	switch(encoding) {
+	case E_RAW:     return "RAW";
+	case E_RRE:     return "RRE";
+	case E_HEXTILE: return "HEXTILE";
+	case E_ZRLE:    return "ZRLE";
+	case E_CURSOR:  return "CURSOR";
+	default:        return "UNKNOWN";
+	}
+}
+
+void RfbEncoder::putPixel(QByteArray& out, quint32 value) {
+	switch(pixelFormat.bitsPerPixel) {
+	case 8:
+		put8(out, value);
+		break;
+	case 16:
+		if (pixelFormat.bigEndian) {
+			put16(out, value);
+		} else {
+			put8(out, value >> 0);
+			put8(out, value >> 8);
+		}
+		break;
+	case 32:
+		if (pixelFormat.bigEndian) {
+			put32(out, value);
+		} else {
+			put8(out, value >>  0);
+			put8(out, value >>  8);
+			put8(out, value >> 16);
+			put8(out, value >> 24);
+		}
+		break;
+	default:
+		ERROR();
+		break;
+	}
+}
+void RfbEncoder::putCPixel(QByteArray& out, quint32 value) {
+	// CPIXEL is 3 bytes if true color, 32 bits per pixel and depth is less than or equal to 24
+	if (pixelFormat.trueColour && pixelFormat.bitsPerPixel == 32 && pixelFormat.depth <= 24) {
+		const int fitsInLeastSignificant = ((pixel[0] | pixel[1]) & 0xFF000000) == 0;
+		if (fitsInLeastSignificant) {
+			if (pixelFormat.bigEndian) {
+				put8(out, value >> 16);
+				put8(out, value >>  8);
+				put8(out, value >>  0);
+			} else {
+				put8(out, value >>  0);
+				put8(out, value >>  8);
+				put8(out, value >> 16);
+			}
+		} else {
+			if (pixelFormat.bigEndian) {
+				put8(out, value >> 24);
+				put8(out, value >> 16);
+				put8(out, value >>  8);
+			} else {
+				put8(out, value >>  8);
+				put8(out, value >> 16);
+				put8(out, value >> 24);
+			}
+		}
+	} else {
+		putPixel(out, value);
+	}
+}
+
+void RfbEncoder::findRuns(const Frame& frame, const GuiOp::Rect& rect, int bit, QVector<Run>& runs) {
+	runs.clear();
+
+	// runs of previous line that can be extended by next line
+	QVector<Run> open;
+	QVector<Run> next;
+	for(int y = 0; y < rect.height; y++) {
+		next.clear();
+		int i = 0;
+		int x = 0;
+		while(x < rect.width) {
+			if (frame.bit(rect.x + x, rect.y + y) != bit) {
+				x++;
+				continue;
+			}
+			const int start = x;
+			while(x < rect.width && frame.bit(rect.x + x, rect.y + y) == bit) x++;
+			const int width = x - start;
+
+			// close open run that cannot be extended
+			while(i < open.size() && open[i].x < start) runs.append(open[i++]);
+			if (i < open.size() && open[i].x == start && open[i].width == width) {
+				Run run = open[i++];
+				run.height++;
+				next.append(run);
+			} else {
+				next.append(Run(start, y, width, 1));
+			}
+		}
+		while(i < open.size()) runs.append(open[i++]);
+		open.swap(next);
+	}
+	for(const Run& run: open) runs.append(run);
+}
+int RfbEncoder::countBlack(const Frame& frame, const GuiOp::Rect& rect) {
+	int ret = 0;
+	for(int y = 0; y < rect.height; y++) {
+		for(int x = 0; x < rect.width; x++) {
+			ret += frame.bit(rect.x + x, rect.y + y);
+		}
+	}
+	return ret;
+}
+
+void RfbEncoder::encode(QByteArray& out, qint32 encoding, const Frame& frame, const GuiOp::Rect& rect) {
+	put16(out, rect.x);
+	put16(out, rect.y);
+	put16(out, rect.width);
+	put16(out, rect.height);
+	put32(out, (quint32)encoding);
+
+	switch(encoding) {
+	case E_RAW:
+		encodeRaw(out, frame, rect);
+		break;
+	case E_RRE:
+		encodeRRE(out, frame, rect);
+		break;
+	case E_HEXTILE:
+		encodeHextile(out, frame, rect);
+		break;
+	case E_ZRLE:
+		encodeZRLE(out, frame, rect);
+		break;
+	default:
+		logger.fatal("encoding = %d", encoding);
+		ERROR();
+		break;
+	}
+}
+
+void RfbEncoder::encodeCursor(QByteArray& out, const GuiOp::CursorPattern& cursor) {
+	const int size = ELEMENTSOF(cursor.data);
+
+	// x and y of rectangle is hot spot of cursor
+	put16(out, 0);
+	put16(out, 0);
+	put16(out, size);
+	put16(out, size);
+	put32(out, (quint32)E_CURSOR);
+
+	// Word of CursorPattern is stored as big endian like display memory. See AgentDisplay::Call
+	quint16 data[size];
+	for(int y = 0; y < size; y++) data[y] = qToBigEndian(cursor.data[y]);
+
+	// pixel of cursor. MSB of word is left most pixel and 1 means black
+	for(int y = 0; y < size; y++) {
+		for(int x = 0; x < size; x++) {
+			putPixel(out, pixel[(data[y] >> (size - 1 - x)) & 1]);
+		}
+	}
+	// bitmask of cursor. Same as UserTerminal::setCursorPattern, only black pixel is visible.
+	for(int y = 0; y < size; y++) {
+		put16(out, data[y]);
+	}
+}
+
+void RfbEncoder::encodeRaw(QByteArray& out, const Frame& frame, const GuiOp::Rect& rect) {
+	for(int y = 0; y < rect.height; y++) {
+		for(int x = 0; x < rect.width; x++) {
+			putPixel(out, pixel[frame.bit(rect.x + x, rect.y + y)]);
+		}
+	}
+}
+
+void RfbEncoder::encodeRRE(QByteArray& out, const Frame& frame, const GuiOp::Rect& rect) {
+	// Use majority color as background to reduce number of subrectangle
+	const int black = countBlack(frame, rect);
+	const int bg = ((rect.width * rect.height) < (black * 2)) ? 1 : 0;
+	const int fg = bg ^ 1;
+
+	QVector<Run> runs;
+	findRuns(frame, rect, fg, runs);
+
+	put32(out, runs.size());
+	putPixel(out, pixel[bg]);
+	for(const Run& run: runs) {
+		putPixel(out, pixel[fg]);
+		put16(out, run.x);
+		put16(out, run.y);
+		put16(out, run.width);
+		put16(out, run.height);
+	}
+}
+
+void RfbEncoder::encodeHextile(QByteArray& out, const Frame& frame, const GuiOp::Rect& rect) {
+	const int bytesPerPixel = pixelFormat.bitsPerPixel / 8;
+
+	// Background and foreground are carried over to next tile unless tile is raw
+	int validBg = 0;
+	int validFg = 0;
+	int lastBg  = 0;
+	int lastFg  = 0;
+
+	QVector<Run> runs;
+	for(int ty = 0; ty < rect.height; ty += HEXTILE_TILE_SIZE) {
+		const int th = qMin(HEXTILE_TILE_SIZE, rect.height - ty);
+		for(int tx = 0; tx < rect.width; tx += HEXTILE_TILE_SIZE) {
+			const int tw = qMin(HEXTILE_TILE_SIZE, rect.width - tx);
+			const GuiOp::Rect tile(rect.x + tx, rect.y + ty, tw, th);
+			const int size  = tw * th;
+			const int black = countBlack(frame, tile);
+
+			if (black == 0 || black == size) {
+				// solid tile
+				const int bg = black ? 1 : 0;
+				if (validBg && lastBg == bg) {
+					put8(out, 0);
+				} else {
+					put8(out, HEXTILE_BACKGROUND_SPECIFIED);
+					putPixel(out, pixel[bg]);
+					validBg = 1;
+					lastBg  = bg;
+				}
+				continue;
+			}
+
+			const int bg = (size < (black * 2)) ? 1 : 0;
+			const int fg = bg ^ 1;
+			findRuns(frame, tile, fg, runs);
+
+			quint8 subencoding = HEXTILE_ANY_SUBRECTS;
+			int subrectSize = 1 + runs.size() * 2;
+			if (!validBg || lastBg != bg) {
+				subencoding |= HEXTILE_BACKGROUND_SPECIFIED;
+				subrectSize += bytesPerPixel;
+			}
+			if (!validFg || lastFg != fg) {
+				subencoding |= HEXTILE_FOREGROUND_SPECIFIED;
+				subrectSize += bytesPerPixel;
+			}
+
+			if (255 < runs.size() || (size * bytesPerPixel) <= subrectSize) {
+				put8(out, HEXTILE_RAW);
+				encodeRaw(out, frame, tile);
+				validBg = 0;
+				validFg = 0;
+				continue;
+			}
+
+			put8(out, subencoding);
+			if (subencoding & HEXTILE_BACKGROUND_SPECIFIED) putPixel(out, pixel[bg]);
+			if (subencoding & HEXTILE_FOREGROUND_SPECIFIED) putPixel(out, pixel[fg]);
+			put8(out, runs.size());
+			for(const Run& run: runs) {
+				put8(out, (run.x << 4) | run.y);
+				put8(out, ((run.width - 1) << 4) | (run.height - 1));
+			}
+			validBg = 1;
+			validFg = 1;
+			lastBg  = bg;
+			lastFg  = fg;
+		}
+	}
+}
+
+void RfbEncoder::encodeZRLE(QByteArray& out, const Frame& frame, const GuiOp::Rect& rect) {
+	zrleData.clear();
+
+	for(int ty = 0; ty < rect.height; ty += ZRLE_TILE_SIZE) {
+		const int th = qMin(ZRLE_TILE_SIZE, rect.height - ty);
+		for(int tx = 0; tx < rect.width; tx += ZRLE_TILE_SIZE) {
+			const int tw = qMin(ZRLE_TILE_SIZE, rect.width - tx);
+			const GuiOp::Rect tile(rect.x + tx, rect.y + ty, tw, th);
+			const int size  = tw * th;
+			const int black = countBlack(frame, tile);
+
+			if (black == 0 || black == size) {
+				put8(zrleData, ZRLE_SOLID);
+				putCPixel(zrleData, pixel[black ? 1 : 0]);
+				continue;
+			}
+
+			// Palette index 0 is white and 1 is black. So packed pixel has same bit pattern as frame.
+			put8(zrleData, ZRLE_PALETTE);
+			putCPixel(zrleData, pixel[0]);
+			putCPixel(zrleData, pixel[1]);
+			const int bytesPerRow = (tw + 7) / 8;
+			// bits of last byte of row that is outside of tile
+			const quint8 lastMask = (quint8)(0xFF << ((bytesPerRow * 8) - tw));
+			for(int y = 0; y < th; y++) {
+				if ((tile.x & 7) == 0) {
+					const quint8* p = frame.data + (tile.y + y) * frame.bytesPerLine + (tile.x >> 3);
+					for(int i = 0; i < bytesPerRow - 1; i++) put8(zrleData, p[i]);
+					put8(zrleData, p[bytesPerRow - 1] & lastMask);
+				} else {
+					for(int i = 0; i < bytesPerRow; i++) {
+						quint8 byte = 0;
+						for(int j = 0; j < 8; j++) {
+							const int x = i * 8 + j;
+							if (x < tw && frame.bit(tile.x + x, tile.y + y)) byte |= 0x80 >> j;
+						}
+						put8(zrleData, byte);
+					}
+				}
+			}
+		}
+	}
+
+	// reserve space for length of zlib data
+	const int pos = out.size();
+	put32(out, 0);
+
+	zstream.next_in  = (Bytef*)zrleData.data();
+	zstream.avail_in = zrleData.size();
+	char buffer[16 * 1024];
+	do {
+		zstream.next_out  = (Bytef*)buffer;
+		zstream.avail_out = sizeof(buffer);
+		int ret = deflate(&zstream, Z_SYNC_FLUSH);
+		if (ret != Z_OK && ret != Z_BUF_ERROR) {
+			logger.fatal("deflate returns %d", ret);
+			ERROR();
+		}
+		out.append(buffer, sizeof(buffer) - zstream.avail_out);
+	} while(zstream.avail_out == 0);
+
+	const quint32 length = out.size() - pos - 4;
+	out[pos + 0] = (char)(length >> 24);
+	out[pos + 1] = (char)(length >> 16);
+	out[pos + 2] = (char)(length >>  8);
+	out[pos + 3] = (char)(length >>  0);
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// RfbEncoder.h
+//
+
+#ifndef RFBENCODER_H__
+#define RFBENCODER_H__
+
+#include "../util/Util.h"
+#include "../util/GuiOp.h"
+
+#include <QtCore>
+
+#include <zlib.h>
+
+// Encoder of RFB (VNC) framebuffer update for monochrome display
+//   See RFC 6143 The Remote Framebuffer Protocol
+class RfbEncoder {
+public:
+	// Encoding type
+	static const qint32 E_RAW     =    0;
+	static const qint32 E_RRE     =    2;
+	static const qint32 E_HEXTILE =    5;
+	static const qint32 E_ZRLE    =   16;
+	// Pseudo encoding type
+	static const qint32 E_CURSOR  = -239;
+
+	// Hextile subencoding
+	static const quint8 HEXTILE_RAW                  =  1;
+	static const quint8 HEXTILE_BACKGROUND_SPECIFIED =  2;
+	static const quint8 HEXTILE_FOREGROUND_SPECIFIED =  4;
+	static const quint8 HEXTILE_ANY_SUBRECTS         =  8;
+
+	// ZRLE subencoding
+	static const quint8 ZRLE_SOLID   = 1;
+	static const quint8 ZRLE_PALETTE = 2; // packed palette of 2 colors
+
+	static const int HEXTILE_TILE_SIZE = 16;
+	static const int ZRLE_TILE_SIZE    = 64;
+
+	class PixelFormat {
+	public:
+		// Default pixel format of server. 32 bit true color
+		PixelFormat() : bitsPerPixel(32), depth(24), bigEndian(0), trueColour(1),
+			redMax(255), greenMax(255), blueMax(255), redShift(16), greenShift(8), blueShift(0) {}
+
+		// Read and write 16 bytes of PIXEL_FORMAT
+		void read (const quint8* p);
+		void write(QByteArray& out) const;
+
+		int isValid() const;
+
+		quint8  bitsPerPixel;
+		quint8  depth;
+		quint8  bigEndian;
+		quint8  trueColour;
+		quint16 redMax;
+		quint16 greenMax;
+		quint16 blueMax;
+		quint8  redShift;
+		quint8  greenShift;
+		quint8  blueShift;
+	};
+
+	// Monochrome snapshot of display. Pixel is MSB first and 1 means black.
+	class Frame {
+	public:
+		Frame(const quint8* data_, int width_, int height_, int bytesPerLine_) :
+			data(data_), width(width_), height(height_), bytesPerLine(bytesPerLine_) {}
+
+		inline int bit(int x, int y) const {
+			return (data[y * bytesPerLine + (x >> 3)] >> (7 - (x & 7))) & 1;
+		}
+
+		const quint8* data;
+		const int     width;
+		const int     height;
+		const int     bytesPerLine;
+	};
+
+	// Horizontal run of pixels merged with same run of following lines
+	class Run {
+	public:
+		Run() : x(0), y(0), width(0), height(0) {}
+		Run(int x_, int y_, int width_, int height_) : x(x_), y(y_), width(width_), height(height_) {}
+
+		int x, y, width, height;
+	};
+
+	RfbEncoder();
+	~RfbEncoder();
+
+	void setPixelFormat(const PixelFormat& newValue);
+	const PixelFormat& getPixelFormat() const {
+		return pixelFormat;
+	}
+
+	// Append rectangle header and encoded pixel data of rect to out
+	void encode(QByteArray& out, qint32 encoding, const Frame& frame, const GuiOp::Rect& rect);
+	// Append cursor pseudo rectangle to out
+	void encodeCursor(QByteArray& out, const GuiOp::CursorPattern& cursor);
+
+	static int isSupported(qint32 encoding);
+	static const char* getEncodingName(qint32 encoding);
+
+	// Write value to out as network byte order
+	static inline void put8(QByteArray& out, quint32 value) {
+		out.append((char)value);
+	}
+	static inline void put16(QByteArray& out, quint32 value) {
+		out.append((char)(value >> 8));
+		out.append((char)(value >> 0));
+	}
+	static inline void put32(QByteArray& out, quint32 value) {
+		out.append((char)(value >> 24));
+		out.append((char)(value >> 16));
+		out.append((char)(value >>  8));
+		out.append((char)(value >>  0));
+	}
+
+	// Find runs of pixel equals to bit in rectangle. x and y of run are relative to rect
+	static void findRuns(const Frame& frame, const GuiOp::Rect& rect, int bit, QVector<Run>& runs);
+	// Count black pixel in rectangle
+	static int countBlack(const Frame& frame, const GuiOp::Rect& rect);
+
+private:
+	PixelFormat pixelFormat;
+	// pixel value of black and white in format of pixelFormat
+	quint32     pixel[2];
+
+	// ZRLE uses one zlib stream for entire connection
+	z_stream    zstream;
+	QByteArray  zrleData;
+
+	void putPixel (QByteArray& out, quint32 value);
+	// Compressed pixel for ZRLE
+	void putCPixel(QByteArray& out, quint32 value);
+
+	void encodeRaw    (QByteArray& out, const Frame& frame, const GuiOp::Rect& rect);
+	void encodeRRE    (QByteArray& out, const Frame& frame, const GuiOp::Rect& rect);
+	void encodeHextile(QByteArray& out, const Frame& frame, const GuiOp::Rect& rect);
+	void encodeZRLE   (QByteArray& out, const Frame& frame, const GuiOp::Rect& rect);
+};
+
+#endif
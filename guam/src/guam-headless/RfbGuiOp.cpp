@@ -0,0 +1,799 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// RfbGuiOp.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("rfbguiop");
+
+#include "../util/Debug.h"
+#include "../util/Preference.h"
+
+#include "../mesa/Memory.h"
+
+#include "../agent/InputQueue.h"
+
+#include "RfbEncoder.h"
+#include "RfbGuiOp.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <errno.h>
+
+
+// Message type of client to server
+static const quint8 MSG_SET_PIXEL_FORMAT           = 0;
+static const quint8 MSG_SET_ENCODINGS              = 2;
+static const quint8 MSG_FRAMEBUFFER_UPDATE_REQUEST = 3;
+static const quint8 MSG_KEY_EVENT                  = 4;
+static const quint8 MSG_POINTER_EVENT              = 5;
+static const quint8 MSG_CLIENT_CUT_TEXT            = 6;
+
+// Message type of server to client
+static const quint8 MSG_FRAMEBUFFER_UPDATE         = 0;
+static const quint8 MSG_SET_COLOUR_MAP_ENTRIES     = 1;
+
+// Security type
+static const quint8 SECURITY_NONE                  = 1;
+
+static const char* RFB_VERSION  = "RFB 003.008\n";
+static const char* DESKTOP_NAME = "guam-headless";
+
+
+//
+// RfbGuiOp::Client
+//
+class RfbGuiOp::Client : public QRunnable {
+public:
+	Client(RfbGuiOp* rfbGuiOp_, int socket_, const QString& peer_);
+	void run();
+
+private:
+	RfbGuiOp*     rfbGuiOp;
+	const int     socket;
+	const QString peer;
+	const int     bytesPerLine;
+
+	RfbEncoder    encoder;
+	qint32        encoding;
+	int           useCursor;
+
+	// snapshot of display and copy of display that viewer has
+	QByteArray    snapshot;
+	QByteArray    sent;
+
+	int           updateRequested;
+	int           fullUpdate;
+	GuiOp::Rect   requested;
+	int           lastDisplayGeneration;
+	int           lastCursorGeneration;
+	QElapsedTimer lastUpdate;
+	quint8        buttonMask;
+
+	// statistics
+	quint64       updateCount;
+	quint64       rectCount;
+	quint64       byteCount;
+	quint64       encodeTime;
+
+	int  readFully (void* buffer, int size);
+	int  writeFully(const QByteArray& data);
+
+	int  handshake();
+	int  processMessage();
+	int  sendUpdate();
+
+	void setPixelFormat(const RfbEncoder::PixelFormat& pixelFormat);
+	void setEncodings(const QVector<qint32>& encodings);
+	void findDirty(QVector<GuiOp::Rect>& rects);
+	int  clip(GuiOp::Rect& rect);
+	void copyToSent(const GuiOp::Rect& rect);
+};
+
+RfbGuiOp::Client::Client(RfbGuiOp* rfbGuiOp_, int socket_, const QString& peer_) :
+	rfbGuiOp(rfbGuiOp_), socket(socket_), peer(peer_), bytesPerLine(Memory::getDisplayBytesPerLine()) {
+	encoding              = RfbEncoder::E_RAW;
+	useCursor             = 0;
+	updateRequested       = 0;
+	fullUpdate            = 0;
+	lastDisplayGeneration = 0;
+	lastCursorGeneration  = 0;
+	buttonMask            = 0;
+	updateCount           = 0;
+	rectCount             = 0;
+	byteCount             = 0;
+	encodeTime            = 0;
+
+	const int size = bytesPerLine * rfbGuiOp->displayHeight;
+	snapshot.fill(0, size);
+	sent.fill(0, size);
+}
+
+int RfbGuiOp::Client::readFully(void* buffer, int size) {
+	char* p = (char*)buffer;
+	while(0 < size) {
+		ssize_t ret = recv(socket, p, size, 0);
+		if (ret == 0) return 0;
+		if (ret < 0) {
+			if (errno == EINTR) continue;
+			int myErrno = errno;
+			logger.warn("%s  recv returns -1.  errno = %d", qPrintable(peer), myErrno);
+			return 0;
+		}
+		p    += ret;
+		size -= ret;
+	}
+	return 1;
+}
+int RfbGuiOp::Client::writeFully(const QByteArray& data) {
+	const char* p = data.constData();
+	int size = data.size();
+	while(0 < size) {
+		ssize_t ret = send(socket, p, size, MSG_NOSIGNAL);
+		if (ret < 0) {
+			if (errno == EINTR) continue;
+			int myErrno = errno;
+			logger.warn("%s  send returns -1.  errno = %d", qPrintable(peer), myErrno);
+			return 0;
+		}
+		p    += ret;
+		size -= ret;
+	}
+	byteCount += data.size();
+	return 1;
+}
+
+int RfbGuiOp::Client::handshake() {
+	// ProtocolVersion
+	if (!writeFully(QByteArray(RFB_VERSION))) return 0;
+	char version[12];
+	if (!readFully(version, sizeof(version))) return 0;
+	QByteArray clientVersion(version, sizeof(version));
+	if (!clientVersion.startsWith("RFB 003.")) {
+		logger.warn("%s  Unexpected version %s", qPrintable(peer), clientVersion.left(11).constData());
+		return 0;
+	}
+	const int minor = clientVersion.mid(8, 3).toInt();
+	logger.info("%s  version 3.%d", qPrintable(peer), minor);
+
+	// Security
+	{
+		QByteArray out;
+		if (minor < 7) {
+			RfbEncoder::put32(out, SECURITY_NONE);
+			if (!writeFully(out)) return 0;
+		} else {
+			RfbEncoder::put8(out, 1);
+			RfbEncoder::put8(out, SECURITY_NONE);
+			if (!writeFully(out)) return 0;
+			quint8 securityType;
+			if (!readFully(&securityType, sizeof(securityType))) return 0;
+			if (securityType != SECURITY_NONE) {
+				logger.warn("%s  Unexpected security type %d", qPrintable(peer), securityType);
+				return 0;
+			}
+			if (8 <= minor) {
+				// SecurityResult OK
+				QByteArray result;
+				RfbEncoder::put32(result, 0);
+				if (!writeFully(result)) return 0;
+			}
+		}
+	}
+
+	// ClientInit. Always share display with other viewer
+	quint8 shared;
+	if (!readFully(&shared, sizeof(shared))) return 0;
+
+	// ServerInit
+	{
+		QByteArray out;
+		RfbEncoder::put16(out, rfbGuiOp->displayWidth);
+		RfbEncoder::put16(out, rfbGuiOp->displayHeight);
+		encoder.getPixelFormat().write(out);
+		RfbEncoder::put32(out, strlen(DESKTOP_NAME));
+		out.append(DESKTOP_NAME);
+		if (!writeFully(out)) return 0;
+	}
+
+	return 1;
+}
+
+void RfbGuiOp::Client::setPixelFormat(const RfbEncoder::PixelFormat& pixelFormat) {
+	logger.info("%s  pixelFormat  bpp = %d  depth = %d  bigEndian = %d  trueColour = %d", qPrintable(peer),
+		pixelFormat.bitsPerPixel, pixelFormat.depth, pixelFormat.bigEndian, pixelFormat.trueColour);
+	encoder.setPixelFormat(pixelFormat);
+
+	if (!pixelFormat.trueColour) {
+		// Entry 0 is white and entry 1 is black. See RfbEncoder::setPixelFormat
+		QByteArray out;
+		RfbEncoder::put8 (out, MSG_SET_COLOUR_MAP_ENTRIES);
+		RfbEncoder::put8 (out, 0);
+		RfbEncoder::put16(out, 0);
+		RfbEncoder::put16(out, 2);
+		for(int i = 0; i < 3; i++) RfbEncoder::put16(out, 0xFFFF);
+		for(int i = 0; i < 3; i++) RfbEncoder::put16(out, 0x0000);
+		writeFully(out);
+	}
+
+	// Need to send whole display with new pixel format
+	fullUpdate = 1;
+}
+
+void RfbGuiOp::Client::setEncodings(const QVector<qint32>& encodings) {
+	// Use first supported encoding. Encoding is listed in order of preference of viewer.
+	encoding  = RfbEncoder::E_RAW;
+	useCursor = 0;
+	int found = 0;
+	for(qint32 e: encodings) {
+		if (!RfbEncoder::isSupported(e)) continue;
+		if (e == RfbEncoder::E_CURSOR) {
+			useCursor = 1;
+			continue;
+		}
+		if (!found) {
+			encoding = e;
+			found = 1;
+		}
+	}
+	logger.info("%s  encoding = %s  useCursor = %d", qPrintable(peer), RfbEncoder::getEncodingName(encoding), useCursor);
+
+	// force send cursor to viewer
+	if (useCursor) lastCursorGeneration = rfbGuiOp->getCursorGeneration() - 1;
+}
+
+int RfbGuiOp::Client::processMessage() {
+	quint8 type;
+	if (!readFully(&type, sizeof(type))) return 0;
+
+	switch(type) {
+	case MSG_SET_PIXEL_FORMAT:
+	{
+		quint8 buffer[3 + 16];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		RfbEncoder::PixelFormat pixelFormat;
+		pixelFormat.read(buffer + 3);
+		if (!pixelFormat.isValid()) {
+			logger.warn("%s  Unexpected bitsPerPixel %d", qPrintable(peer), pixelFormat.bitsPerPixel);
+			return 0;
+		}
+		setPixelFormat(pixelFormat);
+	}
+		break;
+	case MSG_SET_ENCODINGS:
+	{
+		quint8 buffer[3];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		const int count = (buffer[1] << 8) | buffer[2];
+		QVector<qint32> encodings;
+		for(int i = 0; i < count; i++) {
+			quint8 e[4];
+			if (!readFully(e, sizeof(e))) return 0;
+			encodings.append((qint32)((e[0] << 24) | (e[1] << 16) | (e[2] << 8) | e[3]));
+		}
+		setEncodings(encodings);
+	}
+		break;
+	case MSG_FRAMEBUFFER_UPDATE_REQUEST:
+	{
+		quint8 buffer[9];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		const int incremental = buffer[0];
+		requested.x      = (buffer[1] << 8) | buffer[2];
+		requested.y      = (buffer[3] << 8) | buffer[4];
+		requested.width  = (buffer[5] << 8) | buffer[6];
+		requested.height = (buffer[7] << 8) | buffer[8];
+		updateRequested = 1;
+		if (!incremental) fullUpdate = 1;
+		if (DEBUG_SHOW_RFB) logger.debug("%s  request %d  %4d %4d %4d %4d", qPrintable(peer), incremental, requested.x, requested.y, requested.width, requested.height);
+	}
+		break;
+	case MSG_KEY_EVENT:
+	{
+		quint8 buffer[7];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		const int     down   = buffer[0];
+		const quint32 keysym = (buffer[3] << 24) | (buffer[4] << 16) | (buffer[5] << 8) | buffer[6];
+		rfbGuiOp->keyEvent(down, keysym);
+	}
+		break;
+	case MSG_POINTER_EVENT:
+	{
+		quint8 buffer[5];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		const quint8 newMask = buffer[0];
+		const int    x       = (buffer[1] << 8) | buffer[2];
+		const int    y       = (buffer[3] << 8) | buffer[4];
+		rfbGuiOp->pointerEvent(buttonMask, newMask, x, y);
+		buttonMask = newMask;
+	}
+		break;
+	case MSG_CLIENT_CUT_TEXT:
+	{
+		// Ignore contents of cut buffer
+		quint8 buffer[7];
+		if (!readFully(buffer, sizeof(buffer))) return 0;
+		quint32 length = (buffer[3] << 24) | (buffer[4] << 16) | (buffer[5] << 8) | buffer[6];
+		char text[1024];
+		while(0 < length) {
+			const quint32 size = qMin(length, (quint32)sizeof(text));
+			if (!readFully(text, size)) return 0;
+			length -= size;
+		}
+	}
+		break;
+	default:
+		logger.warn("%s  Unexpected message type %d", qPrintable(peer), type);
+		return 0;
+	}
+	return 1;
+}
+
+int RfbGuiOp::Client::clip(GuiOp::Rect& rect) {
+	int x0 = qMax(rect.x, requested.x);
+	int y0 = qMax(rect.y, requested.y);
+	int x1 = qMin(qMin(rect.x + rect.width,  requested.x + requested.width),  rfbGuiOp->displayWidth);
+	int y1 = qMin(qMin(rect.y + rect.height, requested.y + requested.height), rfbGuiOp->displayHeight);
+	if (x1 <= x0 || y1 <= y0) return 0;
+
+	// Align to byte boundary. So copyToSent can copy whole byte.
+	x0 = x0 & ~7;
+	x1 = qMin((x1 + 7) & ~7, rfbGuiOp->displayWidth);
+
+	rect.x      = x0;
+	rect.y      = y0;
+	rect.width  = x1 - x0;
+	rect.height = y1 - y0;
+	return 1;
+}
+
+void RfbGuiOp::Client::copyToSent(const GuiOp::Rect& rect) {
+	const int start = rect.x / 8;
+	const int size  = (rect.x + rect.width + 7) / 8 - start;
+	for(int y = rect.y; y < (rect.y + rect.height); y++) {
+		const int offset = y * bytesPerLine + start;
+		memcpy(sent.data() + offset, snapshot.constData() + offset, size);
+	}
+}
+
+void RfbGuiOp::Client::findDirty(QVector<GuiOp::Rect>& rects) {
+	const int tileSize     = RfbEncoder::HEXTILE_TILE_SIZE;
+	const int bytesPerTile = tileSize / 8;
+	const int tilesPerLine = (rfbGuiOp->displayWidth + tileSize - 1) / tileSize;
+	const int height       = rfbGuiOp->displayHeight;
+
+	QVector<char>        dirty(tilesPerLine);
+	// dirty rectangle of previous tile row that can be extended by next tile row
+	QVector<GuiOp::Rect> open;
+	QVector<GuiOp::Rect> next;
+	for(int ty = 0; ty < height; ty += tileSize) {
+		const int th = qMin(tileSize, height - ty);
+		const char* a = snapshot.constData() + ty * bytesPerLine;
+		const char* b = sent.constData()     + ty * bytesPerLine;
+
+		next.clear();
+		if (memcmp(a, b, th * bytesPerLine) != 0) {
+			dirty.fill(0);
+			for(int y = 0; y < th; y++) {
+				const char* pa = a + y * bytesPerLine;
+				const char* pb = b + y * bytesPerLine;
+				for(int tx = 0; tx < tilesPerLine; tx++) {
+					if (dirty[tx]) continue;
+					const int offset = tx * bytesPerTile;
+					const int size   = qMin(bytesPerTile, bytesPerLine - offset);
+					if (memcmp(pa + offset, pb + offset, size) != 0) dirty[tx] = 1;
+				}
+			}
+
+			int i = 0;
+			int tx = 0;
+			while(tx < tilesPerLine) {
+				if (!dirty[tx]) {
+					tx++;
+					continue;
+				}
+				const int start = tx;
+				while(tx < tilesPerLine && dirty[tx]) tx++;
+				const int x = start * tileSize;
+				const int w = qMin(tx * tileSize, rfbGuiOp->displayWidth) - x;
+
+				// close open rectangle that cannot be extended
+				while(i < open.size() && open[i].x < x) rects.append(open[i++]);
+				if (i < open.size() && open[i].x == x && open[i].width == w) {
+					GuiOp::Rect rect = open[i++];
+					rect.height += th;
+					next.append(rect);
+				} else {
+					next.append(GuiOp::Rect(x, ty, w, th));
+				}
+			}
+			while(i < open.size()) rects.append(open[i++]);
+		} else {
+			for(const GuiOp::Rect& rect: open) rects.append(rect);
+		}
+		open.swap(next);
+	}
+	for(const GuiOp::Rect& rect: open) rects.append(rect);
+}
+
+int RfbGuiOp::Client::sendUpdate() {
+	if (!updateRequested) return 1;
+	if (lastUpdate.isValid() && lastUpdate.elapsed() < FRAME_INTERVAL) return 1;
+
+	const int displayGeneration = rfbGuiOp->getDisplayGeneration();
+	const int cursorGeneration  = rfbGuiOp->getCursorGeneration();
+	const int sendCursor        = useCursor && (cursorGeneration != lastCursorGeneration);
+	if (!fullUpdate && !sendCursor && displayGeneration == lastDisplayGeneration) return 1;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	// Take generation before snapshot. So change during snapshot is sent in next update.
+	lastDisplayGeneration = displayGeneration;
+	rfbGuiOp->getSnapshot(snapshot);
+
+	QVector<GuiOp::Rect> rects;
+	if (fullUpdate) {
+		rects.append(GuiOp::Rect(0, 0, rfbGuiOp->displayWidth, rfbGuiOp->displayHeight));
+	} else {
+		findDirty(rects);
+	}
+	QVector<GuiOp::Rect> clipped;
+	for(GuiOp::Rect rect: rects) {
+		if (clip(rect)) clipped.append(rect);
+	}
+	// Keep request until display is actually changed
+	if (clipped.isEmpty() && !sendCursor) return 1;
+
+	QByteArray out;
+	RfbEncoder::put8 (out, MSG_FRAMEBUFFER_UPDATE);
+	RfbEncoder::put8 (out, 0);
+	RfbEncoder::put16(out, clipped.size() + (sendCursor ? 1 : 0));
+	if (sendCursor) {
+		GuiOp::CursorPattern cursor;
+		rfbGuiOp->getCursorPattern(cursor);
+		encoder.encodeCursor(out, cursor);
+		lastCursorGeneration = cursorGeneration;
+	}
+	const RfbEncoder::Frame frame((const quint8*)snapshot.constData(), rfbGuiOp->displayWidth, rfbGuiOp->displayHeight, bytesPerLine);
+	for(const GuiOp::Rect& rect: clipped) {
+		if (DEBUG_SHOW_RFB) logger.debug("%s  update %4d %4d %4d %4d", qPrintable(peer), rect.x, rect.y, rect.width, rect.height);
+		encoder.encode(out, encoding, frame, rect);
+		copyToSent(rect);
+	}
+	encodeTime += timer.nsecsElapsed();
+
+	updateRequested = 0;
+	fullUpdate      = 0;
+	updateCount++;
+	rectCount += clipped.size();
+	lastUpdate.start();
+
+	return writeFully(out);
+}
+
+void RfbGuiOp::Client::run() {
+	logger.info("%s  Client::run START", qPrintable(peer));
+
+	if (handshake()) {
+		for(;;) {
+			if (rfbGuiOp->stopThread) break;
+
+			struct pollfd pfd;
+			pfd.fd      = socket;
+			pfd.events  = POLLIN;
+			pfd.revents = 0;
+			int ret = poll(&pfd, 1, FRAME_INTERVAL);
+			if (ret < 0) {
+				if (errno == EINTR) continue;
+				int myErrno = errno;
+				logger.warn("%s  poll returns -1.  errno = %d", qPrintable(peer), myErrno);
+				break;
+			}
+			if (0 < ret) {
+				if (!processMessage()) break;
+			}
+			if (!sendUpdate()) break;
+		}
+	}
+	close(socket);
+	rfbGuiOp->clientCount.deref();
+
+	logger.info("%s  updateCount = %llu  rectCount = %llu  byteCount = %llu  encodeTime = %llu ms", qPrintable(peer),
+		updateCount, rectCount, byteCount, encodeTime / (1000 * 1000));
+	logger.info("%s  Client::run STOP", qPrintable(peer));
+}
+
+
+//
+// RfbGuiOp::ListenThread
+//
+void RfbGuiOp::ListenThread::run() {
+	logger.info("RfbGuiOp::ListenThread::run START");
+
+	for(;;) {
+		if (rfbGuiOp->stopThread) break;
+
+		struct pollfd pfd;
+		pfd.fd      = rfbGuiOp->listenSocket;
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+		int ret = poll(&pfd, 1, WAIT_INTERVAL);
+		if (ret == 0) continue;
+		if (ret < 0) {
+			if (errno == EINTR) continue;
+			int myErrno = errno;
+			logger.fatal("poll returns -1.  errno = %d", myErrno);
+			break;
+		}
+
+		struct sockaddr_in addr;
+		socklen_t addrLength = sizeof(addr);
+		int socket = accept(rfbGuiOp->listenSocket, (struct sockaddr*)&addr, &addrLength);
+		if (socket < 0) {
+			int myErrno = errno;
+			logger.warn("accept returns -1.  errno = %d", myErrno);
+			continue;
+		}
+		QString peer = QString("%1:%2").arg(inet_ntoa(addr.sin_addr)).arg(ntohs(addr.sin_port));
+		if (MAX_CLIENT <= rfbGuiOp->getClientCount()) {
+			logger.warn("%s  Too many client.  MAX_CLIENT = %d", qPrintable(peer), MAX_CLIENT);
+			close(socket);
+			continue;
+		}
+		int flag = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+		logger.info("%s  accept", qPrintable(peer));
+		rfbGuiOp->clientCount.ref();
+		rfbGuiOp->threadPool.start(new Client(rfbGuiOp, socket, peer));
+	}
+	close(rfbGuiOp->listenSocket);
+
+	logger.info("RfbGuiOp::ListenThread::run STOP");
+}
+
+
+//
+// RfbGuiOp
+//
+RfbGuiOp::RfbGuiOp(const QString& address_, quint16 port_, int displayWidth_, int displayHeight_) :
+	address(address_), port(port_), displayWidth(displayWidth_), displayHeight(displayHeight_), listenThread(this) {
+	listenSocket = -1;
+	stopThread   = 0;
+
+	for(CARD32 i = 0; i < ELEMENTSOF(cursorPattern.data); i++) cursorPattern.data[i] = 0;
+
+	listenThread.setAutoDelete(false);
+	threadPool.setMaxThreadCount(MAX_CLIENT + 1);
+}
+
+void RfbGuiOp::start() {
+	initializeKeyMap();
+
+	listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenSocket < 0) {
+		int myErrno = errno;
+		logger.fatal("socket returns -1.  errno = %d", myErrno);
+		ERROR();
+	}
+	int flag = 1;
+	setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port   = htons(port);
+	if (inet_aton(address.toLatin1().constData(), &addr.sin_addr) == 0) {
+		logger.fatal("Unexpected address %s", qPrintable(address));
+		ERROR();
+	}
+	if (bind(listenSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+		int myErrno = errno;
+		logger.fatal("bind returns -1.  errno = %d  address = %s  port = %d", myErrno, qPrintable(address), port);
+		ERROR();
+	}
+	if (listen(listenSocket, MAX_CLIENT) < 0) {
+		int myErrno = errno;
+		logger.fatal("listen returns -1.  errno = %d", myErrno);
+		ERROR();
+	}
+	logger.info("RFB server  address = %s  port = %d  display = %d x %d", qPrintable(address), port, displayWidth, displayHeight);
+
+	stopThread = 0;
+	threadPool.start(&listenThread);
+}
+
+void RfbGuiOp::stop() {
+	logger.info("RfbGuiOp::stop START");
+	stopThread = 1;
+	threadPool.waitForDone();
+	logger.info("RfbGuiOp::stop STOP");
+}
+
+void RfbGuiOp::setCursorPatternImpl(CursorPattern* data) {
+	QMutexLocker locker(&mutexCursor);
+	cursorPattern = *data;
+	cursorGeneration.fetchAndAddOrdered(1);
+}
+void RfbGuiOp::updateDisplayImpl(Rect*) {
+	// Rectangle of BitBlt is not available. Client finds changed area by comparing snapshot.
+	displayGeneration.fetchAndAddOrdered(1);
+}
+void RfbGuiOp::setMPImpl(quint16) {
+	// There is no maintenance panel in viewer
+}
+void RfbGuiOp::setColorLookupTableImpl(int, quint8, quint8, quint8) {
+	// RFB server supports monochrome display only
+}
+
+void RfbGuiOp::getCursorPattern(CursorPattern& data) {
+	QMutexLocker locker(&mutexCursor);
+	data = cursorPattern;
+}
+void RfbGuiOp::getSnapshot(QByteArray& data) {
+	// Copy display memory without lock. Torn copy is corrected by next update, because displayGeneration is changed.
+	memcpy(data.data(), Memory::getDisplayPage()->word, data.size());
+}
+
+// Convert keysym of shifted key to keysym of unshifted key assuming US keyboard
+static quint32 toUnshiftedKeySym(quint32 keysym) {
+	if ('A' <= keysym && keysym <= 'Z') return keysym - 'A' + 'a';
+	switch(keysym) {
+	case '!': return '1';
+	case '@': return '2';
+	case '#': return '3';
+	case '$': return '4';
+	case '%': return '5';
+	case '^': return '6';
+	case '&': return '7';
+	case '*': return '8';
+	case '(': return '9';
+	case ')': return '0';
+	case '_': return '-';
+	case '+': return '=';
+	case '{': return '[';
+	case '}': return ']';
+	case '|': return '\\';
+	case ':': return ';';
+	case '"': return '\'';
+	case '<': return ',';
+	case '>': return '.';
+	case '?': return '/';
+	case '~': return '`';
+	default:  return keysym;
+	}
+}
+
+void RfbGuiOp::keyEvent(int down, quint32 keysym) {
+	const quint32 key = toUnshiftedKeySym(keysym);
+	if (!keyMap.contains(key)) {
+		logger.warn("%-12s  %4X", __FUNCTION__, keysym);
+		return;
+	}
+	const quint32 keyName = keyMap.value(key);
+	if (DEBUG_SHOW_EVENT_KEY) logger.debug("%-12s  %d  %4X %3d", __FUNCTION__, down, keysym, keyName);
+
+	QMutexLocker locker(&mutexInput);
+	if (down) {
+		InputQueue::keyPress((LevelVKeys::KeyName)keyName);
+	} else {
+		InputQueue::keyRelease((LevelVKeys::KeyName)keyName);
+	}
+}
+
+void RfbGuiOp::pointerEvent(quint8 oldMask, quint8 newMask, int x, int y) {
+	// Bit 0, 1 and 2 of button mask is left, middle and right button
+	static const quint32 button[] = {Qt::LeftButton, Qt::MiddleButton, Qt::RightButton};
+
+	QMutexLocker locker(&mutexInput);
+	InputQueue::mouseMove(x, y);
+	for(CARD32 i = 0; i < ELEMENTSOF(button); i++) {
+		const quint8 mask = 1 << i;
+		if ((oldMask & mask) == (newMask & mask)) continue;
+		if (!buttonMap.contains(button[i])) continue;
+		const quint32 keyName = buttonMap.value(button[i]);
+		if (DEBUG_SHOW_EVENT_MOUSE) logger.debug("%-12s  %d  %4X %3d", __FUNCTION__, (newMask & mask) ? 1 : 0, button[i], keyName);
+		if (newMask & mask) {
+			InputQueue::keyPress((LevelVKeys::KeyName)keyName);
+		} else {
+			InputQueue::keyRelease((LevelVKeys::KeyName)keyName);
+		}
+	}
+}
+
+static const char* KEYSYMBOL_PATH = "data/Guam/KeySymbol.ini";
+static void readSymbolGroup(QHash<QString, quint32>& symbolMap, QSettings& settings, QString group) {
+	settings.beginGroup(group);
+	const QStringList childKeys = settings.childKeys();
+
+	foreach (const QString &key, childKeys) {
+		QString valueString = settings.value(key).toString();
+		bool ok;
+		quint32 value = valueString.toUInt(&ok, 0);
+		if (!ok) {
+			logger.fatal("valueString = %s", qPrintable(valueString));
+			ERROR();
+		}
+		symbolMap[key] = value;
+	}
+
+	settings.endGroup();
+}
+static void readMapGroup(QHash<quint32, quint32>& map, QHash<QString, quint32>& symbolMap, Preference& preference, QString group) {
+	QStringList childKeys = preference.getChildKeys(group);
+	bool abort = false;
+	foreach (const QString &key, childKeys) {
+		// if first char of key is '#', treat as comment
+		if (key[0] == QChar('#')) continue;
+
+		QString value = preference.getAsString(group, key);
+		if (!symbolMap.contains(key))   {
+			logger.warn("Group = %s  key   = %s! is not defined", qPrintable(group), qPrintable(key));
+			abort = 1;
+			continue;
+		}
+		if (!symbolMap.contains(value)) {
+			logger.fatal("Group = %s  value = %s! is not defined", qPrintable(group), qPrintable(value));
+			abort = 1;
+			continue;
+		}
+
+		quint32 lhs = symbolMap[key];
+		quint32 rhs = symbolMap[value];
+
+		if (rhs) map.insert(rhs, lhs);
+	}
+	if (abort) ERROR();
+}
+
+void RfbGuiOp::initializeKeyMap() {
+	QHash<QString, quint32> symbolMap;
+	{
+		QSettings settings(KEYSYMBOL_PATH, QSettings::IniFormat);
+
+		// add dummy entry for KeyMap
+		symbolMap["0"] = 0;
+
+		readSymbolGroup(symbolMap, settings, "LevelVKeys");
+		readSymbolGroup(symbolMap, settings, "Qt");
+		// Scan::XXX of KeyMap is mapped to X11 keysym that is used in RFB key event
+		readSymbolGroup(symbolMap, settings, "KeySym");
+	}
+
+	Preference preference;
+	readMapGroup(keyMap,    symbolMap, preference, "KeyMap");
+	readMapGroup(buttonMap, symbolMap, preference, "ButtonMap");
+	logger.info("keyMap = %d  buttonMap = %d", keyMap.size(), buttonMap.size());
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// RfbGuiOp.h
+//
+
+#ifndef RFBGUIOP_H__
+#define RFBGUIOP_H__
+
+#include "../util/Util.h"
+#include "../util/GuiOp.h"
+
+#include <QtCore>
+
+// GuiOp for guam-headless that serves display with RFB (VNC) protocol.
+//   Processor thread only increments generation of display in updateDisplayImpl.
+//   Each viewer has own thread that takes snapshot of display, finds changed tile and encodes it.
+class RfbGuiOp : public GuiOp {
+public:
+	// Wait interval in milliseconds for poll
+	static const int WAIT_INTERVAL  = 1000;
+	// Minimum interval in milliseconds between framebuffer update
+	static const int FRAME_INTERVAL = 20;
+	// Maximum number of viewer
+	static const int MAX_CLIENT     = 8;
+
+	RfbGuiOp(const QString& address, quint16 port, int displayWidth, int displayHeight);
+
+	// start must be called after MesaProcessor::initialize to use agent and display memory
+	void start();
+	void stop();
+
+	void setCursorPatternImpl(CursorPattern* data);
+	void updateDisplayImpl   (Rect* rect);
+	void setMPImpl           (quint16 newValue);
+	void setColorLookupTableImpl(int index, quint8 red, quint8 green, quint8 blue);
+
+	class Client;
+
+	class ListenThread : public QRunnable {
+	public:
+		ListenThread(RfbGuiOp* rfbGuiOp_) : rfbGuiOp(rfbGuiOp_) {}
+		void run();
+	private:
+		RfbGuiOp* rfbGuiOp;
+	};
+
+private:
+	const QString address;
+	const quint16 port;
+	const int     displayWidth;
+	const int     displayHeight;
+
+	int           listenSocket;
+	volatile int  stopThread;
+	QThreadPool   threadPool;
+	ListenThread  listenThread;
+	QAtomicInt    clientCount;
+
+	// generation is incremented when display or cursor is changed
+	QAtomicInt    displayGeneration;
+	QAtomicInt    cursorGeneration;
+	QMutex        mutexCursor;
+	CursorPattern cursorPattern;
+
+	// mutexInput serializes input from multiple viewer
+	QMutex        mutexInput;
+	// X11 keysym => LevelVKeys::KeyName
+	QHash<quint32, quint32> keyMap;
+	// Qt::MouseButton => LevelVKeys::KeyName
+	QHash<quint32, quint32> buttonMap;
+
+	void initializeKeyMap();
+
+	int  getDisplayGeneration() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return displayGeneration.loadAcquire();
+#else
+		return (int)displayGeneration;
+#endif
+	}
+	int  getCursorGeneration() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return cursorGeneration.loadAcquire();
+#else
+		return (int)cursorGeneration;
+#endif
+	}
+	int  getClientCount() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return clientCount.loadAcquire();
+#else
+		return (int)clientCount;
+#endif
+	}
+
+	void getCursorPattern(CursorPattern& data);
+	void getSnapshot(QByteArray& data);
+
+	void keyEvent    (int down, quint32 keysym);
+	void pointerEvent(quint8 oldMask, quint8 newMask, int x, int y);
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// RfbGuiOp_dummy.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("rfbguiop");
+
+#include "RfbGuiOp.h"
+
+// RFB server is not supported on this platform
+
+void RfbGuiOp::ListenThread::run() {
+	ERROR();
+}
+
+RfbGuiOp::RfbGuiOp(const QString& address_, quint16 port_, int displayWidth_, int displayHeight_) :
+	address(address_), port(port_), displayWidth(displayWidth_), displayHeight(displayHeight_), listenThread(this) {
+	listenSocket = -1;
+	stopThread   = 0;
+}
+
+void RfbGuiOp::start() {
+	logger.fatal("RFB server is not supported");
+	ERROR();
+}
+void RfbGuiOp::stop() {
+}
+
+void RfbGuiOp::setCursorPatternImpl(CursorPattern*) {
+}
+void RfbGuiOp::updateDisplayImpl(Rect*) {
+}
+void RfbGuiOp::setMPImpl(quint16) {
+}
+void RfbGuiOp::setColorLookupTableImpl(int, quint8, quint8, quint8) {
+}
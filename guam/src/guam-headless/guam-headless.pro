@@ -41,6 +41,15 @@ POST_TARGETDEPS += ../../tmp/build/util/libutil.a
 # Input
 SOURCES += LoadGerm.cpp
 
+HEADERS += RfbGuiOp.h   RfbEncoder.h
+unix {
+	SOURCES += RfbGuiOp.cpp RfbEncoder.cpp
+	LIBS    += -lz
+}
+win32 {
+	SOURCES += RfbGuiOp_dummy.cpp
+}
+
 ###############################################
 
 INCLUDEPATH += .
@@ -44,6 +44,7 @@ GuamObject::GuamObject() {
 
 	displayWidth  = preference->getAsUINT32(section, "DisplayWidth");
 	displayHeight = preference->getAsUINT32(section, "DisplayHeight");
+	displayType   = preference->getAsString(section, "DisplayType");
 
 	emulatorIsRunning = 0;
 }
@@ -69,7 +70,13 @@ void GuamObject::init() {
 
 	mesaProcessor.setMemorySize(vmBits, rmBits);
 	mesaProcessor.setDisplaySize(displayWidth, displayHeight);
+	mesaProcessor.setDisplayType(displayType);
 	mesaProcessor.setNetworkInterfaceName(networkInterface);
+	mesaProcessor.setInputRecordPath(preference->getAsString("Input", "Record"));
+	mesaProcessor.setInputReplayPath(preference->getAsString("Input", "Replay"));
+	mesaProcessor.setProfiler(preference->getAsUINT32("Profiler", "Interval"), preference->getAsString("Profiler", "Path"));
+	mesaProcessor.setTrace(preference->getAsString("Trace", "Mode"), preference->getAsString("Trace", "Path"));
+	mesaProcessor.setSnapshot(preference->getAsString("Snapshot", "Save"), preference->getAsString("Snapshot", "Restore"));
 
 	//extern void initTraceCallRegist_Dawn();
 	//initTraceCallRegist_Dawn();
@@ -80,6 +87,14 @@ QImage* GuamObject::getDisplayImage() {
 	uchar* data = (uchar*)Memory::getDisplayPage()->word;
 	CARD32 bytesPerLine = Memory::getDisplayBytesPerLine();
 
+	if (Memory::getDisplayType() == DisplayIOFaceGuam::T_byteColor) {
+		// Each byte is index of color lookup table. Color table of image is maintained by UserTerminal.
+		QImage* image = new QImage(data, displayWidth, displayHeight, bytesPerLine, QImage::Format_Indexed8);
+		// 0 => white
+		for(CARD32 i = 0; i < (displayHeight * bytesPerLine); i++) data[i] = 0;
+		return image;
+	}
+
 	QImage* image = new QImage(data, displayWidth, displayHeight, bytesPerLine, QImage::Format_Mono);
 	// 0 => white  1 => black
 	for(CARD32 i = 0; i < (displayHeight * bytesPerLine); i++) data[i] = 1;
@@ -98,6 +113,8 @@ void GuamObject::startEmulator() {
 	PageCache::stats();
 	CodeCache::stats();
 	LFCache::stats();
+	AVCache::stats();
+	GFTCache::stats();
 
 	//extern void MonoBlt_MemoryCache_stats();
 	//MonoBlt_MemoryCache_stats();
@@ -77,6 +77,7 @@ private:
 
 	quint32     displayWidth;
 	quint32     displayHeight;
+	QString     displayType;
 
 	MesaProcessor mesaProcessor;
 
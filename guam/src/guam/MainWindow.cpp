@@ -48,11 +48,12 @@ MainWindow::MainWindow() : QMainWindow(0, Qt::Window) {
 	guamObject->init();
 	guamObject->moveToThread(guamThread);
 
-	QtGuiOp* qtGuiOp = new QtGuiOp;
+	qtGuiOp = new QtGuiOp;
 	GuiOp::setContext(qtGuiOp);
 
 	{
 		QImage* image = guamObject->getDisplayImage();
+		qtGuiOp->start(image->width(), image->height());
 		userTerminal = new UserTerminal(image);
 		userTerminal->setParent(this);
 		setCentralWidget(userTerminal);
@@ -88,7 +89,9 @@ MainWindow::MainWindow() : QMainWindow(0, Qt::Window) {
 	}
 
 	QObject::connect(qtGuiOp, SIGNAL(cursorPatternChanged(GuiOp::CursorPattern*)), userTerminal, SLOT(setCursorPattern(GuiOp::CursorPattern*)), Qt::QueuedConnection);
-	QObject::connect(qtGuiOp, SIGNAL(displayChanged(GuiOp::Rect*)), userTerminal, SLOT(updateDisplay(GuiOp::Rect*)), Qt::QueuedConnection);
+	// displayChanged is emitted from timer of gui thread
+	QObject::connect(qtGuiOp, SIGNAL(displayChanged(GuiOp::Rect*)), userTerminal, SLOT(updateDisplay(GuiOp::Rect*)), Qt::DirectConnection);
+	QObject::connect(qtGuiOp, SIGNAL(colorLookupTableChanged(int, uint)), userTerminal, SLOT(setColorLookupTable(int, uint)), Qt::QueuedConnection);
 
 	connect(guamObject, SIGNAL(emulatorStopped()), this, SLOT(close()));
 	guamThread->start();
@@ -108,4 +111,5 @@ void MainWindow::closeEvent (QCloseEvent* event) {
 			ERROR();
 		}
 	}
+	if (event->isAccepted()) qtGuiOp->stats();
 }
@@ -40,6 +40,7 @@ OF SUCH DAMAGE.
 #include "UserTerminal.h"
 #include "GuamObject.h"
 #include "QtEventListener.h"
+#include "QtGuiOp.h"
 
 class MainWindow : public QMainWindow {
 	Q_OBJECT
@@ -60,6 +61,7 @@ private:
 	QThread*    guamThread;
 
 	QtEventListener* eventListener;
+	QtGuiOp*         qtGuiOp;
 };
 
 #endif
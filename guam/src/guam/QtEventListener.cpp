@@ -35,9 +35,7 @@ static log4cpp::Category& logger = Logger::getLogger("qtevent");
 #include "../util/Debug.h"
 #include "../util/Preference.h"
 
-#include "../agent/Agent.h"
-#include "../agent/AgentKeyboard.h"
-#include "../agent/AgentMouse.h"
+#include "../agent/InputQueue.h"
 
 #include "QtEventListener.h"
 
@@ -52,7 +50,7 @@ void QtEventListener::keyPress    (quint32 scancode) {
 	}
 	if (keyName) {
 		if (DEBUG_SHOW_EVENT_KEY) logger.debug("%-12s  %4X %3d", __FUNCTION__, scancode, keyName);
-		keyboard->keyPress((LevelVKeys::KeyName)keyName);
+		InputQueue::keyPress((LevelVKeys::KeyName)keyName);
 	} else {
 		logger.warn("%-12s  %4X", __FUNCTION__, scancode);
 	}
@@ -65,7 +63,7 @@ void QtEventListener::keyRelease  (quint32 scancode) {
 	}
 	if (keyName) {
 		if (DEBUG_SHOW_EVENT_KEY) logger.debug("%-12s  %4X %3d", __FUNCTION__, scancode, keyName);
-		keyboard->keyRelease((LevelVKeys::KeyName)keyName);
+		InputQueue::keyRelease((LevelVKeys::KeyName)keyName);
 	} else {
 		logger.warn("%-12s  %4X", __FUNCTION__, scancode);
 	}
@@ -79,7 +77,7 @@ void QtEventListener::mousePress  (Qt::MouseButton button) {
 
 	if (keyName) {
 		if (DEBUG_SHOW_EVENT_MOUSE) logger.debug("%-12s  %4X %3d", __FUNCTION__, (int)button, keyName);
-		keyboard->keyPress((LevelVKeys::KeyName)keyName);
+		InputQueue::keyPress((LevelVKeys::KeyName)keyName);
 	} else {
 		logger.warn("%-12s  %4X", __FUNCTION__, (int)button);
 	}
@@ -93,13 +91,13 @@ void QtEventListener::mouseRelease(Qt::MouseButton button) {
 
 	if (keyName) {
 		if (DEBUG_SHOW_EVENT_MOUSE) logger.debug("%-12s  %4X %3d", __FUNCTION__, (int)button, keyName);
-		keyboard->keyRelease((LevelVKeys::KeyName)keyName);
+		InputQueue::keyRelease((LevelVKeys::KeyName)keyName);
 	} else {
 		logger.warn("%-12s  %4X", __FUNCTION__, (int)button);
 	}
 }
 void QtEventListener::mouseMove   (int x, int y) {
-	mouse->setPosition(x, y);
+	InputQueue::mouseMove(x, y);
 }
 
 static const char* KEYSYMBOL_PATH = "data/Guam/KeySymbol.ini";
@@ -143,17 +141,6 @@ static void readSymbol(QHash<QString, quint32>& symbolMap) {
 }
 
 QtEventListener::QtEventListener() {
-	keyboard = (AgentKeyboard*)Agent::getAgent(GuamInputOutput::keyboard);
-	if (keyboard == 0) {
-		logger.fatal("keyboard == 0");
-		ERROR();
-	}
-	mouse    = (AgentMouse*)Agent::getAgent(GuamInputOutput::mouse);
-	if (mouse == 0) {
-		logger.fatal("mouse == 0");
-		ERROR();
-	}
-
 	QHash<QString, quint32>symbolMap;
 	readSymbol(symbolMap);
 
@@ -38,9 +38,6 @@ OF SUCH DAMAGE.
 
 using namespace std;
 
-class AgentKeyboard;
-class AgentMouse;
-
 class QtEventListener : public UserTerminal::EventListener {
 public:
 	QtEventListener();
@@ -52,9 +49,6 @@ public:
 	void mouseMove   (int x, int y);
 
 private:
-	AgentKeyboard* keyboard;
-	AgentMouse*    mouse;
-
 	static QHash<quint32,         quint32>keyMap;
 	static QHash<Qt::MouseButton, quint32>buttonMap;
 };
@@ -34,15 +34,132 @@ static log4cpp::Category& logger = Logger::getLogger("qtguiop");
 
 #include "QtGuiOp.h"
 
+QtGuiOp::QtGuiOp() : mpPanel(0), displayWidth(0), displayHeight(0), displayGeneration(0), dirtyArea(AREA_EMPTY), dirtyTime(0) {
+	lastGeneration = 0;
+	intervalTime   = 0;
+
+	clock.start();
+	connect(&timer, SIGNAL(timeout()), this, SLOT(pollDisplay()));
+}
+
+void QtGuiOp::start(int width, int height) {
+	displayWidth  = width;
+	displayHeight = height;
+
+	// Poll once for each refresh of screen
+	int refreshRate = 60;
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+	if (QGuiApplication::primaryScreen()) {
+		refreshRate = qRound(QGuiApplication::primaryScreen()->refreshRate());
+		if (refreshRate <= 0) refreshRate = 60;
+	}
+	timer.setTimerType(Qt::PreciseTimer);
+#endif
+	const int interval = qMax(1, 1000 / refreshRate);
+	logger.info("QtGuiOp  poll display  refreshRate = %d  interval = %d ms", refreshRate, interval);
+	timer.start(interval);
+}
+
+void QtGuiOp::Stats::add(int update, int latency) {
+	countUpdate += update;
+	if (maxUpdate < update) maxUpdate = update;
+	if (0 <= latency) {
+		countRepaint++;
+		totalLatency += latency;
+		if (maxLatency < latency) maxLatency = latency;
+	}
+}
+void QtGuiOp::Stats::output(const char* title) const {
+	// before is queued signal per BitBlt, after is polling with timer
+	logger.info("QtGuiOp %-8s  repaint  before %8lld  after %8lld  queue depth  before %5d  after %d  latency  avg %6.2f ms  max %4d ms",
+		title, countUpdate, countRepaint, maxUpdate, countRepaint ? 1 : 0,
+		countRepaint ? ((double)totalLatency / countRepaint) : 0.0, maxLatency);
+}
+
+void QtGuiOp::stats() {
+	total.output("total");
+}
+
+void QtGuiOp::statsInterval(qint64 now) {
+	if (interval.countUpdate) interval.output("interval");
+	interval     = Stats();
+	intervalTime = now;
+}
+
+quint32 QtGuiOp::toArea(const Rect& rect) {
+	// Empty rectangle means whole display
+	if (rect.width <= 0 || rect.height <= 0) return AREA_FULL;
+
+	const quint32 left   = qMin(rect.x >> TILE_SHIFT, 255);
+	const quint32 top    = qMin(rect.y >> TILE_SHIFT, 255);
+	const quint32 right  = qMin((rect.x + rect.width  - 1) >> TILE_SHIFT, 255);
+	const quint32 bottom = qMin((rect.y + rect.height - 1) >> TILE_SHIFT, 255);
+	return (left << 24) | (top << 16) | (right << 8) | bottom;
+}
+
+quint32 QtGuiOp::mergeArea(quint32 a, quint32 b) {
+	const quint32 left   = qMin((a >> 24) & 0xFF, (b >> 24) & 0xFF);
+	const quint32 top    = qMin((a >> 16) & 0xFF, (b >> 16) & 0xFF);
+	const quint32 right  = qMax((a >>  8) & 0xFF, (b >>  8) & 0xFF);
+	const quint32 bottom = qMax((a >>  0) & 0xFF, (b >>  0) & 0xFF);
+	return (left << 24) | (top << 16) | (right << 8) | bottom;
+}
+
 void QtGuiOp::setCursorPatternImpl(CursorPattern* data) {
 	cusorPattern = *data;
 	emit cursorPatternChanged(&cusorPattern);
 }
 void QtGuiOp::updateDisplayImpl   (Rect* data) {
-	rect = *data;
-	emit displayChanged(&rect);
+	// Called from processor thread. Don't wait for gui thread.
+	const quint32 area = toArea(*data);
+	for(;;) {
+		const int oldValue = getDirtyArea();
+		const int newValue = (int)mergeArea((quint32)oldValue, area);
+		if (oldValue == newValue) break;
+		if (dirtyArea.testAndSetOrdered(oldValue, newValue)) break;
+	}
+	dirtyTime.testAndSetOrdered(0, (int)clock.elapsed() + 1);
+	displayGeneration.fetchAndAddOrdered(1);
 }
 void QtGuiOp::setMPImpl           (quint16 newValue) {
 	if (mpPanel == 0) ERROR();
 	mpPanel->display(newValue);
 }
+void QtGuiOp::setColorLookupTableImpl(int index, quint8 red, quint8 green, quint8 blue) {
+	// pass value of entry, because signal is delivered to gui thread later
+	emit colorLookupTableChanged(index, qRgb(red, green, blue));
+}
+
+void QtGuiOp::pollDisplay() {
+	const qint64 now = clock.elapsed();
+	if (STATS_INTERVAL <= now - intervalTime) statsInterval(now);
+
+	const int generation = getDisplayGeneration();
+	if (generation == lastGeneration) return;
+
+	const quint32 area = (quint32)dirtyArea.fetchAndStoreOrdered((int)AREA_EMPTY);
+	const int     time = dirtyTime.fetchAndStoreOrdered(0);
+
+	const int update = generation - lastGeneration;
+	lastGeneration = generation;
+
+	const quint32 left   = (area >> 24) & 0xFF;
+	const quint32 top    = (area >> 16) & 0xFF;
+	const quint32 right  = (area >>  8) & 0xFF;
+	const quint32 bottom = (area >>  0) & 0xFF;
+	// statistics. latency is -1 if there is no repaint
+	const int latency = (right < left || bottom < top) ? -1 : (time ? (int)now - (time - 1) : 0);
+	total.add(update, latency);
+	interval.add(update, latency);
+	if (latency < 0) return;
+
+	// Tile 255 extends to end of display
+	const int x0 = left << TILE_SHIFT;
+	const int y0 = top  << TILE_SHIFT;
+	const int x1 = (right  == 255) ? displayWidth  : qMin((int)(right  + 1) << TILE_SHIFT, displayWidth);
+	const int y1 = (bottom == 255) ? displayHeight : qMin((int)(bottom + 1) << TILE_SHIFT, displayHeight);
+	if (x1 <= x0 || y1 <= y0) return;
+
+	rect = Rect(x0, y0, x1 - x0, y1 - y0);
+	emit displayChanged(&rect);
+}
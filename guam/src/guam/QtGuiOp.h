@@ -42,13 +42,24 @@ OF SUCH DAMAGE.
 #include <QtGui>
 #endif
 
+// Change of display is not notified to gui thread for each BitBlt.
+//   Processor thread merges changed rectangle to dirtyArea and increments displayGeneration.
+//   Both are QAtomicInt, so that processor thread never waits for gui thread.
+//   Gui thread polls displayGeneration with timer of display refresh rate and repaints dirtyArea.
 class QtGuiOp : public QObject, public GuiOp {
 	Q_OBJECT
 
 public:
+	QtGuiOp();
+
+	// start polling of display change. Must be called from gui thread.
+	void start(int width, int height);
+	void stats();
+
 	void setCursorPatternImpl(CursorPattern* data);
 	void updateDisplayImpl   (Rect* rect);
 	void setMPImpl           (quint16 newValue);
+	void setColorLookupTableImpl(int index, quint8 red, quint8 green, quint8 blue);
 
 	void setMPPanel          (QLCDNumber* mpPanel_) {
 		mpPanel = mpPanel_;
@@ -57,11 +68,74 @@ public:
 signals:
 	void cursorPatternChanged(GuiOp::CursorPattern* data);
 	void displayChanged      (GuiOp::Rect* data);
+	void colorLookupTableChanged(int index, uint rgb);
+
+private slots:
+	void pollDisplay();
 
 private:
+	// dirtyArea holds rectangle in unit of tile.
+	//   Each field is 8 bits. left(31..24) top(23..16) right(15..8) bottom(7..0)
+	static const int     TILE_SHIFT = 4;
+	// interval of periodic statistics in msec
+	static const int     STATS_INTERVAL = 10 * 1000;
+	static const quint32 AREA_EMPTY = 0xFFFF0000U;
+	static const quint32 AREA_FULL  = 0x0000FFFFU;
+
+	static quint32 toArea(const Rect& rect);
+	static quint32 mergeArea(quint32 a, quint32 b);
+
+	// Output statistics of last interval and clear it
+	void statsInterval(qint64 now);
+
+	int  getDisplayGeneration() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return displayGeneration.loadAcquire();
+#else
+		return (int)displayGeneration;
+#endif
+	}
+	int  getDirtyArea() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return dirtyArea.loadAcquire();
+#else
+		return (int)dirtyArea;
+#endif
+	}
+
 	CursorPattern cusorPattern;
 	QLCDNumber*   mpPanel;
 	Rect          rect;
+	int           displayWidth;
+	int           displayHeight;
+
+	QTimer        timer;
+	QElapsedTimer clock;
+	QAtomicInt    displayGeneration;
+	QAtomicInt    dirtyArea;
+	// time in msec + 1 of first change after last poll. 0 means no change
+	QAtomicInt    dirtyTime;
+
+	// Used only in gui thread
+	int           lastGeneration;
+	// statistics
+	//   Queued signal per BitBlt made one event in queue and one repaint for each updateDisplayImpl.
+	//   So countUpdate is number of repaint and maxUpdate is max queue depth of queued signal.
+	class Stats {
+	public:
+		qint64 countUpdate;      // number of call of updateDisplayImpl
+		qint64 countRepaint;     // number of repaint request
+		int    maxUpdate;        // max number of updateDisplayImpl between repaint
+		qint64 totalLatency;     // msec from first change to repaint request
+		int    maxLatency;
+
+		Stats() : countUpdate(0), countRepaint(0), maxUpdate(0), totalLatency(0), maxLatency(0) {}
+		void add(int update, int latency);
+		void output(const char* title) const;
+	};
+	Stats         total;
+	Stats         interval;
+	qint64        intervalTime;     // start time of interval
 };
 
 Q_DECLARE_METATYPE(GuiOp::CursorPattern)
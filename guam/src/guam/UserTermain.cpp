@@ -74,6 +74,12 @@ UserTerminal::UserTerminal(QImage* image_) : image(image_) {
 
 	// clear eventListener
 	eventListener = new NullEventListener;
+
+	if (image->format() == QImage::Format_Indexed8) {
+		colorTable.fill(qRgb(0, 0, 0), 256);
+		colorTable[0] = qRgb(255, 255, 255);
+		rgb32 = QImage(width, height, QImage::Format_RGB32);
+	}
 }
 
 // keyboard press/release
@@ -96,8 +102,21 @@ void UserTerminal::mouseMoveEvent(QMouseEvent* event) {
 }
 
 //
-void UserTerminal::paintEvent(QPaintEvent *) {
+void UserTerminal::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
+    if (image->format() == QImage::Format_Indexed8) {
+        // Convert only exposed area of byteColor display to rgb with color lookup table
+        const QRect rect = event->rect() & image->rect();
+        const int x0 = rect.left();
+        const int x1 = rect.right() + 1;
+        for(int y = rect.top(); y <= rect.bottom(); y++) {
+            const uchar* s = image->constScanLine(y);
+            QRgb*        d = (QRgb*)rgb32.scanLine(y);
+            for(int x = x0; x < x1; x++) d[x] = colorTable[s[x]];
+        }
+        painter.drawImage(rect.topLeft(), rgb32, rect);
+        return;
+    }
     // If call painter.drawImage(0, 0, *image), this call generate segmentation fault.
     // To avoid segmentation fault, need to convert format of image from Format_Mono to Format_RGB16.
     QImage rgb16 = image->convertToFormat(QImage::Format_RGB16, Qt::MonoOnly);
@@ -113,6 +132,16 @@ void UserTerminal::setCursorPattern(GuiOp::CursorPattern* data) {
 	setCursor(cursor);
 }
 
-void UserTerminal::updateDisplay(GuiOp::Rect*) {
-	update();
+void UserTerminal::updateDisplay(GuiOp::Rect* rect) {
+	// Empty rectangle means whole display
+	if (rect->width && rect->height) {
+		update(rect->x, rect->y, rect->width, rect->height);
+	} else {
+		update();
+	}
+}
+
+void UserTerminal::setColorLookupTable(int index, uint rgb) {
+	if (colorTable.isEmpty()) return;
+	colorTable[index] = rgb;
 }
@@ -61,6 +61,7 @@ public:
 public slots:
 	void setCursorPattern(GuiOp::CursorPattern* data);
 	void updateDisplay(GuiOp::Rect* rect);
+	void setColorLookupTable(int index, uint rgb);
 
 protected:
 	// key press/release
@@ -78,6 +79,10 @@ protected:
 private:
 	EventListener* eventListener;
 	QImage*        image;
+
+	// For byteColor display. Pixel of image is converted to rgb with colorTable.
+	QVector<QRgb>  colorTable;
+	QImage         rgb32;
 };
 
 #endif
@@ -85,6 +85,9 @@ extern int CheckForInterrupt();
 extern int TimeoutScan();
 extern int CheckForTimeouts();
 
+// Invalidate host side cache of ready queue and timeout after PDA is replaced
+extern void InvalidateProcessCache();
+
 
 // Debug
 extern const char* getControlLinkType(ControlLink link);
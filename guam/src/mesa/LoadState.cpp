@@ -34,102 +34,41 @@ static log4cpp::Category& logger = Logger::getLogger("loadState");
 
 #include "Memory.h"
 #include "LoadState.h"
+#include "ModuleEntryDB.h"
 
 #include "../symbols/BCD.h"
 #include "../symbols/Symbols.h"
+#include "../symbols/BTIndex.h"
+#include "../symbols/SEIndex.h"
+#include "../symbols/HTIndex.h"
 
+#include <algorithm>
 
-class ModuleEntry {
-public:
-	const QString version;
-	const QString moduleName;
-
-	QVector<QString> entryName;
 
-	ModuleEntry(QString version_, QString moduleName_) : version(version_), moduleName(moduleName_) {}
-
-	QString toString() {
-		return QString("%1 %2 %3").arg(version).arg(moduleName).arg(entryName.size());
-	}
-};
-static QMap<QString, ModuleEntry*> moduleEntryMap; // key is module file version
+static ModuleEntryDB moduleEntryDB;
 
 void initializeModuleEntryMap() {
+	QString PATH_MODULE_ENTRY_DB("tmp/moduleEntry.db");
 	QString PATH_MODULE_ENTRY("tmp/moduleEntry/");
-	QDirIterator i(PATH_MODULE_ENTRY);
-
-	while(i.hasNext()) {
-		QString path = i.next();
-//		logger.info("path = %s", path.toLocal8Bit().constData());
-
-		QFileInfo fileInfo(path);
-		if (fileInfo.isDir()) continue;
-
-		QFile file(path);
-		{
-			bool ok = file.open(QIODevice::ReadOnly | QIODevice::Text);
-			if (!ok) {
-				logger.fatal("path = %s", path.toLocal8Bit().constData());
-				logger.fatal("Unexpected errorString = %s", file.errorString().toLocal8Bit().constData());
-				ERROR();
-			}
-		}
-		QTextStream text(&file);
-		uint count = 0;
-		ModuleEntry* entry = 0;
-		for(;;) {
-			if (text.atEnd()) break;
-			QString line = text.readLine();
-			if (line.isNull()) break;
-
-			QStringList token = line.split(' ');
-			if (token.size() != 4) {
-				logger.fatal("path = %s", path.toLocal8Bit().constData());
-				logger.fatal("Unexpected line = %s", line.toLocal8Bit().constData());
-				ERROR();
-			}
-
-			bool ok;
-			const QString version     = token.at(0);
-			if (!ok) {
-				logger.fatal("path = %s", path.toLocal8Bit().constData());
-				logger.fatal("Unexpected line = %s", line.toLocal8Bit().constData());
-				logger.fatal("version = %s!", token.at(0).toLocal8Bit().constData());
-				ERROR();
-			}
-			const QString moduleName  = token.at(1);
-			const uint    entryIndex  = token.at(2).toUInt(&ok);
-			if (!ok) {
-				logger.fatal("path = %s", path.toLocal8Bit().constData());
-				logger.fatal("Unexpected line = %s", line.toLocal8Bit().constData());
-				logger.fatal("entryIndex = %s!", token.at(2).toLocal8Bit().constData());
-				ERROR();
-			}
-			const QString entryName   = token.at(3);
-
-			if (count == 0) {
-				entry = new ModuleEntry(version, moduleName);
-			}
-			if (count != entryIndex) {
-				logger.fatal("path = %s", path.toLocal8Bit().constData());
-				logger.fatal("Unexpected line = %s", line.toLocal8Bit().constData());
-				logger.fatal("entryIndex = %s!", token.at(2).toLocal8Bit().constData());
-				logger.fatal("count = %d", count);
-				ERROR();
-			}
-			entry->entryName.append(entryName);
 
-			//
-			count++;
-		}
-
-		moduleEntryMap.insert(entry->version, entry);
+	if (moduleEntryDB.open(PATH_MODULE_ENTRY_DB)) {
+		logger.info("%s %s %d", __FUNCTION__, PATH_MODULE_ENTRY_DB.toLocal8Bit().constData(), moduleEntryDB.size());
+	} else {
+		// Fall back to text files of moduleEntry
+		logger.warn("No valid module entry database  %s", PATH_MODULE_ENTRY_DB.toLocal8Bit().constData());
+		logger.warn("Run moduleEntryDB to build it from output of moduleEntry");
+		moduleEntryDB.load(PATH_MODULE_ENTRY);
+		logger.info("%s %s %d", __FUNCTION__, PATH_MODULE_ENTRY.toLocal8Bit().constData(), moduleEntryDB.size());
 	}
-
-	logger.info("%s %s %d", __FUNCTION__, PATH_MODULE_ENTRY.toLocal8Bit().constData(), moduleEntryMap.size());
 }
 
 
+//
+// Processor thread reads load state and copies new or changed BCD from memory.
+// Scan thread decodes copied BCD and builds lookup table from gfi, then replaces current lookup table.
+// So scan of load state in reschedule takes time only to copy changed BCD.
+//
+
 class BCDModuleInfo {
 public:
 	const CARD16 bcdIndex;
@@ -148,35 +87,285 @@ public:
     	return QString("%1-%2").arg(bcdIndex).arg(moduleIndex);
     }
 };
-static QMap<BCDModuleInfo, CARD16>  gfiMap;    // scanModule add entries
 
-class GFInfo {
+// Module of BCD decoded by scan thread. Shared by lookup table of each generation.
+class ModuleProc {
 public:
-	CARD16  gfi;
 	QString name;
-
 	QString fileName;
 	QString fileVersion;
-
-	CARD32  codebase;
 	bool    dummyEntryName;
 
-	QMap<CARD16, QString> entryNameMap; // key = initialPC, value = name
+	// Entry of procedure sorted by initialPC
+	QVector<CARD16>  pcList;
+	QVector<QString> nameList;
+
+	ModuleProc(QString name_, QString fileName_, QString fileVersion_) :
+		name(name_), fileName(fileName_), fileVersion(fileVersion_), dummyEntryName(0) {}
+
+	QString toString() const {
+		return QString("%1 %2 %3 %4 %5").arg(name, -32).arg(fileName, -32).arg(fileVersion).arg(dummyEntryName ? "D" : " ").arg(pcList.size(), 3);
+	}
+};
+typedef QSharedPointer<const ModuleProc> ModuleProcPtr;
+
+// Lookup table from gfi. Not changed after it is published.
+class ProcTable {
+public:
+	QVector<ModuleProcPtr> gfiList; // index is gfi
+};
+
+static QMutex                          tableMutex;
+static QSharedPointer<const ProcTable> currentTable;
+
+static QSharedPointer<const ProcTable> getTable() {
+	QMutexLocker locker(&tableMutex);
+	return currentTable;
+}
+static void setTable(QSharedPointer<const ProcTable> newValue) {
+	QMutexLocker locker(&tableMutex);
+	currentTable.swap(newValue);
+}
+
+bool findProcedureName(CARD16 gfi, CARD16 pc, QString& name) {
+	QSharedPointer<const ProcTable> table = getTable();
+	if (table.isNull() || table->gfiList.size() <= gfi || table->gfiList[gfi].isNull()) return false;
+
+	const ModuleProc& module = *table->gfiList[gfi];
+	// entry of procedure that contains pc has largest initialPC that is not greater than pc
+	const CARD16* i = std::upper_bound(module.pcList.constBegin(), module.pcList.constEnd(), pc);
+	if (i == module.pcList.constBegin()) {
+		name = QString("%1.%2").arg(module.fileName).arg(pc, 4, 16, QChar('0'));
+	} else {
+		name = module.nameList[(int)(i - module.pcList.constBegin()) - 1];
+	}
+	return true;
+}
+
+QString getProcedureName(CARD16 gfi, CARD16 pc) {
+	QString ret;
+	if (!findProcedureName(gfi, pc, ret)) {
+		ret = QString("%1.%2").arg(gfi, 4, 16, QChar('0')).arg(pc, 4, 16, QChar('0'));
+	}
+	return ret;
+}
+
+
+//
+// Scan thread
+//
+static QMap<CARD16, QList<ModuleProcPtr>> bcdModuleMap;   // key is bcdIndex. Accessed only from scan thread
+static QMap<CARD16, CARD32>               bcdChecksumMap; // key is bcdIndex. Checksum of decoded BCD
+
+// Fletcher checksum of words
+class Checksum {
+public:
+	Checksum() : a(0), b(0) {}
+	void add(CARD16 word) {
+		a = (a + word) % 65535;
+		b = (b + a) % 65535;
+	}
+	CARD32 value() const {
+		return (b << 16) | a;
+	}
+private:
+	CARD32 a;
+	CARD32 b;
+};
+
+// Checksum of copy of copyMemory
+static CARD32 checksum(const QByteArray& data) {
+	Checksum ret;
+	const CARD8* p = (const CARD8*)data.constData();
+	for(int i = 0; i + 1 < data.size(); i += 2) ret.add((CARD16)((p[i] << 8) | p[i + 1]));
+	return ret.value();
+}
+
+// Entry name of module from symbols segment contained in copy of BCD. Used when moduleEntryDB doesn't have module.
+// Only name of entry is needed, so SE, CTX and Tree record are decoded lazily like moduleEntry.
+static int getEntryName(BCD& bcd, const QByteArray& data, const MTRecord* mt, QMap<CARD16, QString>& entryNameMap) {
+	const SGRecord* sseg = mt->sseg;
+	if (sseg == 0 || sseg->isNull() || sseg->segClass != SGRecord::SegClass::SYMBOLS) return 0;
+	if (!sseg->file->isSelf() || sseg->base < Symbols::ALTO_BIAS) return 0;
+	// Symbols segment is outside of copy of BCD
+	if (data.size() < (sseg->base - Symbols::ALTO_BIAS + sseg->pages) * Symbols::WORDS_PER_PAGE * 2) return 0;
+	if (!Symbols::isSymbolsSegment(&bcd, sseg->base)) return 0;
+
+	try {
+		Symbols symbols(&bcd, sseg->base, Symbols::Mode::LAZY);
+		for(BTRecord* bt: symbols.bt.values()) {
+			if (bt->info->tag != BTRecord::BodyInfo::Tag::EXTERNAL) continue;
+			if (bt->tag != BTRecord::Tag::CALLABLE) continue;
+			const BTRecord::Callable& callable = bt->getCallable();
+			if (callable.tag != BTRecord::Callable::Tag::OUTER && callable.tag != BTRecord::Callable::Tag::INNER) continue;
+			const CARD16 entryIndex = callable.entryIndex;
+			if (mt->entries->initialPC.size() <= entryIndex) continue;
+			const QString name = callable.id->isNull() ? QString("ANON-%1").arg(entryIndex) : callable.id->getValue().getId().hash->getValue().value;
+			entryNameMap[mt->entries->initialPC[entryIndex]] = name;
+		}
+	} catch (Error& e) {
+		logger.warn("Failed to decode symbols %s  %s %d %s", mt->name.toLocal8Bit().constData(), e.file, e.line, e.func);
+		entryNameMap.clear();
+	}
+	return !entryNameMap.isEmpty();
+}
+
+static QList<ModuleProcPtr> decodeBCD(const QByteArray& data) {
+	BCD bcd(data);
+	if (!bcd.isBCDFile()) ERROR();
+
+	QList<ModuleProcPtr> ret;
+	for(MTRecord* mt: bcd.mt.values()) {
+		if (mt->isNull()) continue;
+
+		const QString   name(mt->name);
+		const FTRecord* file(mt->file);
+		const QString   fileName    = file->isSelf() ? name : file->name;
+		const QString   fileVersion = file->version->value;
+
+		ModuleProc* module = new ModuleProc(name, fileName, fileVersion);
+		ret.append(ModuleProcPtr(module));
+
+		QMap<CARD16, QString> entryNameMap; // key = initialPC, value = name
+		int initialPCSize = mt->entries->initialPC.size();
+		int moduleEntry   = (initialPCSize != 0) ? moduleEntryDB.find(fileVersion) : -1;
+		if (0 <= moduleEntry) {
+			int moduleEntrySize = moduleEntryDB.getEntryCount(moduleEntry);
+			if (moduleEntrySize != initialPCSize) {
+				logger.fatal("Unexpected  entrySize");
+				logger.fatal("entrySize  initialPCSize = %d   moduleEntry = %d", initialPCSize, moduleEntrySize);
+				logger.fatal("mt %s", mt->toString().toLocal8Bit().constData());
+				logger.fatal("moduleEntry %s", moduleEntryDB.toString(moduleEntry).toLocal8Bit().constData());
+				ERROR();
+			}
+			for(int j = 0; j < initialPCSize; j++) {
+				CARD16 initialPC = mt->entries->initialPC[j];
+				entryNameMap[initialPC] = QString("%1.%2").arg(fileName).arg(moduleEntryDB.getEntryName(moduleEntry, j));
+			}
+		} else if (initialPCSize != 0 && getEntryName(bcd, data, mt, entryNameMap)) {
+			for(QMap<CARD16, QString>::iterator j = entryNameMap.begin(); j != entryNameMap.end(); ++j) {
+				j.value() = QString("%1.%2").arg(fileName).arg(j.value());
+			}
+		} else {
+			// Add dummy entry to entryName
+			for(int j = 0; j < initialPCSize; j++) {
+				CARD16 initialPC = mt->entries->initialPC[j];
+				entryNameMap[initialPC] = QString("%1.%2").arg(fileName).arg(j);
+			}
+			module->dummyEntryName = 1;
+		}
+		for(QMap<CARD16, QString>::const_iterator j = entryNameMap.constBegin(); j != entryNameMap.constEnd(); ++j) {
+			module->pcList.append(j.key());
+			module->nameList.append(j.value());
+		}
+	}
+	return ret;
+}
+
+class ScanJob : public QRunnable {
+public:
+	const QMap<BCDModuleInfo, CARD16> gfiMap;
+	const QMap<CARD16, QByteArray>    bcdDataMap; // key is bcdIndex. Contains only new or changed BCD
+
+	ScanJob(const QMap<BCDModuleInfo, CARD16>& gfiMap_, const QMap<CARD16, QByteArray>& bcdDataMap_) :
+		gfiMap(gfiMap_), bcdDataMap(bcdDataMap_) {}
+
+	void run() {
+		QElapsedTimer timer;
+		timer.start();
+
+		int decodeCount = 0;
+		for(QMap<CARD16, QByteArray>::const_iterator i = bcdDataMap.constBegin(); i != bcdDataMap.constEnd(); ++i) {
+			// Skip decode if contents is same as last decoded BCD
+			const CARD32 value = checksum(i.value());
+			if (bcdModuleMap.contains(i.key()) && bcdChecksumMap.value(i.key()) == value) continue;
+			decodeCount++;
+			try {
+				bcdModuleMap[i.key()]   = decodeBCD(i.value());
+				bcdChecksumMap[i.key()] = value;
+			} catch (Error& e) {
+				logger.warn("Failed to decode bcd %d  %s %d %s", i.key(), e.file, e.line, e.func);
+				bcdModuleMap.remove(i.key());
+				bcdChecksumMap.remove(i.key());
+			}
+		}
 
-	GFInfo(CARD16 gfi_, QString name_, QString fileName_, QString fileVersion_, CARD32 codebase_) :
-		gfi(gfi_), name(name_), fileName(fileName_), fileVersion(fileVersion_), codebase(codebase_), dummyEntryName(0) {}
+		QSharedPointer<ProcTable> table(new ProcTable);
+		for(QMap<BCDModuleInfo, CARD16>::const_iterator i = gfiMap.constBegin(); i != gfiMap.constEnd(); ++i) {
+			BCDModuleInfo key = i.key();
+			CARD16        gfi = i.value();
 
-	QString toString() {
-		return QString("%1 %2 %3 %4 %5 %6 %7").arg(gfi, 4, 16).arg(name, -32).arg(fileName, -32).arg(fileVersion).arg(codebase, 8, 16).arg(dummyEntryName ? "D" : " ").arg(entryNameMap.size(), 3);
+			// moduleIndex starts from 1
+			const QList<ModuleProcPtr> moduleList = bcdModuleMap.value(key.bcdIndex);
+			if (key.moduleIndex == 0 || moduleList.size() < key.moduleIndex) {
+				logger.warn("No module of BCD  key = %s  gfi = %4X", key.toString().toLocal8Bit().constData(), gfi);
+				continue;
+			}
+			if (table->gfiList.size() <= gfi) table->gfiList.resize(gfi + 1);
+			table->gfiList[gfi] = moduleList[key.moduleIndex - 1];
+		}
+		setTable(table);
+
+		logger.info("scanJob  bcd %3d  decode %3d  module %4d  %lld ms", bcdDataMap.size(), decodeCount, gfiMap.size(), timer.elapsed());
 	}
 };
-static QMap<BCDModuleInfo, GFInfo*> gfInfoMap; // scanBCD add entries
 
+static QThreadPool& getScanPool() {
+	static QThreadPool scanPool;
+	// Scan job is processed one by one in order of request
+	scanPool.setMaxThreadCount(1);
+	return scanPool;
+}
+
+void waitScanLoadState() {
+	getScanPool().waitForDone();
+}
+
+
+//
+// Processor thread
+//
+static QMap<BCDModuleInfo, CARD16>  gfiMap;    // scanModule add entries
+
+// BCD of load state copied to scan thread. Recorded only when whole BCD is copied.
+// BCD that has same base, pages and head is treated as not changed. Contents of copied BCD is
+// compared by scan thread, so processor thread doesn't touch whole BCD that is not changed.
+class BCDState {
+public:
+	CARD32     base;
+	CARD16     pages;
+	QByteArray head;     // detect other BCD at same place
 
-static void scanBCD(CARD32 loadStateAddress, LoadStateFormat::Object& loadState) {
-//	static QSet<CARD16>       done;
-	static QMap<CARD32, BCD*> bcdMap; // key is base address. Cache BCD* in case of re-scan
+	BCDState() : base(0), pages(0) {}
+	BCDState(CARD32 base_, CARD16 pages_, const QByteArray& head_) :
+		base(base_), pages(pages_), head(head_) {}
 
+	bool operator==(const BCDState& that) const {
+		return base == that.base && pages == that.pages && head == that.head;
+	}
+};
+static QMap<CARD16, BCDState> bcdStateMap; // key is bcdIndex
+
+// Copy words of mesa memory in same byte order of BCD file. Stop at unmapped page.
+static QByteArray copyMemory(CARD32 ptr, CARD32 size) {
+	QByteArray ret(size * 2, 0);
+	CARD8* p = (CARD8*)ret.data();
+	for(CARD32 i = 0; i < size; i++) {
+		CARD32 va = ptr + i;
+		if ((i == 0 || (va % PageSize) == 0) && Memory::isVacant(va)) break;
+		BytePair word = {*Fetch(va)};
+		*p++ = (CARD8)word.left;
+		*p++ = (CARD8)word.right;
+	}
+	ret.resize((int)(p - (CARD8*)ret.data()));
+	return ret;
+}
+
+// Returns copy of new or changed BCD. key is bcdIndex
+static QMap<CARD16, QByteArray> scanBCD(CARD32 loadStateAddress, LoadStateFormat::Object& loadState) {
+	static const CARD32 HEAD_SIZE = 16;
+
+	QMap<CARD16, QByteArray> ret;
 	for(CARD16 i = 0; i < loadState.nBcds; i++) {
 		CARD32 bcdInfoBase = loadStateAddress + loadState.bcdInfo + SIZE(LoadStateFormat::BcdInfo) * i;
 
@@ -198,103 +387,30 @@ static void scanBCD(CARD32 loadStateAddress, LoadStateFormat::Object& loadState)
 			ERROR();
 		}
 
-//		logger.info("bcdInfo %4d %8X+%4d %4d", bcdIndex, bcdInfo.base, bcdInfo.pages, bcdInfo.id);
-
-		BCD* bcd;
-		{
-			CARD32 base = bcdInfo.base;
-			if (bcdMap.contains(base)) {
-				bcd = bcdMap[base];
-			} else {
-				try {
-					bcd = new BCD(base);
-				} catch (Abort& e) {
-					bcd = 0;
-				}
-				if (bcd == 0) {
-					logger.fatal("BCD page is not mapped");
-					ERROR();
-				}
-				bcdMap[base] = bcd;
-			}
-		}
-
-		QList<MTRecord*> mtList = bcd->mt.values();
-
-		CARD16 moduleIndex = 0;
-		for(MTRecord* mt: mtList) {
-			if (mt->isNull()) continue;
-
-			// moduleIndex starts from 1
-			moduleIndex++;
-
-			const QString   name(mt->name);
-			const FTRecord* file(mt->file);
-
-			BCDModuleInfo key(bcdIndex, moduleIndex);
+		// Skip if bcd is not changed
+		const CARD32 size = bcdInfo.pages * PageSize;
+		const BCDState state(bcdInfo.base, bcdInfo.pages, copyMemory(bcdInfo.base, HEAD_SIZE));
+		if (bcdStateMap.contains(bcdIndex) && bcdStateMap[bcdIndex] == state) continue;
 
-			// If there is no correspondence moduleInfo entry, skip this entry.
-			if (!gfiMap.contains(key)) {
-				logger.warn("No module info  key = %s  %s", key.toString().toLocal8Bit().constData(), name.toLocal8Bit().constData());
-				continue;
-			}
-
-			CARD16 gfi = gfiMap[key];
-
-			if (gfInfoMap.contains(key)) {
-				GFInfo* gfInfo = gfInfoMap[key];
-				if (gfInfo->gfi != gfi) {
-					logger.fatal("Unexpected key = %s  gfi = %4X  gfInfo = %s", key.toString().toLocal8Bit().constData(), gfi, gfInfo->toString().toLocal8Bit().constData());
-					ERROR();
-				}
-			} else {
-				QString fileName    = file->name;
-				QString fileVersion = file->version->value;
-				CARD32  codebase    = ReadDbl(GFT_OFFSET(gfi, codebase)) & ~1;
-
-				GFInfo* gfInfo = new GFInfo(gfi, name, (file->isSelf() ? name : file->name), file->version->value, codebase);
-				gfInfoMap[key] = gfInfo;
-
-				logger.info("gfInfo %-7s %s", key.toString().toLocal8Bit().constData(), gfInfo->toString().toLocal8Bit().constData());
-
-				int initialPCSize = mt->entries->initialPC.size();
-				if (initialPCSize != 0 && moduleEntryMap.contains(fileVersion)) {
-					ModuleEntry* moduleEntry = moduleEntryMap[fileVersion];
-					int moduleEntrySize = moduleEntry->entryName.size();
-					if (moduleEntrySize == initialPCSize) {
-						for(int j = 0; j < initialPCSize; j++) {
-							CARD16  initialPC = mt->entries->initialPC[j];
-							QString entryName = moduleEntry->entryName[j];
-							QString name = QString("%1.%2").arg(fileName).arg(entryName);
-							gfInfo->entryNameMap[initialPC] = name;
-						}
-					} else {
-						logger.fatal("Unexpected  entrySize");
-						logger.fatal("entrySize  initialPCSize = %d   moduleEntry = %d", initialPCSize, moduleEntrySize);
-						logger.fatal("mt %s", mt->toString().toLocal8Bit().constData());
-						logger.fatal("moduleEntry %s", moduleEntry->toString().toLocal8Bit().constData());
-						logger.fatal("gfInfo %s", gfInfo->toString().toLocal8Bit().constData());
-						ERROR();
-					}
-				} else {
-					// Add dummy entry to entryName
-					for(int j = 0; j < initialPCSize; j++) {
-						CARD16  initialPC = mt->entries->initialPC[j];
-						QString entryName = QString("%1").arg(j);
-						QString name = QString("%1.%2").arg(fileName).arg(entryName);
-						gfInfo->entryNameMap[initialPC] = name;
-					}
-					gfInfo->dummyEntryName = 1;
-				}
-			}
+		QByteArray copy = copyMemory(bcdInfo.base, size);
+		ret[bcdIndex] = copy;
+		if (copy.size() == (int)(size * 2)) {
+			bcdStateMap[bcdIndex] = state;
+			logger.info("bcdInfo %4d %8X+%3d changed", bcdIndex, bcdInfo.base, bcdInfo.pages);
+		} else {
+			// Part of BCD is not mapped. Copy again at next scan.
+			bcdStateMap.remove(bcdIndex);
+			logger.info("bcdInfo %4d %8X+%3d changed  partial %d", bcdIndex, bcdInfo.base, bcdInfo.pages, copy.size() / 2);
 		}
 	}
+	return ret;
 }
 
-
-static void scanModule(CARD32 loadStateAddress, LoadStateFormat::Object& loadState) {
+// Returns true if gfiMap is changed
+static bool scanModule(CARD32 loadStateAddress, LoadStateFormat::Object& loadState) {
 	// Order of module entry can be change.
 	// So need scan all module entry each time.
+	bool ret = false;
 
 	for(CARD16 i = 0; i < loadState.nModules; i++) {
 		CARD32 moduleBase = loadStateAddress + loadState.moduleInfo + SIZE(LoadStateFormat::ModuleInfo) * i;
@@ -318,17 +434,19 @@ static void scanModule(CARD32 loadStateAddress, LoadStateFormat::Object& loadSta
 			}
 		} else {
 			gfiMap[key] = moduleInfo.globalFrame;
+			ret = true;
 
 //			logger.info("module %4d %d %5d %5d %4X  %8X", i, moduleInfo.resolved, moduleInfo.cgfi, moduleInfo.index, moduleInfo.globalFrame, codebase);
 			logger.info("module %5d %5d %5d %4X", i, bcdIndex, moduleIndex, gfi);
 		}
 	}
+	return ret;
 }
 
 void scanLoadState() {
 	try {
-		if (moduleEntryMap.size() == 0) {
-			logger.fatal("Unexpected moduleEntryMap.size() == 0");
+		if (moduleEntryDB.size() == 0) {
+			logger.fatal("Unexpected moduleEntryDB.size() == 0");
 			ERROR();
 		}
 
@@ -383,8 +501,11 @@ void scanLoadState() {
 			}
 
 			logger.info("loadState %5d %5d %5d", loadState.nModules, loadState.nBcds, loadState.nextID);
-			scanModule(loadStateAddress, loadState);
-			scanBCD(loadStateAddress, loadState);
+			bool                     moduleChanged = scanModule(loadStateAddress, loadState);
+			QMap<CARD16, QByteArray> bcdDataMap    = scanBCD(loadStateAddress, loadState);
+			if (moduleChanged || !bcdDataMap.isEmpty()) {
+				getScanPool().start(new ScanJob(gfiMap, bcdDataMap));
+			}
 
 			esv.loadStateDirty = false;
 			*p27 = esv.u27;
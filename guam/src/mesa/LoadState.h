@@ -32,6 +32,10 @@ OF SUCH DAMAGE.
 #ifndef LOADSTATE_H__
 #define LOADSTATE_H__ 1
 
+#include "MesaBasic.h"
+
+#include <QString>
+
 static const int ENABLE_LOADSTATE_PROCESS = 0;
 
 void initializeModuleEntryMap();
@@ -39,7 +43,18 @@ void initializeModuleEntryMap();
 //
 // Trace XFER with module name
 //   Hook write access to esv.loadStateDirty and collect module info.
+//   Only new or changed BCD is copied. Lookup table is rebuilt on background thread.
 
 void scanLoadState();
 
+// Wait until lookup table reflects last scanLoadState
+void waitScanLoadState();
+
+// Returns "module.procedure" of code at pc of gfi using scanned load state.
+// Returns hex value of gfi or pc if they are unknown.
+QString getProcedureName(CARD16 gfi, CARD16 pc);
+
+// Set "module.procedure" of code at pc of gfi to name. Returns false if gfi is unknown.
+bool findProcedureName(CARD16 gfi, CARD16 pc, QString& name);
+
 #endif
@@ -43,6 +43,7 @@ CARD16 PID[4] = {0, 0, 0, 0}; // Processor ID
 //CARD16 WDC = 0;    // Wakeup disable counter - 10.4.4.3
 //CARD16 PTC = 0;    // Process timeout counter - 10.4.5
 CARD16 XTS = 0;    // Xfer trap status - 9.5.5
+CARD16 FST = 0;    // Floating point sticky word - FSTICKY
 
 // 3.3.1 Control Registers
 CARD16            PSB = 0; // PsbIndex - 10.1.1
@@ -80,6 +81,8 @@ CARD32         Memory::displayVirtualPage  = 0;
 CARD32         Memory::displayWidth        = 0;
 CARD32         Memory::displayHeight       = 0;
 CARD32         Memory::displayBytesPerLine = 0;
+CARD16         Memory::displayType         = 0;
+CARD32         Memory::displayBitsPerPixel = 0;
 CARD32         Memory::mds   = 0;
 
 
@@ -90,6 +93,29 @@ long long       LFCache::hit        = 0;
 long long       LFCache::miss       = 0;
 
 
+CARD16*             AVCache::av         = 0;
+CARD32              AVCache::vp         = 0;
+AVCache::FrameStack AVCache::frameStack[FSIndex_SIZE];
+FSIndex             AVCache::usedList[FSIndex_SIZE];
+int                 AVCache::usedCount  = 0;
+long long           AVCache::hit        = 0;
+long long           AVCache::miss       = 0;
+long long           AVCache::flush      = 0;
+
+
+CARD8           PsbWatch::dirty[PSB_PAGE_SIZE];
+CARD32          PsbWatch::dirtyList[PSB_PAGE_SIZE];
+int             PsbWatch::dirtyCount = 0;
+
+
+GFTCache::Entry GFTCache::gfiEntry[N_ENTRY];
+GFTCache::Entry GFTCache::procEntry[N_ENTRY];
+CARD32          GFTCache::gen       = 1;
+int             GFTCache::armed     = 0;
+long long       GFTCache::flush     = 0;
+long long       GFTCache::remap     = 0;
+
+
 CARD8* CodeCache::page    = 0;
 INT32  CodeCache::offset  = 0;      // byte offset of PC to access data in page (can be negative)
 CARD16 CodeCache::startPC = 0xffff; // valid PC range (startPC <= PC <= endPC)
@@ -160,6 +186,15 @@ void Memory::initialize(int vmBits, int rmBits, CARD16 ioRegionPage) {
 
 	// initialize related class
 	PageCache::initialize();
+	AVCache::initialize();
+	GFTCache::initialize();
+	PsbWatch::initialize();
+}
+
+void Memory::invalidateCache() {
+	PageCache::initialize();
+	AVCache::clear();
+	GFTCache::invalidate();
 }
 
 void Memory::finalize() {
@@ -175,7 +210,7 @@ void Memory::finalize() {
 	vpSize = rpSize = 0;
 }
 
-void Memory::reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_) {
+void Memory::reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_, CARD16 displayType_) {
 	// Taken from APilot/15.3/Faces/Private/UserterminalHeadGuam.mesa
 	// UserTerminal::CalculateDisplayPages
     // wordsPerDWord: CARDINAL = 2;
@@ -185,12 +220,27 @@ void Memory::reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_) {
 
 	displayWidth = displayWidth_;
 	displayHeight = displayHeight_;
+	displayType = displayType_;
+
+	switch(displayType) {
+	case DisplayIOFaceGuam::T_monochrome:
+		displayBitsPerPixel = 1;
+		break;
+	case DisplayIOFaceGuam::T_byteColor:
+		displayBitsPerPixel = 8;
+		break;
+	default:
+		logger.fatal("displayType = %d", displayType);
+		ERROR();
+		break;
+	}
 
-	const int alignedDisplayWidth = ((displayWidth + bitsPerDWord - 1) / bitsPerDWord) * bitsPerDWord;
-	displayBytesPerLine = alignedDisplayWidth / 8;
+	// Each line is aligned to double word
+	const int alignedDisplayBits = ((displayWidth * displayBitsPerPixel + bitsPerDWord - 1) / bitsPerDWord) * bitsPerDWord;
+	displayBytesPerLine = alignedDisplayBits / 8;
 
 	const int PAGE_SIZE = PageSize * sizeof(CARD16);
-	const int imageSize = (alignedDisplayWidth * displayHeight) / 8;
+	const int imageSize = displayBytesPerLine * displayHeight;
 	displayPageSize     = ((imageSize + PAGE_SIZE - 1) / PAGE_SIZE);
 
 	const CARD32 vp = rpSize - displayPageSize;
@@ -205,7 +255,7 @@ void Memory::reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_) {
 		WriteMap(vp + i, map);
 	}
 
-	logger.info("%s rp = %6X+%2X", __FUNCTION__, rpSize - displayPageSize, displayPageSize);
+	logger.info("%s rp = %6X+%2X  bpp = %d", __FUNCTION__, rpSize - displayPageSize, displayPageSize, displayBitsPerPixel);
 }
 void Memory::mapDisplay(CARD32 vp, CARD32 rp, CARD32 pageCount) {
 	logger.info("%s  %6X+%2X  %6X %3d", __FUNCTION__, vp, pageCount, rp, pageCount);
@@ -342,9 +392,13 @@ void Memory::WriteMap(CARD32 vp, Map map) {
 	if (rpSize <= map.rp) ERROR();
 
 	if (Vacant(map.mf)) map.rp = 0;
+	// Link held frames to AV before map of AV or frame is changed
+	AVCache::invalidate();
 	maps[vp] = map;
 	if (PERF_ENABLE) perf_WriteMap++;
 	PageCache::invalidate(vp);
+	// Code segment can be swapped by WriteMap
+	GFTCache::invalidate(vp);
 }
 
 void CodeCache::setup() {
@@ -372,6 +426,7 @@ void PageCache::fetchSetup(Entry *p, CARD32 vp) {
 		if (p->vpno) missConflict++;
 		else missEmpty++;
 	}
+	if (AVCache::watch(vp)) AVCache::invalidate();
 	// Overwrite content of entry
 	p->vpno      = vp;
 	p->flagFetch = 1;
@@ -395,11 +450,23 @@ void PageCache::storeSetup(Entry *p, CARD32 vp) {
 	p->flagFetch = 1;
 	p->flagStore = 1;
 	p->page      = Memory::Store(vp * PageSize);
+	if (AVCache::watch(vp)) AVCache::invalidate();
+	if (GFTCache::watch(vp)) GFTCache::invalidate();
+	if (PsbWatch::watch(vp)) {
+		PsbWatch::notify(vp);
+		p->flagStore = 0;
+	}
 }
 void PageCache::storeMaintainFlag(Entry *p, CARD32 vp) {
 	Memory::setReferencedDirtyFlag(vp);
 	p->flagFetch = 1;
 	p->flagStore = 1;
+	if (AVCache::watch(vp)) AVCache::invalidate();
+	if (GFTCache::watch(vp)) GFTCache::invalidate();
+	if (PsbWatch::watch(vp)) {
+		PsbWatch::notify(vp);
+		p->flagStore = 0;
+	}
 }
 
 void PageCache::stats() {
@@ -426,6 +493,139 @@ CARD16* LFCache::store(CARD32 ptr) {
 	return PageCache::store(ptr);
 }
 
+void AVCache::initialize() {
+	av    = 0;
+	vp    = 0;
+	hit   = 0;
+	miss  = 0;
+	flush = 0;
+	clear();
+}
+
+void AVCache::clear() {
+	av = 0;
+	vp = 0;
+	for(int i = 0; i < FSIndex_SIZE; i++) {
+		frameStack[i].count  = 0;
+		frameStack[i].listed = 0;
+	}
+	usedCount = 0;
+}
+
+void AVCache::stats() {
+	if (!PERF_ENABLE) return;
+	long long total = hit + miss;
+	logger.info("AVCache   %10llu %6.2f%%   miss %10llu  flush %10llu", total, ((double)hit / total) * 100.0, miss, flush);
+}
+
+CARD16* AVCache::setup() {
+	const CARD32 ptr = Memory::lengthenPointer(AV);
+	// Whole AV is placed in one page
+	CARD16* page = Memory::Store(ptr);
+	// Drop PageCache entry of AV page. So that next access to AV page through PageCache will call
+	// fetchSetup or storeSetup and flush AVCache.
+	vp = ptr / PageSize;
+	PageCache::invalidate(vp);
+	av = page;
+	return av;
+}
+
+void AVCache::writeBack() {
+	// Same as Free of each held frame in order. Use Memory::Store to keep PageCache untouched.
+	for(int i = 0; i < usedCount; i++) {
+		const FSIndex fsi   = usedList[i];
+		FrameStack&   stack = frameStack[fsi];
+		for(int j = 0; j < stack.count; j++) {
+			const LocalFrameHandle frame = stack.frame[j];
+			*Memory::Store(Memory::lengthenPointer(frame)) = av[fsi];
+			av[fsi] = frame;
+		}
+		stack.count  = 0;
+		stack.listed = 0;
+	}
+	usedCount = 0;
+}
+
+void PsbWatch::initialize() {
+	for(CARD32 i = 0; i < PSB_PAGE_SIZE; i++) dirty[i] = 0;
+	dirtyCount = 0;
+}
+void PsbWatch::clear() {
+	for(int i = 0; i < dirtyCount; i++) dirty[dirtyList[i]] = 0;
+	dirtyCount = 0;
+}
+
+void GFTCache::initialize() {
+	clear();
+	armed = 0;
+	flush = 0;
+	remap = 0;
+}
+
+void GFTCache::clear() {
+	for(CARD32 i = 0; i < N_ENTRY; i++) {
+		gfiEntry[i].gen  = 0;
+		procEntry[i].gen = 0;
+	}
+	gen = 1;
+}
+
+void GFTCache::arm() {
+	// Drop PageCache entry of GFT pages. So that next store to GFT through PageCache will call
+	// storeSetup or storeMaintainFlag and flush GFTCache.
+	for(CARD32 i = 0; i < GFT_PAGE_SIZE; i++) PageCache::invalidate(GFT_PAGE + i);
+	armed = 1;
+}
+
+void GFTCache::invalidate(CARD32 vp) {
+	if (!armed) return;
+	for(CARD32 i = 0; i < N_ENTRY; i++) {
+		Entry* p = gfiEntry + i;
+		if (p->gen == gen && (p->gftPage == vp || p->codePage == vp)) {
+			if (PERF_ENABLE) remap++;
+			p->gen = 0;
+		}
+		p = procEntry + i;
+		if (p->gen == gen && (p->gftPage == vp || p->codePage == vp)) {
+			if (PERF_ENABLE) remap++;
+			p->gen = 0;
+		}
+	}
+}
+
+void GFTCache::addGFI(GFTHandle gfi, CARD32 gf, CARD32 cb) {
+	if (!armed) arm();
+	Entry* p = gfiEntry + ((gfi / SIZE(GFTItem)) & MASK);
+	p->gen = gen;
+	p->key = gfi;
+	p->gf  = gf;
+	p->cb  = cb;
+	p->gfi = gfi;
+	p->fsi = 0;
+	p->gftPage  = GFT_OFFSET(gfi, globalFrame) / PageSize;
+	p->codePage = cb / PageSize;
+}
+
+void GFTCache::addProc(ControlLink link, GFTHandle gfi, CARD32 gf, CARD32 cb, CARD16 pc, FSIndex fsi) {
+	if (!armed) arm();
+	Entry* p = procEntry + (((link >> WordSize) ^ (link / SIZE(GFTItem))) & MASK);
+	p->gen = gen;
+	p->key = link;
+	p->gf  = gf;
+	p->cb  = cb;
+	p->gfi = gfi;
+	p->fsi = fsi;
+	p->gftPage  = GFT_OFFSET(gfi, globalFrame) / PageSize;
+	// fsi is read from code at pc
+	p->codePage = (cb + pc / 2) / PageSize;
+}
+
+void GFTCache::stats() {
+	if (!PERF_ENABLE) return;
+	long long total = perf_XferCacheHit + perf_XferCacheMiss;
+	logger.info("GFTCache  %10llu %6.2f%%   miss %10llu  flush %10llu  remap %10llu", total, ((double)perf_XferCacheHit / total) * 100.0, perf_XferCacheMiss, flush, remap);
+}
+
 void CodeCache::stats() {
 	if (!PERF_ENABLE) return;
 	long long total = hit + miss;
@@ -144,7 +144,8 @@ public:
 		return rpSize - displayPageSize;
 	}
 
-	static void reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_);
+	// displayType_ is DisplayIOFaceGuam::T_monochrome or DisplayIOFaceGuam::T_byteColor
+	static void reserveDisplayPage(CARD16 displayWidth_, CARD16 displayHeight_, CARD16 displayType_);
 	static inline CARD32 getDisplayPageSize() {
 		if (displayRealPage == 0) ERROR();
 		return displayPageSize;
@@ -153,6 +154,14 @@ public:
 		if (displayRealPage == 0) ERROR();
 		return displayBytesPerLine;
 	}
+	static inline CARD16 getDisplayType() {
+		if (displayRealPage == 0) ERROR();
+		return displayType;
+	}
+	static inline CARD32 getDisplayBitsPerPixel() {
+		if (displayRealPage == 0) ERROR();
+		return displayBitsPerPixel;
+	}
 
 	static void mapDisplay(CARD32 vp, CARD32 rp, CARD32 pageCount);
 	static inline CARD32 getDisplayRealPage() {
@@ -182,6 +191,19 @@ public:
 		return mds;
 	}
 
+	// Raw access to real memory and map for snapshot
+	static inline CARD16* getRealMemory() {
+		return pages;
+	}
+	static inline Map* getMaps() {
+		return maps;
+	}
+	static void setDisplayVirtualPage(CARD32 vp) {
+		displayVirtualPage = vp;
+	}
+	// Invalidate all host side cache of memory after contents of memory is replaced
+	static void invalidateCache();
+
 private:
 	static CARD32  vpSize;
 	static CARD32  rpSize;
@@ -194,6 +216,8 @@ private:
 	static CARD32  displayWidth;
 	static CARD32  displayHeight;
 	static CARD32  displayBytesPerLine;
+	static CARD16  displayType;
+	static CARD32  displayBitsPerPixel;
 	static CARD32  mds;
 };
 
@@ -366,6 +390,188 @@ __attribute__((always_inline)) static inline CARD32 ReadDblLF(CARD16 ptr) {
 }
 
 
+// 9.2.2 Frame Allocation Primitives
+// AVCache holds host address of AV of current MDS and free local frames of each fsi for Alloc and Free.
+// Free holds frame in host side stack of fsi instead of linking it to AV, and Alloc takes frame from
+// the stack first. Held frames are linked to AV in order of Free, when the cache is flushed by process
+// switch, WRMDS, FrameFault, WriteMap and any access to AV page through PageCache.
+class AVCache {
+public:
+	// Number of frames held for each fsi
+	static const int FRAME_DEPTH = 16;
+
+	static void initialize();
+	// Link held frames to AV and drop cached address of AV
+	static void invalidate() {
+		if (av == 0) return;
+		if (PERF_ENABLE) flush++;
+		if (usedCount) writeBack();
+		av = 0;
+		vp = 0;
+	}
+	// Drop held frames without linking them to AV. Used when memory is replaced.
+	static void clear();
+	// Returns true if access to page vp_ need to flush AVCache
+	static inline bool watch(CARD32 vp_) {
+		return av && vp_ == vp;
+	}
+	__attribute__((always_inline)) static inline CARD16* getAV() {
+		if (av) return av;
+		return setup();
+	}
+	// Set frame and returns true if free frame of fsi is held. Call after getAV.
+	__attribute__((always_inline)) static inline bool allocFrame(FSIndex fsi, LocalFrameHandle& frame) {
+		FrameStack& stack = frameStack[fsi];
+		if (stack.count == 0) return false;
+		if (PERF_ENABLE) hit++;
+		frame = stack.frame[--stack.count];
+		return true;
+	}
+	// Count Alloc that takes frame from AV
+	__attribute__((always_inline)) static inline void allocMiss() {
+		if (PERF_ENABLE) miss++;
+	}
+	// Returns true if frame is held. Returns false if stack of fsi is full. Call after getAV.
+	__attribute__((always_inline)) static inline bool freeFrame(FSIndex fsi, LocalFrameHandle frame) {
+		FrameStack& stack = frameStack[fsi];
+		if (stack.count == FRAME_DEPTH) return false;
+		if (!stack.listed) {
+			stack.listed = 1;
+			usedList[usedCount++] = fsi;
+		}
+		stack.frame[stack.count++] = frame;
+		return true;
+	}
+	static void stats();
+protected:
+	struct FrameStack {
+		CARD16           count;
+		CARD16           listed; // fsi is in usedList
+		LocalFrameHandle frame[FRAME_DEPTH];
+	};
+	static CARD16*    av;
+	static CARD32     vp;
+	static FrameStack frameStack[FSIndex_SIZE];
+	static FSIndex    usedList[FSIndex_SIZE];
+	static int        usedCount;
+	static long long  hit;
+	static long long  miss;
+	static long long  flush;
+
+	static CARD16* setup();
+	static void    writeBack();
+};
+
+
+// 9.3 Control Transfer Primitives
+// GFTCache holds globalFrame and codebase of GFT item for XFER. Entry for new procedure descriptor
+// also holds fsi of the procedure. Only item without code trap is cached.
+// All entries are flushed by any store to GFT through PageCache. WriteMap flushes entries
+// whose GFT item or code is in the remapped page.
+class GFTCache {
+public:
+	struct Entry {
+		CARD32      gen;
+		ControlLink key;  // GFI or new procedure descriptor
+		CARD32      gf;
+		CARD32      cb;
+		GFTHandle   gfi;
+		FSIndex     fsi;
+		CARD32      gftPage;  // page of GFT item
+		CARD32      codePage; // page of code that entry depends on
+	};
+
+	static void initialize();
+	// Flush entries that depend on page vp
+	static void invalidate(CARD32 vp);
+	static void invalidate() {
+		if (!armed) return;
+		if (PERF_ENABLE) flush++;
+		armed = 0;
+		if (++gen == 0) clear();
+	}
+	// Returns true if store to page vp need to flush GFTCache
+	static inline bool watch(CARD32 vp) {
+		return armed && (vp - GFT_PAGE) < GFT_PAGE_SIZE;
+	}
+	__attribute__((always_inline)) static inline Entry* findGFI(GFTHandle gfi) {
+		Entry* p = gfiEntry + ((gfi / SIZE(GFTItem)) & MASK);
+		if (p->gen == gen && p->key == gfi) {
+			if (PERF_ENABLE) perf_XferCacheHit++;
+			return p;
+		}
+		if (PERF_ENABLE) perf_XferCacheMiss++;
+		return 0;
+	}
+	__attribute__((always_inline)) static inline Entry* findProc(ControlLink link) {
+		Entry* p = procEntry + (((link >> WordSize) ^ (link / SIZE(GFTItem))) & MASK);
+		if (p->gen == gen && p->key == link) {
+			if (PERF_ENABLE) perf_XferCacheHit++;
+			return p;
+		}
+		if (PERF_ENABLE) perf_XferCacheMiss++;
+		return 0;
+	}
+	static void addGFI(GFTHandle gfi, CARD32 gf, CARD32 cb);
+	static void addProc(ControlLink link, GFTHandle gfi, CARD32 gf, CARD32 cb, CARD16 pc, FSIndex fsi);
+	static void stats();
+protected:
+	static const CARD32 N_BIT = 10;
+	static const CARD32 N_ENTRY = 1 << N_BIT;
+	static const CARD32 MASK = N_ENTRY - 1;
+	static const CARD32 GFT_PAGE = GFT / PageSize;
+	static const CARD32 GFT_PAGE_SIZE = (GFTIndex_SIZE * SIZE(GFTItem)) / PageSize;
+
+	static Entry     gfiEntry[N_ENTRY];
+	static Entry     procEntry[N_ENTRY];
+	static CARD32    gen;
+	static int       armed;
+	static long long flush;
+	static long long remap;
+
+	static void clear();
+	static void arm();
+};
+
+
+// 10.4.5 Timeouts
+// PsbWatch records page of PSB that is stored through PageCache, so that timeout wheel can find
+// timeout of PSB stored by Mesa code. Process instructions store PSB with StorePda that doesn't use
+// PageCache. PageCache entry of watched page keeps flagStore 0, so every store through PageCache
+// goes storeSetup or storeMaintainFlag.
+class PsbWatch {
+public:
+	// Number of PSB in one page
+	static const CARD32 PSB_PER_PAGE = PageSize / SIZE(ProcessStateBlock);
+
+	static void initialize();
+	static inline bool watch(CARD32 vp) {
+		return (vp - PSB_PAGE) < PSB_PAGE_SIZE;
+	}
+	static inline void notify(CARD32 vp) {
+		const CARD32 page = vp - PSB_PAGE;
+		if (dirty[page]) return;
+		dirty[page] = 1;
+		dirtyList[dirtyCount++] = page;
+	}
+	// Returns number of stored page since last clear. Index of first PSB in page i is getPage(i) * PSB_PER_PAGE.
+	static inline int getCount() {
+		return dirtyCount;
+	}
+	static inline CARD32 getPage(int i) {
+		return dirtyList[i];
+	}
+	static void clear();
+protected:
+	static const CARD32 PSB_PAGE      = PDA / PageSize;
+	static const CARD32 PSB_PAGE_SIZE = (PsbIndex_SIZE * SIZE(ProcessStateBlock)) / PageSize;
+
+	static CARD8  dirty[PSB_PAGE_SIZE];
+	static CARD32 dirtyList[PSB_PAGE_SIZE];
+	static int    dirtyCount;
+};
+
+
 // 3.1.4.3 Code Segments
 class CodeCache {
 public:
@@ -510,9 +716,10 @@ static inline CARD16* FetchPda(POINTER ptr) {
 	if (PERF_ENABLE) perf_FetchPda++;
 	return PageCache::fetch(LengthenPdaPtr(ptr));
 }
+// Store to PDA doesn't use PageCache, so that PsbWatch can see store from Mesa code.
 static inline CARD16* StorePda(POINTER ptr) {
 	if (PERF_ENABLE) perf_StorePda++;
-	return PageCache::store(LengthenPdaPtr(ptr));
+	return Memory::Store(LengthenPdaPtr(ptr));
 }
 
 // 9.5.3 Trap Handlers
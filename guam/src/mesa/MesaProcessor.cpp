@@ -48,6 +48,7 @@ static log4cpp::Category& logger = Logger::getLogger("mesaproc");
 #include "MesaThread.h"
 #include "MesaProcessor.h"
 #include "LoadState.h"
+#include "Snapshot.h"
 
 
 void MesaProcessor::initialize() {
@@ -55,12 +56,25 @@ void MesaProcessor::initialize() {
 
 	QThreadPool::globalInstance()->setMaxThreadCount(MAX_THREAD);
 
+	// Trace must be initialized before agent, because agent behaves differently in trace mode
+	Trace::initialize(traceMode, tracePath);
+
 	logger.info("vmBits = %2d  rmBits = %2d", vmBits, rmBits);
 	Memory::initialize(vmBits, rmBits, Agent::ioRegionPage);
 	Interpreter::initialize();
 
 	// Reserve real memory for display
-	Memory::reserveDisplayPage(displayWidth, displayHeight);
+	{
+		CARD16 type = DisplayIOFaceGuam::T_monochrome;
+		if (displayType == "byteColor") {
+			type = DisplayIOFaceGuam::T_byteColor;
+		} else if (!displayType.isEmpty() && displayType != "monochrome") {
+			logger.fatal("Unknown displayType = %s", qPrintable(displayType));
+			ERROR();
+		}
+		logger.info("Display  %d x %d  %s", displayWidth, displayHeight, type == DisplayIOFaceGuam::T_byteColor ? "byteColor" : "monochrome");
+		Memory::reserveDisplayPage(displayWidth, displayHeight, type);
+	}
 
 	// AgentDisk use diskFile
 	for(int i = 1; i <= 999; i++) {
@@ -140,11 +154,21 @@ void MesaProcessor::initialize() {
 	interruptThread.setAutoDelete(false);
 	timerThread.setAutoDelete(false);
 	processorThread.setAutoDelete(false);
+	replayThread.setAutoDelete(false);
+	samplerThread.setAutoDelete(false);
+
+	// Input event from gui thread goes through InputQueue
+	InputQueue::initialize(inputRecordPath);
 	//
 	setRunning(0);
 
+	// Start from saved state instead of boot
+	if (!snapshotRestorePath.isEmpty()) {
+		Snapshot::restore(snapshotRestorePath, diskFileList);
+	}
+
 	// Initialize moduleEntryMap
-	if (ENABLE_LOADSTATE_PROCESS) {
+	if (ENABLE_LOADSTATE_PROCESS || profilerInterval) {
 		initializeModuleEntryMap();
 	}
 }
@@ -153,12 +177,23 @@ void MesaProcessor::boot() {
 	setRunning(1);
 	//
 	logger.info("MesaProcessor::boot START");
-	QThreadPool::globalInstance()->start(&interruptThread);
-	QThreadPool::globalInstance()->start(&timerThread);
-	QThreadPool::globalInstance()->start(&network.receiveThread);
-	QThreadPool::globalInstance()->start(&network.transmitThread);
-	QThreadPool::globalInstance()->start(&disk.ioThread);
+	// In replay, all non-deterministic input comes from trace. Don't start thread that produces input.
+	if (!Trace::isReplay()) {
+		QThreadPool::globalInstance()->start(&interruptThread);
+		QThreadPool::globalInstance()->start(&timerThread);
+		QThreadPool::globalInstance()->start(&network.receiveThread);
+		QThreadPool::globalInstance()->start(&network.transmitThread);
+		QThreadPool::globalInstance()->start(&disk.ioThread);
+	}
 	QThreadPool::globalInstance()->start(&processorThread);
+	if (!inputReplayPath.isEmpty() && !Trace::isReplay()) {
+		replayThread.setPath(inputReplayPath);
+		QThreadPool::globalInstance()->start(&replayThread);
+	}
+	if (profilerInterval) {
+		samplerThread.setInterval(profilerInterval);
+		QThreadPool::globalInstance()->start(&samplerThread);
+	}
 	logger.info("MesaProcessor::boot STOP");
 }
 
@@ -173,6 +208,10 @@ void MesaProcessor::wait() {
 	logger.info("wait for all threads");
 	QThreadPool::globalInstance()->waitForDone();
 	logger.info("MesaProcessor::wait STOP");
+	// All threads are stopped. It is safe to access memory.
+	if (profilerInterval) Profiler::output(profilerPath);
+	Trace::finalize();
+	if (!snapshotSavePath.isEmpty()) Snapshot::save(snapshotSavePath, diskFileList);
 	//
 	setRunning(0);
 	// Properly detach DiskFile
@@ -44,8 +44,11 @@ OF SUCH DAMAGE.
 #include "../agent/AgentNetwork.h"
 #include "../agent/AgentProcessor.h"
 #include "../agent/AgentStream.h"
+#include "../agent/InputQueue.h"
 
 #include "MesaThread.h"
+#include "Profiler.h"
+#include "Trace.h"
 
 class MesaProcessor {
 public:
@@ -78,9 +81,35 @@ public:
 		displayWidth  = displayWidth_;
 		displayHeight = displayHeight_;
 	}
+	// displayType_ is "monochrome" or "byteColor"
+	void setDisplayType(const QString& displayType_) {
+		displayType = displayType_;
+	}
 	void setNetworkInterfaceName(const QString& networkInterfaceName_) {
 		networkInterfaceName = networkInterfaceName_;
 	}
+	// Empty path means no record or no replay
+	void setInputRecordPath(const QString& inputRecordPath_) {
+		inputRecordPath = inputRecordPath_;
+	}
+	void setInputReplayPath(const QString& inputReplayPath_) {
+		inputReplayPath = inputReplayPath_;
+	}
+	// profilerInterval is sampling interval in microseconds. 0 means no profiling
+	void setProfiler(quint32 profilerInterval_, const QString& profilerPath_) {
+		profilerInterval = profilerInterval_;
+		profilerPath     = profilerPath_;
+	}
+	// traceMode is "none", "record" or "replay"
+	void setTrace(const QString& traceMode_, const QString& tracePath_) {
+		traceMode = traceMode_;
+		tracePath = tracePath_;
+	}
+	// Empty path means no save or no restore of snapshot
+	void setSnapshot(const QString& snapshotSavePath_, const QString& snapshotRestorePath_) {
+		snapshotSavePath    = snapshotSavePath_;
+		snapshotRestorePath = snapshotRestorePath_;
+	}
 
 	void setBootRequestPV(CARD16 deviceOrdinal = 0);
 	void setBootRequestEther(CARD16 deviceOrdinal = 0);
@@ -105,7 +134,16 @@ private:
 	int            rmBits;
 	CARD16         displayWidth;
 	CARD16         displayHeight;
+	QString        displayType;
 	QString        networkInterfaceName;
+	QString        inputRecordPath;
+	QString        inputReplayPath;
+	quint32        profilerInterval = 0;
+	QString        profilerPath;
+	QString        traceMode;
+	QString        tracePath;
+	QString        snapshotSavePath;
+	QString        snapshotRestorePath;
 
 	//
 	QList<DiskFile*> diskFileList;
@@ -130,6 +168,8 @@ private:
 	ProcessorThread processorThread;
 	InterruptThread interruptThread;
 	TimerThread     timerThread;
+	InputQueue::ReplayThread replayThread;
+	Profiler::SamplerThread  samplerThread;
 
 	QAtomicInt     running;
 
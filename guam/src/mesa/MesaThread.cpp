@@ -36,6 +36,7 @@ static log4cpp::Category& logger = Logger::getLogger("mesathread");
 
 #include "../agent/AgentNetwork.h"
 #include "../agent/AgentDisk.h"
+#include "../agent/InputQueue.h"
 
 #include "../simple-opcode/Interpreter.h"
 
@@ -46,6 +47,8 @@ static log4cpp::Category& logger = Logger::getLogger("mesathread");
 #include "Memory.h"
 
 #include "LoadState.h"
+#include "Profiler.h"
+#include "Trace.h"
 
 
 //
@@ -57,6 +60,7 @@ int            ProcessorThread::stopThread;
 int            ProcessorThread::rescheduleRequestCount;
 QAtomicInt     ProcessorThread::requestReschedule;
 QMutex         ProcessorThread::mutexRequestReschedule;
+QAtomicInt     ProcessorThread::requestHook;
 
 static int startRunningCount = 0;
 static int stopRunningCount = 0;
@@ -91,7 +95,7 @@ void ProcessorThread::run() {
 	logger.info("bootLink  %04X %d %04X  %08X", bootLink.data, bootLink.tag, bootLink.fill, bootLink.u);
 	if (!stopMessageUntilMPSet.isEmpty()) Logger::pushPriority(QtFatalMsg);
 
-	XFER(bootLink.u, 0, XT_call, 0);
+	if (!resumeThread) XFER(bootLink.u, 0, XT_call, 0);
 	logger.info("GFI = %04X  CB  = %08X  GF = %08X", GFI, CodeCache::CB(), GF);
 	logger.info("PC  = %04X  MDS = %08X  LF = %04X", PC, Memory::MDS(), LFCache::LF());
 
@@ -101,9 +105,27 @@ void ProcessorThread::run() {
 	try {
 		for(;;) {
 			try {
+				// Start from reschedule to wait until running, if state is restored from snapshot
+				if (resumeThread) {
+					resumeThread = 0;
+					ERROR_RequestReschedule();
+				}
 				if (DEBUG_STOP_AT_NOT_RUNNING) {
 					if (!getRunning()) ERROR();
 				}
+				// Test only requestHook while profiler and trace are idle
+				const int hook = getRequestHook();
+				if (hook) {
+					if (hook & REQUEST_HOOK_SAMPLE) {
+						changeRequestHook(0, REQUEST_HOOK_SAMPLE);
+						Profiler::sample();
+					}
+					if (hook & REQUEST_HOOK_TRACE) {
+						Trace::countInstruction();
+						// Request reschedule at same instruction of record
+						if (Trace::isReplay() && Trace::isSafePoint()) setRequestReschedule(REQUSEST_RESCHEDULE_INTERRUPT);
+					}
+				}
 				Interpreter::execute();
 			} catch(RequestReschedule& e) {
 				rescheduleCount++;
@@ -118,7 +140,8 @@ void ProcessorThread::run() {
 					}
 
 					// If not running, wait someone wake me up.
-					if (!getRunning()) {
+					//   In replay, recorded request is used instead of waiting.
+					if (!getRunning() && !Trace::isReplay()) {
 						//logger.debug("waitRunning START");
 						for(;;) {
 							bool ret = cvRunning.wait(&mutexRequestReschedule, WAIT_INTERVAL);
@@ -128,12 +151,18 @@ void ProcessorThread::run() {
 						}
 						//logger.debug("waitRunning FINISH");
 					}
+					// Reschedule is safe point to apply input event
+					InputQueue::apply();
+					// Reschedule is safe point to deliver received frame in trace
+					if (Trace::isEnabled()) {
+						((AgentNetwork*)Agent::getAgent(GuamInputOutput::network))->receiveThread.deliver();
+					}
 					// Do reschedule.
 					{
 						//logger.debug("reschedule START");
 						// to avoid race condition of update of rescheduleFlag, guard with mutexReschedule
 						int needReschedule = 0;
-						const int request = getRequestReschedule();
+						const int request = Trace::isEnabled() ? Trace::value(Trace::T_request, getRequestReschedule()) : getRequestReschedule();
 						if (request & REQUSEST_RESCHEDULE_INTERRUPT) {
 							//logger.debug("reschedule INTERRUPT");
 							// process interrupt
@@ -168,6 +197,8 @@ exitLoop:
 	AgentNetwork::ReceiveThread::stop();
 	AgentNetwork::TransmitThread::stop();
 	AgentDisk::IOThread::stop();
+	InputQueue::ReplayThread::stop();
+	Profiler::SamplerThread::stop();
 	TimerThread::stop();
 	InterruptThread::stop();
 
@@ -180,6 +211,7 @@ exitLoop:
 	logger.info("notifyWakeupCount      = %8u", notifyWakeupCount);
 	logger.info("startRunningCount      = %8u", startRunningCount);
 	logger.info("stopRunningCount       = %8u", stopRunningCount);
+	InputQueue::stats();
 	logger.info("ProcessorThread::run STOP");
 }
 void ProcessorThread::requestRescheduleTimer() {
@@ -192,10 +224,21 @@ void ProcessorThread::requestRescheduleInterrupt() {
 	setRequestReschedule(getRequestReschedule() | REQUSEST_RESCHEDULE_INTERRUPT);
 	if (!getRunning()) cvRunning.wakeOne();
 }
+void ProcessorThread::requestSample() {
+	changeRequestHook(REQUEST_HOOK_SAMPLE, 0);
+}
+void ProcessorThread::enableTrace(int enable) {
+	if (enable) {
+		changeRequestHook(REQUEST_HOOK_TRACE, 0);
+	} else {
+		changeRequestHook(0, REQUEST_HOOK_TRACE);
+	}
+}
 
 QSet<CARD16> ProcessorThread::stopAtMPSet;
 QSet<CARD16> ProcessorThread::stopMessageUntilMPSet;
 CARD16       ProcessorThread::mp = 0;
+int          ProcessorThread::resumeThread = 0;
 
 void ProcessorThread::stopAtMP(CARD16 newValue) {
 	stopAtMPSet += newValue;
@@ -220,6 +263,15 @@ void ProcessorThread::stopMessageUntilMP(CARD16 newValue) {
 	stopMessageUntilMPSet += newValue;
 	logger.info("stopMessageUntilMP %4d", newValue);
 }
+void ProcessorThread::resume(CARD16 mp_, int request) {
+	// Don't use setMP to avoid stop at MP of boot
+	mp = mp_;
+	resumeThread = 1;
+	// InterruptThread is not started yet and misses wake up of pending WP. Process it at first reschedule.
+	if (InterruptThread::getWP()) request |= REQUSEST_RESCHEDULE_INTERRUPT;
+	setRequestReschedule(request);
+	logger.info("resume at MP %4d  request = %d", mp, request);
+}
 
 
 //
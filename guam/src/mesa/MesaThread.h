@@ -135,9 +135,27 @@ public:
 	static void   setMP(CARD16 newValue);
 	static void   stopMessageUntilMP(CARD16 newValue);
 
+	// Resume execution from state restored from snapshot instead of boot
+	//   request is value of getRequestReschedule at save
+	static void   resume(CARD16 mp_, int request);
+
 	static void requestRescheduleTimer();
 	static void requestRescheduleInterrupt();
 
+	// Called from SamplerThread of Profiler. Sample is taken before execution of next instruction.
+	static void requestSample();
+	// Called from Trace when record or replay starts and stops. Instruction is counted only while enabled.
+	static void enableTrace(int enable);
+
+	// Processor thread tests only this value before execution of each instruction
+	static int getRequestHook() {
+#if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
+		return requestHook.loadAcquire();
+#else
+		return (int)requestHook;
+#endif
+	}
+
 	static int getRequestReschedule() {
 #if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
 		return requestReschedule.loadAcquire();
@@ -168,10 +186,23 @@ private:
 	static const int  REQUSEST_RESCHEDULE_INTERRUPT = 0x02;
 	static QAtomicInt requestReschedule;
 	static QMutex     mutexRequestReschedule;
+	//
+	static const int  REQUEST_HOOK_SAMPLE = 0x01;
+	static const int  REQUEST_HOOK_TRACE  = 0x02;
+	static QAtomicInt requestHook;
 
 	static QSet<CARD16> stopAtMPSet;
 	static QSet<CARD16> stopMessageUntilMPSet;
 	static CARD16       mp;
+	static int          resumeThread;
+
+	// Set and clear bits of requestHook. Both SamplerThread and processor thread update requestHook.
+	static int changeRequestHook(int set, int clear) {
+		for(;;) {
+			const int oldValue = getRequestHook();
+			if (requestHook.testAndSetOrdered(oldValue, (oldValue & ~clear) | set)) return oldValue;
+		}
+	}
 
 	static void setRequestReschedule(int newValue) {
 #if (QT_VERSION_CHECK(5, 0, 0) <= QT_VERSION)
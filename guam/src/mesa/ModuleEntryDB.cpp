@@ -0,0 +1,290 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// ModuleEntryDB.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("moduleEntryDB");
+
+#include "ModuleEntryDB.h"
+
+static const char    MAGIC[8] = {'G', 'U', 'A', 'M', 'M', 'E', 'D', 'B'};
+static const quint32 VERSION  = 1;
+static const int     HEADER_SIZE = sizeof(MAGIC) + 4 * 4;
+
+
+//
+// Build
+//
+static void append(QByteArray& data, quint32 value) {
+	uchar buffer[4];
+	qToLittleEndian(value, buffer);
+	data.append((const char*)buffer, sizeof(buffer));
+}
+
+class StringPool {
+public:
+	QByteArray                 data;
+	QHash<QByteArray, quint32> map;
+
+	quint32 intern(const QByteArray& value) {
+		if (map.contains(value)) return map[value];
+		quint32 ret = data.size();
+		data.append(value);
+		data.append('\0');
+		map.insert(value, ret);
+		return ret;
+	}
+};
+
+QByteArray ModuleEntryDB::buildImage(const QString& dirPath) {
+	// key is module version. If there are same version, last one wins.
+	QMap<QByteArray, QList<QByteArray>> moduleMap; // value is module name followed by entry name
+
+	QDirIterator i(dirPath);
+	while(i.hasNext()) {
+		QString path = i.next();
+
+		QFileInfo fileInfo(path);
+		if (fileInfo.isDir()) continue;
+
+		QFile file(path);
+		if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+			logger.fatal("path = %s", path.toLocal8Bit().constData());
+			logger.fatal("Unexpected errorString = %s", file.errorString().toLocal8Bit().constData());
+			ERROR();
+		}
+
+		// line is "version moduleName entryIndex entryName"
+		QByteArray version;
+		QList<QByteArray> nameList;
+		for(;;) {
+			if (file.atEnd()) break;
+			QByteArray line = file.readLine().trimmed();
+			if (line.isEmpty()) continue;
+
+			QList<QByteArray> token = line.split(' ');
+			if (token.size() != 4) {
+				logger.fatal("path = %s", path.toLocal8Bit().constData());
+				logger.fatal("Unexpected line = %s", line.constData());
+				ERROR();
+			}
+
+			// entryIndex starts from 0. nameList.at(0) is module name.
+			bool ok;
+			const int entryIndex = token.at(2).toUInt(&ok);
+			const int expected   = nameList.isEmpty() ? 0 : nameList.size() - 1;
+			if (!ok || entryIndex != expected) {
+				logger.fatal("path = %s", path.toLocal8Bit().constData());
+				logger.fatal("Unexpected line = %s", line.constData());
+				logger.fatal("entryIndex = %s!", token.at(2).constData());
+				ERROR();
+			}
+			if (nameList.isEmpty()) {
+				version = token.at(0);
+				nameList.append(token.at(1));
+			}
+			nameList.append(token.at(3));
+		}
+		if (nameList.isEmpty()) continue;
+
+		moduleMap.insert(version, nameList);
+	}
+
+	// Build each part of file
+	StringPool string;
+	QByteArray module;
+	QByteArray entry;
+	quint32    entryCount = 0;
+	for(QMap<QByteArray, QList<QByteArray>>::const_iterator j = moduleMap.constBegin(); j != moduleMap.constEnd(); ++j) {
+		const QList<QByteArray>& nameList = j.value();
+
+		append(module, string.intern(j.key()));
+		append(module, string.intern(nameList.at(0)));
+		append(module, entryCount);
+		append(module, nameList.size() - 1);
+
+		for(int k = 1; k < nameList.size(); k++) {
+			append(entry, string.intern(nameList.at(k)));
+			entryCount++;
+		}
+	}
+
+	QByteArray ret(MAGIC, sizeof(MAGIC));
+	append(ret, VERSION);
+	append(ret, moduleMap.size());
+	append(ret, entryCount);
+	append(ret, string.data.size());
+	ret.append(module);
+	ret.append(entry);
+	ret.append(string.data);
+
+	logger.info("Build module entry database  %s  module %d  entry %d  string %d",
+		qPrintable(dirPath), moduleMap.size(), entryCount, string.data.size());
+	return ret;
+}
+
+void ModuleEntryDB::build(const QString& dirPath, const QString& dbPath) {
+	QByteArray image = buildImage(dirPath);
+
+	QFile file(dbPath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		logger.fatal("Cannot open module entry database  %s", qPrintable(dbPath));
+		ERROR();
+	}
+	file.write(image);
+	file.close();
+}
+
+
+//
+// Open and lookup
+//
+ModuleEntryDB::~ModuleEntryDB() {
+	close();
+}
+
+void ModuleEntryDB::close() {
+	if (map) file.unmap(map);
+	if (file.isOpen()) file.close();
+	map         = 0;
+	image.clear();
+	moduleCount = 0;
+	entryCount  = 0;
+	stringSize  = 0;
+	module      = 0;
+	entry       = 0;
+	string      = 0;
+}
+
+bool ModuleEntryDB::open(const QString& dbPath) {
+	close();
+
+	file.setFileName(dbPath);
+	if (!file.exists()) return false;
+	if (!file.open(QIODevice::ReadOnly)) {
+		logger.warn("Cannot open module entry database  %s", qPrintable(dbPath));
+		close();
+		return false;
+	}
+	const qint64 fileSize = file.size();
+	map = file.map(0, fileSize);
+	if (map == 0) {
+		logger.warn("file.map returns 0.  error  = %s", qPrintable(file.errorString()));
+		close();
+		return false;
+	}
+	if (!attach(map, fileSize, dbPath)) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ModuleEntryDB::load(const QString& dirPath) {
+	close();
+
+	image = buildImage(dirPath);
+	if (!attach((const uchar*)image.constData(), image.size(), dirPath)) {
+		logger.fatal("Unexpected module entry database built from  %s", qPrintable(dirPath));
+		ERROR();
+	}
+}
+
+bool ModuleEntryDB::attach(const uchar* data, qint64 dataSize, const QString& name) {
+	if (dataSize < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+		logger.warn("Unexpected magic of module entry database  %s", qPrintable(name));
+		return false;
+	}
+	const uchar* p = data + sizeof(MAGIC);
+	if (qFromLittleEndian<quint32>(p) != VERSION) {
+		logger.warn("Unexpected version of module entry database  %s", qPrintable(name));
+		return false;
+	}
+	moduleCount = qFromLittleEndian<quint32>(p + 4);
+	entryCount  = qFromLittleEndian<quint32>(p + 8);
+	stringSize  = qFromLittleEndian<quint32>(p + 12);
+	if ((quint64)dataSize != HEADER_SIZE + (quint64)moduleCount * MODULE_SIZE + (quint64)entryCount * 4 + stringSize) {
+		logger.warn("Unexpected size of module entry database  %s  %lld", qPrintable(name), (long long)dataSize);
+		return false;
+	}
+	module = data + HEADER_SIZE;
+	entry  = module + moduleCount * MODULE_SIZE;
+	string = (const char*)(entry + entryCount * 4);
+
+	// Sanity check of offset, so that lookup doesn't need to check
+	if (stringSize == 0 || string[stringSize - 1] != 0) {
+		logger.warn("Unexpected string of module entry database  %s", qPrintable(name));
+		return false;
+	}
+	for(quint32 i = 0; i < moduleCount; i++) {
+		if (stringSize <= getModuleValue(i, OFFSET_VERSION) || stringSize <= getModuleValue(i, OFFSET_NAME) ||
+			entryCount < (quint64)getModuleValue(i, OFFSET_ENTRY_BASE) + getModuleValue(i, OFFSET_ENTRY_COUNT)) {
+			logger.warn("Unexpected module %d of module entry database  %s", i, qPrintable(name));
+			return false;
+		}
+	}
+	for(quint32 i = 0; i < entryCount; i++) {
+		if (stringSize <= qFromLittleEndian<quint32>(entry + i * 4)) {
+			logger.warn("Unexpected entry %d of module entry database  %s", i, qPrintable(name));
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int ModuleEntryDB::find(const QString& version) const {
+	const QByteArray key = version.toLatin1();
+
+	// binary search of module sorted by version
+	int lo = 0;
+	int hi = (int)moduleCount;
+	while(lo < hi) {
+		const int mid = (lo + hi) / 2;
+		const int cmp = strcmp(getVersion(mid), key.constData());
+		if (cmp == 0) return mid;
+		if (cmp < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return -1;
+}
+
+const char* ModuleEntryDB::getEntryName(int index, quint32 entryIndex) const {
+	if (getEntryCount(index) <= entryIndex) {
+		logger.fatal("Unexpected entryIndex %d  %s", entryIndex, qPrintable(toString(index)));
+		ERROR();
+	}
+	const quint32 entryBase = getModuleValue(index, OFFSET_ENTRY_BASE);
+	return string + qFromLittleEndian<quint32>(entry + (entryBase + entryIndex) * 4);
+}
@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// ModuleEntryDB.h
+//
+
+#ifndef MODULEENTRYDB_H__
+#define MODULEENTRYDB_H__
+
+#include <QtCore>
+
+//
+// ModuleEntryDB is binary database of entry name of module used by getProcedureName.
+//   Built once from text output of moduleEntry (tmp/moduleEntry/) by moduleEntryDB tool.
+//   Loaded by mapping the file. Lookup reads the mapped file directly without parsing.
+//   If the file is missing or invalid, load builds same image in memory from the text files.
+//
+// Format of database file  -- all value is little endian quint32
+//   header   MAGIC(8) VERSION moduleCount entryCount stringSize
+//   module   version name entryBase entryCount     -- moduleCount records sorted by version
+//   entry    name                                  -- entryCount records in order of entryIndex
+//   string   NUL terminated string                 -- string is interned, name is offset in string
+//
+class ModuleEntryDB {
+public:
+	ModuleEntryDB() : map(0), moduleCount(0), entryCount(0), stringSize(0), module(0), entry(0), string(0) {}
+	~ModuleEntryDB();
+
+	// Build database file from text files in dirPath
+	static void build(const QString& dirPath, const QString& dbPath);
+
+	// Returns false if file does not exist or is not valid
+	bool open(const QString& dbPath);
+	// Build database in memory from text files in dirPath
+	void load(const QString& dirPath);
+	void close();
+
+	int size() const {
+		return (int)moduleCount;
+	}
+	// Returns module of version. Returns -1 if not found
+	int find(const QString& version) const;
+
+	const char* getVersion(int index) const {
+		return getString(index, OFFSET_VERSION);
+	}
+	const char* getModuleName(int index) const {
+		return getString(index, OFFSET_NAME);
+	}
+	quint32 getEntryCount(int index) const {
+		return getModuleValue(index, OFFSET_ENTRY_COUNT);
+	}
+	const char* getEntryName(int index, quint32 entryIndex) const;
+
+	QString toString(int index) const {
+		return QString("%1 %2 %3").arg(getVersion(index)).arg(getModuleName(index)).arg(getEntryCount(index));
+	}
+
+private:
+	ModuleEntryDB(const ModuleEntryDB&) = delete;
+	ModuleEntryDB& operator=(const ModuleEntryDB&) = delete;
+
+	static const int MODULE_SIZE        = 16;
+	static const int OFFSET_VERSION     = 0;
+	static const int OFFSET_NAME        = 4;
+	static const int OFFSET_ENTRY_BASE  = 8;
+	static const int OFFSET_ENTRY_COUNT = 12;
+
+	static QByteArray buildImage(const QString& dirPath);
+	// Check header and offset of data, and set pointer to each part
+	bool attach(const uchar* data, qint64 dataSize, const QString& name);
+
+	quint32 getModuleValue(int index, int offset) const {
+		return qFromLittleEndian<quint32>(module + index * MODULE_SIZE + offset);
+	}
+	const char* getString(int index, int offset) const {
+		return string + getModuleValue(index, offset);
+	}
+
+	QFile        file;
+	uchar*       map;
+	QByteArray   image; // used by load
+	quint32      moduleCount;
+	quint32      entryCount;
+	quint32      stringSize;
+	const uchar* module;
+	const uchar* entry;
+	const char*  string;
+};
+
+#endif
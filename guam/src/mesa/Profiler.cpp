@@ -0,0 +1,213 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Profiler.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("profiler");
+
+#include "Type.h"
+#include "Variable.h"
+#include "Memory.h"
+#include "LoadState.h"
+#include "MesaThread.h"
+#include "Profiler.h"
+
+
+//
+// SamplerThread
+//
+int Profiler::SamplerThread::stopThread;
+
+void Profiler::SamplerThread::stop() {
+	logger.info("Profiler::SamplerThread::stop");
+	stopThread = 1;
+}
+void Profiler::SamplerThread::run() {
+	logger.info("Profiler::SamplerThread::run START  interval = %u usec", interval);
+	QThread::currentThread()->setPriority(PRIORITY);
+
+	stopThread = 0;
+	for(;;) {
+		if (stopThread) break;
+		QThread::usleep(interval);
+		ProcessorThread::requestSample();
+	}
+	logger.info("Profiler::SamplerThread::run STOP");
+}
+
+
+//
+// Profiler
+//
+long long             Profiler::sampleCount    = 0;
+long long             Profiler::truncatedCount = 0;
+QMap<QByteArray, int> Profiler::stackMap;
+
+// Read word in MDS without fault and without changing flags of page
+static int peekMds(CARD16 ptr, CARD16& value) {
+	const CARD32 va = Memory::lengthenPointer(ptr);
+	if (Memory::isVacant(va)) return 0;
+	value = *Memory::getAddress(va);
+	return 1;
+}
+
+void Profiler::sample() {
+	CARD32 frame[MAX_DEPTH];
+	int depth = 0;
+
+	frame[depth++] = (GFI << WordSize) | PC;
+	CARD16 lf = LFCache::LF();
+	for(;;) {
+		if (depth == MAX_DEPTH) {
+			truncatedCount++;
+			break;
+		}
+		CARD16 link;
+		if (!peekMds(LO_OFFSET(lf, returnlink), link)) break;
+		if (link == 0 || ControlLinkType(link) != LT_frame) break;
+		lf = link;
+
+		CARD16 gfi;
+		CARD16 pc;
+		if (!peekMds(LO_OFFSET(lf, globallink), gfi)) break;
+		if (!peekMds(LO_OFFSET(lf, pc), pc)) break;
+		frame[depth++] = (gfi << WordSize) | pc;
+	}
+
+	sampleCount++;
+	stackMap[QByteArray((const char*)frame, depth * sizeof(CARD32))]++;
+}
+
+static void writeFile(const QString& path, const QStringList& lines) {
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		logger.fatal("path = %s", qPrintable(path));
+		logger.fatal("Unexpected errorString = %s", qPrintable(file.errorString()));
+		ERROR();
+	}
+	QTextStream out(&file);
+	for(const QString& line: lines) {
+		out << line << "\n";
+	}
+	file.close();
+	logger.info("%s %s %d", __FUNCTION__, qPrintable(path), lines.size());
+}
+
+void Profiler::output(const QString& path) {
+	logger.info("Profiler  sample %10lld  truncated %10lld  stack %6d", sampleCount, truncatedCount, stackMap.size());
+	if (sampleCount == 0) return;
+
+	// Update module info of load state. Names become hex value if load state is not available.
+	try {
+		scanLoadState();
+		waitScanLoadState();
+	} catch (...) {
+		logger.warn("Failed to scan load state");
+	}
+
+	QMap<CARD32, QString> nameMap; // key is GFI << 16 | PC
+	QMap<QString, long long> selfMap;
+	QMap<QString, long long> totalMap;
+	QMap<QString, long long> edgeMap;   // key is "caller -> callee"
+	QMap<QString, long long> foldedMap; // key is "outer;...;inner"
+
+	for(QMap<QByteArray, int>::const_iterator i = stackMap.constBegin(); i != stackMap.constEnd(); i++) {
+		const CARD32* frame = (const CARD32*)i.key().constData();
+		const int     depth = i.key().size() / sizeof(CARD32);
+		const int     count = i.value();
+
+		QStringList names;
+		for(int j = 0; j < depth; j++) {
+			if (!nameMap.contains(frame[j])) {
+				nameMap[frame[j]] = getProcedureName((CARD16)(frame[j] >> WordSize), (CARD16)frame[j]);
+			}
+			names.append(nameMap[frame[j]]);
+		}
+
+		selfMap[names[0]] += count;
+		// count procedure once for each sample even if it appears in recursion
+		QSet<QString> done;
+		for(const QString& name: names) {
+			if (done.contains(name)) continue;
+			done.insert(name);
+			totalMap[name] += count;
+		}
+		for(int j = 1; j < depth; j++) {
+			edgeMap[QString("%1 -> %2").arg(names[j]).arg(names[j - 1])] += count;
+		}
+		QStringList folded;
+		for(int j = depth - 1; 0 <= j; j--) {
+			folded.append(names[j]);
+		}
+		foldedMap[folded.join(";")] += count;
+	}
+
+	// flat profile sorted by self count
+	{
+		QMultiMap<long long, QString> sortMap;
+		for(QMap<QString, long long>::const_iterator i = totalMap.constBegin(); i != totalMap.constEnd(); i++) {
+			sortMap.insert(selfMap.value(i.key(), 0), i.key());
+		}
+		QStringList lines;
+		lines.append(QString("%1 %2 %3 %4  %5").arg("self", 10).arg("%", 6).arg("total", 10).arg("%", 6).arg("name"));
+		for(QMultiMap<long long, QString>::const_iterator i = sortMap.constEnd(); i != sortMap.constBegin();) {
+			--i;
+			const long long self  = i.key();
+			const long long total = totalMap[i.value()];
+			lines.append(QString("%1 %2 %3 %4  %5").arg(self, 10).arg((self * 100.0) / sampleCount, 6, 'f', 2)
+				.arg(total, 10).arg((total * 100.0) / sampleCount, 6, 'f', 2).arg(i.value()));
+		}
+		writeFile(path + ".flat", lines);
+	}
+
+	// call graph as list of edge sorted by count
+	{
+		QMultiMap<long long, QString> sortMap;
+		for(QMap<QString, long long>::const_iterator i = edgeMap.constBegin(); i != edgeMap.constEnd(); i++) {
+			sortMap.insert(i.value(), i.key());
+		}
+		QStringList lines;
+		for(QMultiMap<long long, QString>::const_iterator i = sortMap.constEnd(); i != sortMap.constBegin();) {
+			--i;
+			lines.append(QString("%1  %2").arg(i.key(), 10).arg(i.value()));
+		}
+		writeFile(path + ".graph", lines);
+	}
+
+	// folded stack for flame graph
+	{
+		QStringList lines;
+		for(QMap<QString, long long>::const_iterator i = foldedMap.constBegin(); i != foldedMap.constEnd(); i++) {
+			lines.append(QString("%1 %2").arg(i.key()).arg(i.value()));
+		}
+		writeFile(path + ".folded", lines);
+	}
+}
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Profiler.h
+//
+
+#ifndef PROFILER_H__
+#define PROFILER_H__
+
+#include "MesaBasic.h"
+
+#include <QtCore>
+
+//
+// Sampling profiler of Mesa code
+//   SamplerThread requests sample at every interval with ProcessorThread::requestSample. Processor thread takes
+//   sample of GFI and PC at safe point (before execution of opcode), and walks returnlink chain for call graph.
+//   Samples are resolved to module and procedure name with LoadState at output time.
+//
+class Profiler {
+public:
+	// Maximum depth of returnlink chain
+	static const int MAX_DEPTH = 64;
+
+	class SamplerThread : public QRunnable {
+	public:
+		static const QThread::Priority PRIORITY = QThread::HighPriority;
+
+		static void stop();
+
+		// interval is sampling interval in microseconds
+		void setInterval(quint32 interval_) {
+			interval = interval_;
+		}
+		void run();
+
+	private:
+		static int stopThread;
+		quint32    interval;
+	};
+
+	// Called from processor thread
+	static void sample();
+
+	// Write path + ".flat", path + ".graph" and path + ".folded"
+	static void output(const QString& path);
+
+private:
+	static long long             sampleCount;
+	static long long             truncatedCount;
+	// key is array of frame (GFI << 16 | PC), innermost frame comes first
+	static QMap<QByteArray, int> stackMap;
+};
+
+#endif
@@ -0,0 +1,274 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Snapshot.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("snapshot");
+
+#include "../agent/Agent.h"
+#include "../agent/InputQueue.h"
+
+#include "Memory.h"
+#include "MesaThread.h"
+#include "Function.h"
+#include "Variable.h"
+#include "Snapshot.h"
+
+static const char    MAGIC[8] = {'G', 'U', 'A', 'M', 'S', 'N', 'A', 'P'};
+static const quint32 VERSION  = 2;
+
+static void writeSection(QFile& file, const char* tag, const QByteArray& contents) {
+	const QByteArray data = qCompress(contents);
+	const quint32    size = qToLittleEndian((quint32)data.size());
+	file.write(tag, 4);
+	file.write((const char*)&size, sizeof(size));
+	file.write(data);
+}
+
+// Uncompress section at p, and advance p to next section
+static QByteArray readSection(const uchar*& p, const uchar* end, const char* tag) {
+	if ((end - p) < 8) {
+		logger.fatal("Unexpected end of snapshot  expect = %s", tag);
+		ERROR();
+	}
+	if (memcmp(p, tag, 4) != 0) {
+		logger.fatal("Unexpected section  expect = %s  actual = %.4s", tag, (const char*)p);
+		ERROR();
+	}
+	quint32 size;
+	memcpy(&size, p + 4, sizeof(size));
+	size = qFromLittleEndian(size);
+	p += 8;
+	if ((quint64)(end - p) < size) {
+		logger.fatal("Unexpected size of section  %s  size = %d", tag, size);
+		ERROR();
+	}
+	const QByteArray ret = qUncompress(p, size);
+	p += size;
+	return ret;
+}
+
+void Snapshot::save(const QString& path, const QList<DiskFile*>& diskFileList) {
+	QElapsedTimer timer;
+	timer.start();
+
+	// Agent completes pending request. So save agent before memory and registers.
+	const QByteArray agent = Agent::SaveAgent();
+	// Link frames held by AVCache to AV
+	AVCache::invalidate();
+
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		logger.fatal("Cannot open snapshot file  %s", qPrintable(path));
+		ERROR();
+	}
+	const quint32 version = qToLittleEndian(VERSION);
+	file.write(MAGIC, sizeof(MAGIC));
+	file.write((const char*)&version, sizeof(version));
+
+	const CARD32 vpSize = Memory::getVPSize();
+	const CARD32 rpSize = Memory::getRPSize();
+	{
+		QByteArray data;
+		QDataStream out(&data, QIODevice::WriteOnly);
+		out << (quint32)vpSize << (quint32)rpSize;
+		out << (quint16)Memory::getDisplayType() << (quint32)Memory::getDisplayPageSize() << (quint32)Memory::getDisplayRealPage();
+		writeSection(file, "CONF", data);
+	}
+	{
+		QByteArray data;
+		QDataStream out(&data, QIODevice::WriteOnly);
+		out << (quint16)PSB << (quint32)Memory::MDS() << (quint16)LFCache::LF() << (quint32)GF << (quint32)CodeCache::CB();
+		out << (quint16)PC << (quint16)GFI << (quint16)savedPC << (quint16)savedSP << (quint8)breakByte;
+		out << (quint16)SP;
+		for(int i = 0; i < StackDepth; i++) out << (quint16)stack[i];
+		out << (quint16)XTS;
+		for(int i = 0; i < 4; i++) out << (quint16)PID[i];
+		out << (quint16)InterruptThread::getWP() << (quint16)InterruptThread::getWDC() << (quint16)TimerThread::getPTC();
+		out << (quint16)ProcessorThread::getRunning() << (quint16)ProcessorThread::getMP();
+		out << (quint32)Memory::getDisplayVirtualPage();
+		out << (quint16)FST << (quint16)ProcessorThread::getRequestReschedule();
+		writeSection(file, "REGS", data);
+	}
+	writeSection(file, "MAPS", QByteArray::fromRawData((const char*)Memory::getMaps(), vpSize * sizeof(Memory::Map)));
+	writeSection(file, "AGNT", agent);
+	writeSection(file, "INPQ", InputQueue::save());
+	{
+		QByteArray data;
+		QDataStream out(&data, QIODevice::WriteOnly);
+		out << (quint32)diskFileList.size();
+		for(DiskFile* diskFile: diskFileList) {
+			out << (quint32)diskFile->getBlockSize() << (quint64)diskFile->getHash();
+		}
+		writeSection(file, "DISK", data);
+	}
+	const CARD16* pages = Memory::getRealMemory();
+	for(CARD32 rp = 0; rp < rpSize; rp += BLOCK_SIZE) {
+		const CARD32 count = qMin((CARD32)BLOCK_SIZE, rpSize - rp);
+		writeSection(file, "PAGE", QByteArray::fromRawData((const char*)(pages + rp * PageSize), count * PageSize * sizeof(CARD16)));
+	}
+
+	logger.info("Save snapshot  %s  size = %lld  MP = %d  %lld ms", qPrintable(path), (long long)file.size(), ProcessorThread::getMP(), timer.elapsed());
+	file.close();
+}
+
+void Snapshot::restore(const QString& path, const QList<DiskFile*>& diskFileList) {
+	QElapsedTimer timer;
+	timer.start();
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		logger.fatal("Cannot open snapshot file  %s", qPrintable(path));
+		ERROR();
+	}
+	const qint64 fileSize = file.size();
+	uchar* map = file.map(0, fileSize);
+	if (map == 0) {
+		logger.fatal("file.map returns 0.  error  = %s", qPrintable(file.errorString()));
+		ERROR();
+	}
+	const uchar* p   = map;
+	const uchar* end = map + fileSize;
+
+	{
+		quint32 version;
+		if (fileSize < (qint64)(sizeof(MAGIC) + sizeof(version)) || memcmp(p, MAGIC, sizeof(MAGIC)) != 0) {
+			logger.fatal("Unexpected magic of snapshot file  %s", qPrintable(path));
+			ERROR();
+		}
+		memcpy(&version, p + sizeof(MAGIC), sizeof(version));
+		if (qFromLittleEndian(version) != VERSION) {
+			logger.fatal("Unexpected version of snapshot file  %s", qPrintable(path));
+			ERROR();
+		}
+		p += sizeof(MAGIC) + sizeof(version);
+	}
+
+	const CARD32 vpSize = Memory::getVPSize();
+	const CARD32 rpSize = Memory::getRPSize();
+	{
+		QDataStream in(readSection(p, end, "CONF"));
+		quint32 vpSize_, rpSize_, displayPageSize, displayRealPage;
+		quint16 displayType;
+		in >> vpSize_ >> rpSize_ >> displayType >> displayPageSize >> displayRealPage;
+		if (vpSize_ != vpSize || rpSize_ != rpSize || displayType != Memory::getDisplayType() ||
+			displayPageSize != Memory::getDisplayPageSize() || displayRealPage != Memory::getDisplayRealPage()) {
+			logger.fatal("Unexpected configuration of snapshot");
+			logger.fatal("  vpSize = %6X  rpSize = %6X  displayType = %d  displayPageSize = %4X", vpSize_, rpSize_, displayType, displayPageSize);
+			logger.fatal("  vpSize = %6X  rpSize = %6X  displayType = %d  displayPageSize = %4X", vpSize, rpSize, Memory::getDisplayType(), Memory::getDisplayPageSize());
+			ERROR();
+		}
+	}
+	const QByteArray regs = readSection(p, end, "REGS");
+	{
+		const QByteArray data = readSection(p, end, "MAPS");
+		if ((CARD32)data.size() != vpSize * sizeof(Memory::Map)) ERROR();
+		memcpy(Memory::getMaps(), data.constData(), data.size());
+	}
+	const QByteArray agent = readSection(p, end, "AGNT");
+	InputQueue::restore(readSection(p, end, "INPQ"));
+	{
+		QDataStream in(readSection(p, end, "DISK"));
+		quint32 size;
+		in >> size;
+		if (size != (quint32)diskFileList.size()) {
+			logger.fatal("Unexpected number of disk  %d  %d", size, diskFileList.size());
+			ERROR();
+		}
+		for(DiskFile* diskFile: diskFileList) {
+			quint32 blockSize;
+			quint64 hash;
+			in >> blockSize >> hash;
+			if (blockSize != diskFile->getBlockSize() || hash != diskFile->getHash()) {
+				logger.fatal("Disk image is different from snapshot  %s", qPrintable(diskFile->getPath()));
+				ERROR();
+			}
+		}
+	}
+	CARD16* pages = Memory::getRealMemory();
+	for(CARD32 rp = 0; rp < rpSize; rp += BLOCK_SIZE) {
+		const CARD32     count = qMin((CARD32)BLOCK_SIZE, rpSize - rp);
+		const QByteArray data  = readSection(p, end, "PAGE");
+		if ((CARD32)data.size() != count * PageSize * sizeof(CARD16)) ERROR();
+		memcpy(pages + rp * PageSize, data.constData(), data.size());
+	}
+	file.unmap(map);
+	file.close();
+
+	// Contents of memory is replaced
+	Memory::invalidateCache();
+	InvalidateProcessCache();
+
+	CARD16 mp;
+	quint16 request;
+	{
+		QDataStream in(regs);
+		quint32 mds, gf, cb, displayVirtualPage;
+		quint16 fst, psb, lf, pc, gfi, savedPC_, savedSP_, sp, xts, wp, wdc, ptc, running;
+		quint8  breakByte_;
+		in >> psb >> mds >> lf >> gf >> cb;
+		in >> pc >> gfi >> savedPC_ >> savedSP_ >> breakByte_;
+		in >> sp;
+		for(int i = 0; i < StackDepth; i++) in >> stack[i];
+		in >> xts;
+		for(int i = 0; i < 4; i++) in >> PID[i];
+		in >> wp >> wdc >> ptc;
+		in >> running >> mp;
+		in >> displayVirtualPage;
+		in >> fst >> request;
+
+		PSB       = psb;
+		Memory::setMDS(mds);
+		GF        = gf;
+		GFI       = gfi;
+		PC        = pc;
+		savedPC   = savedPC_;
+		savedSP   = savedSP_;
+		breakByte = breakByte_;
+		SP        = sp;
+		XTS       = xts;
+		FST       = fst;
+		CodeCache::setCB(cb);
+		LFCache::setLF(lf);
+		Memory::setDisplayVirtualPage(displayVirtualPage);
+
+		InterruptThread::setWP(wp);
+		InterruptThread::setWDC(wdc);
+		TimerThread::setPTC(ptc);
+		if (running && !ProcessorThread::getRunning()) ProcessorThread::startRunning();
+		if (!running && ProcessorThread::getRunning()) ProcessorThread::stopRunning();
+	}
+
+	Agent::RestoreAgent(agent);
+	ProcessorThread::resume(mp, request);
+
+	logger.info("Restore snapshot  %s  size = %lld  MP = %d  %lld ms", qPrintable(path), fileSize, mp, timer.elapsed());
+}
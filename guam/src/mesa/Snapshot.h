@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Snapshot.h
+//
+
+#ifndef SNAPSHOT_H__
+#define SNAPSHOT_H__
+
+#include "MesaBasic.h"
+
+#include "../agent/DiskFile.h"
+
+#include <QtCore>
+
+//
+// Snapshot saves whole state of emulator to file, and restores it to start from saved state instead of boot.
+//   Saved state is registers, pending reschedule request, map, real memory, host side state of agent
+//   and pending input event.
+//   Disk image is not saved. Restore checks size and hash of sampled blocks of disk image, so use copy of
+//   disk image taken at save.
+//
+// Format of snapshot file
+//   header   MAGIC(8) VERSION(4)
+//   section  tag(4) size(4) data(size)  -- data is qCompress of contents
+//   Sections are CONF REGS MAPS AGNT INPQ DISK followed by PAGE for each BLOCK_SIZE pages of real memory.
+//   Restore maps the file, uncompresses each section to QByteArray and copies it into place.
+//
+class Snapshot {
+public:
+	// Number of real page in one PAGE section
+	static const CARD32 BLOCK_SIZE = 256;
+
+	// Called after all threads are stopped
+	static void save(const QString& path, const QList<DiskFile*>& diskFileList);
+	// Called after initialization of memory and agent, and before start of threads
+	static void restore(const QString& path, const QList<DiskFile*>& diskFileList);
+};
+
+#endif
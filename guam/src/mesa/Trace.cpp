@@ -0,0 +1,294 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Trace.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("trace");
+
+#include "MesaThread.h"
+#include "Trace.h"
+
+static const char    MAGIC[8] = {'G', 'U', 'A', 'M', 'T', 'R', 'C', 'E'};
+static const quint32 VERSION  = 1;
+
+Trace::Mode         Trace::mode             = M_none;
+quint64             Trace::instructionCount = 0;
+QFile*              Trace::file             = 0;
+long long           Trace::eventCount       = 0;
+long long           Trace::chunkCount       = 0;
+
+QByteArray          Trace::writeBuffer;
+quint64             Trace::writeCount       = 0;
+
+QByteArray          Trace::readBuffer;
+int                 Trace::readPosition     = 0;
+quint64             Trace::readCount        = 0;
+QList<Trace::Event> Trace::lookahead;
+quint64             Trace::safePoint        = 0;
+int                 Trace::safePointValid   = 0;
+
+static void putVarint(QByteArray& buffer, quint64 value) {
+	while(0x80 <= value) {
+		buffer.append((char)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	buffer.append((char)value);
+}
+static int getVarint(const QByteArray& buffer, int& position, quint64& value) {
+	value = 0;
+	for(int shift = 0; shift < 64; shift += 7) {
+		if (buffer.size() <= position) return 0;
+		const quint8 c = (quint8)buffer[position++];
+		value |= (quint64)(c & 0x7f) << shift;
+		if ((c & 0x80) == 0) return 1;
+	}
+	return 0;
+}
+
+void Trace::initialize(const QString& mode_, const QString& path) {
+	instructionCount = 0;
+	eventCount       = 0;
+	chunkCount       = 0;
+	writeBuffer.clear();
+	writeCount       = 0;
+	readBuffer.clear();
+	readPosition     = 0;
+	readCount        = 0;
+	lookahead.clear();
+	safePointValid   = 0;
+
+	if (mode_.isEmpty() || mode_ == "none") {
+		setMode(M_none);
+		return;
+	}
+	if (mode_ == "record") {
+		file = new QFile(path);
+		if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			logger.fatal("Cannot open trace file  %s", qPrintable(path));
+			ERROR();
+		}
+		const quint32 version = qToLittleEndian(VERSION);
+		file->write(MAGIC, sizeof(MAGIC));
+		file->write((const char*)&version, sizeof(version));
+		setMode(M_record);
+	} else if (mode_ == "replay") {
+		file = new QFile(path);
+		if (!file->open(QIODevice::ReadOnly)) {
+			logger.fatal("Cannot open trace file  %s", qPrintable(path));
+			ERROR();
+		}
+		char    magic[sizeof(MAGIC)];
+		quint32 version;
+		if (file->read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+			logger.fatal("Unexpected magic of trace file  %s", qPrintable(path));
+			ERROR();
+		}
+		if (file->read((char*)&version, sizeof(version)) != sizeof(version) || qFromLittleEndian(version) != VERSION) {
+			logger.fatal("Unexpected version of trace file  %s", qPrintable(path));
+			ERROR();
+		}
+		setMode(M_replay);
+	} else {
+		logger.fatal("Unknown mode = %s", qPrintable(mode_));
+		ERROR();
+	}
+	logger.info("Trace %s %s", qPrintable(mode_), qPrintable(path));
+}
+
+void Trace::setMode(Mode newValue) {
+	mode = newValue;
+	ProcessorThread::enableTrace(mode != M_none);
+}
+
+void Trace::finalize() {
+	if (file == 0) return;
+	if (isRecord()) writeChunk();
+	logger.info("Trace  instruction %10llu  event %10lld  chunk %6lld  file %10lld", instructionCount, eventCount, chunkCount, (long long)file->size());
+	file->close();
+	delete file;
+	file = 0;
+	setMode(M_none);
+}
+
+
+//
+// Record
+//
+void Trace::record(Type type, const QByteArray& data) {
+	putVarint(writeBuffer, instructionCount - writeCount);
+	writeCount = instructionCount;
+	writeBuffer.append((char)type);
+	putVarint(writeBuffer, data.size());
+	writeBuffer.append(data);
+	eventCount++;
+
+	if (CHUNK_SIZE <= writeBuffer.size()) writeChunk();
+}
+void Trace::writeChunk() {
+	if (writeBuffer.isEmpty()) return;
+	const QByteArray chunk = qCompress(writeBuffer);
+	const quint32    size  = qToLittleEndian((quint32)chunk.size());
+	file->write((const char*)&size, sizeof(size));
+	file->write(chunk);
+	// Flush each chunk, so that trace is available even if emulator is killed
+	file->flush();
+	writeBuffer.clear();
+	chunkCount++;
+}
+
+
+//
+// Replay
+//
+int Trace::readChunk() {
+	quint32 size;
+	if (file->read((char*)&size, sizeof(size)) != sizeof(size)) return 0;
+	size = qFromLittleEndian(size);
+	const QByteArray chunk = file->read(size);
+	if (chunk.size() != (int)size) {
+		logger.warn("Truncated chunk  size = %d  read = %d", size, chunk.size());
+		return 0;
+	}
+	readBuffer = qUncompress(chunk);
+	if (readBuffer.isEmpty()) {
+		logger.fatal("Unexpected chunk  %lld", chunkCount);
+		ERROR();
+	}
+	readPosition = 0;
+	chunkCount++;
+	return 1;
+}
+int Trace::readEvent() {
+	if (readBuffer.size() <= readPosition) {
+		if (!readChunk()) return 0;
+	}
+	Event   event;
+	quint64 delta;
+	quint64 size;
+	if (!getVarint(readBuffer, readPosition, delta)) ERROR();
+	if (readBuffer.size() <= readPosition) ERROR();
+	event.type = (quint8)readBuffer[readPosition++];
+	if (!getVarint(readBuffer, readPosition, size)) ERROR();
+	if ((quint64)(readBuffer.size() - readPosition) < size) ERROR();
+	event.data   = readBuffer.mid(readPosition, (int)size);
+	readPosition += (int)size;
+	event.count  = readCount + delta;
+	readCount    = event.count;
+
+	lookahead.append(event);
+	return 1;
+}
+int Trace::nextEvent(Type type, QByteArray& data) {
+	if (lookahead.isEmpty() && !readEvent()) {
+		endOfTrace();
+		return 0;
+	}
+	const Event& event = lookahead.first();
+	if (event.count != instructionCount || event.type != type) return 0;
+
+	data = event.data;
+	lookahead.removeFirst();
+	if (type == T_request) safePointValid = 0;
+	eventCount++;
+	return 1;
+}
+int Trace::isSafePoint() {
+	if (!safePointValid) {
+		// find next T_request
+		safePoint = ~(quint64)0;
+		for(int i = 0;; i++) {
+			if (i == lookahead.size() && !readEvent()) break;
+			if (lookahead[i].type == T_request) {
+				safePoint = lookahead[i].count;
+				break;
+			}
+		}
+		safePointValid = 1;
+	}
+	return safePoint == instructionCount;
+}
+int Trace::replay(Type type, QByteArray& data) {
+	if (!isReplay()) return 0;
+	return nextEvent(type, data);
+}
+void Trace::endOfTrace() {
+	logger.info("End of trace  instruction %llu", instructionCount);
+	setMode(M_none);
+	ProcessorThread::stop();
+}
+void Trace::diverged(Type type) {
+	logger.fatal("Replay diverged  type = %d  instruction = %llu", type, instructionCount);
+	if (!lookahead.isEmpty()) {
+		logger.fatal("Next event       type = %d  instruction = %llu", lookahead.first().type, lookahead.first().count);
+	}
+	ERROR();
+}
+
+
+CARD32 Trace::value(Type type, CARD32 value) {
+	switch(mode) {
+	case M_record:
+		record(type, QByteArray((const char*)&value, sizeof(value)));
+		break;
+	case M_replay: {
+		QByteArray data;
+		if (nextEvent(type, data)) {
+			if (data.size() != sizeof(value)) diverged(type);
+			memcpy(&value, data.constData(), sizeof(value));
+		} else if (isReplay()) {
+			diverged(type);
+		}
+	}
+		break;
+	default:
+		break;
+	}
+	return value;
+}
+
+void Trace::verify(Type type, const void* data, int size) {
+	switch(mode) {
+	case M_record:
+		record(type, QByteArray((const char*)data, size));
+		break;
+	case M_replay: {
+		QByteArray recorded;
+		if (nextEvent(type, recorded)) {
+			if (recorded.size() != size || memcmp(recorded.constData(), data, size) != 0) diverged(type);
+		} else if (isReplay()) {
+			diverged(type);
+		}
+	}
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,141 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Trace.h
+//
+
+#ifndef TRACE_H__
+#define TRACE_H__
+
+#include "MesaBasic.h"
+
+#include <QtCore>
+
+//
+// Trace records non-deterministic input of emulator with instruction count, and replays them.
+//   Record and replay must start from same germ and disk image.
+//   Event is applied at same instruction in replay, so instruction stream of replay is same as record.
+//
+// Format of trace file
+//   header  MAGIC(8) VERSION(4)
+//   chunk   size(4) data(size)  -- data is qCompress of events. Size of events is about CHUNK_SIZE.
+//   event   delta of instruction count(varint) type(1) size of data(varint) data(size)
+//
+class Trace {
+public:
+	enum Mode {
+		M_none   = 0,
+		M_record = 1,
+		M_replay = 2,
+	};
+	enum Type {
+		T_request  = 1, // request of reschedule at safe point of processor thread
+		T_wakeup   = 2, // WP consumed by ProcessInterrupt
+		T_time     = 3, // value of host clock
+		T_input    = 4, // keyboard and mouse event applied by InputQueue
+		T_disk     = 5, // disk IOCB after completion
+		T_receive  = 6, // received network frame
+		T_transmit = 7, // network IOCB after transmit
+	};
+
+	// Size of events in one chunk before compression
+	static const int CHUNK_SIZE = 64 * 1024;
+
+	// mode_ is "none", "record" or "replay"
+	static void initialize(const QString& mode_, const QString& path);
+	static void finalize();
+
+	static inline int isEnabled() {
+		return mode != M_none;
+	}
+	static inline int isRecord() {
+		return mode == M_record;
+	}
+	static inline int isReplay() {
+		return mode == M_replay;
+	}
+
+	// Called from processor thread before execution of each instruction while record or replay
+	static inline void countInstruction() {
+		instructionCount++;
+	}
+	static inline quint64 getInstructionCount() {
+		return instructionCount;
+	}
+
+	// Replay: returns 1 if there is recorded safe point at current instruction
+	static int isSafePoint();
+
+	// Record: record value and returns value
+	// Replay: returns recorded value
+	static CARD32 value(Type type, CARD32 value);
+	// Record: record data
+	// Replay: compare data with recorded data
+	static void verify(Type type, const void* data, int size);
+	// Record data
+	static void record(Type type, const QByteArray& data);
+	// Returns 1 and recorded data, if next event is type at current instruction
+	static int  replay(Type type, QByteArray& data);
+
+private:
+	class Event {
+	public:
+		quint64    count;
+		int        type;
+		QByteArray data;
+	};
+
+	static Mode         mode;
+	static quint64      instructionCount;
+	static QFile*       file;
+	static long long    eventCount;
+	static long long    chunkCount;
+
+	// Record
+	static QByteArray   writeBuffer;
+	static quint64      writeCount;  // instruction count of last recorded event
+
+	// Replay
+	static QByteArray   readBuffer;
+	static int          readPosition;
+	static quint64      readCount;   // instruction count of last read event
+	static QList<Event> lookahead;
+	static quint64      safePoint;   // instruction count of next T_request
+	static int          safePointValid;
+
+	static void setMode(Mode newValue);
+	static void writeChunk();
+	static int  readChunk();
+	static int  readEvent();
+	static int  nextEvent(Type type, QByteArray& data);
+	static void endOfTrace();
+	static void diverged(Type type);
+};
+
+#endif
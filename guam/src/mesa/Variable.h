@@ -48,6 +48,7 @@ extern CARD16 PID[4]; // Processor ID
 //extern CARD16 WDC;    // Wakeup disable counter - 10.4.4.3
 //extern CARD16 PTC;    // Process timeout counter - 10.4.5
 extern CARD16 XTS;    // Xfer trap status - 9.5.5
+extern CARD16 FST;    // Floating point sticky word - FSTICKY
 
 // 3.3.1 Control Registers
 extern CARD16            PSB; // PsbIndex - 10.1.1
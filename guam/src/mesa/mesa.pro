@@ -13,8 +13,11 @@ HEADERS += Constant.h Function.h MesaBasic.h Variable.h
 HEADERS += Memory.h   MesaProcessor.h   MesaThread.h   Pilot.h   Type.h
 SOURCES += Memory.cpp MesaProcessor.cpp MesaThread.cpp Pilot.cpp Type.cpp
 
-HEADERS += LoadState.h
-SOURCES += LoadState.cpp
+HEADERS += LoadState.h   ModuleEntryDB.h
+SOURCES += LoadState.cpp ModuleEntryDB.cpp
+
+HEADERS += Profiler.h   Trace.h   Snapshot.h
+SOURCES += Profiler.cpp Trace.cpp Snapshot.cpp
 
 ###############################################
 
@@ -39,6 +39,8 @@ static log4cpp::Category& logger = Logger::getLogger("main");
 #include "../symbols/SEIndex.h"
 #include "../symbols/HTIndex.h"
 
+#include "../util/Batch.h"
+
 
 void PageFault(CARD32 ptr) {
 	logger.fatal("%s %X", __FUNCTION__, ptr);
@@ -97,15 +99,17 @@ void Module::dumpEntry(QString outDirPath, QString filePath) {
 	// Locate target segment
 	if (bcd.isSymbolsFile()) {
 		logger.info("symbol file");
-		Symbols symbols(&bcd, 2);
+		Symbols symbols(&bcd, 2, Symbols::Mode::LAZY);
 		dumpEntry(outDirPath, symbols);
+		symbols.logStats();
 	} else {
 	   for (SGRecord* p : bcd.sg.values()) {
 			if (p->segClass == SGRecord::SegClass::SYMBOLS) {
 				if (p->file->isSelf()) {
 					logger.info("symbol segment  %s %s", p->file->version->toString().toLocal8Bit().constData(), p->toString().toLocal8Bit().constData());
-					Symbols symbols(&bcd, p->base);
+					Symbols symbols(&bcd, p->base, Symbols::Mode::LAZY);
 					dumpEntry(outDirPath, symbols);
+					symbols.logStats();
 				}
 			}
 		}
@@ -220,11 +224,26 @@ int main(int argc, char** argv) {
 			ERROR();
 		}
 
+		QStringList pathList;
 		for(int i = 1; i < argc; i++) {
-			QString filePath = argv[i];
-			logger.info("path = %s", filePath.toLocal8Bit().constData());
+			QString path = argv[i];
+			logger.info("path = %s", path.toLocal8Bit().constData());
+			pathList.append(path);
+		}
 
-			Module::dumpEntry(outDirPath, filePath);
+		Batch batch;
+		QList<Batch::Entry> entryList = batch.scan(pathList, [](const QFileInfo& fileInfo) {
+			QString fileName(fileInfo.fileName());
+			return fileName.endsWith(".bcd") || fileName.endsWith(".symbols");
+		});
+
+		int failCount = batch.run(entryList, [&outDirPath](const Batch::Entry& entry) {
+			Module::dumpEntry(outDirPath, entry.fileInfo.filePath());
+			return QByteArray();
+		}, [](const Batch::Entry& /*entry*/, const QByteArray& /*output*/) {});
+		if (failCount) {
+			logger.fatal("failCount = %d", failCount);
+			ERROR();
 		}
 	} catch (Error& e) {
 		logger.info("Error %s %d %s", e.file, e.line, e.func);
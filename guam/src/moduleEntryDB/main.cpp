@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// main.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("main");
+
+#include "../mesa/ModuleEntryDB.h"
+
+
+// Build module entry database from output of moduleEntry
+//   moduleEntryDB [dirPath [dbPath]]
+int main(int argc, char** argv) {
+	logger.info("START");
+
+	setSignalHandler();
+
+	try {
+		QString dirPath = (2 <= argc) ? argv[1] : "tmp/moduleEntry";
+		QString dbPath  = (3 <= argc) ? argv[2] : "tmp/moduleEntry.db";
+		logger.info("dirPath %s", dirPath.toLocal8Bit().constData());
+		logger.info("dbPath  %s", dbPath.toLocal8Bit().constData());
+		if (!QFile::exists(dirPath)) {
+			logger.fatal("dirPath does not exist. dirPath = %s", dirPath.toLocal8Bit().constData());
+			ERROR();
+		}
+
+		ModuleEntryDB::build(dirPath, dbPath);
+
+		// Sanity check
+		ModuleEntryDB db;
+		if (!db.open(dbPath)) {
+			logger.fatal("Cannot open dbPath = %s", dbPath.toLocal8Bit().constData());
+			ERROR();
+		}
+		for(int i = 0; i < db.size(); i++) {
+			if (db.find(db.getVersion(i)) != i) {
+				logger.fatal("Unexpected find  %s", db.toString(i).toLocal8Bit().constData());
+				ERROR();
+			}
+		}
+		logger.info("module %d", db.size());
+	} catch (Error& e) {
+		logger.info("Error %s %d %s", e.file, e.line, e.func);
+		return 1;
+	} catch (...) {
+		logger.info("Unknown exception");
+		return 1;
+	}
+
+	logger.info("STOP");
+	return 0;
+}
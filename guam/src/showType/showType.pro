@@ -16,7 +16,7 @@ LIBS += ../../tmp/build/symbols/libsymbols.a
 LIBS += ../../tmp/build/mesa/libmesa.a
 LIBS += ../../tmp/build/util/libutil.a
 
-LIBS += -llog4cpp
+LIBS += -llog4cpp -lz
 
 POST_TARGETDEPS += ../../tmp/build/symbols/libsymbols.a
 POST_TARGETDEPS += ../../tmp/build/mesa/libmesa.a
@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Block.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("block");
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Block.h"
+
+
+// Checksum
+//   One step of checksum is s = rotl(s +' w, 1). +' is ones' complement add.
+//   In ones' complement arithmetic, rotate left k bit is multiply by 2^k and 2^16 is 1.
+//   So 16 steps from s is s +' rotl(w[0], 16) +' rotl(w[1], 15) +' ... +' rotl(w[15], 1).
+//   Sum of rotated words of each position can be calculated independently.
+static const int CHECKSUM_BLOCK = 16;
+
+// Fold sum into 16 bit with end around carry
+static inline CARD16 fold(quint64 sum) {
+	while(sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+	return (CARD16)sum;
+}
+
+#if defined(__SSE2__)
+// Sum of rotated words of n blocks
+static quint64 sumBlock(const CARD16* p, CARD32 n) {
+	// rotl(w, k) = (w << k) | (w >> (16 - k)) = low half of w * 2^k | high half of w * 2^k
+	const __m128i m0 = _mm_setr_epi16(1 << 0, (short)(1 << 15), 1 << 14, 1 << 13, 1 << 12, 1 << 11, 1 << 10, 1 << 9);
+	const __m128i m1 = _mm_setr_epi16(1 << 8, 1 << 7, 1 << 6, 1 << 5, 1 << 4, 1 << 3, 1 << 2, 1 << 1);
+	const __m128i zero = _mm_setzero_si128();
+
+	quint64 ret = 0;
+	while(n) {
+		// Each lane of acc gets 4 words per block. 1024 blocks never overflow 32 bit.
+		CARD32 run = (n < 1024) ? n : 1024;
+		n -= run;
+
+		__m128i acc = _mm_setzero_si128();
+		for(CARD32 i = 0; i < run; i++) {
+			__m128i w0 = _mm_loadu_si128((const __m128i*)(p + 0));
+			__m128i w1 = _mm_loadu_si128((const __m128i*)(p + 8));
+			p += CHECKSUM_BLOCK;
+
+			__m128i r0 = _mm_or_si128(_mm_mullo_epi16(w0, m0), _mm_mulhi_epu16(w0, m0));
+			__m128i r1 = _mm_or_si128(_mm_mullo_epi16(w1, m1), _mm_mulhi_epu16(w1, m1));
+
+			acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(r0, zero));
+			acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(r0, zero));
+			acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(r1, zero));
+			acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(r1, zero));
+		}
+
+		CARD32 lane[4];
+		_mm_storeu_si128((__m128i*)lane, acc);
+		ret += (quint64)lane[0] + lane[1] + lane[2] + lane[3];
+	}
+	return ret;
+}
+#else
+// Sum of rotated words of n blocks
+//   Rotate left k bit is multiply by 2^k in ones' complement. So shift without rotate and fold later.
+static quint64 sumBlock(const CARD16* p, CARD32 n) {
+	quint64 ret = 0;
+	for(CARD32 i = 0; i < n; i++) {
+		ret += (quint64)p[ 0] <<  0;
+		ret += (quint64)p[ 1] << 15;
+		ret += (quint64)p[ 2] << 14;
+		ret += (quint64)p[ 3] << 13;
+		ret += (quint64)p[ 4] << 12;
+		ret += (quint64)p[ 5] << 11;
+		ret += (quint64)p[ 6] << 10;
+		ret += (quint64)p[ 7] <<  9;
+		ret += (quint64)p[ 8] <<  8;
+		ret += (quint64)p[ 9] <<  7;
+		ret += (quint64)p[10] <<  6;
+		ret += (quint64)p[11] <<  5;
+		ret += (quint64)p[12] <<  4;
+		ret += (quint64)p[13] <<  3;
+		ret += (quint64)p[14] <<  2;
+		ret += (quint64)p[15] <<  1;
+		p += CHECKSUM_BLOCK;
+	}
+	return ret;
+}
+#endif
+
+CARD16 Block::checksum(CARD16 cksum, const CARD16* p, CARD32 n) {
+	const CARD32 blocks = n / CHECKSUM_BLOCK;
+	if (blocks) {
+		cksum = fold(cksum + sumBlock(p, blocks));
+		p += blocks * CHECKSUM_BLOCK;
+		n -= blocks * CHECKSUM_BLOCK;
+	}
+	return checksumScalar(cksum, p, n);
+}
+
+CARD16 Block::checksumScalar(CARD16 cksum, const CARD16* p, CARD32 n) {
+	while(n--) cksum = checksum(cksum, *p++);
+	return cksum;
+}
+
+
+// Compare
+//   Use memcmp for each chunk and find position in chunk that is not equal.
+static const CARD32 COMPARE_CHUNK = 64;
+
+CARD32 Block::compare(const CARD16* a, const CARD16* b, CARD32 n) {
+	for(CARD32 i = 0; i < n; i += COMPARE_CHUNK) {
+		const CARD32 run = (n - i < COMPARE_CHUNK) ? (n - i) : COMPARE_CHUNK;
+		if (memcmp(a + i, b + i, run * sizeof(CARD16)) == 0) continue;
+		return i + compareScalar(a + i, b + i, run);
+	}
+	return n;
+}
+
+CARD32 Block::compareScalar(const CARD16* a, const CARD16* b, CARD32 n) {
+	for(CARD32 i = 0; i < n; i++) {
+		if (a[i] != b[i]) return i;
+	}
+	return n;
+}
+
+
+// Copy
+//   When dest overlaps upper part of source, word by word copy propagates first k words of source.
+//   k is distance between source and dest. Copy k words and then double copied area.
+void Block::copy(CARD16* d, const CARD16* s, CARD32 n) {
+	if (s < d && d < s + n) {
+		const CARD32 k = d - s;
+		memcpy(d, s, k * sizeof(CARD16));
+		for(CARD32 len = k; len < n;) {
+			const CARD32 run = (n - len < len) ? (n - len) : len;
+			memcpy(d + len, d, run * sizeof(CARD16));
+			len += run;
+		}
+	} else {
+		memmove(d, s, n * sizeof(CARD16));
+	}
+}
+
+void Block::copyScalar(CARD16* d, const CARD16* s, CARD32 n) {
+	while(n--) *d++ = *s++;
+}
+
+// Same as copy except direction. Propagate last k words of source when dest overlaps lower part of source.
+void Block::copyReverse(CARD16* d, const CARD16* s, CARD32 n) {
+	if (d < s && s < d + n) {
+		const CARD32 k = s - d;
+		memcpy(d + n - k, s + n - k, k * sizeof(CARD16));
+		for(CARD32 len = k; len < n;) {
+			const CARD32 run = (n - len < len) ? (n - len) : len;
+			memcpy(d + n - len - run, d + n - run, run * sizeof(CARD16));
+			len += run;
+		}
+	} else {
+		memmove(d, s, n * sizeof(CARD16));
+	}
+}
+
+void Block::copyReverseScalar(CARD16* d, const CARD16* s, CARD32 n) {
+	d += n;
+	s += n;
+	while(n--) *--d = *--s;
+}
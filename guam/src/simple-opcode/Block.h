@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Block.h
+//
+
+#ifndef BLOCK_H__
+#define BLOCK_H__
+
+#include "../mesa/MesaBasic.h"
+
+// Block operation on host memory used by BLT, BLE and CKSUM family.
+//   All operation works on word array in one page and never cause page fault.
+class Block {
+public:
+	// One step of checksum. Add with end around carry and rotate left one bit.
+	__attribute__((always_inline)) static inline CARD16 checksum(CARD16 cksum, CARD16 data) {
+		CARD16 temp = cksum + data;
+		if (temp < cksum) temp = temp + 1;
+		if ((CARD16)0x8000 <= temp) {
+			temp = temp * 2 + 1;
+		} else {
+			temp = temp * 2;
+		}
+		return temp;
+	}
+
+	// Checksum of n words. Same result as applying checksum() to each word except 0 and 0xFFFF.
+	//   Both 0 and 0xFFFF is zero in ones' complement, and CKSUM replaces 0xFFFF with 0 at the end.
+	static CARD16 checksum(CARD16 cksum, const CARD16* p, CARD32 n);
+	// Reference implementation of above
+	static CARD16 checksumScalar(CARD16 cksum, const CARD16* p, CARD32 n);
+
+	// Return index of first word that is not equal. Return n if all words are equal.
+	static CARD32 compare(const CARD16* a, const CARD16* b, CARD32 n);
+	// Reference implementation of above
+	static CARD32 compareScalar(const CARD16* a, const CARD16* b, CARD32 n);
+
+	// Same result as copy word by word from lower address. Overlapped area is propagated.
+	static void copy(CARD16* d, const CARD16* s, CARD32 n);
+	// Reference implementation of above
+	static void copyScalar(CARD16* d, const CARD16* s, CARD32 n);
+
+	// Same result as copy word by word from higher address. d and s points lowest address of block.
+	static void copyReverse(CARD16* d, const CARD16* s, CARD32 n);
+	// Reference implementation of above
+	static void copyReverseScalar(CARD16* d, const CARD16* s, CARD32 n);
+};
+
+#endif
@@ -140,6 +140,7 @@ void Interpreter::initRegisters() {
 //	PTC = 0;    // Process timeout counter - 10.4.5
 	TimerThread::setPTC(0);
 	XTS = 0;    // Xfer trap status - 9.5.5
+	FST = 0;    // Floating point sticky word - FSTICKY
 
 	// 3.3.1 Control Registers
 	PSB = 0; // PsbIndex - 10.1.1
@@ -534,23 +535,23 @@ void Interpreter::initTable() {
 	/* 077 */ //ASSIGN_ESC(a, 77)
 
 	// Floating Point (100B-137B are reserved)
-	/* 0100 */ //ASSIGN_ESC(a, FADD)
-	/* 0101 */ //ASSIGN_ESC(a, FSUB)
-	/* 0102 */ //ASSIGN_ESC(a, FMUL)
-	/* 0103 */ //ASSIGN_ESC(a, FDIV)
-	/* 0104 */ //ASSIGN_ESC(a, FCOMP)
-	/* 0105 */ //ASSIGN_ESC(a, FIX)
-	/* 0106 */ //ASSIGN_ESC(a, FLOAT)
-	/* 0107 */ //ASSIGN_ESC(a, FIXI)
-
-	/* 0110 */ //ASSIGN_ESC(a, FIXC)
-	/* 0111 */ //ASSIGN_ESC(a, FSTICKY)
-	/* 0112 */ //ASSIGN_ESC(a, FREM)
-	/* 0113 */ //ASSIGN_ESC(a, ROUND)
-	/* 0114 */ //ASSIGN_ESC(a, ROUNDI)
-	/* 0115 */ //ASSIGN_ESC(a, ROUNDC)
-	/* 0116 */ //ASSIGN_ESC(a, FSQRT)
-	/* 0117 */ //ASSIGN_ESC(a, FSC)
+	/* 0100 */ ASSIGN_ESC(a, FADD)
+	/* 0101 */ ASSIGN_ESC(a, FSUB)
+	/* 0102 */ ASSIGN_ESC(a, FMUL)
+	/* 0103 */ ASSIGN_ESC(a, FDIV)
+	/* 0104 */ ASSIGN_ESC(a, FCOMP)
+	/* 0105 */ ASSIGN_ESC(a, FIX)
+	/* 0106 */ ASSIGN_ESC(a, FLOAT)
+	/* 0107 */ ASSIGN_ESC(a, FIXI)
+
+	/* 0110 */ ASSIGN_ESC(a, FIXC)
+	/* 0111 */ ASSIGN_ESC(a, FSTICKY)
+	/* 0112 */ ASSIGN_ESC(a, FREM)
+	/* 0113 */ ASSIGN_ESC(a, ROUND)
+	/* 0114 */ ASSIGN_ESC(a, ROUNDI)
+	/* 0115 */ ASSIGN_ESC(a, ROUNDC)
+	/* 0116 */ ASSIGN_ESC(a, FSQRT)
+	/* 0117 */ ASSIGN_ESC(a, FSC)
 
 	//  Read / Write Registers
 	/* 0160 */ ASSIGN_ESC(a, WRPSB)
@@ -445,6 +445,24 @@ static const CARD32 L_##name = (len);
 /* 0062 */ DECL_E(2, SDDIV)
 /* 0063 */ DECL_E(2, UDDIV)
 
+/* 0100 */ DECL_E(2, FADD)
+/* 0101 */ DECL_E(2, FSUB)
+/* 0102 */ DECL_E(2, FMUL)
+/* 0103 */ DECL_E(2, FDIV)
+/* 0104 */ DECL_E(2, FCOMP)
+/* 0105 */ DECL_E(2, FIX)
+/* 0106 */ DECL_E(2, FLOAT)
+/* 0107 */ DECL_E(2, FIXI)
+
+/* 0110 */ DECL_E(2, FIXC)
+/* 0111 */ DECL_E(2, FSTICKY)
+/* 0112 */ DECL_E(2, FREM)
+/* 0113 */ DECL_E(2, ROUND)
+/* 0114 */ DECL_E(2, ROUNDI)
+/* 0115 */ DECL_E(2, ROUNDC)
+/* 0116 */ DECL_E(2, FSQRT)
+/* 0117 */ DECL_E(2, FSC)
+
 /* 0160 */ DECL_E(2, WRPSB)
 /* 0161 */ DECL_E(2, WRMDS)
 /* 0162 */ DECL_E(2, WRWP)
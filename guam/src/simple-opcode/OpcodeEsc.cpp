@@ -37,6 +37,7 @@ static log4cpp::Category& logger = Logger::getLogger("esc");
 #include "../util/Perf.h"
 
 #include "../mesa/MesaThread.h"
+#include "../mesa/Trace.h"
 
 #include "Opcode.h"
 #include "Interpreter.h"
@@ -319,23 +320,23 @@ void E_UDDIV() {
 // 077  //ASSIGN_ESC(a, 77)
 
 // Floating Point (100B-137B are reserved)
-// 0100  //ASSIGN_ESC(a, FADD)
-// 0101  //ASSIGN_ESC(a, FSUB)
-// 0102  //ASSIGN_ESC(a, FMUL)
-// 0103  //ASSIGN_ESC(a, FDIV)
-// 0104  //ASSIGN_ESC(a, FCOMP)
-// 0105  //ASSIGN_ESC(a, FIX)
-// 0106  //ASSIGN_ESC(a, FLOAT)
-// 0107  //ASSIGN_ESC(a, FIXI)
+// 0100  ASSIGN_ESC(a, FADD)
+// 0101  ASSIGN_ESC(a, FSUB)
+// 0102  ASSIGN_ESC(a, FMUL)
+// 0103  ASSIGN_ESC(a, FDIV)
+// 0104  ASSIGN_ESC(a, FCOMP)
+// 0105  ASSIGN_ESC(a, FIX)
+// 0106  ASSIGN_ESC(a, FLOAT)
+// 0107  ASSIGN_ESC(a, FIXI)
 
-// 0110  //ASSIGN_ESC(a, FIXC)
-// 0111  //ASSIGN_ESC(a, FSTICKY)
-// 0112  //ASSIGN_ESC(a, FREM)
-// 0113  //ASSIGN_ESC(a, ROUND)
-// 0114  //ASSIGN_ESC(a, ROUNDI)
-// 0115  //ASSIGN_ESC(a, ROUNDC)
-// 0116  //ASSIGN_ESC(a, FSQRT)
-// 0117  //ASSIGN_ESC(a, FSC)
+// 0110  ASSIGN_ESC(a, FIXC)
+// 0111  ASSIGN_ESC(a, FSTICKY)
+// 0112  ASSIGN_ESC(a, FREM)
+// 0113  ASSIGN_ESC(a, ROUND)
+// 0114  ASSIGN_ESC(a, ROUNDI)
+// 0115  ASSIGN_ESC(a, ROUNDC)
+// 0116  ASSIGN_ESC(a, FSQRT)
+// 0117  ASSIGN_ESC(a, FSC)
 
 //  Read / Write Registers
 // 0160  ASSIGN_ESC(a, WRPSB)
@@ -346,6 +347,7 @@ void E_WRPSB() {
 // 0161  ASSIGN_ESC(a, WRMDS)
 void E_WRMDS() {
 	CARD32 mds = Pop() << WordSize;
+	AVCache::invalidate();
 	Memory::setMDS(mds);
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  WRMDS  %04X", savedPC, (Memory::MDS() >> WordSize));
 }
@@ -512,6 +514,7 @@ void E_RRPTC() {
 // 0175  ASSIGN_ESC(a, RRIT)
 void E_RRIT() {
 	CARD32 time = Util::getMicroTime();
+	if (Trace::isEnabled()) time = Trace::value(Trace::T_time, time);
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  RRIT   %08X", savedPC, time);
 	PushLong(time);
 }
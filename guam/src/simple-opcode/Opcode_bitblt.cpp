@@ -666,6 +666,278 @@ MonoBlt* MonoBlt::getInstance(ColorBlt::ColorBltTable& arg) {
 }
 
 
+// ColorBlt of byteColor display
+//   Each pixel of display is one byte. Pixel of bit source is mapped with colorMapping.
+//   One line of source is expanded to buffer of byte pixel, then combined with dest line with dstFunc.
+//   Combining loop has no branch in loop body, so that compiler can vectorize the loop.
+static int count_ByteBlt_bit     = 0;
+static int count_ByteBlt_pat     = 0;
+static int count_ByteBlt_display = 0;
+void ByteBlt_stats() {
+	if (!PERF_ENABLE) return;
+	logger.debug("ByteBlt stats   bit          = %8d", count_ByteBlt_bit);
+	logger.debug("ByteBlt stats   pat          = %8d", count_ByteBlt_pat);
+	logger.debug("ByteBlt stats   display      = %8d", count_ByteBlt_display);
+}
+
+class ByteBlt {
+public:
+	ByteBlt(ColorBlt::ColorBltTable& arg) : line(arg.width), dstLine(arg.width) {
+		if (32767 < arg.width)  ERROR();
+		if (32767 < arg.height) ERROR();
+		if (arg.flags.dstType != ColorBlt::PT_display) ERROR();
+
+		width   = arg.width;
+		height  = arg.height;
+		src     = arg.src;
+		dst     = arg.dst;
+		srcType = arg.flags.srcType;
+		srcFunc = arg.flags.srcFunc;
+		dstFunc = arg.flags.dstFunc;
+		pattern = arg.flags.pattern;
+
+		// complement of bit source is same as swapping of colorMapping
+		map[0] = (CARD8)arg.colorMapping.color[(srcFunc == ColorBlt::SF_complement) ? 1 : 0];
+		map[1] = (CARD8)arg.colorMapping.color[(srcFunc == ColorBlt::SF_complement) ? 0 : 1];
+
+		displayBase  = Memory::getDisplayVirtualPage() * PageSize;
+		displayBytes = Memory::getDisplayPageSize() * PageSize * sizeof(CARD16);
+		display      = (CARD8*)Memory::getDisplayPage()->word;
+
+		// Address of byte pixmap has 2 pixel in one word
+		Bump(dst, 0, ColorBlt::PT_display);
+		Bump(src, 0, srcType);
+
+		if (pattern) {
+			// Same restriction as MonoBlt_pat
+			if (srcType == ColorBlt::PT_display) ERROR();
+			if (arg.pattern.widthMinusOne || arg.flags.direction != DI_forward || arg.dstPpl < 0) ERROR();
+			grayWidth = (INT16)((arg.pattern.widthMinusOne + 1) * WordSize);
+			grayBump  = -grayWidth * arg.pattern.heightMinusOne;
+			lastGray  = arg.pattern.heightMinusOne - arg.pattern.yOffset;
+			heightMinusOne = arg.pattern.heightMinusOne;
+			unpacked  = arg.pattern.unpacked;
+			bumpSrc   = 0;
+			bumpDst   = arg.dstPpl;
+			if (PERF_ENABLE) count_ByteBlt_pat++;
+		} else {
+			// Same as MonoBlt_bit. In backward direction, address points to last line and line goes upward.
+			if (arg.srcPpl < 0 || arg.dstPpl < 0) ERROR();
+			bumpSrc = (arg.flags.direction == DI_forward) ? arg.srcPpl : -arg.srcPpl;
+			bumpDst = (arg.flags.direction == DI_forward) ? arg.dstPpl : -arg.dstPpl;
+			grayWidth = grayBump = lastGray = heightMinusOne = unpacked = 0;
+			if (PERF_ENABLE) {
+				if (srcType == ColorBlt::PT_display) count_ByteBlt_display++;
+				else count_ByteBlt_bit++;
+			}
+		}
+	}
+
+	void process() {
+		if (width == 0) return;
+		CARD8* s = line.data();
+		CARD8* t = dstLine.data();
+
+		for(int i = 0; i < height; i++) {
+			// Read source line before touching dest line. So overlapped source and dest is safe.
+			if (pattern) {
+				readPattern(s);
+			} else if (srcType == ColorBlt::PT_display) {
+				readDisplay(s);
+			} else {
+				readBit(s);
+			}
+
+			CARD8* d = displayAddress(dst, width);
+			if (d) {
+				combine(d, s);
+			} else {
+				// dest is not in display memory
+				readLine(dst, t);
+				combine(t, s);
+				writeLine(dst, t);
+			}
+
+			// gray is bit pattern
+			if (pattern) {
+				Bump(src, ((i % (heightMinusOne + 1)) == lastGray) ? grayBump : grayWidth, srcType);
+			} else {
+				Bump(src, bumpSrc, srcType);
+			}
+			Bump(dst, bumpDst, ColorBlt::PT_display);
+		}
+	}
+
+private:
+	int width;
+	int height;
+	ColorBlt::Address src;
+	ColorBlt::Address dst;
+	int srcType;
+	int srcFunc;
+	int dstFunc;
+	int pattern;
+	CARD8 map[2];
+
+	int grayWidth;
+	int grayBump;
+	int lastGray;
+	int heightMinusOne;
+	int unpacked;
+	int bumpSrc;
+	int bumpDst;
+
+	CARD32 displayBase;
+	CARD32 displayBytes;
+	CARD8* display;
+
+	// source pixel of one line
+	QVector<CARD8> line;
+	// dest pixel of one line that is not in display memory
+	QVector<CARD8> dstLine;
+
+	// Bump address by offset pixel. Pixel of byte pixmap (PT_display) is byte and pixel of PT_bit is bit.
+	static void Bump(ColorBlt::Address& address, int offset, int type) {
+		if (type == ColorBlt::PT_display) {
+			offset += address.pixel;
+			// Same as MonoBlt::Bump. Don't use divide and modulo for minus offset.
+			address.word += LongArithShift(offset, -1);
+			address.pixel = offset & 1;
+		} else {
+			MonoBlt::Bump(address, offset);
+		}
+	}
+
+	// Return address of display memory for pixel of address.
+	// Returns 0 if pixel from address to address + count is not in display memory.
+	CARD8* displayAddress(const ColorBlt::Address& address, int count) {
+		if (address.word < displayBase) return 0;
+		const CARD32 offset = (address.word - displayBase) * sizeof(CARD16) + address.pixel;
+		if (displayBytes < (offset + count)) return 0;
+		return display + offset;
+	}
+
+	// Access byte pixmap through memory of Mesa. Word of Mesa memory is big endian,
+	// so first pixel is left byte of word, same as FetchByte and StoreByte.
+	void readLine(const ColorBlt::Address& address, CARD8* p) {
+		CARD32 ptr   = address.word;
+		int    pixel = address.pixel;
+		for(int x = 0; x < width; x++) {
+			BytePair word = {*Fetch(ptr)};
+			p[x] = pixel ? word.right : word.left;
+			if (++pixel == 2) {
+				pixel = 0;
+				ptr++;
+			}
+		}
+	}
+	void writeLine(const ColorBlt::Address& address, const CARD8* p) {
+		CARD32 ptr   = address.word;
+		int    pixel = address.pixel;
+		for(int x = 0; x < width; x++) {
+			CARD16* w = Store(ptr);
+			BytePair word = {*w};
+			if (pixel) {
+				word.right = p[x];
+			} else {
+				word.left  = p[x];
+			}
+			*w = word.u;
+			if (++pixel == 2) {
+				pixel = 0;
+				ptr++;
+			}
+		}
+	}
+
+	void readDisplay(CARD8* s) {
+		const CARD8* p = displayAddress(src, width);
+		if (p == 0) {
+			readLine(src, s);
+			p = s;
+		}
+		if (srcFunc == ColorBlt::SF_complement) {
+			for(int x = 0; x < width; x++) s[x] = ~p[x];
+		} else if (p != s) {
+			memcpy(s, p, width);
+		}
+	}
+	void readBit(CARD8* s) {
+		CARD32 ptr  = src.word;
+		int    bit  = src.pixel;
+		CARD16 word = *Fetch(ptr);
+		for(int x = 0; x < width; x++) {
+			s[x] = map[(word >> (WordSize - 1 - bit)) & 1];
+			if (++bit == WordSize) {
+				bit = 0;
+				ptr++;
+				if ((x + 1) < width) word = *Fetch(ptr);
+			}
+		}
+	}
+	void readPattern(CARD8* s) {
+		// pattern is one word wide
+		CARD16 word = *Fetch(src.word);
+		if (word && unpacked) word = 0xffff;
+		CARD8 p[WordSize];
+		for(int i = 0; i < WordSize; i++) p[i] = map[(word >> (WordSize - 1 - i)) & 1];
+		for(int x = 0; x < width; x++) s[x] = p[(src.pixel + x) % WordSize];
+	}
+
+	void combine(CARD8* d, const CARD8* s) {
+		switch(dstFunc) {
+		case ColorBlt::DF_src:
+			memmove(d, s, width);
+			break;
+		case ColorBlt::DF_srcIfDstLE1:
+			for(int x = 0; x < width; x++) d[x] = (d[x] <= 1) ? s[x] : d[x];
+			break;
+		case ColorBlt::DF_srcIf0:
+			for(int x = 0; x < width; x++) d[x] = (s[x] == 0) ? 0 : d[x];
+			break;
+		case ColorBlt::DF_srcIfDstNot0:
+			for(int x = 0; x < width; x++) d[x] = (d[x] != 0) ? s[x] : 0;
+			break;
+		case ColorBlt::DF_srcIfNot0:
+			for(int x = 0; x < width; x++) d[x] = (s[x] != 0) ? s[x] : d[x];
+			break;
+		case ColorBlt::DF_srcIfDst0:
+			for(int x = 0; x < width; x++) d[x] = (d[x] == 0) ? s[x] : d[x];
+			break;
+		case ColorBlt::DF_pixelXor:
+			// src if dst=0, else dst if src=0, else 0
+			for(int x = 0; x < width; x++) d[x] = (d[x] == 0) ? s[x] : ((s[x] == 0) ? d[x] : 0);
+			break;
+		case ColorBlt::DF_srcXorDst:
+			for(int x = 0; x < width; x++) d[x] ^= s[x];
+			break;
+		default:
+			ERROR();
+			break;
+		}
+	}
+};
+
+// Choose implementation of blt from display type and dest type
+static void processBlt(ColorBlt::ColorBltTable& arg) {
+	if (Memory::getDisplayType() == DisplayIOFaceGuam::T_byteColor) {
+		if (arg.flags.dstType == ColorBlt::PT_display) {
+			ByteBlt blt(arg);
+			blt.process();
+			return;
+		}
+		if (arg.flags.srcType == ColorBlt::PT_display) {
+			// Conversion from byte pixel to bit is not defined
+			logger.fatal("ColorBlt from byteColor display to bit is not supported");
+			ERROR();
+		}
+	}
+
+	std::unique_ptr<MonoBlt> blt(MonoBlt::getInstance(arg));
+	blt->process();
+}
+
+
 void E_COLORBLT() {
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  COLORBLT  %d", savedPC, SP);
 	if (SP == 1) {
@@ -702,8 +974,7 @@ void E_COLORBLT() {
 //			}
 //		}
 
-		std::unique_ptr<MonoBlt> blt(MonoBlt::getInstance(arg));
-		blt->process();
+		processBlt(arg);
 
 //		if (updateRect) {
 //			logger.debug("updateDisplay %4d %4d %4d %4d", rect.x, rect.y, rect.width, rect.height);
@@ -726,9 +997,10 @@ void E_BITBLT() {
 
 		POINTER ptr = Pop();
 		MonoBlt::FetchBitBltTable(ptr, &arg);
+		// BitBlt has no colorMapping. Bit 1 is black (1) on byteColor display.
+		if (Memory::getDisplayType() == DisplayIOFaceGuam::T_byteColor) arg.colorMapping.color[1] = 1;
 
-		std::unique_ptr<MonoBlt> blt(MonoBlt::getInstance(arg));
-		blt->process();
+		processBlt(arg);
 
 		GuiOp::Rect rect(0, 0, 0, 0);
 		GuiOp::updateDisplay(&rect);
@@ -39,6 +39,7 @@ static log4cpp::Category& logger = Logger::getLogger("block");
 #include "../mesa/Function.h"
 
 #include "Opcode.h"
+#include "Block.h"
 
 #define USE_FAST_BLT
 
@@ -61,7 +62,7 @@ __attribute__((always_inline)) static inline void BLT(CARD32& s, CARD32& d, CARD
 	c -= run;
 	r =  run;
 
-	while(run--) *dp++ = *sp++;
+	Block::copy(dp, sp, run);
 }
 
 __attribute__((always_inline)) static inline void BLTR(CARD32& s, CARD32& d, CARD32& c, CARD32& r) {
@@ -79,7 +80,8 @@ __attribute__((always_inline)) static inline void BLTR(CARD32& s, CARD32& d, CAR
 	c -= run;
 	r =  run;
 
-	while(run--) *dp-- = *sp--;
+	// sp and dp points last word of block
+	Block::copyReverse(dp + 1 - run, sp + 1 - run, run);
 }
 
 __attribute__((always_inline)) static inline CARD32 BLE(CARD32& a, CARD32& b, CARD32& c, CARD32& r) {
@@ -97,10 +99,7 @@ __attribute__((always_inline)) static inline CARD32 BLE(CARD32& a, CARD32& b, CA
 	c -= run;
 	r =  run;
 
-	while(run--) {
-		if (*ap++ != *bp++) return 0; // FALSE - NOT EQUAL
-	}
-	return 1; // TRUE - EQUAL
+	return Block::compare(ap, bp, run) == run; // TRUE if all words are equal
 }
 
 // zBLT - 0363
@@ -513,16 +512,6 @@ void E_BLECL() {
 
 
 // aCKSUM - 052
-__attribute__((always_inline)) static inline CARDINAL Checksum(CARDINAL chksum, CARDINAL data) {
-	CARDINAL temp = chksum + data;
-	if (temp < chksum) temp = temp + 1;
-	if ((CARD16)0x8000 <= temp) {
-		temp = temp * 2 + 1;
-	} else {
-		temp = temp * 2;
-	}
-	return temp;
-}
 #ifdef USE_FAST_BLT
 void E_CKSUM() {
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  CKSUM", savedPC);
@@ -530,13 +519,16 @@ void E_CKSUM() {
 	CARDINAL     count  = Pop();
 	CARDINAL     cksum  = Pop();
 
-	// No need to maintain stack, because count is small.
-	CARD16* p = Fetch(source);
-	CARD32  c = count;
-	for(;;) {
-		if (c == 0) break;
-		cksum = Checksum(cksum, *p++);
-		c--;
+	// No need to maintain stack. Calculate again from beginning after PageFault.
+	CARD32 s = source;
+	CARD32 c = count;
+	while(c) {
+		CARD16* p = Fetch(s);
+		CARD32 run = PageSize - (s & MASK_OFFSET);
+		if (c < run) run = c;
+		cksum = Block::checksum(cksum, p, run);
+		s += run;
+		c -= run;
 	}
 	if (cksum == (CARDINAL)0xffff) cksum = 0;
 	Push(cksum);
@@ -553,7 +545,7 @@ void E_CKSUM() {
 			Push(cksum);
 			break;
 		}
-		cksum = Checksum(cksum, *Fetch(source));
+		cksum = Block::checksum(cksum, *Fetch(source));
 		Push(cksum);
 		Push(count - 1);
 		PushLong(source + 1);
@@ -562,8 +554,130 @@ void E_CKSUM() {
 #endif
 
 
+// Byte of word in host memory. Index 0 is left (high) byte of first word.
+__attribute__((always_inline)) static inline CARD8 GetByte(const CARD16* p, CARD32 index) {
+	BytePair word = {p[index / 2]};
+	return (index & 1) ? (CARD8)word.right : (CARD8)word.left;
+}
+__attribute__((always_inline)) static inline void SetByte(CARD16* p, CARD32 index, CARD8 data) {
+	BytePair word = {p[index / 2]};
+	if (index & 1) {
+		word.right = data;
+	} else {
+		word.left = data;
+	}
+	p[index / 2] = word.u;
+}
+
+// Copy n bytes from byte sb of sp to byte db of dp as if source is copied to temporary buffer.
+//   sp and dp are host address of word. Source and dest must be in one page each.
+static void CopyBytes(CARD16* dp, CARD32 db, const CARD16* sp, CARD32 sb, CARD32 n) {
+	if (sb == db) {
+		// Same byte lane. Copy odd first byte and last byte separately, and words in between with memmove.
+		// Read first and last byte before memmove in case of overlap.
+		const CARD32 first = db;
+		const CARD32 words = (n - first) / 2;
+		const CARD32 last  = (n - first) & 1;
+		const CARD8  firstByte = first ? GetByte(sp, 1) : 0;
+		const CARD8  lastByte  = last  ? GetByte(sp + first + words, 0) : 0;
+		memmove(dp + first, sp + first, words * sizeof(CARD16));
+		if (first) SetByte(dp, 1, firstByte);
+		if (last)  SetByte(dp + first + words, 0, lastByte);
+		return;
+	}
+
+	const CARD16* ep = sp + (sb + n + 1) / 2;
+	const CARD16* eq = dp + (db + n + 1) / 2;
+	if (ep <= dp || eq <= sp) {
+		// Different byte lane without overlap. Shift byte lane while copying.
+		if (db) {
+			// dest starts from right byte and source starts from left byte
+			SetByte(dp, 1, GetByte(sp, 0));
+			dp++;
+			n--;
+		}
+		// Now dest starts from left byte and source starts from right byte
+		const CARD32 words = n / 2;
+		for(CARD32 i = 0; i < words; i++) {
+			dp[i] = (CARD16)((sp[i] << 8) | (sp[i + 1] >> 8));
+		}
+		if (n & 1) SetByte(dp + words, 0, GetByte(sp + words, 1));
+		return;
+	}
+
+	// Different byte lane with overlap. Use temporary buffer.
+	CARD8 buffer[PageSize * 2];
+	for(CARD32 i = 0; i < n; i++) buffer[i] = GetByte(sp, sb + i);
+	for(CARD32 i = 0; i < n; i++) SetByte(dp, db + i, buffer[i]);
+}
+
+// Return true if bytes of forward byte by byte copy from source to dest is not same as copy through temporary buffer.
+//   It happens when dest is in middle of source. Position is counted in byte of host memory.
+__attribute__((always_inline)) static inline int IsPropagate(const CARD16* from, CARD32 fromByte, const CARD16* to, CARD32 toByte, CARD32 n) {
+	const CARD8* f = (const CARD8*)from + fromByte;
+	const CARD8* t = (const CARD8*)to   + toByte;
+	return f < t && t < (f + n);
+}
+
 // aBYTBLT - 055
-// TODO need to implements fast version of E_BYTBLT
+#ifdef USE_FAST_BLT
+void E_BYTBLT() {
+	CARDINAL     sourceOffset = Pop();
+	LONG_POINTER sourceBase   = PopLong();
+	CARDINAL     count        = Pop();
+	CARDINAL     destOffset   = Pop();
+	LONG_POINTER destBase     = PopLong();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  BYTBLT    %8X+%5d %8X+%5d %5d", savedPC, sourceBase, sourceOffset, destBase, destOffset, count);
+
+	while(count) {
+		const CARD32 s  = sourceBase + sourceOffset / 2;
+		const CARD32 sb = sourceOffset & 1;
+		const CARD32 d  = destBase   + destOffset / 2;
+		const CARD32 db = destOffset & 1;
+
+		CARD16* sp = Fetch(s);
+		CARD16* dp = Store(d);
+		// NO PAGE FAULT AFTER THIS
+
+		// run is limited by end of page and wrap around of offset
+		CARD32 run = count;
+		run = qMin(run, (PageSize - (s & MASK_OFFSET)) * 2 - sb);
+		run = qMin(run, (PageSize - (d & MASK_OFFSET)) * 2 - db);
+		run = qMin(run, (CARD32)(0x10000 - sourceOffset));
+		run = qMin(run, (CARD32)(0x10000 - destOffset));
+
+		if (IsPropagate(sp, sb, dp, db, run)) {
+			// dest is in middle of source. Copy byte by byte to propagate bytes.
+			for(CARD32 i = 0; i < run; i++) SetByte(dp, db + i, GetByte(sp, sb + i));
+		} else {
+			CopyBytes(dp, db, sp, sb, run);
+		}
+
+		sourceOffset += run;
+		destOffset   += run;
+		count        -= run;
+		if (count == 0) break;
+
+		// Update stack in case of PageFault
+		PushLong(destBase);
+		Push(destOffset);
+		Push(count);
+		PushLong(sourceBase);
+		Push(sourceOffset);
+		Discard();
+		Discard(); Discard();
+		Discard();
+		Discard();
+		Discard(); Discard();
+
+		if (DEBUG_FORCE_ABORT) {
+			PC = savedPC;
+			SP = savedSP;
+			ERROR_Abort();
+		}
+	}
+}
+#else
 void E_BYTBLT() {
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  BYTBLT", savedPC);
 	for(;;) {
@@ -589,10 +703,73 @@ void E_BYTBLT() {
 		}
 	}
 }
+#endif
 
 
 // aBYTBLTR - 056
-// TODO need to implements fast version of E_BYTBLTR
+#ifdef USE_FAST_BLT
+void E_BYTBLTR() {
+	CARDINAL     sourceOffset = Pop();
+	LONG_POINTER sourceBase   = PopLong();
+	CARDINAL     count        = Pop();
+	CARDINAL     destOffset   = Pop();
+	LONG_POINTER destBase     = PopLong();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  BYTBLTR   %8X+%5d %8X+%5d %5d", savedPC, sourceBase, sourceOffset, destBase, destOffset, count);
+
+	while(count) {
+		// last byte of remaining bytes
+		const CARD32 se = (CARD32)sourceOffset + (CARD32)count - 1;
+		const CARD32 de = (CARD32)destOffset   + (CARD32)count - 1;
+		const CARD32 s  = sourceBase + se / 2;
+		const CARD32 d  = destBase   + de / 2;
+
+		CARD16* sp = Fetch(s);
+		CARD16* dp = Store(d);
+		// NO PAGE FAULT AFTER THIS
+
+		// run is limited by start of page
+		CARD32 run = count;
+		run = qMin(run, (s & MASK_OFFSET) * 2 + (se & 1) + 1);
+		run = qMin(run, (d & MASK_OFFSET) * 2 + (de & 1) + 1);
+
+		// first byte of run
+		const CARD32 sf = se + 1 - run;
+		const CARD32 df = de + 1 - run;
+		sp -= s - (sourceBase + sf / 2);
+		dp -= d - (destBase   + df / 2);
+		const CARD32 sb = sf & 1;
+		const CARD32 db = df & 1;
+
+		if (IsPropagate(dp, db, sp, sb, run)) {
+			// source is in middle of dest. Copy byte by byte from last byte to propagate bytes.
+			for(CARD32 i = run; 0 < i; i--) SetByte(dp, db + i - 1, GetByte(sp, sb + i - 1));
+		} else {
+			CopyBytes(dp, db, sp, sb, run);
+		}
+
+		count -= run;
+		if (count == 0) break;
+
+		// Update stack in case of PageFault
+		PushLong(destBase);
+		Push(destOffset);
+		Push(count);
+		PushLong(sourceBase);
+		Push(sourceOffset);
+		Discard();
+		Discard(); Discard();
+		Discard();
+		Discard();
+		Discard(); Discard();
+
+		if (DEBUG_FORCE_ABORT) {
+			PC = savedPC;
+			SP = savedSP;
+			ERROR_Abort();
+		}
+	}
+}
+#else
 void E_BYTBLTR() {
 	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  BYTBLTR", savedPC);
 	for(;;) {
@@ -620,4 +797,4 @@ void E_BYTBLTR() {
 		}
 	}
 }
-
+#endif
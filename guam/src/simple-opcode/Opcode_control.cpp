@@ -175,26 +175,34 @@ static inline void CheckForXferTraps(ControlLink dst, int type) {
 // 9.2.2 Frame Allocation Primitives
 
 // Alloc: PROC[fsi: FSIndex] RETURNS[LocalFrameHandle]
+// NOTE Alloc takes frame held by AVCache first. Access to AV uses host address from AVCache.
 static inline LocalFrameHandle Alloc(FSIndex fsi) {
+	CARD16* av = AVCache::getAV();
+	LocalFrameHandle frame;
 	AVItem item;
 	FSIndex slot = fsi;
 	for(;;) {
-		item.u = *FetchMds(AV + OFFSET_AV(slot));
+		if (AVCache::allocFrame(slot, frame)) return frame;
+		item.u = av[slot];
 		if (item.tag != AT_indirect) break;
 		if (FSIndex_SIZE <= item.data) ERROR();
 		slot = item.data;
 	}
 	if (item.tag == AT_empty) FrameFault(fsi);
-	*StoreMds(AV + OFFSET_AV(slot)) = *FetchMds(AVLink(item.u));
+	AVCache::allocMiss();
+	av[slot] = *FetchMds(AVLink(item.u));
 	return AVFrame(item.u);
 }
 
 // Free: PROC[frame: LocalFrameHandle]
+// NOTE Free holds frame in AVCache. Frame is linked to AV when AVCache is full or flushed.
 static inline void Free(LocalFrameHandle frame) {
 	LocalWord word = {*FetchMds(LO_OFFSET(frame, word))};
-	AVItem item = {*FetchMds(AV + OFFSET_AV(word.fsi))};
+	CARD16* av = AVCache::getAV();
+	if (AVCache::freeFrame(word.fsi, frame)) return;
+	AVItem item = {av[word.fsi]};
 	*StoreMds(frame) = item.u;
-	*StoreMds(AV + OFFSET_AV(word.fsi)) = frame;
+	av[word.fsi] = frame;
 }
 
 // 9.3 Control Transfer Primitives
@@ -213,8 +221,10 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 	CARD16 oldGFI = GFI;
 #endif
 
+	if (PERF_ENABLE) perf_Xfer++;
 	if (type == XT_trap && freeFlag) ERROR();
 	while (ControlLinkType(nDst) == LT_indirect ) {
+		if (PERF_ENABLE) perf_XferIndirect++;
 		IndirectLink link = MakeIndirectLink(nDst);
 		if (type == XT_trap) ERROR();
 		nDst = ReadDblMds(link);
@@ -224,6 +234,7 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 	switch (ControlLinkType(nDst)) {
 	case LT_oldProcedure : {
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  LT_oldProcedure");
+		if (PERF_ENABLE) perf_XferOldProc++;
 		ProcDesc proc = {MakeProcDesc(nDst)};
 		CARD16 gf = proc.taggedGF & 0xfffc; // 177774
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  gf  = %04X", gf);
@@ -231,15 +242,23 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 		GFI = *FetchMds(GO_OFFSET(gf, word)) & 0xfffc; // 177774
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  GFI = %04X", GFI);
 		if (GFI == 0) UnboundTrap(dst);
-		GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
-		if (GF != LengthenPointer(gf)) ERROR(); // Sanity check
-		CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
-		if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
-		if (CodeCache::CB() & 1) {
+		GFTCache::Entry* entry = GFTCache::findGFI(GFI);
+		if (entry) {
+			GF = entry->gf;
+			if (GF != LengthenPointer(gf)) ERROR(); // Sanity check
+			CodeCache::setCB(entry->cb);
+		} else {
+			GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
+			if (GF != LengthenPointer(gf)) ERROR(); // Sanity check
+			CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
+			if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
+			if (CodeCache::CB() & 1) {
 #ifdef TRACE_CODETRAP
-			logger.debug("XFER  CODETRAP  OLD  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
+				logger.debug("XFER  CODETRAP  OLD  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
 #endif
-			CodeTrap(GFI);
+				CodeTrap(GFI);
+			}
+			GFTCache::addGFI(GFI, GF, CodeCache::CB());
 		}
 		nPC = proc.pc;
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  nPC = %6o", nPC);
@@ -256,6 +275,7 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 		break;
 	case LT_frame : {
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  LT_frame");
+		if (PERF_ENABLE) perf_XferFrame++;
 		FrameLink frame = {MakeFrameLink(nDst)};
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  frame = %04X", frame);
 		if (frame == 0) ControlTrap(src);
@@ -264,14 +284,21 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 		GFI = *FetchMds(LO_OFFSET(nLF, globallink));
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  GFI = %04X", GFI);
 		if (GFI == 0) UnboundTrap(dst);
-		GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
-		CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
-		if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
-		if (CodeCache::CB() & 1) {
+		GFTCache::Entry* entry = GFTCache::findGFI(GFI);
+		if (entry) {
+			GF = entry->gf;
+			CodeCache::setCB(entry->cb);
+		} else {
+			GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
+			CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
+			if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
+			if (CodeCache::CB() & 1) {
 #ifdef TRACE_CODETRAP
-			logger.debug("XFER  CODETRAP  FRA  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
+				logger.debug("XFER  CODETRAP  FRA  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
 #endif
-			CodeTrap(GFI);
+				CodeTrap(GFI);
+			}
+			GFTCache::addGFI(GFI, GF, CodeCache::CB());
 		}
 		nPC = *FetchMds(LO_OFFSET(nLF, pc));
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  nPC = %6o", nPC);
@@ -285,24 +312,36 @@ void XFER(ControlLink dst, ShortControlLink src, XferType type, int freeFlag = 0
 		break;
 	case LT_newProcedure : {
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  LT_newProcedure");
+		if (PERF_ENABLE) perf_XferNewProc++;
 		NewProcDesc proc = {MakeNewProcDesc(nDst)};
-		GFI = proc.taggedGFI & 0xfffc; // 177774
-		if (DEBUG_TRACE_XFER) logger.debug("XFER  GFI = %04X", GFI);
-		if (GFI == 0) UnboundTrap(dst);
-		GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
-		CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
-		if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
-		if (CodeCache::CB() & 1) {
+		FSIndex fsi;
+		GFTCache::Entry* entry = GFTCache::findProc(nDst);
+		if (entry) {
+			GFI = entry->gfi;
+			GF  = entry->gf;
+			CodeCache::setCB(entry->cb);
+			nPC = proc.pc;
+			fsi = entry->fsi;
+		} else {
+			GFI = proc.taggedGFI & 0xfffc; // 177774
+			if (DEBUG_TRACE_XFER) logger.debug("XFER  GFI = %04X", GFI);
+			if (GFI == 0) UnboundTrap(dst);
+			GF = ReadDbl(GFT_OFFSET(GFI, globalFrame));
+			CodeCache::setCB(ReadDbl(GFT_OFFSET(GFI, codebase)));
+			if (DEBUG_TRACE_XFER) logger.debug("XFER  GF  = %08X  CB = %08X", GF, CodeCache::CB());
+			if (CodeCache::CB() & 1) {
 #ifdef TRACE_CODETRAP
-			logger.debug("XFER  CODETRAP  NEW  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
+				logger.debug("XFER  CODETRAP  NEW  GFI = %04X  GF = %08X  CB = %08X", GFI, GF, CodeCache::CB());
 #endif
-			CodeTrap(GFI);
+				CodeTrap(GFI);
+			}
+			nPC = proc.pc;
+			if (DEBUG_TRACE_XFER) logger.debug("XFER  nPC = %6o", nPC);
+			if (nPC == 0) UnboundTrap(dst);
+			BytePair word = { ReadCode(nPC / 2) };
+			fsi = ((nPC % 2) == 0) ? word.left : word.right;
+			GFTCache::addProc(nDst, GFI, GF, CodeCache::CB(), nPC, fsi);
 		}
-		nPC = proc.pc;
-		if (DEBUG_TRACE_XFER) logger.debug("XFER  nPC = %6o", nPC);
-		if (nPC == 0) UnboundTrap(dst);
-		BytePair word = { ReadCode(nPC / 2) };
-		FSIndex fsi = ((nPC % 2) == 0) ? word.left : word.right;
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  fsi = %2d", fsi);
 		nLF = Alloc(fsi);
 		if (DEBUG_TRACE_XFER) logger.debug("XFER  nLF = %04X", nLF);
@@ -0,0 +1,267 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Opcode_float.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("float");
+
+#include "../util/Debug.h"
+
+#include "../mesa/MesaBasic.h"
+#include "../mesa/Memory.h"
+#include "../mesa/Function.h"
+
+#include "Opcode.h"
+
+#include <cmath>
+
+// REAL is IEEE single precision number in round to nearest mode.
+// Operation that causes exception other than inexact result, or takes or returns
+// NaN, infinity or denormalized number, traps to software emulation as before.
+
+// Software emulation owns sticky flags and mode. FST is a shadow of them, so it
+// can only have a flag that emulation also has.
+//   FSTICKY always traps, and FST takes new value of sticky word before trap.
+//   Native operation sets inexact flag by trapping to emulation, so emulation
+//   sets the flag too. After that, inexact result is calculated natively.
+
+// Sticky flags of exception in FST. Layout is same as Ieee.ExceptionFlags.
+static const CARD16 FLAG_INEXACT = 0x4000;
+static const CARD16 MASK_FLAGS   = 0xFC00;
+// Other bits of FST are rounding mode and trap enable. Native operation supports only
+// default of them (round to nearest and no trap), otherwise traps to software emulation.
+__attribute__((always_inline)) static inline void CheckMode(CARD8 opcode) {
+	if (FST & ~MASK_FLAGS) EscOpcodeTrap(opcode);
+}
+__attribute__((always_inline)) static inline void SetInexact(CARD8 opcode) {
+	if (FST & FLAG_INEXACT) return;
+	FST |= FLAG_INEXACT;
+	EscOpcodeTrap(opcode);
+}
+
+// First word of REAL has sign and exponent. So halves of REAL on stack is swapped from LONG.
+__attribute__((always_inline)) static inline float PopReal() {
+	union {
+		CARD32 u;
+		float  f;
+	} t;
+	CARD32 v = PopLong();
+	t.u = ((CARD32)LowHalf(v) << WordSize) | HighHalf(v);
+	return t.f;
+}
+__attribute__((always_inline)) static inline void PushReal(float f) {
+	union {
+		CARD32 u;
+		float  f;
+	} t;
+	t.f = f;
+	PushLong(((CARD32)LowHalf(t.u) << WordSize) | HighHalf(t.u));
+}
+
+__attribute__((always_inline)) static inline int IsNormal(float f) {
+	int c = std::fpclassify(f);
+	return c == FP_NORMAL || c == FP_ZERO;
+}
+__attribute__((always_inline)) static inline void CheckArg(CARD8 opcode, float a) {
+	CheckMode(opcode);
+	if (!IsNormal(a)) EscOpcodeTrap(opcode);
+}
+__attribute__((always_inline)) static inline void CheckArg(CARD8 opcode, float a, float b) {
+	CheckMode(opcode);
+	if (!IsNormal(a) || !IsNormal(b)) EscOpcodeTrap(opcode);
+}
+// Invalid operation, division by zero and overflow give NaN or infinity, and underflow gives
+// denormalized number or zero from nonzero. Exception flags of host are not used, because
+// compiler can move calculation across access of floating point environment.
+__attribute__((always_inline)) static inline void CheckResult(CARD8 opcode, float r, int underflow, int inexact) {
+	if (!IsNormal(r) || underflow) EscOpcodeTrap(opcode);
+	if (inexact) SetInexact(opcode);
+}
+// r is a after rounding. Trap if r is outside of [low..high].
+__attribute__((always_inline)) static inline void CheckInteger(CARD8 opcode, float a, float r, double low, double high) {
+	if (r < low || high < r) EscOpcodeTrap(opcode);
+	if (r != a) SetInexact(opcode);
+}
+
+// 0100  ASSIGN_ESC(a, FADD)
+void E_FADD() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FADD   %g %g", savedPC, a, b);
+	CheckArg(aFADD, a, b);
+	float r = a + b;
+	// error of addition is exact, and r is exact if a - (r - b) and b - (r - a) are zero
+	CheckResult(aFADD, r, 0, (a - (r - b)) != 0 || (b - (r - a)) != 0);
+	PushReal(r);
+}
+// 0101  ASSIGN_ESC(a, FSUB)
+void E_FSUB() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FSUB   %g %g", savedPC, a, b);
+	CheckArg(aFSUB, a, b);
+	float r = a - b;
+	CheckResult(aFSUB, r, 0, (a - (r + b)) != 0 || (b - (a - r)) != 0);
+	PushReal(r);
+}
+// 0102  ASSIGN_ESC(a, FMUL)
+void E_FMUL() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FMUL   %g %g", savedPC, a, b);
+	CheckArg(aFMUL, a, b);
+	float r = a * b;
+	// product of two single precision number is exact in double precision
+	double d = (double)a * (double)b;
+	CheckResult(aFMUL, r, r == 0 && d != 0, r != d);
+	PushReal(r);
+}
+// 0103  ASSIGN_ESC(a, FDIV)
+void E_FDIV() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FDIV   %g %g", savedPC, a, b);
+	CheckArg(aFDIV, a, b);
+	float r = a / b;
+	CheckResult(aFDIV, r, r == 0 && a != 0, (double)r * (double)b != a);
+	PushReal(r);
+}
+// 0104  ASSIGN_ESC(a, FCOMP)
+void E_FCOMP() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FCOMP  %g %g", savedPC, a, b);
+	CheckArg(aFCOMP, a, b);
+	Push((CARD16)((a < b) ? -1 : ((a == b) ? 0 : 1)));
+}
+// 0105  ASSIGN_ESC(a, FIX)
+void E_FIX() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FIX    %g", savedPC, a);
+	CheckArg(aFIX, a);
+	float r = std::trunc(a);
+	CheckInteger(aFIX, a, r, -2147483648.0, 2147483647.0);
+	PushLong((CARD32)(INT32)r);
+}
+// 0106  ASSIGN_ESC(a, FLOAT)
+void E_FLOAT() {
+	INT32 a = PopLong();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FLOAT  %d", savedPC, a);
+	CheckMode(aFLOAT);
+	float r = (float)a;
+	CheckResult(aFLOAT, r, 0, (double)r != a);
+	PushReal(r);
+}
+// 0107  ASSIGN_ESC(a, FIXI)
+void E_FIXI() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FIXI   %g", savedPC, a);
+	CheckArg(aFIXI, a);
+	float r = std::trunc(a);
+	CheckInteger(aFIXI, a, r, -32768.0, 32767.0);
+	Push((CARD16)(INT16)r);
+}
+
+// 0110  ASSIGN_ESC(a, FIXC)
+void E_FIXC() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FIXC   %g", savedPC, a);
+	CheckArg(aFIXC, a);
+	float r = std::trunc(a);
+	CheckInteger(aFIXC, a, r, 0.0, 65535.0);
+	Push((CARD16)r);
+}
+// 0111  ASSIGN_ESC(a, FSTICKY)
+void E_FSTICKY() {
+	CARD16 newValue = Pop();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FSTICKY %04X %04X", savedPC, FST, newValue);
+	FST = newValue;
+	EscOpcodeTrap(aFSTICKY);
+}
+// 0112  ASSIGN_ESC(a, FREM)
+void E_FREM() {
+	float b = PopReal();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FREM   %g %g", savedPC, a, b);
+	CheckArg(aFREM, a, b);
+	if (b == 0) EscOpcodeTrap(aFREM);
+	// remainder is always exact
+	float r = std::remainder(a, b);
+	CheckResult(aFREM, r, 0, 0);
+	PushReal(r);
+}
+// 0113  ASSIGN_ESC(a, ROUND)
+void E_ROUND() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  ROUND  %g", savedPC, a);
+	CheckArg(aROUND, a);
+	float r = std::nearbyint(a);
+	CheckInteger(aROUND, a, r, -2147483648.0, 2147483647.0);
+	PushLong((CARD32)(INT32)r);
+}
+// 0114  ASSIGN_ESC(a, ROUNDI)
+void E_ROUNDI() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  ROUNDI %g", savedPC, a);
+	CheckArg(aROUNDI, a);
+	float r = std::nearbyint(a);
+	CheckInteger(aROUNDI, a, r, -32768.0, 32767.0);
+	Push((CARD16)(INT16)r);
+}
+// 0115  ASSIGN_ESC(a, ROUNDC)
+void E_ROUNDC() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  ROUNDC %g", savedPC, a);
+	CheckArg(aROUNDC, a);
+	float r = std::nearbyint(a);
+	CheckInteger(aROUNDC, a, r, 0.0, 65535.0);
+	Push((CARD16)r);
+}
+// 0116  ASSIGN_ESC(a, FSQRT)
+void E_FSQRT() {
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FSQRT  %g", savedPC, a);
+	CheckArg(aFSQRT, a);
+	if (a < 0) EscOpcodeTrap(aFSQRT);
+	float r = std::sqrt(a);
+	CheckResult(aFSQRT, r, 0, (double)r * (double)r != a);
+	PushReal(r);
+}
+// 0117  ASSIGN_ESC(a, FSC)
+void E_FSC() {
+	INT16 n = Pop();
+	float a = PopReal();
+	if (DEBUG_TRACE_OPCODE) logger.debug("TRACE %6o  FSC    %g %d", savedPC, a, n);
+	CheckArg(aFSC, a);
+	float r = std::ldexp(a, n);
+	CheckResult(aFSC, r, r == 0 && a != 0, 0);
+	PushReal(r);
+}
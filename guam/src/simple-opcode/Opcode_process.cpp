@@ -40,9 +40,12 @@ static log4cpp::Category& logger = Logger::getLogger("process");
 #include "../mesa/Memory.h"
 #include "../mesa/Function.h"
 #include "../mesa/MesaThread.h"
+#include "../mesa/Trace.h"
 
 #include "Opcode.h"
 
+#include <algorithm>
+
 #define OFFSET_PDA(m)      OFFSET(ProcessDataArea, m)
 #define OFFSET_PDA2(m,n)   OFFSET3(ProcessDataArea, m, n)
 #define OFFSET_PDA3(m,n,o) OFFSET4(ProcessDataArea, m, n, o)
@@ -52,6 +55,153 @@ static log4cpp::Category& logger = Logger::getLogger("process");
 
 //#define TRACE_RESCHEDULE
 
+// Ready queue cache
+//   Host side copy of ready queue to find process to run and position to enqueue without walking ready queue.
+//   readyList[pri] has PSB of priority pri in order of ready queue. readyMask has bit of priority that has
+//   ready PSB. Free state vector is not cached, because Mesa code can change state of PDA directly.
+//   Enqueue and Dequeue update the cache. Before use, the cache is compared with
+//   ready queue in PDA, and is rebuilt from PDA when they are different.
+static QVector<PsbIndex> readyList[Priority_SIZE];
+static CARD16            readyMask  = 0;
+static int               readyValid = 0;
+// Time in microseconds when PSB is placed in ready queue
+static CARD32            readyTime[PsbIndex_SIZE];
+
+static inline int IsReadyQueue(LONG_POINTER que) {
+	return que == PDA + OFFSET_PDA(ready);
+}
+static inline int HighestPriority(CARD16 mask) {
+	return 31 - __builtin_clz(mask);
+}
+static inline int LowestPriority(CARD16 mask) {
+	return __builtin_ctz(mask);
+}
+static inline PsbIndex ReadyHead() {
+	return readyList[HighestPriority(readyMask)].first();
+}
+static inline PsbIndex ReadyTail() {
+	return readyList[LowestPriority(readyMask)].last();
+}
+
+// Build cache from PDA. Cache is valid only if ready queue is ordered by priority.
+static void BuildReadyCache() {
+	if (PERF_ENABLE) perf_ReadyRebuild++;
+	for(int i = 0; i < Priority_SIZE; i++) readyList[i].clear();
+	readyMask  = 0;
+	readyValid = 1;
+
+	Queue queue = {*FetchPda(OFFSET_PDA(ready))};
+	if (queue.tail == PsbNull) return;
+	PsbLink link = {*FetchPda(OFFSET_PDA3(block, queue.tail, link))};
+	CARD16 lastPriority = Priority_SIZE - 1;
+	for(int i = 0; i < PsbIndex_SIZE; i++) {
+		PsbIndex psb = link.next;
+		link.u = *FetchPda(OFFSET_PDA3(block, psb, link));
+		if (lastPriority < link.priority) readyValid = 0;
+		lastPriority = link.priority;
+		readyList[link.priority].append(psb);
+		readyMask |= 1 << link.priority;
+		if (psb == queue.tail) return;
+	}
+	logger.fatal("%s ready queue is not circular", __FUNCTION__);
+	ERROR();
+}
+// Compare order and priority of whole cache with ready queue in PDA. Cache is not changed.
+static int CompareReadyCache(Queue queue) {
+	QVector<PsbIndex> list;
+	QVector<CARD16>   priority;
+	for(CARD16 mask = readyMask; mask; mask &= ~(1 << HighestPriority(mask))) {
+		CARD16 pri = HighestPriority(mask);
+		list += readyList[pri];
+		priority += QVector<CARD16>(readyList[pri].size(), pri);
+	}
+	if (queue.tail == PsbNull) return list.isEmpty();
+
+	PsbLink link = {*FetchPda(OFFSET_PDA3(block, queue.tail, link))};
+	for(int i = 0; i < list.size(); i++) {
+		PsbIndex psb = link.next;
+		link.u = *FetchPda(OFFSET_PDA3(block, psb, link));
+		if (psb != list[i] || link.priority != priority[i]) return 0;
+		if (psb == queue.tail) return i == list.size() - 1;
+	}
+	// ready queue is longer than cache
+	return 0;
+}
+// Compare head and tail of cache with ready queue in PDA.
+//   With DEBUG_CHECK_READY_CACHE, whole cache is compared and inconsistency is reported.
+static inline int CheckReadyCache(Queue queue) {
+	if (!readyValid) return 0;
+	int ret;
+	if (queue.tail == PsbNull) {
+		ret = readyMask == 0;
+	} else if (readyMask == 0 || queue.tail != ReadyTail()) {
+		ret = 0;
+	} else {
+		PsbLink link = {*FetchPda(OFFSET_PDA3(block, queue.tail, link))};
+		ret = link.next == ReadyHead();
+	}
+	// Head and tail are same but others are different
+	if (DEBUG_CHECK_READY_CACHE && ret && !CompareReadyCache(queue)) {
+		logger.fatal("%s ready queue cache is not consistent  readyMask %02X", __FUNCTION__, readyMask);
+		ERROR();
+	}
+	return ret;
+}
+// Find PSB to run from cache in same order as Reschedule. Set PsbNull to ret if there is no PSB to run.
+// Return false if priority of PSB is changed outside of cache.
+static int FindReadyCache(PsbIndex& ret) {
+	for(CARD16 mask = readyMask; mask; mask &= ~(1 << HighestPriority(mask))) {
+		CARD16 pri = HighestPriority(mask);
+		// one fetch of state vector for each priority
+		const int hasState = !EmptyState(pri);
+		for(PsbIndex psb: readyList[pri]) {
+			PsbLink link = {*FetchPda(OFFSET_PDA3(block, psb, link))};
+			if (link.priority != pri) {
+				readyValid = 0;
+				return 0;
+			}
+			if (link.permanent || link.preempted || hasState) {
+				ret = psb;
+				return 1;
+			}
+		}
+	}
+	ret = PsbNull;
+	return 1;
+}
+// Return PSB that is placed before psb when psb is enqueued to ready queue. Return PsbNull if not found in cache.
+static PsbIndex FindEnqueuePosition(PsbLink link) {
+	// psb is placed after last PSB whose priority is equal or higher than psb
+	// If there is no such PSB, psb is placed after tail as new head.
+	CARD16 higher = readyMask & ~((1 << link.priority) - 1);
+	CARD16 lower  = readyMask &  ((1 << link.priority) - 1);
+	if (lower == 0) return PsbNull;
+	PsbIndex prev = higher ? readyList[LowestPriority(higher)].last() : ReadyTail();
+	PsbIndex next = readyList[HighestPriority(lower)].first();
+	PsbLink prevLink = {*FetchPda(OFFSET_PDA3(block, prev, link))};
+	if (prevLink.next != next) return PsbNull;
+	if (higher && prevLink.priority < link.priority) return PsbNull;
+	return prev;
+}
+static void AddReadyCache(PsbIndex psb, CARD16 priority) {
+	if (PERF_ENABLE) readyTime[psb] = Util::getMicroTime();
+	if (!readyValid) return;
+	readyList[priority].append(psb);
+	readyMask |= 1 << priority;
+}
+static void RemoveReadyCache(PsbIndex psb, CARD16 priority) {
+	if (!readyValid) return;
+	QVector<PsbIndex>& list = readyList[priority];
+	int index = list.indexOf(psb);
+	if (index < 0) {
+		readyValid = 0;
+		return;
+	}
+	list.remove(index);
+	if (list.isEmpty()) readyMask &= ~(1 << priority);
+}
+
+
 // 10.3.1 Queuing Procedures
 
 // Dequeue: PROC[src: LONG POINTER, ps: PsbIndex]
@@ -82,6 +232,7 @@ static void Dequeue(LONG_POINTER src, PsbIndex psb) {
 		queue.tail = prev;
 		*Store(que) = queue.u;
 	}
+	if (que != 0 && IsReadyQueue(que)) RemoveReadyCache(psb, link.priority);
 }
 
 // Equeue: PROC[dst: LONG POINTER, psb: PsbIndex]
@@ -101,11 +252,17 @@ static void Enqueue(LONG_POINTER dst, PsbIndex psb) {
 			queue.tail = psb;
 			*Store(que) = queue.u;
 		} else {
-			for(;;) {
-				PsbLink nextlink = {*FetchPda(OFFSET_PDA3(block, currentlink.next, link))};
-				if (nextlink.priority < link.priority) break;
-				prev = currentlink.next;
-				currentlink = nextlink;
+			PsbIndex position = (IsReadyQueue(que) && CheckReadyCache(queue)) ? FindEnqueuePosition(link) : PsbNull;
+			if (position != PsbNull) {
+				prev = position;
+				currentlink.u = *FetchPda(OFFSET_PDA3(block, prev, link));
+			} else {
+				for(;;) {
+					PsbLink nextlink = {*FetchPda(OFFSET_PDA3(block, currentlink.next, link))};
+					if (nextlink.priority < link.priority) break;
+					prev = currentlink.next;
+					currentlink = nextlink;
+				}
 			}
 		}
 		link.next = currentlink.next;
@@ -113,6 +270,7 @@ static void Enqueue(LONG_POINTER dst, PsbIndex psb) {
 		currentlink.next = psb;
 		*StorePda(OFFSET_PDA3(block, prev, link)) = currentlink.u;
 	}
+	if (IsReadyQueue(que)) AddReadyCache(psb, link.priority);
 }
 
 // Requeue: PROC[src, dst: LONG POINTER, psb: PsbIndex]
@@ -134,7 +292,8 @@ static LONG_POINTER AllocState(CARD16 pri) {
 	PDA_POINTER offset = *FetchPda(OFFSET_PDA2(state, pri));
 	if (offset == 0) ERROR();
 	StateHandle state = LengthenPdaPtr(offset);
-	*StorePda(OFFSET_PDA2(state, pri)) = *Fetch(state);
+	CARD16 next = *Fetch(state);
+	*StorePda(OFFSET_PDA2(state, pri)) = next;
 	return state;
 }
 
@@ -196,6 +355,8 @@ LocalFrameHandle LoadProcess() {
 			}
 		}
 		CARD32 mds = *FetchPda(OFFSET_PDA3(block, PSB, mds)) << WordSize;
+		// Link frames held by AVCache to AV of current MDS
+		AVCache::invalidate();
 		Memory::setMDS(mds);
 		return frame;
 	} catch (Abort &abort) {
@@ -217,15 +378,27 @@ void Reschedule(int preemption) {
 	CARD16 oldLF  = LFCache::LF();
 #endif
 
+	if (PERF_ENABLE) perf_Reschedule++;
 	if (ProcessorThread::getRunning()) SaveProcess(preemption);
 	Queue queue = {*FetchPda(OFFSET_PDA(ready))};
-	if (queue.tail == PsbNull) goto BusyWait;
-	link.u = *FetchPda(OFFSET_PDA3(block, queue.tail, link));
-	for(;;) {
-		psb = link.next;
-		link.u = *FetchPda(OFFSET_PDA3(block, psb, link));
-		if (link.permanent || link.preempted || !EmptyState(link.priority)) break;
-		if (psb == queue.tail) goto BusyWait;
+	if (CheckReadyCache(queue) && FindReadyCache(psb)) {
+		if (psb == PsbNull) goto BusyWait;
+	} else {
+		BuildReadyCache();
+		if (queue.tail == PsbNull) goto BusyWait;
+		link.u = *FetchPda(OFFSET_PDA3(block, queue.tail, link));
+		for(;;) {
+			psb = link.next;
+			link.u = *FetchPda(OFFSET_PDA3(block, psb, link));
+			if (link.permanent || link.preempted || !EmptyState(link.priority)) break;
+			if (psb == queue.tail) goto BusyWait;
+		}
+	}
+	if (PERF_ENABLE && psb != PSB) {
+		CARD32 latency = Util::getMicroTime() - readyTime[psb];
+		perf_ProcessSwitch++;
+		perf_SwitchLatency += latency;
+		if (perf_SwitchLatMax < latency) perf_SwitchLatMax = latency;
 	}
 	PSB = psb;
 	PC = savedPC = 0;
@@ -356,6 +529,7 @@ int ProcessInterrupt() {
 	int requeue = 0;
 	UNSPEC wakeups = InterruptThread::getWP();
 	InterruptThread::setWP(0);
+	if (Trace::isEnabled()) wakeups = (UNSPEC)Trace::value(Trace::T_wakeup, wakeups);
 	for(int level = InterruptLevel_SIZE - 1; 0 <= level; level--) {
 		if (wakeups & mask) requeue = NotifyWakeup(PDA + OFFSET_PDA3(interrupt, level, condition)) || requeue;
 		mask = Shift(mask, 1);
@@ -403,6 +577,8 @@ static void FaultTwo(FaultIndex fi, LONG_UNSPEC parameter) {
 // FrameFault: PROC[fsi: FSIndex]
 void FrameFault(FSIndex fsi) {
 	if (PERF_ENABLE) perf_FrameFault++;
+	// Fault handler will fill AV
+	AVCache::invalidate();
 	if (DEBUG_SHOW_FRAME_FAULT) {
 		if (Opcode::getLast()) {
 			logger.debug("%-10s %8d  %-8s  %8X+%4X  %8X", __FUNCTION__, fsi, Opcode::getLast()->getName(), CodeCache::CB(), savedPC, (CodeCache::CB() + savedPC));
@@ -435,23 +611,112 @@ void WriteProtectFault(LONG_POINTER ptr) {
 
 // 10.4.5 Timeouts
 
-// TimeoutScan: PROC RETURNS [BOOLEAN]
-int TimeoutScan() {
-	int requeue = 0;
+// Timeout wheel
+//   Mirror of PSB that has timeout to avoid scanning all PSB at every tick.
+//   PSB is placed in slot of its timeout. MW adds PSB when it stores timeout.
+//   Timeout of PSB is read again when its slot is scanned. So entry of PSB whose
+//   timeout is cleared or changed is removed at that time.
+//   Timeout stored by Mesa code is found by PsbWatch. PSB in stored page is added
+//   again before scan of slot, so the wheel has same timeout as all PSB at every tick.
+static const CARD16 TIMEOUT_WHEEL_SIZE = 256;
+static const CARD16 TIMEOUT_WHEEL_MASK = TIMEOUT_WHEEL_SIZE - 1;
+
+static QVector<PsbIndex> timeoutWheel[TIMEOUT_WHEEL_SIZE];
+static int               timeoutWheelReady = 0;
+
+static void AddTimeout(PsbIndex psb, Ticks timeout) {
+	if (timeout == 0) return;
+	QVector<PsbIndex>& slot = timeoutWheel[timeout & TIMEOUT_WHEEL_MASK];
+	if (!slot.contains(psb)) slot.append(psb);
+}
+// Build timeout wheel from all PSB
+static void BuildTimeoutWheel() {
+	for(int i = 0; i < TIMEOUT_WHEEL_SIZE; i++) timeoutWheel[i].clear();
+	CARDINAL count = *FetchPda(OFFSET_PDA(count));
+	for(PsbIndex psb = StartPsb; psb < (StartPsb + count); psb++) {
+		AddTimeout(psb, *FetchPda(OFFSET_PDA3(block, psb, timeout)));
+	}
+	PsbWatch::clear();
+	timeoutWheelReady = 1;
+}
+// Add PSB in page stored by Mesa code
+static void UpdateTimeoutWheel() {
+	if (PsbWatch::getCount() == 0) return;
+	CARDINAL count = *FetchPda(OFFSET_PDA(count));
+	for(int i = 0; i < PsbWatch::getCount(); i++) {
+		const CARD32 first = PsbWatch::getPage(i) * PsbWatch::PSB_PER_PAGE;
+		const CARD32 start = qMax(first, (CARD32)StartPsb);
+		const CARD32 end   = qMin(first + PsbWatch::PSB_PER_PAGE, (CARD32)(StartPsb + count));
+		for(CARD32 psb = start; psb < end; psb++) {
+			AddTimeout(psb, *FetchPda(OFFSET_PDA3(block, psb, timeout)));
+		}
+	}
+	PsbWatch::clear();
+}
+// Return PSB that timeout is expired by scanning all PSB
+static QVector<PsbIndex> ScanAllTimeout(Ticks ptc) {
+	QVector<PsbIndex> ret;
 	CARDINAL count = *FetchPda(OFFSET_PDA(count));
 	for(PsbIndex psb = StartPsb; psb < (StartPsb + count); psb++) {
 		Ticks timeout = *FetchPda(OFFSET_PDA3(block, psb, timeout));
-		if (timeout && timeout == TimerThread::getPTC()) {
-			PsbFlags flags = {*FetchPda(OFFSET_PDA3(block, psb, flags))};
-			flags.waiting = 0;
-			*StorePda(OFFSET_PDA3(block, psb, flags)) = flags.u;
-			*StorePda(OFFSET_PDA3(block, psb, timeout)) = 0;
-			Requeue(0, PDA + OFFSET_PDA(ready), psb);
-			requeue = 1;
+		if (timeout && timeout == ptc) ret.append(psb);
+	}
+	return ret;
+}
+// Return PSB that timeout is expired from slot of timeout wheel in ascending order
+static QVector<PsbIndex> ScanTimeoutWheel(Ticks ptc) {
+	QVector<PsbIndex> ret;
+	QVector<PsbIndex>& slot = timeoutWheel[ptc & TIMEOUT_WHEEL_MASK];
+	int size = 0;
+	for(PsbIndex psb: slot) {
+		Ticks timeout = *FetchPda(OFFSET_PDA3(block, psb, timeout));
+		if (timeout == ptc) {
+			ret.append(psb);
+		} else if (timeout && (timeout & TIMEOUT_WHEEL_MASK) == (ptc & TIMEOUT_WHEEL_MASK)) {
+			// keep entry for later round
+			slot[size++] = psb;
+		}
+	}
+	slot.resize(size);
+
+	// Same order as scan of all PSB
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
+
+// TimeoutScan: PROC RETURNS [BOOLEAN]
+int TimeoutScan() {
+	Ticks ptc = TimerThread::getPTC();
+	if (timeoutWheelReady) {
+		UpdateTimeoutWheel();
+	} else {
+		BuildTimeoutWheel();
+	}
+	QVector<PsbIndex> list = ScanTimeoutWheel(ptc);
+	if (DEBUG_CHECK_TIMEOUT_WHEEL) {
+		QVector<PsbIndex> expect = ScanAllTimeout(ptc);
+		if (list != expect) {
+			logger.fatal("%s timeout wheel is not consistent  PTC = %04X  wheel = %d  all = %d", __FUNCTION__, ptc, list.size(), expect.size());
+			ERROR();
 		}
 	}
+
+	int requeue = 0;
+	for(PsbIndex psb: list) {
+		PsbFlags flags = {*FetchPda(OFFSET_PDA3(block, psb, flags))};
+		flags.waiting = 0;
+		*StorePda(OFFSET_PDA3(block, psb, flags)) = flags.u;
+		*StorePda(OFFSET_PDA3(block, psb, timeout)) = 0;
+		Requeue(0, PDA + OFFSET_PDA(ready), psb);
+		requeue = 1;
+	}
 	return requeue;
 }
+// Both cache are built again from PDA at next use
+void InvalidateProcessCache() {
+	readyValid        = 0;
+	timeoutWheelReady = 0;
+}
 // CheckForTimeouts: PROC RETURNS [BOOLEAN]
 //int CheckForTimeouts() {
 //	int ret = 0;
@@ -514,7 +779,9 @@ void E_MW() {
 			*Store(c) = cond.u;
 		} else {
 //			*StorePda(OFFSET_PDA3(block, PSB, timeout)) = ((t == 0) ? 0 : MAX(1U, (CARD16)((CARD32)PTC + (CARD32)t)));
-			*StorePda(OFFSET_PDA3(block, PSB, timeout)) = ((t == 0) ? 0 : MAX(1U, (CARD16)((CARD32)TimerThread::getPTC() + (CARD32)t)));
+			Ticks timeout = (t == 0) ? 0 : MAX(1U, (CARD16)((CARD32)TimerThread::getPTC() + (CARD32)t));
+			*StorePda(OFFSET_PDA3(block, PSB, timeout)) = timeout;
+			AddTimeout(PSB, timeout);
 			flags.waiting = 1;
 			*StorePda(OFFSET_PDA3(block, PSB, flags)) = flags.u;
 			Requeue(PDA + OFFSET_PDA(ready), c, PSB);
@@ -12,7 +12,10 @@ CONFIG  += staticlib
 HEADERS += Interpreter.h   Opcode.h
 SOURCES += Interpreter.cpp Opcode.cpp
 
-SOURCES += Opcode_bitblt.cpp Opcode_block.cpp Opcode_control.cpp Opcode_process.cpp Opcode_special.cpp
+HEADERS += Block.h
+SOURCES += Block.cpp
+
+SOURCES += Opcode_bitblt.cpp Opcode_block.cpp Opcode_control.cpp Opcode_float.cpp Opcode_process.cpp Opcode_special.cpp
 SOURCES += OpcodeMop0xx.cpp OpcodeMop1xx.cpp OpcodeMop2xx.cpp OpcodeMop3xx.cpp
 SOURCES += OpcodeEsc.cpp
 
@@ -38,6 +38,9 @@ static log4cpp::Category& logger = Logger::getLogger("main");
 #include "../bcd/BCDInfo.h"
 #include "../bcd/SymInfo.h"
 
+#include "../util/Batch.h"
+#include "../util/BuildCache.h"
+
 // Define PageFault and WriteProtectFault for BCDFile
 void PageFault(CARD32 ptr) {
 	logger.fatal("%s %X", __FUNCTION__, ptr);
@@ -50,7 +53,7 @@ void WriteProtectFault(CARD32 ptr) {
 
 static QList<BCDInfo> bcdAll;
 
-void processFile(const QDir& /*outDir*/, const QFileInfo& fileInfo) {
+void processFile(const QFileInfo& fileInfo, BCDInfo& bcdInfo) {
 	QFile jsonFile(fileInfo.filePath());
 
 	if (!jsonFile.open(QIODevice::ReadOnly)) {
@@ -74,79 +77,68 @@ void processFile(const QDir& /*outDir*/, const QFileInfo& fileInfo) {
 	}
 	QJsonObject jsonObject(jsonDocument.object());
 
-	BCDInfo bcdInfo(jsonObject);
-
-	bcdAll.append(bcdInfo);
+	bcdInfo = BCDInfo(jsonObject);
 }
 
 
-void processDir(const QDir& outDir, const QFileInfo& parentFileInfo) {
-	QDir parentDir(parentFileInfo.filePath());
+static QMap<QString, BCDInfo> bcdMap;
 
-	QList<QFileInfo> childFileInfoList = parentDir.entryInfoList(QDir::Filter::NoFilter, QDir::SortFlag::Name);
-	for(QFileInfo childFileInfo: childFileInfoList) {
-		QString childFileName(childFileInfo.fileName());
-		if (childFileInfo.isDir()) {
-			// Return if file is . or ..
-			if (childFileName == ".") continue;
-			if (childFileName == "..") continue;
+class SymbolsJob {
+public:
+	QString name;
+	QString version;
+	CARD16  base;
 
-			processDir(outDir, childFileInfo);
-		}
-		if (childFileInfo.isFile()) {
-			if (childFileName.endsWith(".json")) {
-				processFile(outDir, childFileInfo);
-			}
-		}
+	SymbolsJob() : base(0) {}
+	SymbolsJob(const QString& name_, const QString& version_, CARD16 base_) : name(name_), version(version_), base(base_) {}
+
+	QString getFileName() const {
+		return QString("%1-%2-%3.json").arg(name).arg(version).arg(base);
 	}
-}
+};
 
-static QMap<QString, BCDInfo> bcdMap;
-void processSymbols(const QDir& outDir, const QString& name, const QString& version, CARD16 base) {
-	if (bcdMap.contains(version)) {
-		QString path = bcdMap[version].path;
-		BCD bcd(path);
-
-		if (Symbols::isSymbolsSegment(&bcd, base)) {
-			// Found symbols segment
-			Symbols symbols(&bcd, base);
-
-			QJsonObject jsonObject;
-			SymInfo symInfo(symbols);
-			symInfo.setJsonValue(jsonObject);
-
-			// Output jsonObect to file
-			{
-				QJsonDocument jsonDoc(jsonObject);
-				QByteArray fileContents = jsonDoc.toJson(QJsonDocument::JsonFormat::Indented); // Compact or Indented
-
-				QFileInfo outFileInfo(outDir, QString("%1-%2-%3.json").arg(name).arg(version).arg(base));
-				logger.info("outFile %s", outFileInfo.fileName().toLocal8Bit().constData());
-
-				QString outFilePath = outFileInfo.filePath();
-				QFile outFile(outFilePath);
-				if (!outFile.open(QIODevice::OpenModeFlag::WriteOnly)) {
-					logger.fatal("File open error %s", outFile.errorString().toLocal8Bit().constData());
-					ERROR();
-				}
-				int fileLength = outFile.write(fileContents);
-				if (fileLength != fileContents.size()) {
-					logger.fatal("File write error %s  fileLength = %d  fileContents = %d", outFile.errorString().toLocal8Bit().constData(), fileLength, fileContents.size());
-					ERROR();
-				}
-				outFile.close();
-			}
-		} else {
+void processSymbols(const QDir& outDir, const QString& path, const SymbolsJob& job) {
+	BCD bcd(path);
+
+	QJsonObject jsonObject;
+	{
+		if (!Symbols::isSymbolsSegment(&bcd, job.base)) {
 			logger.fatal("Unexpected not symbol segment");
-			logger.fatal("path = %s  base = %d", path.toLocal8Bit().constData(), base);
+			logger.fatal("path = %s  base = %d", path.toLocal8Bit().constData(), job.base);
+			ERROR();
+		}
+
+		// Found symbols segment
+		Symbols symbols(&bcd, job.base);
+
+		SymInfo symInfo(symbols);
+		symInfo.setJsonValue(jsonObject);
+	}
+
+	// Output jsonObect to file
+	{
+		QJsonDocument jsonDoc(jsonObject);
+		QByteArray fileContents = jsonDoc.toJson(QJsonDocument::JsonFormat::Indented); // Compact or Indented
+
+		QFileInfo outFileInfo(outDir, job.getFileName());
+		logger.info("outFile %s", outFileInfo.fileName().toLocal8Bit().constData());
+
+		QString outFilePath = outFileInfo.filePath();
+		QFile outFile(outFilePath);
+		if (!outFile.open(QIODevice::OpenModeFlag::WriteOnly)) {
+			logger.fatal("File open error %s", outFile.errorString().toLocal8Bit().constData());
+			ERROR();
+		}
+		int fileLength = outFile.write(fileContents);
+		if (fileLength != fileContents.size()) {
+			logger.fatal("File write error %s  fileLength = %d  fileContents = %d", outFile.errorString().toLocal8Bit().constData(), fileLength, fileContents.size());
 			ERROR();
 		}
-	} else {
-		logger.warn("Not in bcdMap  %llu", version);
+		outFile.close();
 	}
 }
 
-int main(int /*argc*/, char** /*argv*/) {
+int main(int /*argc*/, char** argv) {
 	logger.info("START");
 
 	setSignalHandler();
@@ -186,7 +178,27 @@ int main(int /*argc*/, char** /*argv*/) {
 			}
 		}
 
-		processDir(outDir, QFileInfo(inDirPath));
+		Batch batch;
+
+		// Read json file of bcdInfo in parallel
+		{
+			QList<Batch::Entry> entryList = batch.scan(QStringList(inDirPath), [](const QFileInfo& fileInfo) {
+				return fileInfo.fileName().endsWith(".json");
+			});
+			QVector<BCDInfo> infoList(entryList.size());
+			BCDInfo* info = infoList.data();
+
+			int failCount = batch.run(entryList, [info](const Batch::Entry& entry) {
+				processFile(entry.fileInfo, info[entry.index]);
+				return QByteArray();
+			}, [info](const Batch::Entry& entry, const QByteArray& /*output*/) {
+				bcdAll.append(info[entry.index]);
+			});
+			if (failCount) {
+				logger.fatal("failCount = %d", failCount);
+				ERROR();
+			}
+		}
 		logger.info("bcdAll %d", bcdAll.size());
 
 		{
@@ -216,6 +228,23 @@ int main(int /*argc*/, char** /*argv*/) {
 		int countSym      = 0;
 		int countSymSelf  = 0;
 		int countSymMiss = 0;
+		QList<Batch::Entry> symbolsEntryList;
+		QList<SymbolsJob>   symbolsJobList;
+		QSet<QString>       symbolsFileNameSet;
+		auto addSymbols = [&](const QString& name, const QString& version, CARD16 base) {
+			if (!bcdMap.contains(version)) {
+				countSymMiss++;
+				logger.warn("Not in bcdMap  %s", version.toLocal8Bit().constData());
+				return;
+			}
+			SymbolsJob job(name, version, base);
+			// Same symbols segment produces same output file
+			if (symbolsFileNameSet.contains(job.getFileName())) return;
+			symbolsFileNameSet.insert(job.getFileName());
+
+			Batch::append(symbolsEntryList, QFileInfo(bcdMap[version].path));
+			symbolsJobList.append(job);
+		};
 		for(BCDInfo bcdInfo: bcdMap.values()) {
 			countBCD++;
 			logger.info("bcdInfo %s", bcdInfo.path.toLocal8Bit().constData());
@@ -243,18 +272,45 @@ int main(int /*argc*/, char** /*argv*/) {
 				} else if (sym.file.isSelf()) {
 					countSymSelf++;
 					logger.info("bcdInfo sym S %s %llu, %d", bcdInfo.path.toLocal8Bit().constData(), bcdInfo.version, sym.base);
-					processSymbols(outDir, mt.name, bcdInfo.version, sym.base);
+					addSymbols(mt.name, bcdInfo.version, sym.base);
 				} else {
 					countSym++;
 					logger.info("bcdInfo sym E %s %llu, %d", bcdInfo.path.toLocal8Bit().constData(), sym.file.version, sym.base);
 					logger.info("XX  %llu  %lld  %s", sym.file.version, sym.file.version, QString("%1").arg(sym.file.version).toLocal8Bit().constData());
-					processSymbols(outDir, mt.name, sym.file.version, sym.base);
+					addSymbols(mt.name, sym.file.version, sym.base);
 				}
 			}
 		}
+
+		// Skip symbols segment whose BCD file is not changed since last run.
+		//   Output file name contains version of BCD, so changed BCD produces new output file.
+		//   Output of symbols segment that is no longer in bcdMap is removed.
+		BuildCache cache(outDirPath + ".cache", argv[0]);
+		cache.load();
+		for(QString output: cache.removeStale(symbolsFileNameSet)) {
+			logger.info("remove %s", output.toLocal8Bit().constData());
+			QFile::remove(output);
+		}
+
+		// Output symInfo of each symbols segment in parallel
+		int failCount = batch.run(symbolsEntryList, [&outDir, &symbolsJobList, &cache](const Batch::Entry& entry) {
+			const SymbolsJob& job = symbolsJobList.at(entry.index);
+			if (cache.isUpToDate(job.getFileName(), entry.fileInfo)) return QByteArray();
+
+			processSymbols(outDir, entry.fileInfo.filePath(), job);
+			cache.update(job.getFileName(), entry.fileInfo, QString(), QStringList(outDir.absoluteFilePath(job.getFileName())));
+			return QByteArray();
+		}, [](const Batch::Entry& /*entry*/, const QByteArray& /*output*/) {});
+		cache.save();
+		logger.info("cache hit %d  miss %d", cache.getHit(), cache.getMiss());
+
 		logger.info("countBCD      = %5d  countMT   = %5d", countBCD, countMT);
 		logger.info("countCodeSelf = %5d  countCode = %5d  countCodeMiss = %5d", countCodeSelf, countCode, countCodeMiss);
 		logger.info("countSymSelf  = %5d  countSym  = %5d  countSymMiss  = %5d", countSymSelf,  countSym,  countSymMiss);
+		if (failCount) {
+			logger.fatal("failCount = %d", failCount);
+			ERROR();
+		}
 
 
 	} catch (Error& e) {
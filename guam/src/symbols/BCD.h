@@ -303,6 +303,7 @@ public:
 
 	BCD(QString path) : BCD(BCDFile::getInstance(path)) {}
 	BCD(CARD32 ptr) : BCD(BCDFile::getInstance(ptr)) {}
+	BCD(const QByteArray& data) : BCD(BCDFile::getInstance(data)) {}
 
 	~BCD();
 
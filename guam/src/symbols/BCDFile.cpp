@@ -39,22 +39,6 @@ static log4cpp::Category& logger = Logger::getLogger("bcdfile");
 #include "BCD.h"
 #include "Symbols.h"
 
-CARD16 BCDFile::getCARD16() {
-	CARD16 b0 = getCARD8();
-	CARD16 b1 = getCARD8();
-	return (b0 << 8) | b1;
-}
-CARD32 BCDFile::getCARD32() {
-	CARD32 b0 = getCARD16();
-	CARD32 b1 = getCARD16();
-	return (b1 << 16) | b0;
-}
-void   BCDFile::get(int size, CARD8* data) {
-	for(int i = 0; i < size; i++) {
-		data[i] = getCARD8();
-	}
-}
-
 bool BCDFile::isBCDFile() {
 	int oldPosition = getPosition();
 
@@ -78,12 +62,12 @@ bool BCDFile::isSymbolsFile() {
 
 
 //
-// BCDFileFile
+// BCDFileMap
 //
 
-class BCDFileFile : public BCDFile {
+class BCDFileMap : public BCDFile {
 public:
-	BCDFileFile(QString path_) : path(path_), file(path_) {
+	BCDFileMap(QString path_) : BCDFile(0), path(path_), file(path_), map(0) {
 		if (!file.exists()) {
 			logger.fatal("File does not exist. path = %s", path.toLocal8Bit().constData());
 			ERROR();
@@ -93,10 +77,22 @@ public:
 			logger.fatal("File open error %s", file.errorString().toLocal8Bit().constData());
 			ERROR();
 		}
-		capacity = file.size();
-		logger.info("%s  %s  %d", __FUNCTION__, path.toLocal8Bit().constData(), capacity);
+		length = (CARD32)file.size();
+		if (length) map = file.map(0, length);
+		if (map) {
+			buffer = map;
+		} else {
+			// Fall back to whole file read, if file cannot be mapped
+			data   = file.readAll();
+			buffer = (const CARD8*)data.constData();
+			file.close();
+		}
+		bufferBase = 0;
+		bufferSize = length;
+		logger.info("%s  %s  %d", __FUNCTION__, path.toLocal8Bit().constData(), length);
 	}
-	~BCDFileFile() {
+	~BCDFileMap() {
+		if (map) file.unmap(map);
 		if (file.isOpen()) file.close();
 	}
 
@@ -104,36 +100,52 @@ public:
 		return path;
 	}
 
-	int getPosition() {
-		return (int)file.pos();
+protected:
+	void fill(CARD32 position, CARD32 size) {
+		logger.fatal("Read beyond end of file  position = %d  size = %d  length = %d", position, size, length);
+		ERROR();
 	}
-	void setPosition(int newPosition) {
-		if (newPosition < 0) ERROR();
-		if (capacity <= newPosition) ERROR();
 
-		file.seek(newPosition);
+private:
+	QString    path;
+	QFile      file;
+	uchar*     map;
+	QByteArray data;
+};
+
+BCDFile* BCDFile::getInstance(QString path) {
+	return new BCDFileMap(path);
+}
+
+
+//
+// BCDFileData
+//
+
+class BCDFileData : public BCDFile {
+public:
+	BCDFileData(const QByteArray& data_) : BCDFile((CARD32)data_.size()), data(data_) {
+		buffer     = (const CARD8*)data.constData();
+		bufferBase = 0;
+		bufferSize = length;
 	}
-	CARD8 getCARD8() {
-		char data;
-		quint32 nRead = (quint32)file.read(&data, 1);
-		if (nRead != 1) {
-			logger.fatal("nRead %d", nRead);
-			ERROR();
-		}
-		return (CARD8)data;
+
+	QString getPath() {
+		return QString("#DATA-%1#").arg(length);
 	}
-	CARD32 getLength() {
-		return (CARD32)capacity;
+
+protected:
+	void fill(CARD32 position, CARD32 size) {
+		logger.fatal("Read beyond end of data  position = %d  size = %d  length = %d", position, size, length);
+		ERROR();
 	}
 
 private:
-	QString path;
-	QFile   file;
-	qint64  capacity;
+	QByteArray data;
 };
 
-BCDFile* BCDFile::getInstance(QString path) {
-	return new BCDFileFile(path);
+BCDFile* BCDFile::getInstance(const QByteArray& data) {
+	return new BCDFileData(data);
 }
 
 
@@ -150,9 +162,8 @@ BCDFile* BCDFile::getInstance(QString path) {
 
 class BCDFileMesaMemory : public BCDFile {
 public:
-	BCDFileMesaMemory(CARD32 ptr_) {
+	BCDFileMesaMemory(CARD32 ptr_) : BCDFile((CARD32)-1) {
 		ptr = ptr_;
-		pos = 0;
 		if (Memory::isVacant(ptr)) {
 			logger.fatal("ptr is not mapped. ptr = %X", ptr);
 			ERROR();
@@ -165,33 +176,38 @@ public:
 		logger.fatal("Unexpected call of %s", __FUNCTION__);
 		ERROR();
 	}
-	int getPosition() {
-		return pos;
-	}
-	void setPosition(int newPosition) {
-		if (newPosition < 0) ERROR();
-		pos = (CARD32)newPosition;
-	}
-	CARD8 getCARD8() {
-		CARD32 p = ptr + (pos / 2);
-		if (Memory::isVacant(p)) {
-//			logger.fatal("p is not mapped. p = %X", p);
-//			logBackTrace();
-			ERROR_Abort();
+
+protected:
+	// Copy words of mesa memory to data until end of page that contains position + size
+	void fill(CARD32 position, CARD32 size) {
+		CARD32 first = position / BYTES_PER_WORD;
+		CARD32 last  = (position + size + BYTES_PER_WORD - 1) / BYTES_PER_WORD;
+		last = ((last + PageSize - 1) / PageSize) * PageSize;
+
+		data.resize((last - first) * BYTES_PER_WORD);
+		CARD8* p = (CARD8*)data.data();
+		for(CARD32 i = first; i < last; i++) {
+			CARD32 va = ptr + i;
+			if ((i == first || (va % PageSize) == 0) && Memory::isVacant(va)) {
+				// Keep bytes before unmapped page
+				if (position + size <= i * BYTES_PER_WORD) break;
+//				logger.fatal("p is not mapped. p = %X", va);
+//				logBackTrace();
+				ERROR_Abort();
+			}
+			BytePair word = {*Fetch(va)};
+			*p++ = (CARD8)word.left;
+			*p++ = (CARD8)word.right;
 		}
-		BytePair word = {*Fetch(p)};
-		CARD8 data =  ((pos % 2) == 0) ? (BYTE)word.left : (BYTE)word.right;
 
-		pos++;
-		return data;
-	}
-	CARD32 getLength() {
-		return (CARD32)-1;
+		buffer     = (const CARD8*)data.constData();
+		bufferBase = first * BYTES_PER_WORD;
+		bufferSize = (CARD32)(p - buffer);
 	}
 
 private:
-	CARD32 ptr;
-	CARD32 pos;
+	CARD32     ptr;
+	QByteArray data;
 };
 BCDFile* BCDFile::getInstance(CARD32 ptr) {
 	return new BCDFileMesaMemory(ptr);
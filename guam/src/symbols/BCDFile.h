@@ -43,10 +43,36 @@ public:
 	static BCDFile* getInstance(QString path);
 	// From mesa memory
 	static BCDFile* getInstance(CARD32 ptr);
+	// From copy of file contents
+	static BCDFile* getInstance(const QByteArray& data);
 
 	// To make call destructor of child class, define virtual desturctor of parent
     virtual ~BCDFile() {}
 
+	// Span makes whole table of size words from offset readable from buffer.
+	// Records of table are decoded in one pass without refill of buffer.
+	class Span {
+	public:
+		Span(BCDFile* file_, int offset_, int size_) : file(file_), offset(offset_), limit(offset_ + size_) {
+			file->position(offset);
+			file->prepare(offset * BYTES_PER_WORD, size_ * BYTES_PER_WORD);
+		}
+		bool atEnd() const {
+			return limit <= file->position();
+		}
+		// word offset of current position from start of table
+		int index() const {
+			return file->position() - offset;
+		}
+		int getLimit() const {
+			return limit;
+		}
+	private:
+		BCDFile*  file;
+		const int offset;
+		const int limit;
+	};
+
 	int  bytePosition() {
 		return getPosition();
 	}
@@ -63,24 +89,69 @@ public:
 		setPosition(0);
 	}
 
-	virtual QString getPath()                    = 0;
-	virtual int     getPosition()                = 0;
-	virtual void    setPosition(int newPosition) = 0;
-	virtual CARD8   getCARD8()                   = 0;
-	virtual CARD32  getLength()                  = 0;
+	virtual QString getPath() = 0;
+
+	int getPosition() {
+		return (int)pos;
+	}
+	void setPosition(int newPosition) {
+		if (newPosition < 0) ERROR();
+		if (length < (CARD32)newPosition) ERROR();
+		pos = (CARD32)newPosition;
+	}
+	CARD32 getLength() {
+		return length;
+	}
 
-	CARD16 getCARD16();
-	CARD32 getCARD32();
+	CARD8  getCARD8() {
+		return *reserve(1);
+	}
+	CARD16 getCARD16() {
+		const CARD8* p = reserve(2);
+		return (CARD16)((p[0] << 8) | p[1]);
+	}
+	CARD32 getCARD32() {
+		const CARD8* p = reserve(4);
+		CARD32 b0 = (CARD16)((p[0] << 8) | p[1]);
+		CARD32 b1 = (CARD16)((p[2] << 8) | p[3]);
+		return (b1 << 16) | b0;
+	}
 	INT16  getINT16() {
 		return (INT16)getCARD16();
 	}
 	INT32  getINT32() {
 		return (INT32)getCARD32();
 	}
-	void   get(int size, CARD8* data);
+	void   get(int size, CARD8* data) {
+		if (size <= 0) return;
+		memcpy(data, reserve((CARD32)size), size);
+	}
 
 	bool isBCDFile();
 	bool isSymbolsFile();
+
+protected:
+	BCDFile(CARD32 length_) : buffer(0), bufferBase(0), bufferSize(0), length(length_), pos(0) {}
+
+	// buffer holds bytes from bufferBase to bufferBase + bufferSize of file
+	const CARD8* buffer;
+	CARD32       bufferBase;
+	CARD32       bufferSize;
+	CARD32       length;
+	CARD32       pos;
+
+	// Make bytes from position to position + size available in buffer
+	virtual void fill(CARD32 position, CARD32 size) = 0;
+
+	void prepare(CARD32 position, CARD32 size) {
+		if (position < bufferBase || bufferBase + bufferSize < position + size) fill(position, size);
+	}
+	const CARD8* reserve(CARD32 size) {
+		prepare(pos, size);
+		const CARD8* ret = buffer + (pos - bufferBase);
+		pos += size;
+		return ret;
+	}
 };
 
 #endif
@@ -42,13 +42,9 @@ static log4cpp::Category& logger = Logger::getLogger("bt");
 //
 // BTIndex
 //
-QMap<BTIndex::Key, BTIndex*> BTIndex::all;
-BTIndex::BTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void BTIndex::checkAll() {
-	for(BTIndex* e: all.values()) {
+BTIndex::BTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void BTIndex::checkAll(Symbols* symbols) {
+	for(BTIndex* e: symbols->btIndex.values()) {
 		if (e->isNull()) continue;
 		BTRecord* value = BTRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -57,13 +53,18 @@ void BTIndex::checkAll() {
 	}
 }
 BTIndex* BTIndex::getNull() {
-	return getInstance(0, BT_NULL);
+	static BTIndex null(0, BT_NULL);
+	return &null;
 }
 BTIndex* BTIndex::getInstance(Symbols* symbols_, CARD16 index_) {
-	Key key(symbols_, index_);
-	if (all.contains(key)) return all[key];
+	if (symbols_ == 0) return getNull();
 
-	return new BTIndex(symbols_, index_);
+	BTIndex* ret = symbols_->btIndex.value(index_);
+	if (ret == 0) {
+		ret = symbols_->arena.make<BTIndex>(symbols_, index_);
+		symbols_->btIndex.insert(index_, ret);
+	}
+	return ret;
 }
 QString BTIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -82,19 +83,17 @@ const BTRecord& BTIndex::getValue() const {
 //
 // BTRecord
 //
-QMap<BTRecord::Key, BTRecord*> BTRecord::all;
 BTRecord::BTRecord(Symbols* symbols_, CARD16 index_, BodyLink* link_, BTIndex* firstSon_,SEIndex* type_,
 		CTXIndex* localCtx_, CARD16 level_, CARD16 sourceIndex_, BodyInfo* info_, Tag tag_, void* tagValue_) :
 	symbols(symbols_), index(index_), link(link_), firstSon(firstSon_), type(type_),
 	localCtx(localCtx_), level(level_), sourceIndex(sourceIndex_), info(info_), tag(tag_), tagValue(tagValue_) {
-	Key key(symbols, index);
-	all[key] = this;
+	symbols_->bt.insert(index_, this);
 
 	BTIndex::getInstance(symbols_, index);
 }
 BTRecord* BTRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	return symbols->bt.value(index);
 }
 
 BTRecord* BTRecord::getInstance(Symbols* symbols, CARD16 index) {
@@ -123,7 +122,7 @@ BTRecord* BTRecord::getInstance(Symbols* symbols, CARD16 index) {
 		ERROR();
 	}
 
-	return new BTRecord(symbols, index, link, firstSon, type, localCtx, level, sourceIndex, info, tag, tagValue);
+	return symbols->arena.make<BTRecord>(symbols, index, link, firstSon, type, localCtx, level, sourceIndex, info, tag, tagValue);
 }
 //      inline(8:1..1): BOOLEAN,
 //      id(8:2..15): ISEIndex,
@@ -160,10 +159,10 @@ BTRecord::Callable* BTRecord::Callable::getInstance(Symbols* symbols, CARD16 u8)
 		tagValue = 0;
 		break;
 	case Tag::INNER:
-		tagValue = new Inner(bitField(u11, 2, 15));
+		tagValue = symbols->arena.make<Inner>(bitField(u11, 2, 15));
 		break;
 	case Tag::CATCH:
-		tagValue = new Catch(symbols->file->getCARD16());
+		tagValue = symbols->arena.make<Catch>(symbols->file->getCARD16());
 		break;
 	default:
 		ERROR();
@@ -171,7 +170,7 @@ BTRecord::Callable* BTRecord::Callable::getInstance(Symbols* symbols, CARD16 u8)
 		break;
 	}
 
-	return new Callable(inline_, id, ioType, monitored, noXfers, resident, entry, internal, entryIndex, tag, tagValue);
+	return symbols->arena.make<Callable>(inline_, id, ioType, monitored, noXfers, resident, entry, internal, entryIndex, tag, tagValue);
 }
 const BTRecord::Callable::Inner& BTRecord::Callable::getInner() const {
 	if (tag != Tag::INNER) ERROR();
@@ -215,10 +214,10 @@ QString BTRecord::Callable::Catch::toString() const {
 }
 
 //    Other => [relOffset(8:1..15): [0..LAST[CARDINAL]/2]]
-BTRecord::Other* BTRecord::Other::getInstance(Symbols* /*symbols*/, CARD16 u8) {
+BTRecord::Other* BTRecord::Other::getInstance(Symbols* symbols, CARD16 u8) {
 	CARD16 realOffset = bitField(u8, 1, 15);
 
-	return new Other(realOffset);
+	return symbols->arena.make<Other>(realOffset);
 }
 QString BTRecord::Other::toString() const {
 	return QString("%1").arg(realOffset);
@@ -271,7 +270,7 @@ BTRecord::BodyLink* BTRecord::BodyLink::getInstance(Symbols* symbols) {
 	Which    which = (Which)bitField(u0, 0, 0);
 	BTIndex* index = BTIndex::getInstance(symbols, bitField(u0, 1, 14));
 
-	return new BodyLink(which, index);
+	return symbols->arena.make<BodyLink>(which, index);
 }
 QString BTRecord::BodyLink::toString() const {
 	return QString("%1 %2").arg(toString(which)).arg(index->toString());
@@ -308,7 +307,7 @@ BTRecord::BodyInfo* BTRecord::BodyInfo::getInstance(Symbols* symbols) {
 		CARD16 thread    = symbols->file->getCARD16();
 		CARD16 frameSize = symbols->file->getCARD16();
 
-		tagValue = new Internal(bodyTree, thread, frameSize);
+		tagValue = symbols->arena.make<Internal>(bodyTree, thread, frameSize);
 	}
 		break;
 	case Tag::EXTERNAL: {
@@ -316,14 +315,14 @@ BTRecord::BodyInfo* BTRecord::BodyInfo::getInstance(Symbols* symbols) {
 		CARD16 startIndex  = symbols->file->getCARD16();
 		CARD16 indexLength = symbols->file->getCARD16();
 
-		tagValue = new External(bytes, startIndex, indexLength);
+		tagValue = symbols->arena.make<External>(bytes, startIndex, indexLength);
 	}
 		break;
 	default:
 		ERROR();
 	}
 
-	return new BodyInfo(tag, tagValue);
+	return symbols->arena.make<BodyInfo>(tag, tagValue);
 }
 QString BTRecord::BodyInfo::toString(Tag value) {
 	TO_STRING_PROLOGUE(Tag)
@@ -52,7 +52,7 @@ private:
 	CARD16     index;
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static BTIndex* getNull();
 	static BTIndex* getInstance(Symbols* symbols, CARD16 index);
 
@@ -63,8 +63,7 @@ public:
 	const BTRecord& getValue() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, BTIndex*> all;
+	friend class Symbols::Arena;
 
 	BTIndex(Symbols* symbols, CARD16 index);
 };
@@ -250,8 +249,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, BTRecord*> all;
+	friend class Symbols::Arena;
 
 	BTRecord(Symbols* symbols, CARD16 index, BodyLink* link, BTIndex* firstSon,SEIndex* type,
 			CTXIndex* localCtx, CARD16 level, CARD16 sourceIndex, BodyInfo* info, Tag tag, void* tagValue);
@@ -41,13 +41,9 @@ static log4cpp::Category& logger = Logger::getLogger("ctx");
 //
 // CTXIndex
 //
-QMap<CTXIndex::Key, CTXIndex*> CTXIndex::all;
-CTXIndex::CTXIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void CTXIndex::checkAll() {
-	for(CTXIndex* e: all.values()) {
+CTXIndex::CTXIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void CTXIndex::checkAll(Symbols* symbols) {
+	for(CTXIndex* e: symbols->ctxIndex.values()) {
 		if (e->isNull()) continue;
 		CTXRecord* value = CTXRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -56,13 +52,18 @@ void CTXIndex::checkAll() {
 	}
 }
 CTXIndex* CTXIndex::getNull() {
-	return getInstance(0, CTX_NULL);
+	static CTXIndex null(0, CTX_NULL);
+	return &null;
 }
 CTXIndex* CTXIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new CTXIndex(symbols, index);
+	CTXIndex* ret = symbols->ctxIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<CTXIndex>(symbols, index);
+		symbols->ctxIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString CTXIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -106,17 +107,17 @@ const SEIndex* CTXIndex::firstCtxSe() const {
 //    nil => []
 //    ENDCASE];
 
-QMap<CTXRecord::Key, CTXRecord*> CTXRecord::all;
 CTXRecord::CTXRecord(Symbols* symbols_, CARD16 index_, SEIndex* seList_, CARD16 level_, Tag tag_, void* tagValue_) :
 	symbols(symbols_), index(index_), seList(seList_), level(level_), tag(tag_), tagValue(tagValue_) {
-	Key key(symbols, index);
-	all[key] = this;
+	symbols_->ctx.insert(index_, this);
 
 	CTXIndex::getInstance(symbols_, index);
 }
 CTXRecord* CTXRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	CTXRecord* ret = symbols->ctx.value(index);
+	if (ret == 0 && symbols->mode == Symbols::Mode::LAZY) ret = symbols->decodeCTX(index);
+	return ret;
 }
 
 CTXRecord* CTXRecord::getInstance(Symbols* symbols, CARD16 index) {
@@ -132,7 +133,7 @@ CTXRecord* CTXRecord::getInstance(Symbols* symbols, CARD16 index) {
  	case Tag::SIMPLE: {
  		CTXIndex* ctxNew = CTXIndex::getInstance(symbols, bitField(u1, 5, 15));
 
- 		tagValue = new Simple(ctxNew);
+ 		tagValue = symbols->arena.make<Simple>(ctxNew);
  	}
  		break;
  	case Tag::INCLUDED: {
@@ -149,13 +150,13 @@ CTXRecord* CTXRecord::getInstance(Symbols* symbols, CARD16 index) {
  		bool restricted = bitField(u3, 13);
  		bool reset = bitField(u3, 14, 15);
 
- 		tagValue = new Included(chain, copied, module, map, closed, complete, restricted, reset);
+ 		tagValue = symbols->arena.make<Included>(chain, copied, module, map, closed, complete, restricted, reset);
  	}
  		break;
  	case Tag::IMPORTED: {
  		CTXIndex* includeLink = CTXIndex::getInstance(symbols, bitField(u1, 5, 15));
 
- 		tagValue = new Imported(includeLink);
+ 		tagValue = symbols->arena.make<Imported>(includeLink);
  	}
  		break;
  	case Tag::NIL:
@@ -165,7 +166,13 @@ CTXRecord* CTXRecord::getInstance(Symbols* symbols, CARD16 index) {
  		ERROR();
  	}
 
-    return new CTXRecord(symbols, index, seList, level, tag, tagValue);
+    return symbols->arena.make<CTXRecord>(symbols, index, seList, level, tag, tagValue);
+}
+void CTXRecord::skip(Symbols* symbols) {
+	BCDFile* file = symbols->file;
+	file->position(file->position() + 1);
+	Tag tag = (Tag)bitField(file->getCARD16(), 3, 4);
+	if (tag == Tag::INCLUDED) file->position(file->position() + 2);
 }
 const CTXRecord::Simple&   CTXRecord::getSimple() const {
 	if (tag != Tag::SIMPLE) ERROR();
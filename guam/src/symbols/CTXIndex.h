@@ -50,7 +50,7 @@ private:
 	CARD16     index;
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static CTXIndex* getNull();
 	static CTXIndex* getInstance(Symbols* symbols, CARD16 index_);
 
@@ -74,8 +74,7 @@ public:
     }
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, CTXIndex*> all;
+	friend class Symbols::Arena;
 	CTXIndex(Symbols* symbols, CARD16 index);
 };
 
@@ -143,6 +142,8 @@ public:
 	};
 
 	static CTXRecord* getInstance(Symbols* symbols, CARD16 index);
+	// Advance file position to next record without decoding
+	static void skip(Symbols* symbols);
 	static CTXRecord* find(Symbols* symbols, CARD16 index);
 
 	enum class Tag {SIMPLE, INCLUDED, IMPORTED, NIL};
@@ -167,8 +168,7 @@ public:
 	}
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, CTXRecord*> all;
+	friend class Symbols::Arena;
 
 	CTXRecord(Symbols* symbols, CARD16 index, SEIndex* seList, CARD16 level, Tag tag, void* tagValue);
 };
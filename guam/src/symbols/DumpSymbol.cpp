@@ -44,8 +44,11 @@ static log4cpp::Category& logger = Logger::getLogger("dumpSymbol");
 #include "MDIndex.h"
 #include "SEIndex.h"
 
-static int indentWidth = 4;
-static int indentLevel = 0;
+static const int indentWidth = 4;
+static thread_local int indentLevel = 0;
+// indent() returns tail of spaces
+static const int        SPACES_SIZE = 256;
+static const QByteArray SPACES(SPACES_SIZE, ' ');
 void DumpSymbol::nest() {
 	indentLevel++;
 }
@@ -53,11 +56,11 @@ void DumpSymbol::unnest() {
 	indentLevel--;
 	if (indentLevel < 0) ERROR();
 }
-QString DumpSymbol::indent() {
-	return QString("%1").arg("", indentWidth * indentLevel);
+const char* DumpSymbol::indent() {
+	return SPACES.constData() + SPACES_SIZE - qMin(indentWidth * indentLevel, SPACES_SIZE);
 }
 
-void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
+quint64 DumpSymbol::dumpSymbol(QString filePath, QString outDirPath, bool compress) {
 	// Check existence of file
 	if (!QFile::exists(filePath)) {
 		logger.fatal("File does not exist. pathFile = %s", filePath.toLocal8Bit().constData());
@@ -68,7 +71,7 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
 	BCD bcd(filePath);
 	if (!bcd.isBCDFile()) {
 		logger.info("file is no bcd file. pathFile = %s", filePath.toLocal8Bit().constData());
-		return;
+		return 0;
 	}
 
 
@@ -105,31 +108,26 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
 			ERROR();
 		}
 
-		QString fileName(QFileInfo(filePath).baseName() + ".symbol");
+		QString fileName(QFileInfo(filePath).baseName() + (compress ? ".symbol.gz" : ".symbol"));
 		outFilePath = outDir.absoluteFilePath(fileName);
 		logger.info("outFilePath = %s", outFilePath.toLocal8Bit().constData());
 	}
 
-	QFile outFile(outFilePath);
-	{
-		bool result = outFile.open(QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Truncate);
-		if (!result) {
-			logger.fatal("File open error %s", outFile.errorString().toLocal8Bit().constData());
-			ERROR();
-		}
-	}
-	QTextStream out(&outFile);
+	TextWriter out(outFilePath, compress);
+	dumpSymbol(bcd, symbols, out);
+	out.flush();
+	return out.getSize();
+}
 
+void DumpSymbol::dumpSymbol(BCD& bcd, Symbols& symbols, TextWriter& out) {
 	// Print Header
 	{
 		MDRecord* self = symbols.md[MDIndex::MD_OWN];
 		//FTRecord* self = bcd.ft[FTRecord::FT_SELF];
 
-		QFileInfo info(filePath);
-
 		out << "--" << endl;
-		out << QString("-- File   %1 %2").arg(self->stamp->toString()).arg(self->fileId->getValue().value) << endl;
-		if (!bcd.sourceFile->isNull()) out << QString("-- Source %1 %2").arg(bcd.sourceFile->version->toString()).arg(bcd.sourceFile->name) << endl;
+		out << "-- File   " << self->stamp->toString() << " " << self->fileId->getValue().value << endl;
+		if (!bcd.sourceFile->isNull()) out << "-- Source " << bcd.sourceFile->version->toString() << " " << bcd.sourceFile->name << endl;
 		out << "--" << endl;
 		out << endl;
 	}
@@ -149,7 +147,11 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
 					if (index == MDIndex::MD_OWN) continue;
 	                MDRecord* e = symbols.md[index];
 
-	                out << indent() << QString("%1 %2%3").arg(e->moduleId->getValue().value, -30).arg(e->stamp->toString()).arg(i.hasNext() ? "," : ";") << endl;
+	                // module name is left aligned in 30 columns
+	                const QString& name = e->moduleId->getValue().value;
+	                out << indent() << name;
+	                for(int j = name.size(); j < 30; j++) out << ' ';
+	                out << " " << e->stamp->toString() << (i.hasNext() ? "," : ";") << endl;
 				}
 			}
 			unnest();
@@ -161,7 +163,7 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
     {
 		MDRecord* self = symbols.md[MDIndex::MD_OWN];
 
-		out << indent() << QString("%1 %2 = BEGIN").arg(self->moduleId->getValue().value).arg(self->stamp->toString()) << endl;
+		out << indent() << self->moduleId->getValue().value << " " << self->stamp->toString() << " = BEGIN" << endl;
     }
     nest();
 
@@ -170,7 +172,7 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
 
     for (const SEIndex* sei = outerCtx.seList; !sei->isNull(); sei = sei->nextSe()) {
     	out << indent();
-    	printSym(out, sei, ": ");
+    	printSym(out, sei);
     	out << ";" << endl;
     }
 
@@ -178,10 +180,12 @@ void DumpSymbol::dumpSymbol(QString filePath, QString outDirPath) {
     out << "END." << endl;
 }
 
-void DumpSymbol::printSym(QTextStream& out, const SEIndex* sei, QString colonString) {
+void DumpSymbol::printSym(TextWriter& out, const SEIndex* sei, bool bitSpec) {
 	const SERecord::Id& id = sei->getValue().getId();
 	if (!id.hash->isNull()) {
-		out << id.hash->getValue().value << colonString;
+		out << id.hash->getValue().value;
+		if (bitSpec) putBitSpec(out, sei);
+		else out << ": ";
 	}
 	if (!id.public_) {
 		out << "PRIVATE ";
@@ -250,7 +254,7 @@ void DumpSymbol::printSym(QTextStream& out, const SEIndex* sei, QString colonStr
 }
 
 
-QString DumpSymbol::getBitSpec(const SEIndex* isei) {
+void DumpSymbol::putBitSpec(TextWriter& out, const SEIndex* isei) {
 	const SERecord::Id& t(isei->getValue().getId());
 
 	int a = t.idValue;
@@ -258,11 +262,13 @@ QString DumpSymbol::getBitSpec(const SEIndex* isei) {
 	int bd = bitField(a, 12, 15);
 	int s = t.idInfo;
 
-	return QString(" (%1%2): ").arg(wd).arg(s ? QString(":%1..%2").arg(bd).arg(bd + s - 1) : "");
+	out << " (" << wd;
+	if (s) out << ":" << bd << ".." << (bd + s - 1);
+	out << "): ";
 }
 
 
-void DumpSymbol::printFieldCtx(QTextStream& out, const CTXIndex* ctx) {
+void DumpSymbol::printFieldCtx(TextWriter& out, const CTXIndex* ctx) {
 	const SEIndex* isei = ctx->firstCtxSe();
 	bool first = true;
 	if ((!isei->isNull()) && (!isei->getValue().getId().idCtx->equals(ctx)))
@@ -280,14 +286,14 @@ void DumpSymbol::printFieldCtx(QTextStream& out, const CTXIndex* ctx) {
 			out << "," << endl;
 		}
 		out << indent();
-		printSym(out, isei, getBitSpec(isei));
+		printSym(out, isei, true);
 		printDefaultValue(out, isei, ShowType::getValFormat(isei->getValue().getId().idType));
 	}
 	out << "]";
 	unnest();
 }
 
-void DumpSymbol::printDefaultValue(QTextStream& out, const SEIndex* sei, ValFormat vf) {
+void DumpSymbol::printDefaultValue(TextWriter& out, const SEIndex* sei, ValFormat vf) {
 	ExtRecord* ext = ExtRecord::find(sei);
 	if (ext == 0) return;
 	if (ext->type != Symbols::ExtensionType::DEFAULT) return;
@@ -295,7 +301,7 @@ void DumpSymbol::printDefaultValue(QTextStream& out, const SEIndex* sei, ValForm
 	ShowType::printTreeLink(out, ext->tree, vf, 0);
 }
 
-ValFormat DumpSymbol::printType(QTextStream& out, const SEIndex* tsei, std::function<void()> dosub) {
+ValFormat DumpSymbol::printType(TextWriter& out, const SEIndex* tsei, std::function<void()> dosub) {
 	ValFormat vf = ShowType::getValFormat(tsei);
 	switch (tsei->getValue().tag) {
 	case SERecord::Tag::ID:
@@ -349,7 +355,7 @@ ValFormat DumpSymbol::printType(QTextStream& out, const SEIndex* tsei, std::func
                 const HTIndex* hti = isei->getValue().getId().hash;
                 if (!hti->isNull()) out << hti->getValue().value;
                 int sv = isei->getValue().getId().idValue;
-                out << QString("(%1)").arg(sv);
+                out << "(" << sv << ")";
             }
             out << "}";
             unnest();
@@ -449,7 +455,7 @@ noprint:;
 				out << (t.overlaid ? "OVERLAID " : "COMPUTED ");
 			} else {
 				out << t.tagSei->getValue().getId().hash->getValue().value;
-				out << getBitSpec(t.tagSei);
+				putBitSpec(out, t.tagSei);
 			}
 
 			const SEIndex* tagType = t.tagSei->getValue().getId().idType;
@@ -505,7 +511,7 @@ noprint:;
 			else {
 
 				out << t.tagSei->getValue().getId().hash->getValue().value;
-				out << getBitSpec(t.tagSei);
+				putBitSpec(out, t.tagSei);
 			}
 			const SEIndex* tagType = t.tagSei->getValue().getId().idType;
 			if (!t.tagSei->getValue().getId().public_)
@@ -580,7 +586,7 @@ noprint:;
 	return vf;
 }
 
-void DumpSymbol::outArgType(QTextStream& out, const SEIndex* sei) {
+void DumpSymbol::outArgType(TextWriter& out, const SEIndex* sei) {
 	if (sei->isNull()) out << ": NIL";
 	else {
 		switch(sei->getValue().getCons().tag) {
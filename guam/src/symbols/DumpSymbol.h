@@ -44,21 +44,24 @@ class DumpSymbol {
 public:
 	static void nest();
 	static void unnest();
-	static QString indent();
+	static const char* indent();
 
-	static void dumpSymbol(QString filePath, QString outDirPath);
+	// Write symbol of bcd file to outDirPath. Returns size of output before compression.
+	static quint64 dumpSymbol(QString filePath, QString outDirPath, bool compress = false);
+	static void    dumpSymbol(BCD& bcd, Symbols& symbols, TextWriter& out);
 
-    static void printSym(QTextStream& out, const SEIndex* sei, QString colonString);
+    // Write bit spec of sei instead of ": " if bitSpec is true
+    static void printSym(TextWriter& out, const SEIndex* sei, bool bitSpec = false);
 
-    static ValFormat printType(QTextStream& out, const SEIndex* tsei, std::function<void()> dosub);
+    static ValFormat printType(TextWriter& out, const SEIndex* tsei, std::function<void()> dosub);
 
-    static void printFieldCtx(QTextStream& out, const CTXIndex* ctx);
+    static void printFieldCtx(TextWriter& out, const CTXIndex* ctx);
 
-    static QString getBitSpec(const SEIndex* isei);
+    static void putBitSpec(TextWriter& out, const SEIndex* isei);
 
-    static void printDefaultValue(QTextStream& out, const SEIndex* sei, ValFormat vf);
+    static void printDefaultValue(TextWriter& out, const SEIndex* sei, ValFormat vf);
 
-    static void outArgType(QTextStream& out, const SEIndex* sei);
+    static void outArgType(TextWriter& out, const SEIndex* sei);
 };
 
 #endif
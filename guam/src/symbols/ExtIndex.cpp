@@ -41,13 +41,9 @@ static log4cpp::Category& logger = Logger::getLogger("etx");
 //
 // ExtIndex
 //
-QMap<ExtIndex::Key, ExtIndex*> ExtIndex::all;
-ExtIndex::ExtIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void ExtIndex::checkAll() {
-	for(ExtIndex* e: all.values()) {
+ExtIndex::ExtIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void ExtIndex::checkAll(Symbols* symbols) {
+	for(ExtIndex* e: symbols->extIndex.values()) {
 		if (e->isNull()) continue;
 		ExtRecord* value = ExtRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -56,13 +52,18 @@ void ExtIndex::checkAll() {
 	}
 }
 ExtIndex* ExtIndex::getNull() {
-	return getInstance(0, EXT_NULL);
+	static ExtIndex null(0, EXT_NULL);
+	return &null;
 }
 ExtIndex* ExtIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new ExtIndex(symbols, index);
+	ExtIndex* ret = symbols->extIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<ExtIndex>(symbols, index);
+		symbols->extIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString ExtIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -87,17 +88,15 @@ const ExtRecord& ExtIndex::getValue() const {
 //  sei (0:2..15): Symbols.ISEIndex,
 //  tree (1:0..15): Tree.Link]
 
-QMap<ExtRecord::Key, ExtRecord*> ExtRecord::all;
 ExtRecord::ExtRecord(Symbols* symbols_, CARD16 index_, ExtensionType type_, SEIndex* sei_, TreeLink* tree_) :
 	symbols(symbols_), index(index_), type(type_), sei(sei_), tree(tree_) {
-	Key key(symbols_, index_);
-	all[key] = this;
+	symbols_->ext.insert(index_, this);
 
 	ExtIndex::getInstance(symbols_, index_);
 }
 ExtRecord* ExtRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	return symbols->ext.value(index);
 }
 //  FindExtension: PROC [h: Handle, sei: ISEIndex] RETURNS [type: ExtensionType, tree: Tree.Link] = {
 //	OPEN SymbolSegment;
@@ -107,7 +106,8 @@ ExtRecord* ExtRecord::find(Symbols* symbols, CARD16 index) {
 //	  ENDLOOP;
 //	RETURN [none, Tree.Null]};
 ExtRecord* ExtRecord::find(const SEIndex* sei) {
-	for(ExtRecord* e: all.values()) {
+	if (sei->getSymbols() == 0) return 0;
+	for(ExtRecord* e: sei->getSymbols()->ext.values()) {
 		if (sei->equals(e->sei)) return e;
 	}
 	return 0;
@@ -120,7 +120,7 @@ ExtRecord* ExtRecord::getInstance(Symbols* symbols, CARD16 index) {
     SEIndex*      sei  = SEIndex::getInstance(symbols, bitField(u0, 2, 15));
     TreeLink*     tree = TreeLink::getInstance(symbols);
 
-    return new ExtRecord(symbols, index, type, sei, tree);
+    return symbols->arena.make<ExtRecord>(symbols, index, type, sei, tree);
 }
 
 QString ExtRecord::toString() const {
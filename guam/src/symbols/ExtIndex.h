@@ -52,7 +52,7 @@ private:
 	CARD16     index;
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static ExtIndex* getNull();
 	static ExtIndex* getInstance(Symbols* symbols, CARD16 index);
 
@@ -63,8 +63,7 @@ public:
 	const ExtRecord& getValue() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, ExtIndex*> all;
+	friend class Symbols::Arena;
 
 	ExtIndex(Symbols* symbols, CARD16 index_);
 };
@@ -98,8 +97,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, ExtRecord*> all;
+	friend class Symbols::Arena;
 
 	ExtRecord(Symbols* symbols, CARD16 index, ExtensionType type, SEIndex* sei, TreeLink* tree);
 };
@@ -39,13 +39,9 @@ static log4cpp::Category& logger = Logger::getLogger("ht");
 //
 // HTIndex
 //
-QMap<HTIndex::Key, HTIndex*> HTIndex::all;
-HTIndex::HTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void HTIndex::checkAll() {
-	for(HTIndex* e: all.values()) {
+HTIndex::HTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void HTIndex::checkAll(Symbols* symbols) {
+	for(HTIndex* e: symbols->htIndex.values()) {
 		if (e->isNull()) continue;
 		HTRecord* value = HTRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -54,13 +50,18 @@ void HTIndex::checkAll() {
 	}
 }
 HTIndex* HTIndex::getNull() {
-	return getInstance(0, HT_NULL);
+	static HTIndex null(0, HT_NULL);
+	return &null;
 }
 HTIndex* HTIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new HTIndex(symbols, index);
+	HTIndex* ret = symbols->htIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<HTIndex>(symbols, index);
+		symbols->htIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString HTIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -79,17 +80,15 @@ const HTRecord& HTIndex::getValue() const {
 //
 // HTRecord
 //
-QMap<HTRecord::Key, HTRecord*> HTRecord::all;
 HTRecord::HTRecord(Symbols* symbols_, CARD16 index_, bool anyInternal_, bool anyPublic_, CARD16 link_, CARD16 ssIndex_, QString value_) :
 	symbols(symbols_), index(index_), anyInternal(anyInternal_), anyPublic(anyPublic_), link(link_), ssIndex(ssIndex_), value(value_) {
-	Key key(symbols_, index_);
-	all[key] = this;
+	symbols_->ht.insert(index_, this);
 
 	HTIndex::getInstance(symbols_, index_);
 }
 HTRecord* HTRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	return symbols->ht.value(index);
 }
 
 HTRecord* HTRecord::getInstance(Symbols* symbols, CARD16 index, CARD16 lastSSIndex) {
@@ -103,7 +102,7 @@ HTRecord* HTRecord::getInstance(Symbols* symbols, CARD16 index, CARD16 lastSSInd
     // ss.substring(lastSSIndex, data.ssIndex);
     QString value       = symbols->ss.mid(lastSSIndex, ssIndex - lastSSIndex);
 
-    return new HTRecord(symbols, index, anyInternal, anyPublic, link, ssIndex, value);
+    return symbols->arena.make<HTRecord>(symbols, index, anyInternal, anyPublic, link, ssIndex, value);
 }
 QString HTRecord::toString() const {
 	return QString("%1 %2%3 %4").arg(index, 4).arg(anyInternal ? "I" : " ").arg(anyPublic ? "P" : " ").arg(value);
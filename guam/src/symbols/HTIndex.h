@@ -50,7 +50,7 @@ private:
 	CARD16    index;
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static HTIndex* getNull();
 	static HTIndex* getInstance(Symbols* symbols_, CARD16 index_);
 
@@ -61,8 +61,7 @@ public:
 
 	const HTRecord& getValue() const;
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, HTIndex*> all;
+	friend class Symbols::Arena;
 
 	HTIndex(Symbols* symbols, CARD16 index);
 };
@@ -90,8 +89,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, HTRecord*> all;
+	friend class Symbols::Arena;
 
 	HTRecord(Symbols* symbols, CARD16 index, bool anyInternal, bool anyPublic, CARD16 link, CARD16 ssIndex, QString value);
 };
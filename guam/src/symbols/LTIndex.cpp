@@ -40,13 +40,9 @@ static log4cpp::Category& logger = Logger::getLogger("lt");
 //
 // LTIndex
 //
-QMap<LTIndex::Key, LTIndex*> LTIndex::all;
-LTIndex::LTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void LTIndex::checkAll() {
-	for(LTIndex* e: all.values()) {
+LTIndex::LTIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void LTIndex::checkAll(Symbols* symbols) {
+	for(LTIndex* e: symbols->ltIndex.values()) {
 		if (e->isNull()) continue;
 		LTRecord* value = LTRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -55,13 +51,18 @@ void LTIndex::checkAll() {
 	}
 }
 LTIndex* LTIndex::getNull() {
-	return getInstance(0, LT_NULL);
+	static LTIndex null(0, LT_NULL);
+	return &null;
 }
 LTIndex* LTIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new LTIndex(symbols, index);
+	LTIndex* ret = symbols->ltIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<LTIndex>(symbols, index);
+		symbols->ltIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString LTIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -93,17 +94,15 @@ const LTRecord& LTIndex::getValue() const {
 //      value(3): WordSequence]
 //    ENDCASE];
 
-QMap<LTRecord::Key, LTRecord*> LTRecord::all;
 LTRecord::LTRecord(Symbols* symbols_, CARD16 index_, Tag tag_, void* tagValue_) :
 	symbols(symbols_), index(index_), tag(tag_), tagValue(tagValue_) {
-	Key key(symbols_, index_);
-	all[key] = this;
+	symbols_->lt.insert(index_, this);
 
 	LTIndex::getInstance(symbols_, index_);
 }
 LTRecord* LTRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	return symbols->lt.value(index);
 }
 
 QString LTRecord::toString(Tag value) {
@@ -148,16 +147,16 @@ LTRecord* LTRecord::getInstance(Symbols* symbols, CARD16 index) {
 
  	switch(tag) {
  	case Tag::SHORT:
- 		tagValue = new Short(symbols->file->getCARD16());
+ 		tagValue = symbols->arena.make<Short>(symbols->file->getCARD16());
  		break;
  	case Tag::LONG:
  	{
  		CARD16  codeIndex = symbols->file->getCARD16();
  		CARD16  length    = symbols->file->getCARD16();
- 		CARD16* value     = new CARD16[length];
+ 		CARD16* value     = symbols->arena.makeArray<CARD16>(length);
  		for(CARD16 i = 0; i < length; i++) value[i] = symbols->file->getCARD16();
 
- 		tagValue = new Long(codeIndex, length, value);
+ 		tagValue = symbols->arena.make<Long>(codeIndex, length, value);
  	}
  		break;
  	default:
@@ -166,7 +165,7 @@ LTRecord* LTRecord::getInstance(Symbols* symbols, CARD16 index) {
  		break;
  	}
 
-    return new LTRecord(symbols, index, tag, tagValue);
+    return symbols->arena.make<LTRecord>(symbols, index, tag, tagValue);
 }
 
 QString LTRecord::toString() const {
@@ -199,20 +198,20 @@ LitRecord* LitRecord::getInstance(Symbols* symbols, CARD16 u0) {
 	case Tag::WORD:
 	{
 		LTIndex* index = LTIndex::getInstance(symbols, bitField(u0, 1, 13));
-		tagValue = new Word(index);
+		tagValue = symbols->arena.make<Word>(index);
 	}
 		break;
 	case Tag::STRING:
 	{
 		CARD16 index = bitField(u0, 1, 13);
-		tagValue = new String(index);
+		tagValue = symbols->arena.make<String>(index);
 	}
 		break;
 	default:
 		ERROR();
 		tagValue = 0;
 	}
-	return new LitRecord(tag, tagValue);
+	return symbols->arena.make<LitRecord>(tag, tagValue);
 }
 QString LitRecord::toString() const {
 	switch(tag) {
@@ -50,7 +50,7 @@ private:
 	CARD16     index;
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static LTIndex* getNull();
 	static LTIndex* getInstance(Symbols* symbols, CARD16 index);
 
@@ -61,8 +61,7 @@ public:
 	const LTRecord& getValue() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, LTIndex*> all;
+	friend class Symbols::Arena;
 
 	LTIndex(Symbols* symbols, CARD16 index);
 };
@@ -124,8 +123,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, LTRecord*> all;
+	friend class Symbols::Arena;
 
 	LTRecord(Symbols* symbols, CARD16 index, Tag tag, void* tagValue);
 };
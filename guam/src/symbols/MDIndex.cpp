@@ -41,13 +41,9 @@ static log4cpp::Category& logger = Logger::getLogger("md");
 //
 // MDIndex
 //
-QMap<MDIndex::Key, MDIndex*> MDIndex::all;
-MDIndex::MDIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void MDIndex::checkAll() {
-	for(MDIndex* e: all.values()) {
+MDIndex::MDIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void MDIndex::checkAll(Symbols* symbols) {
+	for(MDIndex* e: symbols->mdIndex.values()) {
 		if (e->isNull()) continue;
 		MDRecord* value = MDRecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -56,13 +52,18 @@ void MDIndex::checkAll() {
 	}
 }
 MDIndex* MDIndex::getNull() {
-	return getInstance(0, MD_NULL);
+	static MDIndex null(0, MD_NULL);
+	return &null;
 }
 MDIndex* MDIndex::getInstance(Symbols* symbols_, CARD16 index_) {
-	Key key(symbols_, index_);
-	if (all.contains(key)) return all[key];
+	if (symbols_ == 0) return getNull();
 
-	return new MDIndex(symbols_, index_);
+	MDIndex* ret = symbols_->mdIndex.value(index_);
+	if (ret == 0) {
+		ret = symbols_->arena.make<MDIndex>(symbols_, index_);
+		symbols_->mdIndex.insert(index_, ret);
+	}
+	return ret;
 }
 QString MDIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -81,19 +82,17 @@ const MDRecord& MDIndex::getValue() const {
 //
 // MDRecord
 //
-QMap<MDRecord::Key, MDRecord*> MDRecord::all;
 MDRecord::MDRecord(Symbols* symbols_, CARD16 index_, Stamp* stamp_, HTIndex* moduleId_, HTIndex* fileId_,
 		bool shared_, bool exported_, CTXIndex* ctx_, CTXIndex* defaultImport_, CARD16 file_) :
 	symbols(symbols_), index(index_), stamp(stamp_), moduleId(moduleId_), fileId(fileId_),
 	shared(shared_), exported(exported_), ctx(ctx_), defaultImport(defaultImport_), file(file_) {
-	Key key(symbols_, index_);
-	all[key] = this;
+	symbols_->md.insert(index_, this);
 
 	MDIndex::getInstance(symbols_, index_);
 }
 MDRecord* MDRecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	return symbols->md.value(index);
 }
 MDRecord* MDRecord::getInstance(Symbols* symbols, CARD16 index) {
 	Stamp*   stamp    = Stamp::getInstance(symbols->bcd);
@@ -109,7 +108,7 @@ MDRecord* MDRecord::getInstance(Symbols* symbols, CARD16 index) {
 
     CARD16 file = symbols->file->getCARD16();
 
-    return new MDRecord(symbols, index, stamp, moduleId, fileId, shared, exported, ctx, defaultImport, file);
+    return symbols->arena.make<MDRecord>(symbols, index, stamp, moduleId, fileId, shared, exported, ctx, defaultImport, file);
 }
 QString MDRecord::toString() const {
 //	return QString("%1 %2 %3 %4 %5 %6 %7 %8").
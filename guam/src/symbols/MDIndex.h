@@ -53,7 +53,7 @@ private:
 public:
 	static const CARD16  MD_OWN  = 0;
 
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static MDIndex* getNull();
 	static MDIndex* getInstance(Symbols* symbols_, CARD16 index_);
 
@@ -64,8 +64,7 @@ public:
 	const MDRecord& getValue() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, MDIndex*> all;
+	friend class Symbols::Arena;
 
 	MDIndex(Symbols* symbols, CARD16 index);
 };
@@ -101,8 +100,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, MDRecord*> all;
+	friend class Symbols::Arena;
 
 	MDRecord(Symbols* symbols, CARD16 index, Stamp* stamp, HTIndex* moduleId, HTIndex* fileId,
 			bool shared, bool exported, CTXIndex* ctx, CTXIndex* defaultImport, CARD16 file);
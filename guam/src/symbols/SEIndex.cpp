@@ -41,13 +41,9 @@ static log4cpp::Category& logger = Logger::getLogger("se");
 //
 // SEIndex
 //
-QMap<SEIndex::Key, SEIndex*> SEIndex::all;
-SEIndex::SEIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols, index_);
-	all[key] = this;
-}
-void SEIndex::checkAll() {
-	for(SEIndex* e: all.values()) {
+SEIndex::SEIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void SEIndex::checkAll(Symbols* symbols) {
+	for(SEIndex* e: symbols->seIndex.values()) {
 		if (e->isNull()) continue;
 		SERecord* value = SERecord::find(e->symbols, e->index);
 		if (value == 0) {
@@ -56,13 +52,18 @@ void SEIndex::checkAll() {
 	}
 }
 SEIndex* SEIndex::getNull() {
-	return SEIndex::getInstance(0, SEIndex::SE_NULL);
+	static SEIndex null(0, SE_NULL);
+	return &null;
 }
 SEIndex* SEIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new SEIndex(symbols, index);
+	SEIndex* ret = symbols->seIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<SEIndex>(symbols, index);
+		symbols->seIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString SEIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -78,8 +79,10 @@ const SERecord& SEIndex::getValue() const {
 }
 
 SEIndex* SEIndex::find(CARD16 index_) const {
-	Key key(symbols, index_);
-	if (all.contains(key)) return all[key];
+	SEIndex* ret = symbols ? symbols->seIndex.value(index_) : 0;
+	if (ret) return ret;
+	// In lazy mode, SEIndex of record is registered when the record is decoded
+	if (SERecord::find(symbols, index_)) return symbols->seIndex.value(index_);
 
 	logger.fatal("Cannot find  symbols = %p  index = %d", symbols, index_);
 	ERROR();
@@ -171,16 +174,16 @@ const SEIndex* SEIndex::typeLink() const {
 //
 // SERecord
 //
-QMap<SERecord::Key, SERecord*> SERecord::all;
 SERecord::SERecord(Symbols* symbols_, CARD16 index_, Tag tag_, void* tagValue_) : symbols(symbols_), index(index_), tag(tag_), tagValue(tagValue_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-	// register SEIndex::all
+	symbols_->se.insert(index_, this);
+	// register SEIndex
 	SEIndex::getInstance(symbols_, index_);
 }
 SERecord* SERecord::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	SERecord* ret = symbols->se.value(index);
+	if (ret == 0 && symbols->mode == Symbols::Mode::LAZY) ret = symbols->decodeSE(index);
+	return ret;
 }
 
 
@@ -650,7 +653,59 @@ SERecord* SERecord::getInstance(Symbols* symbols, CARD16 index) {
 		tagValue = 0;
 	}
 
-	return new SERecord(symbols, index, tag, tagValue);
+	return symbols->arena.make<SERecord>(symbols, index, tag, tagValue);
+}
+
+void SERecord::skip(Symbols* symbols) {
+	BCDFile* file = symbols->file;
+	CARD16 u0 = file->getCARD16();
+	int size = 0; // number of words after u0
+	switch((Tag)bitField(u0, 2)) {
+	case Tag::ID:
+		file->position(file->position() + 3);
+		size = ((Id::Tag)bitField(file->getCARD16(), 14, 15) == Id::Tag::LINKED) ? 1 : 0;
+		break;
+	case Tag::CONS:
+		switch((Cons::Tag)bitField(u0, 3, 7)) {
+		case Cons::Tag::MODE:
+		case Cons::Tag::ZONE:
+		case Cons::Tag::ANY:
+		case Cons::Tag::NIL:
+			size = 0;
+			break;
+		case Cons::Tag::BASIC:
+		case Cons::Tag::REF:
+		case Cons::Tag::ARRAYDESC:
+		case Cons::Tag::DEFINITION:
+		case Cons::Tag::LONG:
+		case Cons::Tag::REAL:
+			size = 1;
+			break;
+		case Cons::Tag::ENUMERATED:
+		case Cons::Tag::ARRAY:
+		case Cons::Tag::TRANSFER:
+		case Cons::Tag::UNION:
+		case Cons::Tag::SEQUENCE:
+		case Cons::Tag::OPAQUE:
+		case Cons::Tag::BITS:
+			size = 2;
+			break;
+		case Cons::Tag::RELATIVE:
+		case Cons::Tag::SUBRANGE:
+			size = 3;
+			break;
+		case Cons::Tag::RECORD:
+			file->position(file->position() + 1);
+			size = ((Cons::Record::Tag)bitField(file->getCARD16(), 15) == Cons::Record::Tag::LINKED) ? 1 : 0;
+			break;
+		default:
+			ERROR();
+		}
+		break;
+	default:
+		ERROR();
+	}
+	file->position(file->position() + size);
 }
 
 SERecord::Id* SERecord::Id::getInstance(Symbols* symbols, CARD16 u0) {
@@ -693,7 +748,7 @@ SERecord::Id* SERecord::Id::getInstance(Symbols* symbols, CARD16 u0) {
 	case Tag::LINKED:
 	{
 		SEIndex* linked = SEIndex::getInstance(symbols, symbols->file->getCARD16());
-		tagValue = new Linked(linked);
+		tagValue = symbols->arena.make<Linked>(linked);
 	}
 		break;
 	default:
@@ -701,7 +756,7 @@ SERecord::Id* SERecord::Id::getInstance(Symbols* symbols, CARD16 u0) {
 		tagValue = 0;
 	}
 
-	return new Id(extended, public_, idCtx, immutable, constant, idType, idInfo, idValue, hash, linkSpace, tag, tagValue);
+	return symbols->arena.make<Id>(extended, public_, idCtx, immutable, constant, idType, idInfo, idValue, hash, linkSpace, tag, tagValue);
 }
 
 SERecord::Cons* SERecord::Cons::getInstance(Symbols* symbols, CARD16 u0) {
@@ -778,7 +833,7 @@ SERecord::Cons* SERecord::Cons::getInstance(Symbols* symbols, CARD16 u0) {
 		ERROR();
 		tagValue = 0;
 	}
-	return new Cons(tag, tagValue);
+	return symbols->arena.make<Cons>(tag, tagValue);
 }
 
 SERecord::Cons::Basic* SERecord::Cons::Basic::getInstance(Symbols* symbols, CARD16 u0) {
@@ -789,7 +844,7 @@ SERecord::Cons::Basic* SERecord::Cons::Basic::getInstance(Symbols* symbols, CARD
 	CARD16 code    = bitField(u0, 9, 15);
 	CARD16 length  = symbols->file->getCARD16();
 
-	return new Basic(ordered, code, length);
+	return symbols->arena.make<Basic>(ordered, code, length);
 }
 
 SERecord::Cons::Enumerated* SERecord::Cons::Enumerated::getInstance(Symbols* symbols, CARD16 u0) {
@@ -805,7 +860,7 @@ SERecord::Cons::Enumerated* SERecord::Cons::Enumerated::getInstance(Symbols* sym
 	CTXIndex* valueCtx   = CTXIndex::getInstance(symbols, symbols->file->getCARD16());
 	CARD16    nValues    = symbols->file->getCARD16();
 
-	return new Enumerated(ordered, machineDep, unpainted, sparse, valueCtx, nValues);
+	return symbols->arena.make<Enumerated>(ordered, machineDep, unpainted, sparse, valueCtx, nValues);
 }
 
 SERecord::Cons::Record* SERecord::Cons::Record::getInstance(Symbols* symbols, CARD16 u0) {
@@ -841,7 +896,7 @@ SERecord::Cons::Record* SERecord::Cons::Record::getInstance(Symbols* symbols, CA
 	case Tag::LINKED:
 	{
 		SEIndex* linkType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
-		tagValue = new Linked(linkType);
+		tagValue = symbols->arena.make<Linked>(linkType);
 	}
 		break;
 	default:
@@ -849,7 +904,7 @@ SERecord::Cons::Record* SERecord::Cons::Record::getInstance(Symbols* symbols, CA
 		tagValue = 0;
 	}
 
-	return new Record(privateFields, length, argumented, monitored, machineDep, painted, fieldCtx, tag, tagValue);
+	return symbols->arena.make<Record>(privateFields, length, argumented, monitored, machineDep, painted, fieldCtx, tag, tagValue);
 }
 
 SERecord::Cons::Ref* SERecord::Cons::Ref::getInstance(Symbols* symbols, CARD16 u0) {
@@ -863,7 +918,7 @@ SERecord::Cons::Ref* SERecord::Cons::Ref::getInstance(Symbols* symbols, CARD16 u
 	bool     basing   = bitField(u0, 13, 15);
 	SEIndex* refType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Ref(counted, ordered, readOnly, list, var, basing, refType);
+	return symbols->arena.make<Ref>(counted, ordered, readOnly, list, var, basing, refType);
 }
 
 SERecord::Cons::Array* SERecord::Cons::Array::getInstance(Symbols* symbols, CARD16 u0) {
@@ -874,7 +929,7 @@ SERecord::Cons::Array* SERecord::Cons::Array::getInstance(Symbols* symbols, CARD
 	SEIndex* indexType     = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 	SEIndex* componentType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Array(packed, indexType, componentType);
+	return symbols->arena.make<Array>(packed, indexType, componentType);
 }
 
 SERecord::Cons::ArrayDesc* SERecord::Cons::ArrayDesc::getInstance(Symbols* symbols, CARD16 u0) {
@@ -884,7 +939,7 @@ SERecord::Cons::ArrayDesc* SERecord::Cons::ArrayDesc::getInstance(Symbols* symbo
 	bool     readOnly      = bitField(u0, 9, 15);
 	SEIndex* describedType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new ArrayDesc(var, readOnly, describedType);
+	return symbols->arena.make<ArrayDesc>(var, readOnly, describedType);
 }
 
 SERecord::Cons::Transfer* SERecord::Cons::Transfer::getInstance(Symbols* symbols, CARD16 u0) {
@@ -896,7 +951,7 @@ SERecord::Cons::Transfer* SERecord::Cons::Transfer::getInstance(Symbols* symbols
 	SEIndex*     typeIn  = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 	SEIndex*     typeOut = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Transfer(safe, mode, typeIn, typeOut);
+	return symbols->arena.make<Transfer>(safe, mode, typeIn, typeOut);
 }
 
 SERecord::Cons::Definition* SERecord::Cons::Definition::getInstance(Symbols* symbols, CARD16 u0) {
@@ -905,7 +960,7 @@ SERecord::Cons::Definition* SERecord::Cons::Definition::getInstance(Symbols* sym
 	bool      named  = bitField(u0, 8, 15);
 	CTXIndex* defCtx = CTXIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Definition(named, defCtx);
+	return symbols->arena.make<Definition>(named, defCtx);
 }
 
 SERecord::Cons::Union* SERecord::Cons::Union::getInstance(Symbols* symbols, CARD16 u0) {
@@ -921,7 +976,7 @@ SERecord::Cons::Union* SERecord::Cons::Union::getInstance(Symbols* symbols, CARD
 	CTXIndex* caseCtx    = CTXIndex::getInstance(symbols, symbols->file->getCARD16());
 	SEIndex*  tagSei     = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Union(overlaid, controlled, machineDep, caseCtx, tagSei);
+	return symbols->arena.make<Union>(overlaid, controlled, machineDep, caseCtx, tagSei);
 }
 
 SERecord::Cons::Sequence* SERecord::Cons::Sequence::getInstance(Symbols* symbols, CARD16 u0) {
@@ -935,7 +990,7 @@ SERecord::Cons::Sequence* SERecord::Cons::Sequence::getInstance(Symbols* symbols
 	SEIndex* tagSei        = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 	SEIndex* componentType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Sequence(packed, controlled, machineDep, tagSei, componentType);
+	return symbols->arena.make<Sequence>(packed, controlled, machineDep, tagSei, componentType);
 }
 
 SERecord::Cons::Relative* SERecord::Cons::Relative::getInstance(Symbols* symbols, CARD16 /*u0*/) {
@@ -946,7 +1001,7 @@ SERecord::Cons::Relative* SERecord::Cons::Relative::getInstance(Symbols* symbols
 	SEIndex* offsetType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 	SEIndex* resultType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Relative(baseType, offsetType, resultType);
+	return symbols->arena.make<Relative>(baseType, offsetType, resultType);
 }
 
 SERecord::Cons::Subrange* SERecord::Cons::Subrange::getInstance(Symbols* symbols, CARD16 u0) {
@@ -960,21 +1015,21 @@ SERecord::Cons::Subrange* SERecord::Cons::Subrange::getInstance(Symbols* symbols
 	INT16    origin    = (INT16)symbols->file->getCARD16();
 	CARD16   range    = symbols->file->getCARD16();
 
-	return new Subrange(filled, empty, rangeType, origin, range);
+	return symbols->arena.make<Subrange>(filled, empty, rangeType, origin, range);
 }
 
 SERecord::Cons::Long* SERecord::Cons::Long::getInstance(Symbols* symbols, CARD16 /*u0*/) {
 	//        long, real => [rangeType(1:0..15): SEIndex],
 	SEIndex* rangeType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Long(rangeType);
+	return symbols->arena.make<Long>(rangeType);
 }
 
 SERecord::Cons::Real* SERecord::Cons::Real::getInstance(Symbols* symbols, CARD16 /*u0*/) {
 	//        long, real => [rangeType(1:0..15): SEIndex],
 	SEIndex* rangeType = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Real(rangeType);
+	return symbols->arena.make<Real>(rangeType);
 }
 
 SERecord::Cons::Opaque* SERecord::Cons::Opaque::getInstance(Symbols* symbols, CARD16 u0) {
@@ -985,20 +1040,20 @@ SERecord::Cons::Opaque* SERecord::Cons::Opaque::getInstance(Symbols* symbols, CA
 	CARD16   length      = symbols->file->getCARD16();
 	SEIndex* id          = SEIndex::getInstance(symbols, symbols->file->getCARD16());
 
-	return new Opaque(lengthKnown, length, id);
+	return symbols->arena.make<Opaque>(lengthKnown, length, id);
 }
 
-SERecord::Cons::Zone* SERecord::Cons::Zone::getInstance(Symbols* /*symbols*/, CARD16 u0) {
+SERecord::Cons::Zone* SERecord::Cons::Zone::getInstance(Symbols* symbols, CARD16 u0) {
 	//        zone => [counted(0:8..8), mds(0:9..15): BOOLEAN],
 	bool counted = bitField(u0, 8);
 	bool mds     = bitField(u0, 9, 15);
 
-	return new Zone(counted, mds);
+	return symbols->arena.make<Zone>(counted, mds);
 }
 
 SERecord::Cons::Bits* SERecord::Cons::Bits::getInstance(Symbols* symbols, CARD16 /*u0*/) {
 	//        bits => [length(1:0..31): BitCount],   -- placed here to avoid
 	CARD32 length = symbols->file->getCARD32();
 
-	return new Bits(length);
+	return symbols->arena.make<Bits>(length);
 }
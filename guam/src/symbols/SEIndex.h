@@ -55,7 +55,7 @@ private:
 
 public:
 	typedef Symbols::TransferMode TransferMode;
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 
 	static SEIndex* getNull();
 	static SEIndex* getInstance(Symbols* symbols, CARD16 index);
@@ -93,8 +93,7 @@ public:
 	}
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, SEIndex*> all;
+	friend class Symbols::Arena;
 
 	SEIndex(Symbols* symbols, CARD16 index);
 };
@@ -545,6 +544,8 @@ public:
 
 
 	static SERecord* getInstance(Symbols* symbols, CARD16 index);
+	// Advance file position to next record without decoding
+	static void skip(Symbols* symbols);
 	static SERecord* find(Symbols* symbols, CARD16 index);
 
 	enum class Tag {ID, CONS};
@@ -559,8 +560,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, SERecord*> all;
+	friend class Symbols::Arena;
 
 	SERecord(Symbols* symbols, CARD16 index, Tag tag, void* tagValue);
 };
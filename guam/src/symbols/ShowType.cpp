@@ -64,13 +64,13 @@ QString ValFormat::toString(Tag value) {
 	TO_STRING_EPILOGUE
 }
 QString ValFormat::Enum::toString() const {
-	return QString("%1").arg(esei->toString());
+	return esei->toString();
 }
 QString ValFormat::Array::toString() const {
-	return QString("%1").arg(componentType->toString());
+	return componentType->toString();
 }
 QString ValFormat::Transfer::toString() const {
-	return QString("%1").arg(ValFormat::toString(mode));
+	return ValFormat::toString(mode);
 }
 const ValFormat::Enum&     ValFormat::getEnum()     const {
 	if (tag != Tag::ENUM) ERROR();
@@ -93,17 +93,17 @@ const ValFormat::Transfer& ValFormat::getTransfer() const {
 QString ValFormat::toString() const {
 	switch(tag) {
 	case Tag::ENUM:
-		return QString("[%1 %2]").arg(toString(tag)).arg(getEnum().toString());
+		return "[" + toString(tag) + " " + getEnum().toString() + "]";
 	case Tag::ARRAY:
-		return QString("[%1 %2]").arg(toString(tag)).arg(getArray().toString());
+		return "[" + toString(tag) + " " + getArray().toString() + "]";
 	case Tag::TRANSFER:
-		return QString("[%1 %2]").arg(toString(tag)).arg(getTransfer().toString());
+		return "[" + toString(tag) + " " + getTransfer().toString() + "]";
 	case Tag::SIGNED:
 	case Tag::UNSIGNED:
 	case Tag::CHAR:
 	case Tag::REF:
 	case Tag::OTHER:
-		return QString("[%1]").arg(toString(tag));
+		return "[" + toString(tag) + "]";
 	default:
 		ERROR();
 		return "???";
@@ -117,7 +117,7 @@ bool ShowType::showBits = true;
 //static std::function<void()> nosub = []{};
 
 //PrintSym: PROCEDURE [sei: Symbols.ISEIndex, colonstring: LONG STRING] =
-void ShowType::printSym(QTextStream& out, const SEIndex* sei, QString colonString) {
+void ShowType::printSym(TextWriter& out, const SEIndex* sei, bool bitSpec) {
 //    BEGIN
 //    savePublic: BOOLEAN � defaultPublic;
 	bool savePublic = defaultPublic;
@@ -127,7 +127,8 @@ void ShowType::printSym(QTextStream& out, const SEIndex* sei, QString colonStrin
 	if (!id.hash->isNull()) {
 //      PrintSei[sei]; out[colonstring, cd]};
 		printSei(out, sei);
-		out << colonString;
+		if (bitSpec) putBitSpec(out, sei);
+		else out << ": ";
 	}
 //    IF symbols.seb[sei].public # defaultPublic THEN {
 	if (id.public_ != defaultPublic) {
@@ -283,7 +284,7 @@ void ShowType::printSym(QTextStream& out, const SEIndex* sei, QString colonStrin
 
 
 //PrintTypedVal: PROCEDURE [val: UNSPECIFIED, vf: ValFormat] =
-void ShowType::printTypedVal(QTextStream& out, CARD16 val, ValFormat vf) {
+void ShowType::printTypedVal(TextWriter& out, CARD16 val, ValFormat vf) {
 //  BEGIN
 //  loophole: BOOLEAN � FALSE;
 	bool loophole = false;
@@ -300,7 +301,7 @@ void ShowType::printTypedVal(QTextStream& out, CARD16 val, ValFormat vf) {
 //    char => {
 //      Format.Octal[out, val, cd]; PutChar['C]};
 	case ValFormat::Tag::CHAR:
-		out << QString("%1C").arg(val, 0, 8);
+		out.octal(val) << "C";
 		break;
 //    enum => PutEnum[val, esei];
 	case ValFormat::Tag::ENUM:
@@ -343,19 +344,18 @@ void ShowType::printTypedVal(QTextStream& out, CARD16 val, ValFormat vf) {
 //    String.AppendDecimal[bitspec, a.bd+s-1]};
 //  String.AppendString[bitspec, "): "L]
 //  END;
-void ShowType::getBitSpec(const SEIndex* isei, QString& bitspec) {
+void ShowType::putBitSpec(TextWriter& out, const SEIndex* isei) {
 	CARD16 a = isei->getValue().getId().idValue;
 	CARD16 s = isei->getValue().getId().idInfo;
 
 	CARD16 wd = a / 16;
 	CARD16 bd = a % 16;
 
-	bitspec.clear();
-	bitspec.append(QString(" (%1").arg(wd));
+	out << " (" << (int)wd;
 	if (s) {
-		bitspec.append(QString(":%1..%2").arg(bd).arg(bd + s - 1));
+		out << ":" << (int)bd << ".." << (bd + s - 1);
 	}
-	bitspec.append("): ");
+	out << "): ";
 }
 
 
@@ -366,7 +366,7 @@ void ShowType::getBitSpec(const SEIndex* isei, QString& bitspec) {
 //      record => PrintFieldCtx[t.fieldCtx];
 //	    any => out[": ANY"L, cd];
 //	ENDCASE};
-void ShowType::outArgType(QTextStream& out, const SEIndex* sei) {
+void ShowType::outArgType(TextWriter& out, const SEIndex* sei) {
 	if (sei->isNull()) out << ": NIL";
 	else {
 		switch(sei->getValue().getCons().tag) {
@@ -400,11 +400,9 @@ void ShowType::outArgType(QTextStream& out, const SEIndex* sei) {
 //    ENDLOOP;
 //  PutChar[']];
 //  END;
-void ShowType::printFieldCtx(QTextStream& out, const CTXIndex* ctx, bool md) {
+void ShowType::printFieldCtx(TextWriter& out, const CTXIndex* ctx, bool md) {
 	const SEIndex* isei = ctx->firstCtxSe();
-	QString bitspec;
 	bool first = true;
-	if (!md) bitspec.append(": ");
 	if (!(isei->isNull()) && !(isei->getValue().getId().idCtx->equals(ctx))) {
 		isei = isei->nextSe();
 	}
@@ -415,8 +413,7 @@ void ShowType::printFieldCtx(QTextStream& out, const CTXIndex* ctx, bool md) {
 		} else {
 			out << ", ";
 		}
-		if (md) getBitSpec(isei, bitspec);
-		printSym(out, isei, bitspec);
+		printSym(out, isei, md);
 		printDefaultValue(out, isei, getValFormat(isei->getValue().getId().idType));
 	}
 	out << "]";
@@ -432,7 +429,7 @@ void ShowType::printFieldCtx(QTextStream& out, const CTXIndex* ctx, bool md) {
 //    SymbolOps.SubStringForHash[symbols, s, hti]; Format.SubString[out, s, cd]};
 //  RETURN
 //  END;
-void ShowType::printHti(QTextStream& out, const HTIndex* hti) {
+void ShowType::printHti(TextWriter& out, const HTIndex* hti) {
 	if (hti->isNull()) out << "(anonymous)";
 	else out << hti->getValue().value;
 }
@@ -443,7 +440,7 @@ void ShowType::printHti(QTextStream& out, const HTIndex* hti) {
 //    IF sei = Symbols.SENull
 //    THEN Symbols.HTNull
 //    ELSE symbols.seb[sei].hash]};
-void ShowType::printSei(QTextStream& out, const SEIndex* sei) {
+void ShowType::printSei(TextWriter& out, const SEIndex* sei) {
 	printHti(out, sei->isNull() ? HTIndex::getNull() : sei->getValue().getId().hash);
 }
 
@@ -451,7 +448,7 @@ void ShowType::printSei(QTextStream& out, const SEIndex* sei) {
 //EnumeratedSEIndex: TYPE = Table.Base RELATIVE POINTER [0..Table.Limit)
 //  TO enumerated cons Symbols.SERecord;
 //PutEnum: PROCEDURE [val: UNSPECIFIED, esei: EnumeratedSEIndex] =
-void ShowType::putEnum(QTextStream& out, CARD16 val, const SEIndex* esei) {
+void ShowType::putEnum(TextWriter& out, CARD16 val, const SEIndex* esei) {
 //  BEGIN
 //  FOR sei: Symbols.ISEIndex �
 //    SymbolOps.FirstCtxSe[symbols, symbols.seb[esei].valueCtx], SymbolOps.NextSe[symbols, sei]
@@ -548,7 +545,7 @@ ValFormat ShowType::getValFormat(const SEIndex* tsei) {
 
 
 //PrintType: PROCEDURE [tsei: Symbols.SEIndex, dosub: PROCEDURE] RETURNS [vf: ValFormat] =
-ValFormat ShowType::printType(QTextStream& out, const SEIndex* tsei, std::function<void()> dosub) {
+ValFormat ShowType::printType(TextWriter& out, const SEIndex* tsei, std::function<void()> dosub) {
 //  BEGIN
 //  bitspec: LONG STRING = [20];
 //  vf � GetValFormat[tsei];
@@ -879,9 +876,7 @@ noprint:;
 //    	        GetBitSpec[tagSei, bitspec]; out[bitspec, cd]}
 //    	      ELSE out[": "L, cd];
 				if (t.machineDep || showBits) {
-					QString bitspec;
-					getBitSpec(t.tagSei, bitspec);
-					out << bitspec;
+					putBitSpec(out, t.tagSei);
 				} else {
 					out << ": ";
 				}
@@ -987,9 +982,7 @@ noprint:;
 //    	      IF machineDep OR showBits THEN {
 //    	        GetBitSpec[tagSei, bitspec]; out[bitspec, cd]}
 				if (t.machineDep || showBits) {
-					QString bitspec;
-					getBitSpec(t.tagSei, bitspec);
-					out << bitspec;
+					putBitSpec(out, t.tagSei);
 				}
 //    	      ELSE out[": "L, cd];
 				else out << ": ";
@@ -1147,7 +1140,7 @@ bool ShowType::isVar(const SEIndex* tsei) {
 //	"NONE"L];
 //  out[ModePrintName[n], cd];
 //  END;
-void ShowType::putModeName(QTextStream& out, Symbols::TransferMode n) {
+void ShowType::putModeName(TextWriter& out, Symbols::TransferMode n) {
 	switch(n) {
 	case Symbols::TransferMode::PROC:
 		out << "PROC";
@@ -1185,7 +1178,7 @@ void ShowType::putModeName(QTextStream& out, Symbols::TransferMode n) {
 //  out[" � "L, cd];
 //  PrintTreeLink[tree, vf, 0];
 //  END;
-void ShowType::printDefaultValue(QTextStream& out, const SEIndex* sei, ValFormat vf) {
+void ShowType::printDefaultValue(TextWriter& out, const SEIndex* sei, ValFormat vf) {
 	ExtRecord* ext = ExtRecord::find(sei);
 	Symbols::ExtensionType type = ext ? ext->type : Symbols::ExtensionType::NONE;
 	const TreeLink* tree(ext ? ext->tree : TreeLink::getNull());
@@ -1196,7 +1189,7 @@ void ShowType::printDefaultValue(QTextStream& out, const SEIndex* sei, ValFormat
 
 
 //PrintTreeLink: PROCEDURE [tree: Tree.Link, vf: ValFormat, recur: CARDINAL, sonOfDot: BOOLEAN � FALSE] =
-void ShowType::printTreeLink(QTextStream& out, const TreeLink* tree, ValFormat vf, int recur, bool /*sonOfDot*/) {
+void ShowType::printTreeLink(TextWriter& out, const TreeLink* tree, ValFormat vf, int recur, bool /*sonOfDot*/) {
 //  BEGIN
 //  IF tree = Tree.Null THEN RETURN;
 	if (tree->isNull()) return;
@@ -1509,7 +1502,7 @@ void ShowType::printTreeLink(QTextStream& out, const TreeLink* tree, ValFormat v
 //  PutUnsigned[seq[LENGTH[seq]-1]];
 //  PutChar[']];
 //  END;
-void ShowType::putWordSeq(QTextStream& out, CARD16 length, const CARD16* value) {
+void ShowType::putWordSeq(TextWriter& out, CARD16 length, const CARD16* value) {
 	out << "[";
 	for(CARD16 i = 0; i < length; i++) {
 		if (i) out << ", ";
@@ -1533,7 +1526,7 @@ void ShowType::dump(Symbols* symbols) {
 		ERROR();
 	}
 
-	QTextStream out(&file);
+	TextWriter out(&file);
 
     const CTXIndex* outerCtx = symbols->outerCtx;
     logger.info("dump %s", outerCtx->toString().toLocal8Bit().constData());
@@ -1541,8 +1534,8 @@ void ShowType::dump(Symbols* symbols) {
     out.flush();
     const SEIndex* sei = outerCtx->getValue().seList;
     for(;;) {
-    	out << QString("%1: ").arg(sei->toString());
-        printSym(out, sei, ": ");
+    	out << sei->toString() << ": ";
+        printSym(out, sei);
         out << endl;
 
         sei = sei->nextSe();
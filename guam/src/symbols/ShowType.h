@@ -37,7 +37,7 @@ OF SUCH DAMAGE.
 
 #include "Symbols.h"
 
-#include <QTextStream>
+#include "../util/TextWriter.h"
 
 #include <functional>
 
@@ -150,49 +150,51 @@ private:
 class ShowType {
 public:
     //PrintSym: PROCEDURE [sei: Symbols.ISEIndex, colonstring: LONG STRING] =
-    static void printSym(QTextStream& out, const SEIndex* sei, QString colonString);
+    //  colonstring is bit spec of sei if bitSpec is true, otherwise ": "
+    static void printSym(TextWriter& out, const SEIndex* sei, bool bitSpec = false);
 
     //PrintTypedVal: PROCEDURE [val: UNSPECIFIED, vf: ValFormat] =
-    static void printTypedVal(QTextStream& out, CARD16 val, ValFormat vf);
+    static void printTypedVal(TextWriter& out, CARD16 val, ValFormat vf);
 
     //GetBitSpec: PROCEDURE [isei: Symbols.ISEIndex, bitspec: LONG STRING] =
-    static void getBitSpec(const SEIndex* isei, QString& bitspec);
+    //  bit spec is written to out instead of bitspec
+    static void putBitSpec(TextWriter& out, const SEIndex* isei);
 
     //OutArgType: PROCEDURE [sei: Symbols.CSEIndex] = {
-    static void outArgType(QTextStream& out, const SEIndex* sei);
+    static void outArgType(TextWriter& out, const SEIndex* sei);
 
     //PrintFieldCtx: PROCEDURE [ctx: Symbols.CTXIndex, md: BOOLEAN � FALSE] =
-    static void printFieldCtx(QTextStream& out, const CTXIndex* ctx, bool md = false);
+    static void printFieldCtx(TextWriter& out, const CTXIndex* ctx, bool md = false);
 
     //PrintHti: PROCEDURE [hti: Symbols.HTIndex] =
-    static void printHti(QTextStream& out, const HTIndex* hti);
+    static void printHti(TextWriter& out, const HTIndex* hti);
 
     //PrintSei: PROCEDURE [sei: Symbols.ISEIndex] = {
-    static void printSei(QTextStream& out, const SEIndex* sei);
+    static void printSei(TextWriter& out, const SEIndex* sei);
 
     //PutEnum: PROCEDURE [val: UNSPECIFIED, esei: EnumeratedSEIndex] =
-    static void putEnum(QTextStream& out, CARD16 val, const SEIndex* esei);
+    static void putEnum(TextWriter& out, CARD16 val, const SEIndex* esei);
 
     //GetValFormat: PROCEDURE [tsei: Symbols.SEIndex] RETURNS [vf: ValFormat] =
     static ValFormat getValFormat(const SEIndex* tsei);
 
     //PrintType: PROCEDURE [tsei: Symbols.SEIndex, dosub: PROCEDURE] RETURNS [vf: ValFormat] =
-    static ValFormat printType(QTextStream& out, const SEIndex* tsei, std::function<void()> dosub);
+    static ValFormat printType(TextWriter& out, const SEIndex* tsei, std::function<void()> dosub);
 
     //IsVar: PROC [tsei: Symbols.SEIndex] RETURNS [BOOLEAN] =
     static bool isVar(const SEIndex* tsei);
 
     //PutModeName: PROCEDURE [n: Symbols.TransferMode] =
-    static void putModeName(QTextStream& out, Symbols::TransferMode n);
+    static void putModeName(TextWriter& out, Symbols::TransferMode n);
 
     //PrintDefaultValue: PROCEDURE [sei: Symbols.ISEIndex, vf: ValFormat] =
-    static void printDefaultValue(QTextStream& out, const SEIndex* sei, ValFormat vf);
+    static void printDefaultValue(TextWriter& out, const SEIndex* sei, ValFormat vf);
 
     //PrintTreeLink: PROCEDURE [tree: Tree.Link, vf: ValFormat, recur: CARDINAL, sonOfDot: BOOLEAN � FALSE] =
-    static void printTreeLink(QTextStream& out, const TreeLink* tree, ValFormat vf, int recur, bool sonOfDot = false);
+    static void printTreeLink(TextWriter& out, const TreeLink* tree, ValFormat vf, int recur, bool sonOfDot = false);
 
     // PutWordSeq: PROCEDURE [seq: LONG DESCRIPTOR FOR ARRAY OF UNSPECIFIED] =
-    static void putWordSeq(QTextStream& out, CARD16 length, const CARD16* value);
+    static void putWordSeq(TextWriter& out, CARD16 length, const CARD16* value);
 
     // for debug
     static void dump(Symbols* symbols);
@@ -46,7 +46,6 @@ static log4cpp::Category& logger = Logger::getLogger("symbols");
 #include "SEIndex.h"
 #include "Tree.h"
 
-
 QString Symbols::toString(TypeClass value) {
 	TO_STRING_PROLOGUE(TypeClass)
 
@@ -167,15 +166,47 @@ QString Symbols::toString(VarTag value) {
 
 
 
+//
+// Symbols::Arena
+//
+Symbols::Arena::~Arena() {
+	// Destroy in reverse order of creation
+	for(int i = destructorList.size() - 1; 0 <= i; i--) {
+		destructorList[i].function(destructorList[i].object);
+	}
+	for(char* block: blockList) {
+		delete[] block;
+	}
+}
+void* Symbols::Arena::allocate(size_t size_) {
+	// Keep alignment of pointer and 64 bit value
+	const size_t alignedSize = (size_ + 7) & ~(size_t)7;
+
+	if ((size_t)(limit - next) < alignedSize) {
+		// Large object has own block
+		const size_t blockSize = qMax(alignedSize, (size_t)BLOCK_SIZE);
+		char* block = new char[blockSize];
+		blockList.append(block);
+		next  = block;
+		limit = block + blockSize;
+	}
+
+	void* ret = next;
+	next += alignedSize;
+	size += alignedSize;
+	return ret;
+}
+
+
 //
 // Symbols
 //
 
-Symbols::BlockDescriptor* Symbols::BlockDescriptor::getInstance(BCD* bcd) {
-	CARD16 offset = bcd->file->getCARD16();
-	CARD16 size   = bcd->file->getCARD16();
+Symbols::BlockDescriptor* Symbols::BlockDescriptor::getInstance(Symbols* symbols) {
+	CARD16 offset = symbols->file->getCARD16();
+	CARD16 size   = symbols->file->getCARD16();
 
-	return new BlockDescriptor(offset, size);
+	return symbols->arena.make<BlockDescriptor>(offset, size);
 }
 
 QString Symbols::BlockDescriptor::toString() const {
@@ -189,7 +220,7 @@ bool Symbols::isSymbolsSegment(BCD* bcd, int symbolBase) {
     return versionIdent == VersionID;
 }
 
-Symbols::Symbols(BCD* bcd_, int symbolBase_) : bcd(bcd_) {
+Symbols::Symbols(BCD* bcd_, int symbolBase_, Mode mode_) : bcd(bcd_), mode(mode_) {
 	bcd             = bcd_;
 	file            = bcd->file;
 
@@ -224,37 +255,37 @@ Symbols::Symbols(BCD* bcd_, int symbolBase_) : bcd(bcd_) {
     logger.info("outerCtx       %s", outerCtx->toString().toLocal8Bit().constData());
 
 
-    hvBlock         = BlockDescriptor::getInstance(bcd);
+    hvBlock         = BlockDescriptor::getInstance(this);
     logger.info("hvBlock        %s", hvBlock->toString().toLocal8Bit().constData());
-    htBlock         = BlockDescriptor::getInstance(bcd);
+    htBlock         = BlockDescriptor::getInstance(this);
     logger.info("htBlock        %s", htBlock->toString().toLocal8Bit().constData());
-    ssBlock         = BlockDescriptor::getInstance(bcd);
+    ssBlock         = BlockDescriptor::getInstance(this);
     logger.info("ssBlock        %s", ssBlock->toString().toLocal8Bit().constData());
-    outerPackBlock  = BlockDescriptor::getInstance(bcd);
+    outerPackBlock  = BlockDescriptor::getInstance(this);
 //    logger.info("outerPackBlock %s", outerPackBlock->toString().toLocal8Bit().constData());
-    innerPackBlock  = BlockDescriptor::getInstance(bcd);
+    innerPackBlock  = BlockDescriptor::getInstance(this);
 //    logger.info("innerPackBlock %s", innerPackBlock->toString().toLocal8Bit().constData());
-    constBlock      = BlockDescriptor::getInstance(bcd);
+    constBlock      = BlockDescriptor::getInstance(this);
 //    logger.info("constBlock     %s", constBlock->toString().toLocal8Bit().constData());
-    seBlock         = BlockDescriptor::getInstance(bcd);
+    seBlock         = BlockDescriptor::getInstance(this);
     logger.info("seBlock        %s", seBlock->toString().toLocal8Bit().constData());
-    ctxBlock        = BlockDescriptor::getInstance(bcd);
+    ctxBlock        = BlockDescriptor::getInstance(this);
     logger.info("ctxBlock       %s", ctxBlock->toString().toLocal8Bit().constData());
-    mdBlock         = BlockDescriptor::getInstance(bcd);
+    mdBlock         = BlockDescriptor::getInstance(this);
     logger.info("mdBlock        %s", mdBlock->toString().toLocal8Bit().constData());
-    bodyBlock       = BlockDescriptor::getInstance(bcd);
+    bodyBlock       = BlockDescriptor::getInstance(this);
     logger.info("bodyBlock      %s", bodyBlock->toString().toLocal8Bit().constData());
-    extBlock        = BlockDescriptor::getInstance(bcd);
+    extBlock        = BlockDescriptor::getInstance(this);
 //    logger.info("extBlock       %s", extBlock->toString().toLocal8Bit().constData());
-    treeBlock       = BlockDescriptor::getInstance(bcd);
+    treeBlock       = BlockDescriptor::getInstance(this);
 //    logger.info("treeBlock      %s", treeBlock->toString().toLocal8Bit().constData());
-    litBlock        = BlockDescriptor::getInstance(bcd);
+    litBlock        = BlockDescriptor::getInstance(this);
 //    logger.info("litBlock       %s", litBlock->toString().toLocal8Bit().constData());
-    sLitBlock       = BlockDescriptor::getInstance(bcd);
+    sLitBlock       = BlockDescriptor::getInstance(this);
 //    logger.info("sLitBlock      %s", sLitBlock->toString().toLocal8Bit().constData());
-    epMapBlock      = BlockDescriptor::getInstance(bcd);
+    epMapBlock      = BlockDescriptor::getInstance(this);
 //    logger.info("epMapBlock     %s", epMapBlock->toString().toLocal8Bit().constData());
-    spareBlock      = BlockDescriptor::getInstance(bcd);
+    spareBlock      = BlockDescriptor::getInstance(this);
 //    logger.info("spareBlock     %s", spareBlock->toString().toLocal8Bit().constData());
 
     fgRelPgBase     = file->getCARD16();
@@ -266,23 +297,75 @@ Symbols::Symbols(BCD* bcd_, int symbolBase_) : bcd(bcd_) {
     initializeSS(ssBlock);
     initializeHT(htBlock);
     initializeMD(mdBlock);
-    initializeCTX(ctxBlock);
-    initializeSE(seBlock);
+    if (mode == Mode::EAGER) {
+        initializeCTX(ctxBlock);
+        initializeSE(seBlock);
+    } else {
+        scanStart<CTXRecord>(ctxBlock, ctxStart);
+        scanStart<SERecord>(seBlock, seStart);
+    }
     initializeBT(bodyBlock);
     initializeLT(litBlock);
     initializeExt(extBlock);
-    initializeTree(treeBlock);
-
-    BTIndex::checkAll();
-    CTXIndex::checkAll();
-    ExtIndex::checkAll();
-    HTIndex::checkAll();
-    LTIndex::checkAll();
-    MDIndex::checkAll();
-    SEIndex::checkAll();
-    TreeIndex::checkAll();
+    if (mode == Mode::EAGER) {
+        initializeTree(treeBlock);
+    } else {
+        scanStart<TreeNode>(treeBlock, treeStart);
+    }
+
+    BTIndex::checkAll(this);
+    ExtIndex::checkAll(this);
+    HTIndex::checkAll(this);
+    LTIndex::checkAll(this);
+    MDIndex::checkAll(this);
+    if (mode == Mode::EAGER) {
+        // In lazy mode, checkAll would decode every referenced record
+        CTXIndex::checkAll(this);
+        SEIndex::checkAll(this);
+        TreeIndex::checkAll(this);
+    }
 };
 
+template<typename T> void Symbols::scanStart(BlockDescriptor* block, std::vector<bool>& start) {
+	start.assign(block->size, false);
+	if (block->size == 0) return;
+
+	BCDFile::Span span(file, offsetBase + block->offset, block->size);
+	while(!span.atEnd()) {
+		start[span.index()] = true;
+		T::skip(this);
+	}
+}
+template<typename T> T* Symbols::decode(BlockDescriptor* block, const std::vector<bool>& start, CARD16 index) {
+	// Same as eager mode, index that is not start of record has no record
+	if (block->size <= index) return 0;
+	if (!start[index]) return 0;
+
+	// Record can be decoded while other table is being read. Keep current position.
+	int savedPosition = file->bytePosition();
+	file->position(offsetBase + block->offset + index);
+	T* ret = T::getInstance(this, index);
+	file->bytePosition(savedPosition);
+
+	return ret;
+}
+SERecord* Symbols::decodeSE(CARD16 index) {
+	return decode<SERecord>(seBlock, seStart, index);
+}
+CTXRecord* Symbols::decodeCTX(CARD16 index) {
+	return decode<CTXRecord>(ctxBlock, ctxStart, index);
+}
+TreeNode* Symbols::decodeTree(CARD16 index) {
+	return decode<TreeNode>(treeBlock, treeStart, index);
+}
+
+void Symbols::logStats() const {
+	// Number of record and size of table in word for lazily decoded table
+	logger.info("stats  %s  ctx %4d/%5d  se %4d/%5d  tree %4d/%5d  bt %4d  ht %4d  arena %llu",
+		mode == Mode::LAZY ? "LAZY " : "EAGER",
+		ctx.size(), ctxBlock->size, se.size(), seBlock->size, tree.size(), treeBlock->size, bt.size(), ht.size(), arena.getSize());
+}
+
 void Symbols::initializeSS(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     CARD16 limit = base + block->size;
@@ -291,16 +374,12 @@ void Symbols::initializeSS(BlockDescriptor* block) {
     CARD16 length    = file->getCARD16();
     CARD16 maxLength = file->getCARD16();
 
-    for(int i = 0; i < length; i++) {
-     	char data = file->getCARD8();
-    	QChar c(data);
-    	ss.append(c);
-    }
+    QByteArray data(length, 0);
+    file->get(length, (CARD8*)data.data());
+    ss.append(QString::fromLatin1(data.constData(), data.size()));
 
     // Advance position
-    for(int i = length; i <= maxLength; i++) {
-    	file->getCARD8();
-    }
+    file->bytePosition(file->bytePosition() + (maxLength + 1 - length));
 
     // sanity check
     {
@@ -319,14 +398,10 @@ void Symbols::initializeHT(BlockDescriptor* block) {
 
     CARD16 lastSSIndex = 0;
     CARD16 index = 0;
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
+    while(!span.atEnd()) {
         HTRecord* record = HTRecord::getInstance(this, index, lastSSIndex);
-        ht[index] = record;
 
         logger.info("ht %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -349,15 +424,11 @@ void Symbols::initializeMD(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         MDRecord* record = MDRecord::getInstance(this, index);
-        md[index] = record;
 
         logger.info("md %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -379,15 +450,11 @@ void Symbols::initializeCTX(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         CTXRecord* record = CTXRecord::getInstance(this, index);
-        ctx[index] = record;
 
         logger.info("ctx %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -409,15 +476,11 @@ void Symbols::initializeSE(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         SERecord* record = SERecord::getInstance(this, index);
-        se[index] = record;
 
         logger.info("se %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -439,15 +502,11 @@ void Symbols::initializeBT(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
+    BCDFile::Span span(file, base, block->size);
 
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
-
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         BTRecord* record = BTRecord::getInstance(this, index);
-        bt[index] = record;
 
         logger.info("bt %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -469,15 +528,11 @@ void Symbols::initializeExt(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         ExtRecord* record = ExtRecord::getInstance(this, index);
-        ext[index] = record;
 
         logger.info("ext %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -499,15 +554,11 @@ void Symbols::initializeLT(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         LTRecord* record = LTRecord::getInstance(this, index);
-        lt[index] = record;
 
         logger.info("lt %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
@@ -529,15 +580,11 @@ void Symbols::initializeTree(BlockDescriptor* block) {
     CARD16 base  = offsetBase + block->offset;
     int    limit = base + block->size;
 
-    file->position(base);
-
-    for(;;) {
-        int pos = file->position();
-        if (limit <= pos) break;
+    BCDFile::Span span(file, base, block->size);
 
-        int index = pos - base;
+    while(!span.atEnd()) {
+        int index = span.index();
         TreeNode* record = TreeNode::getInstance(this, index);
-        tree[index] = record;
 
         logger.info("tree %4d %s", index, record->toString().toLocal8Bit().constData());
         index++;
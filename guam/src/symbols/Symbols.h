@@ -35,6 +35,11 @@ OF SUCH DAMAGE.
 #include "../util/Util.h"
 #include "../mesa/MesaBasic.h"
 
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "BCD.h"
 
 // Forward declaration of classes
@@ -61,6 +66,7 @@ class MDRecord;
 class SEIndex;
 class SERecord;
 
+class TreeIndex;
 class TreeLink;
 class TreeNode;
 
@@ -70,17 +76,98 @@ class TreeNode;
 //
 class Symbols {
 public:
-	struct Key {
-		const Symbols* symbols;
-		const CARD16   index;
+	// Arena owns every object decoded from symbols segment.
+	// All objects are released at once when Symbols is destroyed.
+	class Arena {
+	public:
+		static const int BLOCK_SIZE = 64 * 1024;
+
+		Arena() : next(0), limit(0), size(0) {}
+		~Arena();
+
+		template<typename T, typename... Args> T* make(Args&&... args) {
+			T* ret = new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+			if (!std::is_trivially_destructible<T>::value) destructorList.append(Destructor(ret, destroy<T>));
+			return ret;
+		}
+		template<typename T> T* makeArray(int length) {
+			static_assert(std::is_trivially_destructible<T>::value, "T must be trivially destructible");
+			return (T*)allocate(sizeof(T) * length);
+		}
+
+		// Total bytes of allocated object
+		quint64 getSize() const {
+			return size;
+		}
 
-		bool operator<(const Key &that) const {
-				if (symbols != that.symbols) return symbols < that.symbols;
-				return index < that.index;
+	private:
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		class Destructor {
+		public:
+			void* object;
+			void  (*function)(void*);
+
+			Destructor() : object(0), function(0) {}
+			Destructor(void* object_, void (*function_)(void*)) : object(object_), function(function_) {}
+		};
+		template<typename T> static void destroy(void* object) {
+			((T*)object)->~T();
 		}
 
-		Key(const Key& that) : symbols(that.symbols), index(that.index) {}
-		Key(const Symbols* symbols_, const CARD16 index_) : symbols(symbols_), index(index_) {}
+		void* allocate(size_t size);
+
+		QList<char*>        blockList;
+		char*               next;
+		char*               limit;
+		quint64             size;
+		QVector<Destructor> destructorList;
+	};
+
+	// Table of objects addressed directly by table index
+	template<typename T> class Table {
+	public:
+		Table() : count(0) {}
+
+		T* value(CARD16 index) const {
+			return (index < list.size()) ? list[index] : 0;
+		}
+		T* operator[](CARD16 index) const {
+			return value(index);
+		}
+		bool contains(CARD16 index) const {
+			return value(index) != 0;
+		}
+		void insert(CARD16 index, T* newValue) {
+			if (list.size() <= index) list.resize(index + 1);
+			if (list[index] == 0) count++;
+			list[index] = newValue;
+		}
+		// Number of entries
+		int size() const {
+			return count;
+		}
+		// Index of entries in ascending order
+		QList<CARD16> keys() const {
+			QList<CARD16> ret;
+			for(int i = 0; i < list.size(); i++) {
+				if (list[i]) ret.append((CARD16)i);
+			}
+			return ret;
+		}
+		// Value of entries in ascending order of index
+		QList<T*> values() const {
+			QList<T*> ret;
+			for(T* e: list) {
+				if (e) ret.append(e);
+			}
+			return ret;
+		}
+
+	private:
+		QVector<T*> list;
+		int         count;
 	};
 
 	//  altoBias: CARDINAL = 1;  -- AMesa/14.0/Compiler/Friends/FilePack.mesa
@@ -205,13 +292,14 @@ public:
 	//BlockDescriptor: TYPE = RECORD [offset: WordOffset, size: CARDINAL];
 	class BlockDescriptor {
 	public:
-		static BlockDescriptor* getInstance(BCD* bcd);
+		static BlockDescriptor* getInstance(Symbols* symbols);
 
 	    const CARD16 offset;
 	    const CARD16 size;
 
 	    QString toString() const;
 	private:
+		friend class Arena;
 	    BlockDescriptor(CARD16 offset_, CARD16 size_) : offset(offset_), size(size_) {}
 	};
 
@@ -276,18 +364,50 @@ public:
 	CARD16           fgPgCount;
 	//
 	QString                   ss;
-	QMap<CARD16, CTXRecord*>  ctx;
-	QMap<CARD16, HTRecord*>   ht;
-	QMap<CARD16, MDRecord*>   md;
-	QMap<CARD16, SERecord*>   se;
-    QMap<CARD16, BTRecord*>   bt;
-    QMap<CARD16, ExtRecord*>  ext;
-    QMap<CARD16, LTRecord*>   lt;
-    QMap<CARD16, TreeNode*>   tree;
-
-    Symbols(BCD* bcd, int symbolBase);
+	Arena                     arena;
+	Table<CTXRecord>          ctx;
+	Table<HTRecord>           ht;
+	Table<MDRecord>           md;
+	Table<SERecord>           se;
+	Table<BTRecord>           bt;
+	Table<ExtRecord>          ext;
+	Table<LTRecord>           lt;
+	Table<TreeNode>           tree;
+	//
+	Table<CTXIndex>           ctxIndex;
+	Table<HTIndex>            htIndex;
+	Table<MDIndex>            mdIndex;
+	Table<SEIndex>            seIndex;
+	Table<BTIndex>            btIndex;
+	Table<ExtIndex>           extIndex;
+	Table<LTIndex>            ltIndex;
+	Table<TreeIndex>          treeIndex;
+
+	// EAGER decodes every table in constructor.
+	// LAZY decodes SE, CTX and Tree record on first access. Table index is word offset of record.
+	// Word offset of start of each record is scanned in constructor.
+	enum class Mode {EAGER, LAZY};
+	const Mode mode;
+
+    Symbols(BCD* bcd, int symbolBase, Mode mode = Mode::EAGER);
+
+    // Decode record of lazily decoded table. Returns 0 if index is not start of record
+    SERecord*  decodeSE  (CARD16 index);
+    CTXRecord* decodeCTX (CARD16 index);
+    TreeNode*  decodeTree(CARD16 index);
+
+    // Output number of materialized record of each table
+    void logStats() const;
 
 private:
+	// true if word offset is start of record
+	std::vector<bool> seStart;
+	std::vector<bool> ctxStart;
+	std::vector<bool> treeStart;
+
+	template<typename T> void scanStart(BlockDescriptor* block, std::vector<bool>& start);
+	template<typename T> T* decode(BlockDescriptor* block, const std::vector<bool>& start, CARD16 index);
+
 	void initializeSS(BlockDescriptor* block);
 	void initializeHT(BlockDescriptor* block);
 	void initializeMD(BlockDescriptor* block);
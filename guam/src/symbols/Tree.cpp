@@ -43,13 +43,9 @@ static log4cpp::Category& logger = Logger::getLogger("tree");
 //
 // TreeIndex
 //
-QMap<TreeIndex::Key, TreeIndex*> TreeIndex::all;
-TreeIndex::TreeIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {
-	Key key(symbols_, index_);
-	all[key] = this;
-}
-void TreeIndex::checkAll() {
-	for(TreeIndex* e: all.values()) {
+TreeIndex::TreeIndex(Symbols* symbols_, CARD16 index_) : symbols(symbols_), index(index_) {}
+void TreeIndex::checkAll(Symbols* symbols) {
+	for(TreeIndex* e: symbols->treeIndex.values()) {
 		if (e->isNull()) continue;
 		TreeNode* value = TreeNode::find(e->symbols, e->index);
 		if (value == 0) {
@@ -58,13 +54,18 @@ void TreeIndex::checkAll() {
 	}
 }
 TreeIndex* TreeIndex::getNull() {
-	return getInstance(0, TREE_NULL);
+	static TreeIndex null(0, TREE_NULL);
+	return &null;
 }
 TreeIndex* TreeIndex::getInstance(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	if (all.contains(key)) return all[key];
+	if (symbols == 0) return getNull();
 
-	return new TreeIndex(symbols, index);
+	TreeIndex* ret = symbols->treeIndex.value(index);
+	if (ret == 0) {
+		ret = symbols->arena.make<TreeIndex>(symbols, index);
+		symbols->treeIndex.insert(index, ret);
+	}
+	return ret;
 }
 QString TreeIndex::toString() const {
 	if (isNull()) return QString("%1-NULL").arg(PREFIX);
@@ -95,17 +96,17 @@ const TreeNode& TreeIndex::getValue() const {
 //  info (1): Info,
 //  son (2): ARRAY [1..1) OF Link];
 
-QMap<TreeNode::Key, TreeNode*> TreeNode::all;
 TreeNode::TreeNode(Symbols* symbols_, CARD16 index_, NodeName name_, bool shared_, CARD16 nSons_, CARD16 info_, TreeLink** son_) :
 	symbols(symbols_), index(index_), name(name_), shared(shared_), nSons(nSons_), info(info_), son(son_) {
-	Key key(symbols_, index_);
-	all[key] = this;
+	symbols_->tree.insert(index_, this);
 
 	TreeIndex::getInstance(symbols_, index_);
 }
 TreeNode* TreeNode::find(Symbols* symbols, CARD16 index) {
-	Key key(symbols, index);
-	return all.value(key, 0);
+	if (symbols == 0) return 0;
+	TreeNode* ret = symbols->tree.value(index);
+	if (ret == 0 && symbols->mode == Symbols::Mode::LAZY) ret = symbols->decodeTree(index);
+	return ret;
 }
 
 QString TreeNode::toString(NodeName value) {
@@ -212,12 +213,18 @@ TreeNode* TreeNode::getInstance(Symbols* symbols, CARD16 index) {
  	CARD16   nSons  = bitField(u0, 13, 15);
  	CARD16   info   = symbols->file->getCARD16();
 
- 	TreeLink** son = new TreeLink*[nSons];
+ 	TreeLink** son = symbols->arena.makeArray<TreeLink*>(nSons);
  	for(CARD16 i = 0; i < nSons; i++) {
  		son[i] = TreeLink::getInstance(symbols);
  	}
 
-    return new TreeNode(symbols, index, name, shared, nSons, info, son);
+    return symbols->arena.make<TreeNode>(symbols, index, name, shared, nSons, info, son);
+}
+void TreeNode::skip(Symbols* symbols) {
+	BCDFile* file = symbols->file;
+	CARD16 nSons = bitField(file->getCARD16(), 13, 15);
+	// info and sons
+	file->position(file->position() + 1 + nSons);
 }
 
 
@@ -300,16 +307,16 @@ TreeLink* TreeLink::getInstance(Symbols* symbols) {
 
 	switch(tag) {
 	case Tag::SUBTREE:
-		tagValue = new Subtree(TreeIndex::getInstance(symbols, bitField(u0, 2, 15)));
+		tagValue = symbols->arena.make<Subtree>(TreeIndex::getInstance(symbols, bitField(u0, 2, 15)));
 		break;
 	case Tag::HASH:
-		tagValue = new Hash(HTIndex::getInstance(symbols, bitField(u0, 2, 15)));
+		tagValue = symbols->arena.make<Hash>(HTIndex::getInstance(symbols, bitField(u0, 2, 15)));
 		break;
 	case Tag::SYMBOL:
-		tagValue = new Symbol(SEIndex::getInstance(symbols, bitField(u0, 2, 15)));
+		tagValue = symbols->arena.make<Symbol>(SEIndex::getInstance(symbols, bitField(u0, 2, 15)));
 		break;
 	case Tag::LITERAL:
-		tagValue = new Literal(LitRecord::getInstance(symbols, bitField(u0, 2, 15)));
+		tagValue = symbols->arena.make<Literal>(LitRecord::getInstance(symbols, bitField(u0, 2, 15)));
 		break;
 	default:
 		ERROR();
@@ -317,7 +324,7 @@ TreeLink* TreeLink::getInstance(Symbols* symbols) {
 		break;
 	}
 
-	return new TreeLink(tag, tagValue);
+	return symbols->arena.make<TreeLink>(tag, tagValue);
 }
 //Null: Tree.Link = [subtree[index: Tree.NullIndex]];
 TreeLink* TreeLink::getNull() {
@@ -57,7 +57,7 @@ private:
 
 
 public:
-	static void checkAll();
+	static void checkAll(Symbols* symbols);
 	static TreeIndex* getNull();
 	static TreeIndex* getInstance(Symbols* symbols, CARD16 index);
 
@@ -68,8 +68,7 @@ public:
 
 	const TreeNode& getValue() const;
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, TreeIndex*> all;
+	friend class Symbols::Arena;
 
 	TreeIndex(Symbols* symbols, CARD16 index);
 };
@@ -92,6 +91,8 @@ private:
 
 public:
 	static TreeNode* getInstance(Symbols* symbols, CARD16 index);
+	// Advance file position to next record without decoding
+	static void skip(Symbols* symbols);
 	static TreeNode* find(Symbols* symbols, CARD16 index);
 
 	enum class NodeName {
@@ -193,8 +194,7 @@ public:
 	QString toString() const;
 
 private:
-	typedef Symbols::Key Key;
-	static QMap<Key, TreeNode*> all;
+	friend class Symbols::Arena;
 
 	TreeNode(Symbols* symbols, CARD16 index, NodeName name, bool shared, CARD16 nSons, CARD16 info, TreeLink** son);
 };
@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+
+//
+// testBatch.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testBatch");
+
+#include "testBase.h"
+
+#include "../util/Batch.h"
+
+class testBatch : public testBase {
+	CPPUNIT_TEST_SUITE(testBatch);
+	CPPUNIT_TEST(testRun);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void testRun() {
+		const int N = 200;
+		QList<Batch::Entry> entryList;
+		for(int i = 0; i < N; i++) {
+			Batch::append(entryList, QFileInfo(QString("file-%1").arg(i)));
+		}
+
+		Batch batch;
+		batch.setThreadCount(8);
+
+		QList<int> mergeList;
+		int failCount = batch.run(entryList, [](const Batch::Entry& entry) {
+			// Finish later entry earlier to check order of merge
+			if ((entry.index % 3) == 0) QThread::usleep(100);
+			if ((entry.index % 50) == 49) {
+				logger.info("Expected error");
+				throw Error(__FUNCTION__, __FILE__, __LINE__);
+			}
+			return QByteArray::number(entry.index);
+		}, [&mergeList](const Batch::Entry& entry, const QByteArray& output) {
+			CPPUNIT_ASSERT_EQUAL(entry.index, output.toInt());
+			mergeList.append(entry.index);
+		});
+
+		CPPUNIT_ASSERT_EQUAL(N / 50, failCount);
+		CPPUNIT_ASSERT_EQUAL(N - N / 50, mergeList.size());
+		for(int i = 1; i < mergeList.size(); i++) {
+			CPPUNIT_ASSERT(mergeList[i - 1] < mergeList[i]);
+		}
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatch);
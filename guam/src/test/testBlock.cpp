@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// testBlock.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testBlock");
+
+#include "testBase.h"
+
+#include "../simple-opcode/Block.h"
+
+class testBlock : public testBase {
+	CPPUNIT_TEST_SUITE(testBlock);
+	CPPUNIT_TEST(testChecksum);
+	CPPUNIT_TEST(testCompare);
+	CPPUNIT_TEST(testCopy);
+	CPPUNIT_TEST(testCopyReverse);
+	CPPUNIT_TEST(testBenchmark);
+	CPPUNIT_TEST_SUITE_END();
+
+	static const CARD32 SIZE  = PageSize * 4;
+	static const int    COUNT = 10000;
+
+	// Use own random number generator to make test reproducible
+	CARD32 seed;
+	CARD32 random() {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+	CARD32 random(CARD32 limit) {
+		return random() % limit;
+	}
+	void fill(CARD16* p, CARD32 n) {
+		switch(random(3)) {
+		case 0:
+			for(CARD32 i = 0; i < n; i++) p[i] = (CARD16)random();
+			break;
+		case 1: // all one
+			for(CARD32 i = 0; i < n; i++) p[i] = 0xFFFF;
+			break;
+		default: // zero in ones' complement
+			for(CARD32 i = 0; i < n; i++) p[i] = (random() & 1) ? 0 : 0xFFFF;
+			break;
+		}
+	}
+	static CARD16 normalize(CARD16 cksum) {
+		return (cksum == 0xFFFF) ? 0 : cksum;
+	}
+
+public:
+	void setUp() {
+		testBase::setUp();
+		seed = 1;
+	}
+
+	void testChecksum() {
+		CARD16 data[SIZE];
+		for(int i = 0; i < COUNT; i++) {
+			CARD32 n     = random(SIZE);
+			CARD16 cksum = (CARD16)random();
+			fill(data, n);
+			CPPUNIT_ASSERT_EQUAL(normalize(Block::checksumScalar(cksum, data, n)), normalize(Block::checksum(cksum, data, n)));
+		}
+	}
+
+	void testCompare() {
+		CARD16 a[SIZE];
+		CARD16 b[SIZE];
+		for(int i = 0; i < COUNT; i++) {
+			CARD32 n = random(SIZE);
+			fill(a, n);
+			for(CARD32 j = 0; j < n; j++) b[j] = a[j];
+			if (n && random(4)) b[random(n)] ^= 1 << random(16);
+			CPPUNIT_ASSERT_EQUAL(Block::compareScalar(a, b, n), Block::compare(a, b, n));
+		}
+	}
+
+	void testCopy() {
+		CARD16 expect[SIZE * 2];
+		CARD16 actual[SIZE * 2];
+		for(int i = 0; i < COUNT; i++) {
+			CARD32 n = random(SIZE);
+			CARD32 s = random(SIZE);
+			// dest is near source to test overlap
+			CARD32 d = random(2) ? random(SIZE) : (s + random(64) + SIZE - 32) % SIZE;
+			fill(expect, SIZE * 2);
+			for(CARD32 j = 0; j < SIZE * 2; j++) actual[j] = expect[j];
+
+			Block::copyScalar(expect + d, expect + s, n);
+			Block::copy      (actual + d, actual + s, n);
+			for(CARD32 j = 0; j < SIZE * 2; j++) CPPUNIT_ASSERT_EQUAL(expect[j], actual[j]);
+		}
+	}
+
+	void testCopyReverse() {
+		CARD16 expect[SIZE * 2];
+		CARD16 actual[SIZE * 2];
+		for(int i = 0; i < COUNT; i++) {
+			CARD32 n = random(SIZE);
+			CARD32 s = random(SIZE);
+			// dest is near source to test overlap
+			CARD32 d = random(2) ? random(SIZE) : (s + random(64) + SIZE - 32) % SIZE;
+			fill(expect, SIZE * 2);
+			for(CARD32 j = 0; j < SIZE * 2; j++) actual[j] = expect[j];
+
+			Block::copyReverseScalar(expect + d, expect + s, n);
+			Block::copyReverse      (actual + d, actual + s, n);
+			for(CARD32 j = 0; j < SIZE * 2; j++) CPPUNIT_ASSERT_EQUAL(expect[j], actual[j]);
+		}
+	}
+
+	// Log throughput of Block and reference implementation in mega words per second
+	void testBenchmark() {
+		const int    LOOP = 20000;
+		const CARD32 n    = PageSize;
+		CARD16 a[n];
+		CARD16 b[n];
+		for(CARD32 i = 0; i < n; i++) a[i] = b[i] = (CARD16)random();
+
+		CARD16 cksum = 0;
+		CARD32 count = 0;
+		CARD32 t[9];
+		t[0] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) cksum = Block::checksumScalar(cksum, a, n);
+		t[1] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) cksum = Block::checksum(cksum, a, n);
+		t[2] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) count += Block::compareScalar(a, b, n);
+		t[3] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) count += Block::compare(a, b, n);
+		t[4] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) Block::copyScalar(b, a, n);
+		t[5] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) Block::copy(b, a, n);
+		t[6] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) Block::copyReverseScalar(b, a, n);
+		t[7] = Util::getMicroTime();
+		for(int i = 0; i < LOOP; i++) Block::copyReverse(b, a, n);
+		t[8] = Util::getMicroTime();
+
+		const char* name[] = {"checksum", "compare", "copy", "copyReverse"};
+		const double words = (double)LOOP * n;
+		for(int i = 0; i < 4; i++) {
+			CARD32 scalar = t[i * 2 + 1] - t[i * 2 + 0];
+			CARD32 block  = t[i * 2 + 2] - t[i * 2 + 1];
+			logger.info("benchmark %-12s scalar %8.1f  block %8.1f  Mword/s", name[i], words / (scalar ? scalar : 1), words / (block ? block : 1));
+		}
+		logger.info("benchmark cksum = %04X  count = %u", cksum, count);
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBlock);
@@ -41,6 +41,10 @@ class testMemory : public testBase {
 	CPPUNIT_TEST(testStack);
 	CPPUNIT_TEST(testReadDbl);
 	CPPUNIT_TEST(testGetCodeByte);
+	CPPUNIT_TEST(testAVCache);
+	CPPUNIT_TEST(testAVCacheFrame);
+	CPPUNIT_TEST(testGFTCache);
+	CPPUNIT_TEST(testPsbWatch);
 	CPPUNIT_TEST_SUITE_END();
 
 
@@ -110,6 +114,89 @@ public:
      		CPPUNIT_ASSERT_EQUAL(expect, actual);
     	}
     }
+
+    void testAVCache() {
+    	CARD16* av = AVCache::getAV();
+    	CPPUNIT_ASSERT_EQUAL(page_AV, av);
+
+    	// store through PageCache flush AVCache
+    	*StoreMds(AV + OFFSET_AV(1)) = 0x1234;
+    	av = AVCache::getAV();
+    	CPPUNIT_ASSERT_EQUAL(page_AV, av);
+    	CPPUNIT_ASSERT_EQUAL((CARD16)0x1234, av[1]);
+
+    	// store through AVCache is visible through PageCache
+    	av[2] = 0x5678;
+    	CPPUNIT_ASSERT_EQUAL((CARD16)0x5678, *FetchMds(AV + OFFSET_AV(2)));
+    }
+
+    void testAVCacheFrame() {
+    	const FSIndex fsi = 10;
+    	CARD16* av = AVCache::getAV();
+    	const CARD16 first = av[fsi];
+    	const LocalFrameHandle frame = 0x2010;
+    	LocalFrameHandle ret;
+
+    	// freed frame is held and taken by next alloc of same fsi
+    	CPPUNIT_ASSERT(AVCache::freeFrame(fsi, frame));
+    	CPPUNIT_ASSERT_EQUAL(first, page_AV[fsi]);
+    	CPPUNIT_ASSERT(AVCache::allocFrame(fsi, ret));
+    	CPPUNIT_ASSERT_EQUAL(frame, ret);
+    	CPPUNIT_ASSERT(!AVCache::allocFrame(fsi, ret));
+
+    	// access to AV through PageCache links held frame to AV
+    	CPPUNIT_ASSERT(AVCache::freeFrame(fsi, frame));
+    	CPPUNIT_ASSERT_EQUAL(frame, *FetchMds(AV + OFFSET_AV(fsi)));
+    	CPPUNIT_ASSERT_EQUAL(first, page_MDS[frame]);
+    	AVCache::getAV();
+    	CPPUNIT_ASSERT(!AVCache::allocFrame(fsi, ret));
+
+    	// frame is not held if stack of fsi is full
+    	for(int i = 0; i < AVCache::FRAME_DEPTH; i++) CPPUNIT_ASSERT(AVCache::freeFrame(fsi, frame + i * 0x10));
+    	CPPUNIT_ASSERT(!AVCache::freeFrame(fsi, frame + AVCache::FRAME_DEPTH * 0x10));
+    }
+
+    void testPsbWatch() {
+    	const PsbIndex psb = 40; // second page of PSB
+    	const POINTER  ptr = OFFSET4(ProcessDataArea, block, psb, timeout);
+    	PsbWatch::clear();
+
+    	// store of process instruction is not recorded
+    	*StorePda(ptr) = 0x0010;
+    	CPPUNIT_ASSERT_EQUAL(0, PsbWatch::getCount());
+
+    	// store through PageCache is recorded every time
+    	*Store(PDA + ptr) = 0x0020;
+    	CPPUNIT_ASSERT_EQUAL(1, PsbWatch::getCount());
+    	CPPUNIT_ASSERT_EQUAL((CARD32)1, PsbWatch::getPage(0));
+    	PsbWatch::clear();
+    	*Store(PDA + ptr) = 0x0030;
+    	CPPUNIT_ASSERT_EQUAL(1, PsbWatch::getCount());
+    	CPPUNIT_ASSERT_EQUAL((CARD16)0x0030, *FetchPda(ptr));
+    }
+
+    void testGFTCache() {
+    	const GFTHandle gfi = 0x0024;
+    	CPPUNIT_ASSERT(GFTCache::findGFI(gfi) == 0);
+
+    	GFTCache::addGFI(gfi, 0x00051234, 0x00030000);
+    	GFTCache::Entry* entry = GFTCache::findGFI(gfi);
+    	CPPUNIT_ASSERT(entry != 0);
+    	CPPUNIT_ASSERT_EQUAL((CARD32)0x00051234, entry->gf);
+    	CPPUNIT_ASSERT_EQUAL((CARD32)0x00030000, entry->cb);
+
+    	// store to GFT through PageCache flush GFTCache
+    	*Store(GFT_OFFSET(gfi, codebase)) = 0x0001;
+    	CPPUNIT_ASSERT(GFTCache::findGFI(gfi) == 0);
+    	// WriteMap flush only entry that depends on the page
+    	const GFTHandle gfi2 = 0x0028;
+    	GFTCache::addGFI(gfi, 0x00051234, 0x00030000);
+    	GFTCache::addGFI(gfi2, 0x00051240, 0x00040000);
+    	const CARD32 vp = 0x00030000 / PageSize;
+    	Memory::WriteMap(vp, Memory::ReadMap(vp));
+    	CPPUNIT_ASSERT(GFTCache::findGFI(gfi) == 0);
+    	CPPUNIT_ASSERT(GFTCache::findGFI(gfi2) != 0);
+    }
 };
 
 
@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// testModuleEntryDB.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testModuleEntryDB");
+
+#include "testBase.h"
+
+#include "../mesa/ModuleEntryDB.h"
+
+class testModuleEntryDB : public testBase {
+	CPPUNIT_TEST_SUITE(testModuleEntryDB);
+	CPPUNIT_TEST(testBuild);
+	CPPUNIT_TEST(testLoad);
+	CPPUNIT_TEST_SUITE_END();
+
+	static void writeFile(const QString& path, const char* contents) {
+		QFile file(path);
+		CPPUNIT_ASSERT(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		file.write(contents);
+		file.close();
+	}
+	static void removeFile(QDir& dir) {
+		for(QString name: dir.entryList(QDir::Files)) dir.remove(name);
+	}
+
+public:
+	void testBuild() {
+		QDir dir(QDir::tempPath() + "/testModuleEntryDB");
+		CPPUNIT_ASSERT(dir.mkpath("."));
+		removeFile(dir);
+
+		writeFile(dir.absoluteFilePath("GermOpsImpl-B"), "B GermOpsImpl 0 GermOpsImpl\nB GermOpsImpl 1 Start\nB GermOpsImpl 2 Stop\n");
+		writeFile(dir.absoluteFilePath("ProcessImpl-A"), "A ProcessImpl 0 ProcessImpl\nA ProcessImpl 1 Start\n");
+		writeFile(dir.absoluteFilePath("Empty-C"),       "");
+
+		const QString dbPath = QDir::tempPath() + "/testModuleEntryDB.db";
+		ModuleEntryDB::build(dir.absolutePath(), dbPath);
+
+		ModuleEntryDB db;
+		CPPUNIT_ASSERT(db.open(dbPath));
+		CPPUNIT_ASSERT_EQUAL(2, db.size());
+		CPPUNIT_ASSERT_EQUAL(-1, db.find("C"));
+
+		int a = db.find("A");
+		int b = db.find("B");
+		CPPUNIT_ASSERT_EQUAL(0, a);
+		CPPUNIT_ASSERT_EQUAL(1, b);
+		CPPUNIT_ASSERT_EQUAL(std::string("ProcessImpl"), std::string(db.getModuleName(a)));
+		CPPUNIT_ASSERT_EQUAL((quint32)3, db.getEntryCount(b));
+		CPPUNIT_ASSERT_EQUAL(std::string("Stop"), std::string(db.getEntryName(b, 2)));
+		// Interned string shares same storage
+		CPPUNIT_ASSERT(db.getEntryName(a, 1) == db.getEntryName(b, 1));
+
+		db.close();
+		QFile::remove(dbPath);
+		removeFile(dir);
+		dir.rmdir(".");
+		logger.info("testBuild  OK");
+	}
+
+	void testLoad() {
+		QDir dir(QDir::tempPath() + "/testModuleEntryDB");
+		CPPUNIT_ASSERT(dir.mkpath("."));
+		removeFile(dir);
+
+		writeFile(dir.absoluteFilePath("GermOpsImpl-B"), "B GermOpsImpl 0 GermOpsImpl\nB GermOpsImpl 1 Start\n");
+
+		// Invalid database is not opened
+		const QString dbPath = QDir::tempPath() + "/testModuleEntryDB.db";
+		writeFile(dbPath, "GUAMMEDB");
+		ModuleEntryDB db;
+		CPPUNIT_ASSERT(!db.open(dbPath));
+		CPPUNIT_ASSERT_EQUAL(0, db.size());
+
+		// Fall back to text files
+		db.load(dir.absolutePath());
+		CPPUNIT_ASSERT_EQUAL(1, db.size());
+		int b = db.find("B");
+		CPPUNIT_ASSERT_EQUAL(0, b);
+		CPPUNIT_ASSERT_EQUAL(std::string("Start"), std::string(db.getEntryName(b, 1)));
+
+		db.close();
+		QFile::remove(dbPath);
+		removeFile(dir);
+		dir.rmdir(".");
+		logger.info("testLoad  OK");
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testModuleEntryDB);
@@ -636,6 +636,8 @@ class testOpcode_300 : public testBase {
 
 		CPPUNIT_ASSERT_EQUAL(GFI_EFC, GFI);
 		CPPUNIT_ASSERT_EQUAL(nPC, PC);
+		// Link frame held by AVCache to AV
+		AVCache::invalidate();
 		CPPUNIT_ASSERT_EQUAL(page_AV[0], oLF);
 		CPPUNIT_ASSERT_EQUAL((CARD16)0, SP);
 	}
@@ -134,23 +134,31 @@ class testOpcode_esc : public testBase {
 //	CPPUNIT_TEST(testA76);   // 0076
 //	CPPUNIT_TEST(testA77);   // 0077
 
-//  CPPUNIT_TEST(testFADD);  // 0100
-//  CPPUNIT_TEST(testFSUB);  // 0101
-//  CPPUNIT_TEST(testFMUL);  // 0102
-//  CPPUNIT_TEST(testFDIV);  // 0103
-//  CPPUNIT_TEST(testFCOMP); // 0104
-//  CPPUNIT_TEST(testFIX);   // 0105
-//  CPPUNIT_TEST(testFLOAT); // 0106
-//  CPPUNIT_TEST(testFIXI);  // 0107
-
-//  CPPUNIT_TEST(testFIXC);    // 0110
-//  CPPUNIT_TEST(testFSTICKY); // 0111
-//  CPPUNIT_TEST(testFREM);    // 0112
-//  CPPUNIT_TEST(testROUND);   // 0113
-//  CPPUNIT_TEST(testROUNDI);  // 0114
-//  CPPUNIT_TEST(testROUNDC);  // 0115
-//  CPPUNIT_TEST(testFSQRT);   // 0116
-//  CPPUNIT_TEST(testFSC);     // 0117
+	CPPUNIT_TEST(testFADD);    // 0100
+	CPPUNIT_TEST(testFADD_t);  // 0100
+	CPPUNIT_TEST(testFSUB);    // 0101
+	CPPUNIT_TEST(testFMUL);    // 0102
+	CPPUNIT_TEST(testFDIV);    // 0103
+	CPPUNIT_TEST(testFDIV_t);  // 0103
+	CPPUNIT_TEST(testFCOMP);   // 0104
+	CPPUNIT_TEST(testFIX);     // 0105
+	CPPUNIT_TEST(testFLOAT);   // 0106
+	CPPUNIT_TEST(testFIXI);    // 0107
+	CPPUNIT_TEST(testFIXI_t);  // 0107
+
+	CPPUNIT_TEST(testFIXC);    // 0110
+	CPPUNIT_TEST(testFIXC_t);  // 0110
+	CPPUNIT_TEST(testFSTICKY); // 0111
+	CPPUNIT_TEST(testFSTICKY_inexact); // 0111
+	CPPUNIT_TEST(testFSTICKY_inexact2); // 0111
+	CPPUNIT_TEST(testFSTICKY_mode);    // 0111
+	CPPUNIT_TEST(testFREM);    // 0112
+	CPPUNIT_TEST(testROUND);   // 0113
+	CPPUNIT_TEST(testROUNDI);  // 0114
+	CPPUNIT_TEST(testROUNDC);  // 0115
+	CPPUNIT_TEST(testFSQRT);   // 0116
+	CPPUNIT_TEST(testFSQRT_t); // 0116
+	CPPUNIT_TEST(testFSC);     // 0117
 
 
 
@@ -334,6 +342,8 @@ class testOpcode_esc : public testBase {
 
 		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
 		CPPUNIT_ASSERT_EQUAL((CARD16)0, SP);
+		// Link frame held by AVCache to AV
+		AVCache::invalidate();
 		CPPUNIT_ASSERT_EQUAL(frame, page_AV[fsi]);
 		CPPUNIT_ASSERT_EQUAL(first, page_MDS[frame]);
 	}
@@ -766,6 +776,7 @@ class testOpcode_esc : public testBase {
 		CPPUNIT_ASSERT_EQUAL(GFI_EFC, GFI);
 		CPPUNIT_ASSERT_EQUAL((CARD16)(dst.pc + 1), PC);
 		CPPUNIT_ASSERT_EQUAL((CARD16)1, InterruptThread::getWDC());
+		AVCache::invalidate();
 		CPPUNIT_ASSERT_EQUAL(page_AV[0], oLF);
 		CPPUNIT_ASSERT_EQUAL(0, (int)SP);
 	}
@@ -1404,6 +1415,263 @@ class testOpcode_esc : public testBase {
 	}
 
 
+	// REAL has sign and exponent in first word
+	void pushReal(float f) {
+		union {
+			CARD32 u;
+			float  f;
+		} t;
+		t.f = f;
+		stack[SP++] = HighHalf(t.u);
+		stack[SP++] = LowHalf(t.u);
+	}
+	float getReal(int index) {
+		union {
+			CARD32 u;
+			float  f;
+		} t;
+		t.u = ((CARD32)stack[index] << WordSize) | stack[index + 1];
+		return t.f;
+	}
+	// Inexact flag of sticky word
+	static const CARD16 FLAG_INEXACT = 0x4000;
+	// Operation that cannot be done by host traps to software emulation
+	void checkEscOpcodeTrap() {
+		int catchException = 0;
+		try {
+			Interpreter::execute();
+		} catch (Abort &info) {
+			catchException = 1;
+		}
+
+		CPPUNIT_ASSERT_EQUAL(1, catchException);
+		CPPUNIT_ASSERT_EQUAL(GFI_ETT, GFI);
+	}
+
+	void testFADD() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFADD;
+		pushReal(1.5);
+		pushReal(2.25);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(3.75f, getReal(0));
+	}
+	void testFADD_t() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFADD;
+		pushReal(3.0e38f);
+		pushReal(3.0e38f);
+		checkEscOpcodeTrap();
+	}
+	void testFSUB() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFSUB;
+		pushReal(1.5);
+		pushReal(2.25);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(-0.75f, getReal(0));
+	}
+	void testFMUL() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFMUL;
+		pushReal(1.5);
+		pushReal(-2.25);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(-3.375f, getReal(0));
+	}
+	void testFDIV() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFDIV;
+		pushReal(3.375);
+		pushReal(1.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(2.25f, getReal(0));
+	}
+	void testFDIV_t() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFDIV;
+		pushReal(1.0);
+		pushReal(0.0);
+		checkEscOpcodeTrap();
+	}
+	void testFCOMP() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFCOMP;
+		pushReal(1.5);
+		pushReal(2.25);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(1, (int)SP);
+		CPPUNIT_ASSERT_EQUAL((CARD16)-1, stack[0]);
+	}
+	void testFIX() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFIX;
+		FST = FLAG_INEXACT;
+		pushReal(-123456.75);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		INT32 a = -123456;
+		CPPUNIT_ASSERT_EQUAL(LowHalf(a),  stack[0]);
+		CPPUNIT_ASSERT_EQUAL(HighHalf(a), stack[1]);
+	}
+	void testFLOAT() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFLOAT;
+		INT32 a = -123456;
+		stack[SP++] = LowHalf(a);
+		stack[SP++] = HighHalf(a);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(-123456.0f, getReal(0));
+	}
+	void testFIXI() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFIXI;
+		FST = FLAG_INEXACT;
+		pushReal(-3.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(1, (int)SP);
+		CPPUNIT_ASSERT_EQUAL((CARD16)-3, stack[0]);
+	}
+	void testFIXI_t() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFIXI;
+		pushReal(32768.0);
+		checkEscOpcodeTrap();
+	}
+
+	void testFIXC() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFIXC;
+		FST = FLAG_INEXACT;
+		pushReal(65535.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(1, (int)SP);
+		CPPUNIT_ASSERT_EQUAL((CARD16)65535, stack[0]);
+	}
+	void testFIXC_t() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFIXC;
+		pushReal(-1.0);
+		checkEscOpcodeTrap();
+	}
+	void testFSTICKY() {
+		// software emulation owns sticky word, and FST follows new value
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFSTICKY;
+		stack[SP++] = 0x1234;
+		checkEscOpcodeTrap();
+
+		CPPUNIT_ASSERT_EQUAL((CARD16)0x1234, FST);
+	}
+	void testFSTICKY_inexact() {
+		// first inexact result traps, so software emulation sets inexact flag
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFDIV;
+		pushReal(1.0);
+		pushReal(3.0);
+		checkEscOpcodeTrap();
+
+		CPPUNIT_ASSERT_EQUAL(FLAG_INEXACT, FST);
+	}
+	void testFSTICKY_inexact2() {
+		// after that, inexact result is calculated natively
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFDIV;
+		FST = FLAG_INEXACT;
+		pushReal(1.0);
+		pushReal(3.0);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(1.0f / 3.0f, getReal(0));
+		CPPUNIT_ASSERT_EQUAL(FLAG_INEXACT, FST);
+	}
+	void testFSTICKY_mode() {
+		// rounding mode other than round to nearest traps even if result is exact
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFADD;
+		FST = 0x0001;
+		pushReal(1.5);
+		pushReal(2.25);
+		checkEscOpcodeTrap();
+
+		CPPUNIT_ASSERT_EQUAL((CARD16)0x0001, FST);
+	}
+	void testFREM() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFREM;
+		pushReal(7.0);
+		pushReal(2.0);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(-1.0f, getReal(0));
+	}
+	void testROUND() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aROUND;
+		FST = FLAG_INEXACT;
+		pushReal(-123456.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		INT32 a = -123456; // round to even
+		CPPUNIT_ASSERT_EQUAL(LowHalf(a),  stack[0]);
+		CPPUNIT_ASSERT_EQUAL(HighHalf(a), stack[1]);
+	}
+	void testROUNDI() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aROUNDI;
+		FST = FLAG_INEXACT;
+		pushReal(-2.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(1, (int)SP);
+		CPPUNIT_ASSERT_EQUAL((CARD16)-2, stack[0]);
+	}
+	void testROUNDC() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aROUNDC;
+		FST = FLAG_INEXACT;
+		pushReal(3.5);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(1, (int)SP);
+		CPPUNIT_ASSERT_EQUAL((CARD16)4, stack[0]);
+	}
+	void testFSQRT() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFSQRT;
+		pushReal(2.25);
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(1.5f, getReal(0));
+	}
+	void testFSQRT_t() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFSQRT;
+		pushReal(-1.0);
+		checkEscOpcodeTrap();
+	}
+	void testFSC() {
+		page_CB[(PC / 2) + 0] = zESC << 8 | aFSC;
+		pushReal(1.5);
+		stack[SP++] = (CARD16)-2;
+		Interpreter::execute();
+
+		CPPUNIT_ASSERT_EQUAL(savedPC + 2, (int)PC);
+		CPPUNIT_ASSERT_EQUAL(2, (int)SP);
+		CPPUNIT_ASSERT_EQUAL(0.375f, getReal(0));
+	}
+
+
 	void testWRPSB() {
 		page_CB[(PC / 2) + 0] = zESC << 8 | aWRPSB;
 		CARD16 n = 128;
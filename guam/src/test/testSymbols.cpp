@@ -0,0 +1,182 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+
+
+//
+// testSymbols.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testSymbols");
+
+#include "testBase.h"
+
+#include "../symbols/BCD.h"
+#include "../symbols/BCDFile.h"
+#include "../symbols/Symbols.h"
+#include "../symbols/SEIndex.h"
+
+class testSymbols : public testBase {
+	CPPUNIT_TEST_SUITE(testSymbols);
+	CPPUNIT_TEST(testSESkip);
+	CPPUNIT_TEST(testLazy);
+	CPPUNIT_TEST_SUITE_END();
+
+	typedef Symbols::TypeClass TypeClass;
+
+	// Symbols segment starts at page 1 of file. Page 0 is not BCD header.
+	static const int SYMBOL_BASE = 2;
+	static const int HEADER_SIZE = 47;
+	static const int SS_SIZE     = 3;
+	static const int HT_SIZE     = 2;
+
+	// Record of SE table and its size in word
+	class SE {
+	public:
+		QVector<CARD16> words;
+		QString         name;
+	};
+
+	static SE id(SERecord::Id::Tag tag) {
+		SE ret;
+		ret.words << 0x0000 << 0 << 0 << 0 << (CARD16)tag;
+		if (tag == SERecord::Id::Tag::LINKED) ret.words << 0;
+		ret.name = QString("ID %1").arg(SERecord::Id::toString(tag));
+		return ret;
+	}
+	static SE cons(TypeClass tag, int size) {
+		SE ret;
+		ret.words << (CARD16)(0x2000 | ((int)tag << 8));
+		for(int i = 1; i < size; i++) ret.words << 0;
+		ret.name = QString("CONS %1").arg(Symbols::toString(tag));
+		return ret;
+	}
+	static SE record(SERecord::Cons::Record::Tag tag) {
+		SE ret;
+		ret.words << (CARD16)(0x2000 | ((int)TypeClass::RECORD << 8)) << 0 << (CARD16)tag;
+		if (tag == SERecord::Cons::Record::Tag::LINKED) ret.words << 0;
+		ret.name = QString("CONS RECORD %1").arg(SERecord::Cons::Record::toString(tag));
+		return ret;
+	}
+
+	// One record of each kind of SE
+	static QList<SE> seList() {
+		QList<SE> ret;
+		ret << id(SERecord::Id::Tag::TERMINAL) << id(SERecord::Id::Tag::SEQUENTIAL) << id(SERecord::Id::Tag::LINKED);
+		ret << cons(TypeClass::MODE,       1) << cons(TypeClass::BASIC,      2) << cons(TypeClass::ENUMERATED, 3);
+		ret << record(SERecord::Cons::Record::Tag::NOT_LINKED) << record(SERecord::Cons::Record::Tag::LINKED);
+		ret << cons(TypeClass::REF,        2) << cons(TypeClass::ARRAY,      3) << cons(TypeClass::ARRAYDESC,  2);
+		ret << cons(TypeClass::TRANSFER,   3) << cons(TypeClass::DEFINITION, 2) << cons(TypeClass::UNION,      3);
+		ret << cons(TypeClass::SEQUENCE,   3) << cons(TypeClass::RELATIVE,   4) << cons(TypeClass::SUBRANGE,   4);
+		ret << cons(TypeClass::LONG,       2) << cons(TypeClass::REAL,       2) << cons(TypeClass::OPAQUE,     3);
+		ret << cons(TypeClass::ZONE,       1) << cons(TypeClass::ANY,        1) << cons(TypeClass::NIL,        1);
+		ret << cons(TypeClass::BITS,       3);
+		return ret;
+	}
+
+	// Build file that contains symbols segment with SE table of seList
+	static QByteArray buildFile() {
+		QVector<CARD16> se;
+		for(const SE& e: seList()) se += e.words;
+
+		QVector<CARD16> words(Symbols::WORDS_PER_PAGE, 0);
+		words << (CARD16)Symbols::VersionID;
+		for(int i = 0; i < 9; i++) words << 0; // version, creator and sourceVersion
+		words << 0 << 0 << 0;                  // definitionsFile, directoryCtx, importCtx and outerCtx
+		// hvBlock, htBlock, ssBlock, outerPackBlock, innerPackBlock, constBlock, seBlock, ctxBlock,
+		// mdBlock, bodyBlock, extBlock, treeBlock, litBlock, sLitBlock, epMapBlock and spareBlock
+		const CARD16 ssOffset = HEADER_SIZE;
+		const CARD16 htOffset = ssOffset + SS_SIZE;
+		const CARD16 seOffset = htOffset + HT_SIZE;
+		words << 0 << 0 << htOffset << HT_SIZE << ssOffset << SS_SIZE;
+		words << 0 << 0 << 0 << 0 << 0 << 0 << seOffset << (CARD16)se.size();
+		for(int i = 0; i < 9; i++) words << 0 << 0;
+		words << 0 << 0;                       // fgRelPgBase and fgPgCount
+		CPPUNIT_ASSERT_EQUAL(Symbols::WORDS_PER_PAGE + HEADER_SIZE, words.size());
+		// ss: length = 0  maxLength = 1
+		words << 0 << 1 << 0;
+		// ht: one empty name used as hash of every ID
+		words << 0 << 0;
+		words += se;
+
+		QByteArray ret;
+		for(CARD16 word: words) ret.append((char)(word >> 8)).append((char)word);
+		return ret;
+	}
+
+public:
+	void testSESkip() {
+		BCD     bcd(buildFile());
+		Symbols symbols(&bcd, SYMBOL_BASE, Symbols::Mode::EAGER);
+		BCDFile* file = symbols.file;
+
+		int offset = symbols.offsetBase + symbols.seBlock->offset;
+		for(const SE& e: seList()) {
+			logger.info("%-24s %d", e.name.toLocal8Bit().constData(), e.words.size());
+			// skip advances same number of words as getInstance
+			file->position(offset);
+			SERecord::skip(&symbols);
+			CPPUNIT_ASSERT_EQUAL(offset + e.words.size(), file->position());
+
+			file->position(offset);
+			SERecord::getInstance(&symbols, offset - (symbols.offsetBase + symbols.seBlock->offset));
+			CPPUNIT_ASSERT_EQUAL(offset + e.words.size(), file->position());
+
+			offset += e.words.size();
+		}
+	}
+
+	void testLazy() {
+		BCD     bcd(buildFile());
+		Symbols eager(&bcd, SYMBOL_BASE, Symbols::Mode::EAGER);
+		Symbols lazy (&bcd, SYMBOL_BASE, Symbols::Mode::LAZY);
+
+		// Lazy mode decodes nothing in constructor
+		CPPUNIT_ASSERT_EQUAL(seList().size(), eager.se.size());
+		CPPUNIT_ASSERT_EQUAL(0, lazy.se.size());
+
+		// Every index has same record or no record in both mode
+		for(CARD16 index = 0; index < eager.seBlock->size; index++) {
+			SERecord* e = SERecord::find(&eager, index);
+			SERecord* l = SERecord::find(&lazy,  index);
+			CPPUNIT_ASSERT_EQUAL(e == 0, l == 0);
+			if (e == 0) continue;
+			CPPUNIT_ASSERT_EQUAL(e->toString().toStdString(), l->toString().toStdString());
+		}
+		// Outside of table
+		CPPUNIT_ASSERT(SERecord::find(&lazy, eager.seBlock->size) == 0);
+
+		// Record is decoded once and memoized
+		CPPUNIT_ASSERT_EQUAL(eager.se.size(), lazy.se.size());
+		CARD16 index = eager.se.keys().last();
+		CPPUNIT_ASSERT(SERecord::find(&lazy, index) == lazy.se.value(index));
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testSymbols);
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// testTrace.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testTrace");
+
+#include "testBase.h"
+
+#include "../mesa/MesaThread.h"
+#include "../mesa/Trace.h"
+
+class testTrace : public testBase {
+	CPPUNIT_TEST_SUITE(testTrace);
+	CPPUNIT_TEST(testRecordReplay);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void testRecordReplay() {
+		const QString path = QDir::tempPath() + "/testTrace.trace";
+		CARD16 iocb[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+		// Enough events to span multiple chunks
+		const int N = Trace::CHUNK_SIZE / 16;
+
+		Trace::initialize("record", path);
+		CPPUNIT_ASSERT_EQUAL(1, Trace::isRecord());
+		// Processor thread counts instruction only while record or replay
+		CPPUNIT_ASSERT(ProcessorThread::getRequestHook() != 0);
+		for(int i = 0; i < 3; i++) Trace::countInstruction();
+		CPPUNIT_ASSERT_EQUAL((CARD32)100, Trace::value(Trace::T_time, 100));
+		for(int i = 0; i < 2; i++) Trace::countInstruction();
+		CPPUNIT_ASSERT_EQUAL((CARD32)2, Trace::value(Trace::T_request, 2));
+		Trace::verify(Trace::T_disk, iocb, sizeof(iocb));
+		for(int i = 0; i < N; i++) {
+			Trace::countInstruction();
+			Trace::value(Trace::T_wakeup, i);
+		}
+		Trace::finalize();
+		CPPUNIT_ASSERT_EQUAL(0, Trace::isEnabled());
+		CPPUNIT_ASSERT_EQUAL(0, ProcessorThread::getRequestHook());
+
+		Trace::initialize("replay", path);
+		CPPUNIT_ASSERT_EQUAL(1, Trace::isReplay());
+		CPPUNIT_ASSERT(ProcessorThread::getRequestHook() != 0);
+		for(int i = 0; i < 3; i++) {
+			Trace::countInstruction();
+			CPPUNIT_ASSERT_EQUAL(0, Trace::isSafePoint());
+		}
+		CPPUNIT_ASSERT_EQUAL((CARD32)100, Trace::value(Trace::T_time, 999));
+		for(int i = 0; i < 2; i++) Trace::countInstruction();
+		CPPUNIT_ASSERT_EQUAL(1, Trace::isSafePoint());
+		CPPUNIT_ASSERT_EQUAL((CARD32)2, Trace::value(Trace::T_request, 0));
+		Trace::verify(Trace::T_disk, iocb, sizeof(iocb));
+		// T_input is not recorded at this instruction
+		QByteArray data;
+		CPPUNIT_ASSERT_EQUAL(0, Trace::replay(Trace::T_input, data));
+		for(int i = 0; i < N; i++) {
+			Trace::countInstruction();
+			CPPUNIT_ASSERT_EQUAL((CARD32)i, Trace::value(Trace::T_wakeup, 0));
+		}
+		Trace::finalize();
+
+		QFile::remove(path);
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testTrace);
@@ -0,0 +1,255 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Batch.cpp
+//
+
+#include "Util.h"
+static log4cpp::Category& logger = Logger::getLogger("batch");
+
+#include "Batch.h"
+
+#include <algorithm>
+
+
+//
+// Batch::ScanTask
+//
+class Batch::ScanTask : public QRunnable {
+public:
+	class Context {
+	public:
+		QThreadPool*  pool;
+		Filter        filter;
+		QMutex        mutex;
+		QList<Entry>  entryList;
+		int           dirCount;
+	};
+
+	ScanTask(Context* context_, const QFileInfo& dirInfo_, const QString& relativePath_) :
+		context(context_), dirInfo(dirInfo_), relativePath(relativePath_) {}
+
+	void run() {
+		QDir dir(dirInfo.filePath());
+		QList<Entry> entryList;
+
+		for(QFileInfo childInfo: dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::Name)) {
+			QString childPath = QString("%1/%2").arg(relativePath).arg(childInfo.fileName());
+			if (childInfo.isDir()) {
+				context->pool->start(new ScanTask(context, childInfo, childPath));
+			}
+			if (childInfo.isFile() && context->filter(childInfo)) {
+				entryList.append(Entry(childInfo, childPath));
+			}
+		}
+
+		QMutexLocker locker(&context->mutex);
+		context->entryList.append(entryList);
+		context->dirCount++;
+	}
+
+private:
+	Context*        context;
+	const QFileInfo dirInfo;
+	const QString   relativePath;
+};
+
+
+//
+// Batch::RunTask
+//
+class Batch::RunTask : public QRunnable {
+public:
+	class Result {
+	public:
+		bool       done;
+		bool       failed;
+		QByteArray output;
+
+		Result() : done(false), failed(false) {}
+	};
+	class Context {
+	public:
+		const QList<Entry>* entryList;
+		Process             process;
+		QVector<Result>     resultList;
+		QAtomicInt          next;
+		QMutex              mutex;
+		QWaitCondition      cv;
+	};
+
+	RunTask(Context* context_) : context(context_) {}
+
+	void run() {
+		const int size = context->entryList->size();
+		for(;;) {
+			const int index = context->next.fetchAndAddOrdered(1);
+			if (size <= index) break;
+
+			const Entry& entry = context->entryList->at(index);
+			QByteArray output;
+			bool       failed = false;
+			try {
+				output = context->process(entry);
+			} catch (Error& e) {
+				logger.error("Error %s %d %s  path = %s", e.file, e.line, e.func, entry.fileInfo.filePath().toLocal8Bit().constData());
+				failed = true;
+			} catch (...) {
+				logger.error("Unknown exception  path = %s", entry.fileInfo.filePath().toLocal8Bit().constData());
+				failed = true;
+			}
+
+			QMutexLocker locker(&context->mutex);
+			Result& result = context->resultList[index];
+			result.done   = true;
+			result.failed = failed;
+			result.output = output;
+			context->cv.wakeAll();
+		}
+	}
+
+private:
+	Context* context;
+};
+
+
+//
+// Batch
+//
+Batch::Batch() {
+	setThreadCount(QThread::idealThreadCount());
+}
+
+void Batch::setThreadCount(int newValue) {
+	threadCount = (newValue < 1) ? 1 : newValue;
+	pool.setMaxThreadCount(threadCount);
+}
+
+void Batch::append(QList<Entry>& entryList, const QFileInfo& fileInfo) {
+	Entry entry(fileInfo, fileInfo.fileName());
+	entry.index = entryList.size();
+	entryList.append(entry);
+}
+
+QList<Batch::Entry> Batch::scan(const QStringList& pathList, Filter filter) {
+	QElapsedTimer timer;
+	timer.start();
+
+	ScanTask::Context context;
+	context.pool     = &pool;
+	context.filter   = filter;
+	context.dirCount = 0;
+
+	for(QString path: pathList) {
+		QFileInfo fileInfo(path);
+		if (!fileInfo.exists()) {
+			logger.fatal("path doesn't exist = %s", fileInfo.filePath().toLocal8Bit().constData());
+			ERROR();
+		}
+		if (fileInfo.isFile()) {
+			QMutexLocker locker(&context.mutex);
+			context.entryList.append(Entry(fileInfo, fileInfo.fileName()));
+		}
+		if (fileInfo.isDir()) {
+			// Special case : trailing slash
+			if (fileInfo.fileName().length() == 0) fileInfo = QFileInfo(fileInfo.path());
+			pool.start(new ScanTask(&context, fileInfo, fileInfo.fileName()));
+		}
+	}
+	pool.waitForDone();
+
+	QList<Entry> ret = context.entryList;
+	std::sort(ret.begin(), ret.end(), [](const Entry& a, const Entry& b){ return a.relativePath < b.relativePath; });
+	for(int i = 0; i < ret.size(); i++) {
+		ret[i].index = i;
+	}
+
+	logger.info("scan  %6d dirs  %6d files  %6lld ms", context.dirCount, ret.size(), timer.elapsed());
+	return ret;
+}
+
+int Batch::run(const QList<Entry>& entryList, Process process, Merge merge) {
+	const int size = entryList.size();
+
+	RunTask::Context context;
+	context.entryList = &entryList;
+	context.process   = process;
+	context.resultList.resize(size);
+	context.next      = 0;
+
+	const int taskCount = qMin(threadCount, size);
+	logger.info("run   %6d files  %3d threads", size, taskCount);
+	for(int i = 0; i < taskCount; i++) {
+		pool.start(new RunTask(&context));
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	qint64 lastReport = 0;
+	qint64 totalBytes = 0;
+	int    failCount  = 0;
+
+	// Merge output in order of entry list
+	for(int index = 0; index < size; index++) {
+		bool       failed;
+		QByteArray output;
+		{
+			QMutexLocker locker(&context.mutex);
+			RunTask::Result& result = context.resultList[index];
+			while(!result.done) context.cv.wait(&context.mutex);
+			failed = result.failed;
+			output = result.output;
+			// Release output as soon as possible
+			result.output.clear();
+		}
+
+		const Entry& entry = entryList.at(index);
+		totalBytes += entry.fileInfo.size();
+		if (failed) {
+			failCount++;
+		} else {
+			merge(entry, output);
+		}
+
+		qint64 elapsed = timer.elapsed();
+		if (PROGRESS_INTERVAL <= (elapsed - lastReport)) {
+			lastReport = elapsed;
+			double second = elapsed / 1000.0;
+			logger.info("progress  %6d / %6d  %5.1f%%  %8.1f file/s  %6.1f MB/s",
+				index + 1, size, (index + 1) * 100.0 / size, (index + 1) / second, totalBytes / (1024.0 * 1024.0) / second);
+		}
+	}
+	pool.waitForDone();
+
+	double second = qMax(timer.elapsed(), (qint64)1) / 1000.0;
+	logger.info("done  %6d files  %6d failed  %8.1f file/s  %6.1f MB/s  %6lld ms",
+		size, failCount, size / second, totalBytes / (1024.0 * 1024.0) / second, timer.elapsed());
+
+	return failCount;
+}
@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// Batch.h
+//
+
+#ifndef BATCH_H__
+#define BATCH_H__
+
+#include <functional>
+
+#include "Util.h"
+
+// Batch processes many files on thread pool.
+// Output of each file is merged on calling thread in order of entry list.
+class Batch {
+public:
+	class Entry {
+	public:
+		// index in entry list
+		int       index;
+		QFileInfo fileInfo;
+		// path relative to parent directory of path given to scan
+		QString   relativePath;
+
+		Entry() : index(0) {}
+		Entry(const QFileInfo& fileInfo_, const QString& relativePath_) : index(0), fileInfo(fileInfo_), relativePath(relativePath_) {}
+	};
+
+	// Returns true if file is target of batch
+	typedef std::function<bool(const QFileInfo& fileInfo)> Filter;
+	// Called on worker thread. Return value is passed to merge.
+	typedef std::function<QByteArray(const Entry& entry)> Process;
+	// Called on calling thread in order of entry list
+	typedef std::function<void(const Entry& entry, const QByteArray& output)> Merge;
+
+	// Interval in milliseconds of progress report
+	static const int PROGRESS_INTERVAL = 5000;
+
+	Batch();
+
+	void setThreadCount(int newValue);
+	int  getThreadCount() {
+		return threadCount;
+	}
+
+	// Scan each path of pathList. Directory is scanned recursively in parallel.
+	// Returned entry list is sorted by relativePath.
+	QList<Entry> scan(const QStringList& pathList, Filter filter);
+
+	// Add entry of file to entry list
+	static void append(QList<Entry>& entryList, const QFileInfo& fileInfo);
+
+	// Process each entry of entryList in parallel. Returns number of failed entry.
+	int run(const QList<Entry>& entryList, Process process, Merge merge);
+
+private:
+	class ScanTask;
+	class RunTask;
+
+	int         threadCount;
+	QThreadPool pool;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// BuildCache.cpp
+//
+
+#include "Util.h"
+static log4cpp::Category& logger = Logger::getLogger("cache");
+
+#include "BuildCache.h"
+
+#include <QCryptographicHash>
+
+static const int VERSION = 2;
+
+QByteArray BuildCache::getHash(const QString& path) {
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		logger.fatal("File open error %s", file.errorString().toLocal8Bit().constData());
+		logger.fatal("path = %s", path.toLocal8Bit().constData());
+		ERROR();
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(file.readAll());
+	return hash.result().toHex();
+}
+
+QString BuildCache::getFingerprint(const QString& toolPath) {
+	QFileInfo fileInfo(toolPath);
+	if (!fileInfo.exists()) {
+		logger.warn("No tool  %s", toolPath.toLocal8Bit().constData());
+		return QString();
+	}
+	return QString("%1 %2 %3").arg(fileInfo.fileName()).arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+void BuildCache::load() {
+	QMutexLocker locker(&mutex);
+
+	map.clear();
+	QFile file(path);
+	if (!file.exists()) {
+		logger.info("No cache  %s", path.toLocal8Bit().constData());
+		return;
+	}
+	if (!file.open(QIODevice::ReadOnly)) {
+		logger.fatal("File open error %s", file.errorString().toLocal8Bit().constData());
+		logger.fatal("path = %s", path.toLocal8Bit().constData());
+		ERROR();
+	}
+
+	QJsonDocument jsonDocument(QJsonDocument::fromJson(file.readAll()));
+	QJsonObject   jsonObject(jsonDocument.object());
+	// Ignore broken or old cache. Everything is built again.
+	if (jsonObject["version"].toInt() != VERSION) {
+		logger.warn("Ignore cache  %s", path.toLocal8Bit().constData());
+		return;
+	}
+	// Output of other tool or other build of tool can be different.
+	if (fingerprint.isEmpty() || jsonObject["fingerprint"].toString() != fingerprint) {
+		logger.warn("Ignore cache of other tool  %s", path.toLocal8Bit().constData());
+		return;
+	}
+
+	QJsonObject itemMap = jsonObject["item"].toObject();
+	for(QString key: itemMap.keys()) {
+		QJsonObject itemObject = itemMap[key].toObject();
+
+		Item item;
+		item.input        = itemObject["input"].toString();
+		item.size         = (qint64)itemObject["size"].toDouble();
+		item.lastModified = (qint64)itemObject["lastModified"].toDouble();
+		item.hash         = itemObject["hash"].toString().toLatin1();
+		item.extra        = itemObject["extra"].toString();
+		for(QJsonValue output: itemObject["output"].toArray()) {
+			item.outputList.append(output.toString());
+		}
+		map.insert(key, item);
+	}
+	logger.info("Load cache  %s  %d", path.toLocal8Bit().constData(), map.size());
+}
+
+void BuildCache::save() {
+	QMutexLocker locker(&mutex);
+
+	QJsonObject itemMap;
+	for(QMap<QString, Item>::const_iterator i = map.constBegin(); i != map.constEnd(); ++i) {
+		const Item& item = i.value();
+
+		QJsonObject itemObject;
+		itemObject["input"]        = item.input;
+		itemObject["size"]         = (double)item.size;
+		itemObject["lastModified"] = (double)item.lastModified;
+		itemObject["hash"]         = QString::fromLatin1(item.hash.constData(), item.hash.size());
+		itemObject["extra"]        = item.extra;
+		itemObject["output"]       = QJsonArray::fromStringList(item.outputList);
+		itemMap[i.key()] = itemObject;
+	}
+	QJsonObject jsonObject;
+	jsonObject["version"]     = VERSION;
+	jsonObject["fingerprint"] = fingerprint;
+	jsonObject["item"]        = itemMap;
+
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		logger.fatal("File open error %s", file.errorString().toLocal8Bit().constData());
+		logger.fatal("path = %s", path.toLocal8Bit().constData());
+		ERROR();
+	}
+	file.write(QJsonDocument(jsonObject).toJson(QJsonDocument::JsonFormat::Compact));
+	file.close();
+
+	logger.info("Save cache  %s  %d  hit %d  miss %d", path.toLocal8Bit().constData(), map.size(), hit, miss);
+}
+
+bool BuildCache::isUpToDate(const QString& key, const QFileInfo& input, const QString& extra) {
+	const QString filePath     = input.absoluteFilePath();
+	const qint64  size         = input.size();
+	const qint64  lastModified = input.lastModified().toMSecsSinceEpoch();
+
+	Item item;
+	{
+		QMutexLocker locker(&mutex);
+		if (!map.contains(key)) {
+			miss++;
+			return false;
+		}
+		item = map[key];
+	}
+
+	bool ret = (item.input == filePath && item.size == size && item.extra == extra);
+	for(QString output: item.outputList) {
+		if (!ret) break;
+		ret = QFile::exists(output);
+	}
+	if (ret && item.lastModified != lastModified) {
+		// Touched but may be not changed. Compare contents.
+		ret = (item.hash == getHash(filePath));
+		if (ret) {
+			QMutexLocker locker(&mutex);
+			map[key].lastModified = lastModified;
+		}
+	}
+
+	QMutexLocker locker(&mutex);
+	if (ret) {
+		hit++;
+	} else {
+		miss++;
+	}
+	return ret;
+}
+
+void BuildCache::update(const QString& key, const QFileInfo& input, const QString& extra, const QStringList& outputList) {
+	Item item;
+	item.input        = input.absoluteFilePath();
+	item.size         = input.size();
+	item.lastModified = input.lastModified().toMSecsSinceEpoch();
+	item.hash         = getHash(item.input);
+	item.extra        = extra;
+	item.outputList   = outputList;
+
+	QMutexLocker locker(&mutex);
+	map.insert(key, item);
+}
+
+QStringList BuildCache::removeStale(const QSet<QString>& keySet) {
+	QMutexLocker locker(&mutex);
+
+	QStringList ret;
+	for(QString key: map.keys()) {
+		if (keySet.contains(key)) continue;
+		ret.append(map[key].outputList);
+		map.remove(key);
+	}
+	return ret;
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// BuildCache.h
+//
+
+#ifndef BUILDCACHE_H__
+#define BUILDCACHE_H__
+
+#include "Util.h"
+
+// BuildCache remembers input file of each output, to skip building output again from unchanged input.
+//   Input is identified by path, size, last modified time and SHA-1 hash of contents.
+//   Hash is computed only when size is same and last modified time is changed.
+//   Cache is saved as json file. Remove the file to force full build.
+//   Cache is valid only for same tool. Fingerprint of tool is size and last modified time of its executable.
+//   Methods can be called from worker thread of Batch.
+class BuildCache {
+public:
+	// toolPath is path of executable that builds output, usually argv[0]
+	BuildCache(const QString& path_, const QString& toolPath) : path(path_), fingerprint(getFingerprint(toolPath)), hit(0), miss(0) {}
+
+	void load();
+	void save();
+
+	// Returns true if output of key was built from same input and extra, and all outputs still exist.
+	// extra is anything else that affects output.
+	bool isUpToDate(const QString& key, const QFileInfo& input, const QString& extra = QString());
+	// Record successful build of outputList of key
+	void update(const QString& key, const QFileInfo& input, const QString& extra, const QStringList& outputList);
+
+	// Remove entry whose key is not in keySet. Returns output of removed entry.
+	QStringList removeStale(const QSet<QString>& keySet);
+
+	int getHit() {
+		return hit;
+	}
+	int getMiss() {
+		return miss;
+	}
+
+private:
+	class Item {
+	public:
+		QString     input;
+		qint64      size;
+		qint64      lastModified;
+		QByteArray  hash;
+		QString     extra;
+		QStringList outputList;
+
+		Item() : size(0), lastModified(0) {}
+	};
+
+	static QByteArray getHash(const QString& path);
+	// Returns empty string if toolPath is not found
+	static QString    getFingerprint(const QString& toolPath);
+
+	const QString       path;
+	const QString       fingerprint;
+	QMutex              mutex;
+	QMap<QString, Item> map;
+	int                 hit;
+	int                 miss;
+};
+
+#endif
@@ -36,6 +36,9 @@ OF SUCH DAMAGE.
 static const int DEBUG_SHOW_EVENT_KEY       = 0;
 static const int DEBUG_SHOW_EVENT_MOUSE     = 0;
 
+// RFB server of guam-headless
+static const int DEBUG_SHOW_RFB             = 0;
+
 // Network
 static const int DEBUG_SHOW_NETWORK_PACKET  = 0;
 static const int DEBUG_TRACE_NETWORK_PACKET = 0;
@@ -46,6 +49,8 @@ static const int DEBUG_SHOW_RUNNING           = 0;
 static const int DEBUG_TRACE_OPCODE           = 0;
 static const int DEBUG_SHOW_OPCODE_STATS      = 0;
 static const int DEBUG_TRACE_XFER             = 0;
+static const int DEBUG_CHECK_TIMEOUT_WHEEL    = 0;
+static const int DEBUG_CHECK_READY_CACHE      = 0;
 
 // Show Fault
 static const int DEBUG_SHOW_FRAME_FAULT         = 0;
@@ -50,3 +50,8 @@ void GuiOp::setMP(quint16 newValue) {
 	if (guiOp == 0) ERROR();
 	guiOp->setMPImpl(newValue);
 }
+
+void GuiOp::setColorLookupTable(int index, quint8 red, quint8 green, quint8 blue) {
+	if (guiOp == 0) ERROR();
+	guiOp->setColorLookupTableImpl(index, red, green, blue);
+}
@@ -68,6 +68,9 @@ public:
 
 	static void setMP(quint16 newValue);
 
+	// Change entry of color lookup table. Used only with byteColor display.
+	static void setColorLookupTable(int index, quint8 red, quint8 green, quint8 blue);
+
 	static void setContext(GuiOp *newValue) {
 		guiOp = newValue;
 	}
@@ -76,6 +79,7 @@ protected:
 	virtual void setCursorPatternImpl(CursorPattern* data) = 0;
 	virtual void updateDisplayImpl   (Rect* rect) = 0;
 	virtual void setMPImpl           (quint16 newValue) = 0;
+	virtual void setColorLookupTableImpl(int index, quint8 red, quint8 green, quint8 blue) = 0;
 	//
 	virtual ~GuiOp() {}
 
@@ -87,6 +91,7 @@ class NullGuiOp : public GuiOp {
 	void setCursorPatternImpl(CursorPattern*) {}
 	void updateDisplayImpl   (Rect*) {}
 	void setMPImpl           (quint16) {}
+	void setColorLookupTableImpl(int, quint8, quint8, quint8) {}
 };
 
 #endif
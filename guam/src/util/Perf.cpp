@@ -63,3 +63,17 @@ long long perf_CodeTrap = 0;
 long long perf_EscOpcodeTrap = 0;
 long long perf_OpcodeTrap = 0;
 long long perf_UnboundTrap = 0;
+// Scheduler
+long long perf_Reschedule = 0;
+long long perf_ReadyRebuild = 0;
+long long perf_ProcessSwitch = 0;
+long long perf_SwitchLatency = 0;
+long long perf_SwitchLatMax = 0;
+// Xfer
+long long perf_Xfer = 0;
+long long perf_XferIndirect = 0;
+long long perf_XferOldProc = 0;
+long long perf_XferFrame = 0;
+long long perf_XferNewProc = 0;
+long long perf_XferCacheHit = 0;
+long long perf_XferCacheMiss = 0;
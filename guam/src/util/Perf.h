@@ -65,6 +65,20 @@ extern long long perf_CodeTrap;
 extern long long perf_EscOpcodeTrap;
 extern long long perf_OpcodeTrap;
 extern long long perf_UnboundTrap;
+// Scheduler
+extern long long perf_Reschedule;
+extern long long perf_ReadyRebuild;
+extern long long perf_ProcessSwitch;
+extern long long perf_SwitchLatency;
+extern long long perf_SwitchLatMax;
+// Xfer
+extern long long perf_Xfer;
+extern long long perf_XferIndirect;
+extern long long perf_XferOldProc;
+extern long long perf_XferFrame;
+extern long long perf_XferNewProc;
+extern long long perf_XferCacheHit;
+extern long long perf_XferCacheMiss;
 
 
 #define Perf_log() if (PERF_ENABLE) { \
@@ -97,6 +111,18 @@ extern long long perf_UnboundTrap;
 		logger.info("perf_EscOpcodeTrap = %10llu", perf_EscOpcodeTrap); \
 		logger.info("perf_OpcodeTrap    = %10llu", perf_OpcodeTrap); \
 		logger.info("perf_UnboundTrap   = %10llu", perf_UnboundTrap); \
+		logger.info("perf_Reschedule    = %10llu", perf_Reschedule); \
+		logger.info("perf_ReadyRebuild  = %10llu", perf_ReadyRebuild); \
+		logger.info("perf_ProcessSwitch = %10llu", perf_ProcessSwitch); \
+		logger.info("perf_SwitchLatency = %10llu", perf_SwitchLatency); \
+		logger.info("perf_SwitchLatMax  = %10llu", perf_SwitchLatMax); \
+		logger.info("perf_Xfer          = %10llu", perf_Xfer); \
+		logger.info("perf_XferIndirect  = %10llu", perf_XferIndirect); \
+		logger.info("perf_XferOldProc   = %10llu", perf_XferOldProc); \
+		logger.info("perf_XferFrame     = %10llu", perf_XferFrame); \
+		logger.info("perf_XferNewProc   = %10llu", perf_XferNewProc); \
+		logger.info("perf_XferCacheHit  = %10llu", perf_XferCacheHit); \
+		logger.info("perf_XferCacheMiss = %10llu", perf_XferCacheMiss); \
 }
 
 #endif
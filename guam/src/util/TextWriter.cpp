@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// TextWriter.cpp
+//
+
+#include "Util.h"
+static log4cpp::Category& logger = Logger::getLogger("writer");
+
+#include "TextWriter.h"
+
+#include <zlib.h>
+
+TextWriter::TextWriter(QIODevice* device_) : device(device_), file(0), gz(0), size(0) {
+	buffer = new char[BUFFER_SIZE];
+	next   = buffer;
+	limit  = buffer + BUFFER_SIZE;
+}
+
+TextWriter::TextWriter(const QString& path, bool compress) : device(0), file(0), gz(0), size(0) {
+	if (compress) {
+		gz = gzopen(path.toLocal8Bit().constData(), "wb");
+		if (gz == 0) {
+			logger.fatal("File open error %s", path.toLocal8Bit().constData());
+			ERROR();
+		}
+	} else {
+		file = new QFile(path);
+		if (!file->open(QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Truncate)) {
+			logger.fatal("File open error %s", file->errorString().toLocal8Bit().constData());
+			logger.fatal("path = %s", path.toLocal8Bit().constData());
+			delete file;
+			ERROR();
+		}
+		device = file;
+	}
+	buffer = new char[BUFFER_SIZE];
+	next   = buffer;
+	limit  = buffer + BUFFER_SIZE;
+}
+
+TextWriter::~TextWriter() {
+	flushBuffer();
+	if (gz) gzclose(gz);
+	if (file) {
+		file->close();
+		delete file;
+	}
+	delete[] buffer;
+}
+
+void TextWriter::flush() {
+	flushBuffer();
+	if (gz) gzflush(gz, Z_SYNC_FLUSH);
+}
+
+void TextWriter::flushBuffer() {
+	const int length = (int)(next - buffer);
+	if (length == 0) return;
+	output(buffer, length);
+	size += length;
+	next = buffer;
+}
+
+void TextWriter::output(const char* data, int length) {
+	if (gz) {
+		if (gzwrite(gz, data, length) != length) {
+			logger.fatal("File write error  length = %d", length);
+			ERROR();
+		}
+	} else {
+		if (device->write(data, length) != length) {
+			logger.fatal("File write error %s  length = %d", device->errorString().toLocal8Bit().constData(), length);
+			ERROR();
+		}
+	}
+}
+
+void TextWriter::write(const char* data, int length) {
+	if (limit - next < length) {
+		flushBuffer();
+		// Large data goes to output directly
+		if (BUFFER_SIZE < length) {
+			output(data, length);
+			size += length;
+			return;
+		}
+	}
+	memcpy(next, data, length);
+	next += length;
+}
+
+TextWriter& TextWriter::operator<<(const QString& value) {
+	const QChar* p = value.constData();
+	const int    n = value.size();
+	for(int i = 0; i < n; i++) {
+		const ushort c = p[i].unicode();
+		if (0x80 <= c) {
+			// Rest of string is not ASCII
+			const QByteArray utf8 = QString(p + i, n - i).toUtf8();
+			write(utf8.constData(), utf8.size());
+			break;
+		}
+		if (next == limit) flushBuffer();
+		*next++ = (char)c;
+	}
+	return *this;
+}
+
+void TextWriter::putUnsigned(quint64 value, int base) {
+	// Enough for 64 bit value in octal
+	char  data[24];
+	char* p = data + sizeof(data);
+	do {
+		*--p = (char)('0' + (value % base));
+		value /= base;
+	} while(value);
+	write(p, (int)(data + sizeof(data) - p));
+}
+
+TextWriter& endl(TextWriter& out) {
+	return out << '\n';
+}
@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2018, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+
+//
+// TextWriter.h
+//
+
+#ifndef TEXTWRITER_H__
+#define TEXTWRITER_H__
+
+#include "Util.h"
+
+struct gzFile_s;
+
+// TextWriter writes text through fixed size buffer.
+//   String is written in UTF-8. Integer is formatted directly into buffer.
+//   Output is plain file, gzip file or QIODevice.
+class TextWriter {
+public:
+	static const int BUFFER_SIZE = 64 * 1024;
+
+	// Write to device. Device is not closed by TextWriter.
+	TextWriter(QIODevice* device);
+	// Write to file of path. If compress is true, file is gzip format.
+	TextWriter(const QString& path, bool compress = false);
+	~TextWriter();
+
+	void flush();
+
+	// Number of byte written before compression
+	quint64 getSize() const {
+		return size + (quint64)(next - buffer);
+	}
+
+	TextWriter& operator<<(const char* value) {
+		write(value, (int)strlen(value));
+		return *this;
+	}
+	TextWriter& operator<<(const QString& value);
+	TextWriter& operator<<(char value) {
+		if (next == limit) flushBuffer();
+		*next++ = value;
+		return *this;
+	}
+	TextWriter& operator<<(int value) {
+		if (value < 0) {
+			*this << '-';
+			putUnsigned((quint64)-(qint64)value, 10);
+		} else {
+			putUnsigned((quint64)value, 10);
+		}
+		return *this;
+	}
+	TextWriter& operator<<(unsigned int value) {
+		putUnsigned(value, 10);
+		return *this;
+	}
+	TextWriter& operator<<(qint64 value) {
+		if (value < 0) {
+			*this << '-';
+			putUnsigned(-(quint64)value, 10);
+		} else {
+			putUnsigned((quint64)value, 10);
+		}
+		return *this;
+	}
+	TextWriter& operator<<(quint64 value) {
+		putUnsigned(value, 10);
+		return *this;
+	}
+	TextWriter& operator<<(TextWriter& (*function)(TextWriter&)) {
+		return function(*this);
+	}
+
+	TextWriter& octal(quint64 value) {
+		putUnsigned(value, 8);
+		return *this;
+	}
+
+	void write(const char* data, int length);
+
+private:
+	TextWriter(const TextWriter&) = delete;
+	TextWriter& operator=(const TextWriter&) = delete;
+
+	void putUnsigned(quint64 value, int base);
+	void flushBuffer();
+	void output(const char* data, int length);
+
+	QIODevice* device;
+	QFile*     file;
+	gzFile_s*  gz;
+
+	char*      buffer;
+	char*      next;
+	char*      limit;
+	quint64    size;
+};
+
+TextWriter& endl(TextWriter& out);
+
+#endif
@@ -8,8 +8,8 @@ TEMPLATE = lib
 CONFIG  += staticlib
 
 # Input
-HEADERS += ByteBuffer.h   GuiOp.h   Perf.h   Preference.h   Util.h
-SOURCES += ByteBuffer.cpp GuiOp.cpp Perf.cpp preference.cpp Util.cpp
+HEADERS += Batch.h   BuildCache.h   ByteBuffer.h   GuiOp.h   Perf.h   Preference.h   TextWriter.h   Util.h
+SOURCES += Batch.cpp BuildCache.cpp ByteBuffer.cpp GuiOp.cpp Perf.cpp preference.cpp TextWriter.cpp Util.cpp
 
 HEADERS += Debug.h
 
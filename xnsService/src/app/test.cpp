@@ -69,7 +69,7 @@ int main(int /*argc*/, char** /*argv*/) {
 	SocketPEX socketTime(Courier::PacketExchange::ClientType::TIME, &pexTime);
 
 	// Initialize SocketBoot
-	SocketBoot  socketBoot;
+	SocketBoot  socketBoot(network);
 	socketBoot.addBootFile(SocketBoot::BFN_GVWIN_NETBOOT, "data/GVWin/NSINSTLR.DAT");
 
 	// Add SocketXXX with SocketManager
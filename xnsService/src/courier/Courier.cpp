@@ -44,8 +44,8 @@ const char* Courier::getSocketName(quint16 value) {
 	return getSocketNameBuffer;
 }
 
-quint16 Courier::checksum(quint8* data, quint32 offset, quint32 length) {
-	quint32 s = 0;
+quint16 Courier::checksum(quint8* data, quint32 offset, quint32 length, quint16 start) {
+	quint32 s = start;
 
 	for(quint32 i = 0; i < length; i += 2) {
 		quint16 w = data[offset++] & 0x00ffU;
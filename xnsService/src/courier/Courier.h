@@ -29,7 +29,8 @@ namespace Courier {
 
     const char* getSocketName(quint16 value);
 
-    quint16 checksum(quint8* base, quint32 offset, quint32 length);
+    // start is checksum of preceding data to calculate checksum of data in several buffer
+    quint16 checksum(quint8* base, quint32 offset, quint32 length, quint16 start = 0);
 }
 
 #define COURIER_ERROR() RUNTIME_ERROR()
@@ -38,6 +38,7 @@ static log4cpp::Category& logger = Logger::getLogger("network");
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include <linux/if.h>
 #include <linux/if_packet.h>
@@ -205,6 +206,24 @@ int Network::transmit(quint8* data, quint32 dataLen, int& opErrno) {
 	return ret;
 }
 
+int Network::transmit(quint8* head, quint32 headLen, quint8* body, quint32 bodyLen, int& opErrno) {
+	struct iovec iov[2];
+	iov[0].iov_base = head;
+	iov[0].iov_len  = headLen;
+	iov[1].iov_base = body;
+	iov[1].iov_len  = bodyLen;
+
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = iov;
+	msg.msg_iovlen = bodyLen ? 2 : 1;
+
+	int ret = sendmsg(fd, &msg, 0);
+	opErrno = errno;
+	if (DEBUG_SHOW_NETWORK) logger.debug("%-8s head = %p  headLen = %4d  body = %p  bodyLen = %4d  opErrno = %3d  ret = %4d", __FUNCTION__, head, headLen, body, bodyLen, opErrno, ret);
+	return ret;
+}
+
 int Network::receive(quint8* data, quint32 dataLen, int& opErrno) {
 	int ret = recv(fd, data, dataLen, 0);
 	opErrno = errno;
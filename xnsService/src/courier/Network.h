@@ -70,6 +70,8 @@ public:
 	// returns return code of send and recv. no error checking
 	int transmit(quint8* data, quint32 dataLen, int& opErrno);
 	int receive (quint8* data, quint32 dataLen, int& opErrno);
+	// send head and body as one packet without copying body
+	int transmit(quint8* head, quint32 headLen, quint8* body, quint32 bodyLen, int& opErrno);
 
 private:
 	const char* name;
@@ -40,30 +40,54 @@ static log4cpp::Category& logger = Logger::getLogger("socketMan");
 #include "stub/StubEthernet.h"
 #include "stub/StubDatagram.h"
 
+SocketManager::SocketManager(Network& network_, quint48 localNetworkNumber_, int shardCount_) :
+	network(network_), thread(0), localNetworkNumber(localNetworkNumber_), shardCount(shardCount_) {
+	if (shardCount <= 0) {
+		logger.fatal("Unexpected shardCount = %d", shardCount);
+		RUNTIME_ERROR();
+	}
+}
+SocketManager::~SocketManager() {
+	if (thread) stop();
+	QWriteLocker mapLocker(&mapLock);
+	for(Listener* listener: map) {
+		delete listener;
+	}
+	map.clear();
+}
+
 void SocketManager::add(quint16 no, SocketManager::Socket* socket) {
-	QMutexLocker mutexLocker(&mutex);
-	Socket* that = map.value(no, 0);
+	QWriteLocker mapLocker(&mapLock);
+	Listener* that = map.value(no, 0);
 	if (that) {
-		logger.fatal("already registered  no = %d  listener = %s", no, that->name);
+		logger.fatal("already registered  no = %d  listener = %s", no, that->socket->name);
 		RUNTIME_ERROR();
 	}
 	logger.info("Add    %4d(%s) %s", no, Courier::getSocketName(no), socket->name);
-	map.insert(no, socket);
+	map.insert(no, new Listener(socket));
 }
 void SocketManager::remove(quint16 no) {
-	QMutexLocker mutexLocker(&mutex);
-	Socket* that = map.value(no, 0);
+	// Write lock waits until no listener is processing frame
+	QWriteLocker mapLocker(&mapLock);
+	Listener* that = map.value(no, 0);
 	if (!that) {
-		logger.fatal("not registered  socket = %s", no, Courier::getSocketName(no));
+		logger.fatal("not registered  socket = %d(%s)", no, Courier::getSocketName(no));
 		RUNTIME_ERROR();
 	}
-	logger.info("Remove %4d(%s) %s", no, Courier::getSocketName(no), that->name);
+	logger.info("Remove %4d(%s) %s", no, Courier::getSocketName(no), that->socket->name);
 	map.remove(no);
+	delete that;
 }
 
 void SocketManager::start() {
 	if (thread) RUNTIME_ERROR();
 	//
+	clock.start();
+	for(int i = 0; i < shardCount; i++) {
+		Shard* shard = new Shard(*this, i);
+		shards.append(shard);
+		shard->start();
+	}
 	thread = new SocketThread(*this);
 	thread->start();
 }
@@ -71,17 +95,115 @@ void SocketManager::stop() {
 	if (!thread) RUNTIME_ERROR();
 	//
 	thread->stopThread();
-	for(;;) {
-		if (thread->isFinished()) break;
-		QThread::msleep(200);
-	}
+	thread->wait();
+	delete thread;
 	thread = 0;
+
+	// Shard process remaining frame in queue before exit
+	for(Shard* shard: shards) {
+		shard->stopThread();
+	}
+	for(Shard* shard: shards) {
+		shard->wait();
+	}
+	logStats();
+	for(Shard* shard: shards) {
+		delete shard;
+	}
+	shards.clear();
 }
 int  SocketManager::isRunning() {
 	return thread != 0;
 }
 
+void SocketManager::logStats() {
+	for(Shard* shard: shards) {
+		shard->logStats();
+	}
+}
+
+int SocketManager::getShardIndex(const Courier::Datagram::Header& datagram) {
+	// mix bits of source host and destination socket
+	quint64 key = datagram.source.host ^ ((quint64)datagram.destination.socket << 48);
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return (int)(key % (quint64)shardCount);
+}
+
+
+//
+// SocketManager::Shard
+//
+SocketManager::Shard::Shard(SocketManager& socketManager_, int index_) : index(index_), socketManager(socketManager_),
+	frameCount(0), dropCount(0), errorCount(0), maxDepth(0), totalWait(0), maxWait(0), totalProcess(0), maxProcess(0) {
+	stop.storeRelease(0);
+}
+void SocketManager::Shard::stopThread() {
+	QMutexLocker locker(&mutex);
+	stop.storeRelease(1);
+	cond.wakeAll();
+}
+bool SocketManager::Shard::enqueue(Frame* frame) {
+	QMutexLocker locker(&mutex);
+	if (MAX_QUEUE_DEPTH <= queue.size()) {
+		dropCount++;
+		return false;
+	}
+	queue.enqueue(frame);
+	if (maxDepth < queue.size()) maxDepth = queue.size();
+	cond.wakeOne();
+	return true;
+}
+void SocketManager::Shard::logStats() {
+	QMutexLocker locker(&mutex);
+	qint64 avgWait    = frameCount ? (totalWait    / (qint64)frameCount) : 0;
+	qint64 avgProcess = frameCount ? (totalProcess / (qint64)frameCount) : 0;
+	logger.info("shard %2d  frame %8llu  drop %6llu  error %6llu  depth %3d / %3d  wait %6lld / %8lld us  process %6lld / %8lld us",
+		index, frameCount, dropCount, errorCount, queue.size(), maxDepth,
+		avgWait / 1000, maxWait / 1000, avgProcess / 1000, maxProcess / 1000);
+}
+void SocketManager::Shard::run() {
+	for(;;) {
+		Frame* frame = 0;
+		{
+			QMutexLocker locker(&mutex);
+			while(queue.isEmpty()) {
+				if (stop.loadAcquire()) return;
+				cond.wait(&mutex);
+			}
+			frame = queue.dequeue();
+		}
+
+		qint64 startTime = socketManager.clock.nsecsElapsed();
+		bool   error     = false;
+		try {
+			socketManager.process(*frame);
+		} catch (RuntimeError&) {
+			// Error of one frame should not stop other connection in same shard
+			error = true;
+		}
+		qint64 endTime = socketManager.clock.nsecsElapsed();
+
+		{
+			QMutexLocker locker(&mutex);
+			qint64 wait    = startTime - frame->receiveTime;
+			qint64 process = endTime   - startTime;
+			frameCount++;
+			if (error) errorCount++;
+			totalWait    += wait;
+			totalProcess += process;
+			if (maxWait    < wait)    maxWait    = wait;
+			if (maxProcess < process) maxProcess = process;
+		}
+		delete frame;
+	}
+}
 
+
+//
+// SocketManager::SocketThread
+//
 void SocketManager::SocketThread::run() {
 	for(;;) {
 		if (stop.loadAcquire()) break;
@@ -89,182 +211,199 @@ void SocketManager::SocketThread::run() {
 		int ret = socketManager.network.select(1, opErrno);
 		if (ret == 0) continue;
 
-		ByteBuffer request;
-		ByteBuffer response;
+		Frame* frame = new Frame(socketManager.localNetworkNumber, socketManager.network.getAddress());
+		ByteBuffer& request = frame->request;
 
 		int dataLength = socketManager.network.receive(request.getData(), request.getCapacity(), opErrno);
 		if (dataLength <= 0) RUNTIME_ERROR();
 		request.setLimit((quint32)dataLength);
+		frame->receiveTime = socketManager.clock.nsecsElapsed();
 
-		Socket::Context context(socketManager.localNetworkNumber, socketManager.network.getAddress());
-
-		// make alias of fields in context
-		Courier::Ethernet::Header& reqEthernet = context.reqEthernet;
-		Courier::Datagram::Header& reqDatagram = context.reqDatagram;
-		Courier::Ethernet::Header& resEthernet = context.resEthernet;
-		Courier::Datagram::Header& resDatagram = context.resDatagram;
-
-		Courier::deserialize(request, reqEthernet);
-		Courier::deserialize(request, reqDatagram);
-		request.setLimit(reqDatagram.base + reqDatagram.length);
+		Courier::deserialize(request, frame->context.reqEthernet);
+		Courier::deserialize(request, frame->context.reqDatagram);
+		request.setLimit(frame->context.reqDatagram.base + frame->context.reqDatagram.length);
 		//logger.debug("dataLength = %d  newLimit = %u", dataLength, request.getLimit());
 
-		try {
-			// check integrity of packet
-			if (reqDatagram.checksum == Courier::Datagram::CHECKSUM_NONE) {
-				// DON'T VERIFY CHECKSUM
-			} else {
-				if (reqDatagram.checksum != Courier::checksum(request.getData(), reqDatagram.base + 2, reqDatagram.length - 2)) {
-					// packet data is corrupted
-					throw PacketError(Courier::Error::ErrorNumber::BAD_CHECKSUM);
-				}
+		Shard* shard = socketManager.shards[socketManager.getShardIndex(frame->context.reqDatagram)];
+		if (!shard->enqueue(frame)) {
+			logger.warn("DROP shard %d  %012llX-%s", shard->index, frame->context.reqDatagram.source.host, Courier::getSocketName(frame->context.reqDatagram.destination.socket));
+			delete frame;
+		}
+	}
+}
+
+void SocketManager::process(Frame& frame) {
+	ByteBuffer& request = frame.request;
+	ByteBuffer  response;
+
+	Socket::Context& context = frame.context;
+
+	// make alias of fields in context
+	Courier::Ethernet::Header& reqEthernet = context.reqEthernet;
+	Courier::Datagram::Header& reqDatagram = context.reqDatagram;
+	Courier::Ethernet::Header& resEthernet = context.resEthernet;
+	Courier::Datagram::Header& resDatagram = context.resDatagram;
+
+	try {
+		// check integrity of packet
+		if (reqDatagram.checksum == Courier::Datagram::CHECKSUM_NONE) {
+			// DON'T VERIFY CHECKSUM
+		} else {
+			if (reqDatagram.checksum != Courier::checksum(request.getData(), reqDatagram.base + 2, reqDatagram.length - 2)) {
+				// packet data is corrupted
+				throw PacketError(Courier::Error::ErrorNumber::BAD_CHECKSUM);
 			}
+		}
+
+		// check destination network
+		switch(reqDatagram.destination.network) {
+		case Courier::Datagram::NETWORK_UNKNOWN:
+		case Courier::Datagram::NETWORK_ALL:
+			break;
+		default:
+			// If packet is for local network
+			if (reqDatagram.destination.network == context.network) break;
+			// packet is for other network
+			// TODO forward this packet
+			logger.warn("FORWARD %08X-%012llX-%s", reqDatagram.destination.network, reqDatagram.destination.host, Courier::getSocketName(reqDatagram.destination.socket));
+			return;
+		}
 
-			// check destination network
-			switch(reqDatagram.destination.network) {
-			case Courier::Datagram::NETWORK_UNKNOWN:
-			case Courier::Datagram::NETWORK_ALL:
-				break;
-			default:
-				// If packet is for local network
-				if (reqDatagram.destination.network == context.network) break;
-				// packet is for other network
-				// TODO forward this packet
-				logger.warn("FORWARD %08X-%012llX-%s", reqDatagram.destination.network, reqDatagram.destination.host, Courier::getSocketName(reqDatagram.destination.socket));
-				continue;
+		// Build response
+		response.clear();
+
+		// Build response ethernet
+		resEthernet.base        = reqEthernet.base;
+		resEthernet.destination = reqEthernet.source;
+		resEthernet.source      = context.host;
+		resEthernet.type        = reqEthernet.type;
+		serialize(response, resEthernet);
+
+		// Build response datagram (partial)
+		resDatagram.base                = reqDatagram.base;
+		resDatagram.checksum            = 0;
+		resDatagram.length              = 0;
+		resDatagram.flags               = reqDatagram.flags & 0x00ffU;
+		resDatagram.destination.base    = reqDatagram.destination.base;
+		resDatagram.destination.network = reqDatagram.source.network;
+		resDatagram.destination.host    = reqDatagram.source.host;
+		resDatagram.destination.socket  = reqDatagram.source.socket;
+		resDatagram.source.base         = reqDatagram.source.base;
+		resDatagram.source.network      = context.network;
+		resDatagram.source.host         = context.host;
+		resDatagram.source.socket       = reqDatagram.destination.socket;
+		serialize(response, resDatagram);
+
+		QReadLocker mapLocker(&mapLock);
+		Listener* listener = map.value(reqDatagram.destination.socket, 0);
+		if (listener) {
+			if (DEBUG_SHOW_PACKET) {
+				logger.debug("====  >>>>");
+				SocketManager::dumpPacket(context.reqEthernet);
+				SocketManager::dumpPacket(context.reqDatagram);
 			}
 
-			// Build response
-			response.clear();
-
-			// Build response ethernet
-			resEthernet.base        = reqEthernet.base;
-			resEthernet.destination = reqEthernet.source;
-			resEthernet.source      = context.host;
-			resEthernet.type        = reqEthernet.type;
-			serialize(response, resEthernet);
-
-			// Build response datagram (partial)
-			resDatagram.base                = reqDatagram.base;
-			resDatagram.checksum            = 0;
-			resDatagram.length              = 0;
-			resDatagram.flags               = reqDatagram.flags & 0x00ffU;
-			resDatagram.destination.base    = reqDatagram.destination.base;
-			resDatagram.destination.network = reqDatagram.source.network;
-			resDatagram.destination.host    = reqDatagram.source.host;
-			resDatagram.destination.socket  = reqDatagram.source.socket;
-			resDatagram.source.base         = reqDatagram.source.base;
-			resDatagram.source.network      = context.network;
-			resDatagram.source.host         = context.host;
-			resDatagram.source.socket       = reqDatagram.destination.socket;
-			serialize(response, resDatagram);
-
-			SocketManager::Socket* listener = socketManager.map.value(reqDatagram.destination.socket, 0);
-			if (listener) {
-				if (DEBUG_SHOW_PACKET) {
-					logger.debug("====  >>>>");
-					SocketManager::dumpPacket(context.reqEthernet);
-					SocketManager::dumpPacket(context.reqDatagram);
-				}
-
-				// Call listener if exists.
-				QMutexLocker mutexLocker(&socketManager.mutex);
-				listener->process(context, request, response);
+			// Call listener if exists. Frames for same listener that is not thread safe are serialized.
+			if (listener->socket->threadSafe) {
+				listener->socket->process(context, request, response);
 			} else {
-				// no one listen the socket
-				quint16 socket = reqDatagram.destination.socket;
-				Courier::Datagram::PacketType packetType = Socket::getPacketType(reqDatagram);
-				logger.warn("NO SOCKET LISTENER  %s (%d) %s (%d)", Courier::getSocketName(socket), socket, Courier::getName(packetType), packetType);
-				throw PacketError(Courier::Error::ErrorNumber::NO_SOCKET);
+				QMutexLocker listenerLocker(&listener->mutex);
+				listener->socket->process(context, request, response);
 			}
-		} catch (PacketError& packetError) {
-			// Don't send error packet of broadcast request
-			if (reqDatagram.destination.network == Courier::Datagram::NETWORK_ALL) continue;
-			if (reqDatagram.destination.host    == Courier::Datagram::HOST_ALL)    continue;
-
-			// Clear buffer in case data is already written to response
-			response.clear();
-
-			// Build response
-			serialize(response, resEthernet);
-
-			resDatagram.base                = reqDatagram.base;
-			resDatagram.checksum            = 0;
-			resDatagram.length              = 0;
-			resDatagram.flags               = (quint16)Courier::Datagram::PacketType::ERROR;
-			resDatagram.destination.base    = reqDatagram.destination.base;
-			resDatagram.destination.network = reqDatagram.source.network;
-			resDatagram.destination.host    = reqDatagram.source.host;
-			resDatagram.destination.socket  = reqDatagram.source.socket;
-			resDatagram.source.base         = reqDatagram.source.base;
-			resDatagram.source.network      = context.network;
-			resDatagram.source.host         = context.host;
-			resDatagram.source.socket       = reqDatagram.destination.socket;
-
-			serialize(response, resDatagram);
-
-			// Build response
-			Courier::Error::Header resError;
-			resError.base      = response.getPos();
-			resError.number    = packetError.errorNumber;
-			resError.parameter = packetError.errorParameter;
-			serialize(response, resError);
-
-			// output request packet data from datagram
-			quint8* p = request.getData() + reqDatagram.base;
-			for(quint32 i = response.getPos(); i < reqDatagram.length; i++) {
-				response.put8(*p++);
-			}
-
-			logger.debug("====  <<<<  ERROR");
-			SocketManager::dumpPacket(context.resEthernet);
-			SocketManager::dumpPacket(context.resDatagram);
-			logger.debug("ERROR     %4d %d", resError.number, resError.parameter);
+		} else {
+			// no one listen the socket
+			quint16 socket = reqDatagram.destination.socket;
+			Courier::Datagram::PacketType packetType = Socket::getPacketType(reqDatagram);
+			logger.warn("NO SOCKET LISTENER  %s (%d) %s (%d)", Courier::getSocketName(socket), socket, Courier::getName(packetType), packetType);
+			throw PacketError(Courier::Error::ErrorNumber::NO_SOCKET);
+		}
+	} catch (PacketError& packetError) {
+		// Don't send error packet of broadcast request
+		if (reqDatagram.destination.network == Courier::Datagram::NETWORK_ALL) return;
+		if (reqDatagram.destination.host    == Courier::Datagram::HOST_ALL)    return;
+
+		// Clear buffer in case data is already written to response
+		response.clear();
+
+		// Build response
+		serialize(response, resEthernet);
+
+		resDatagram.base                = reqDatagram.base;
+		resDatagram.checksum            = 0;
+		resDatagram.length              = 0;
+		resDatagram.flags               = (quint16)Courier::Datagram::PacketType::ERROR;
+		resDatagram.destination.base    = reqDatagram.destination.base;
+		resDatagram.destination.network = reqDatagram.source.network;
+		resDatagram.destination.host    = reqDatagram.source.host;
+		resDatagram.destination.socket  = reqDatagram.source.socket;
+		resDatagram.source.base         = reqDatagram.source.base;
+		resDatagram.source.network      = context.network;
+		resDatagram.source.host         = context.host;
+		resDatagram.source.socket       = reqDatagram.destination.socket;
+
+		serialize(response, resDatagram);
+
+		// Build response
+		Courier::Error::Header resError;
+		resError.base      = response.getPos();
+		resError.number    = packetError.errorNumber;
+		resError.parameter = packetError.errorParameter;
+		serialize(response, resError);
+
+		// output request packet data from datagram
+		quint8* p = request.getData() + reqDatagram.base;
+		for(quint32 i = response.getPos(); i < reqDatagram.length; i++) {
+			response.put8(*p++);
 		}
 
-		// if something is written to response, sent it
-		if (response.getLimit()) {
-			// set length of response datagram
-			resDatagram.length = response.getLimit() - reqDatagram.base;
+		logger.debug("====  <<<<  ERROR");
+		SocketManager::dumpPacket(context.resEthernet);
+		SocketManager::dumpPacket(context.resDatagram);
+		logger.debug("ERROR     %4d %d", resError.number, resError.parameter);
+	}
 
-			// Move position to last written data == limit
-			response.setPos(response.getLimit());
+	// if something is written to response, sent it
+	if (response.getLimit()) {
+		// set length of response datagram
+		resDatagram.length = response.getLimit() - reqDatagram.base;
 
-			// if number of datagram size is odd, add one zero byte to make even length
-			if (reqDatagram.length & 1) {
-				response.put8(0);
-			}
+		// Move position to last written data == limit
+		response.setPos(response.getLimit());
+
+		// if number of datagram size is odd, add one zero byte to make even length
+		if (reqDatagram.length & 1) {
+			response.put8(0);
+		}
 
-			// expand packet size to meet minimum packet length requirement if needed
-			if (response.getLimit() < (reqDatagram.base + Courier::Ethernet::MIN_DATA_LENGTH)) {
-				quint32 padSize = reqDatagram.base + Courier::Ethernet::MIN_DATA_LENGTH - response.getLimit();
-				for(quint32 i = 0; i < padSize; i++) {
-					response.put8(0);
-				}
+		// expand packet size to meet minimum packet length requirement if needed
+		if (response.getLimit() < (reqDatagram.base + Courier::Ethernet::MIN_DATA_LENGTH)) {
+			quint32 padSize = reqDatagram.base + Courier::Ethernet::MIN_DATA_LENGTH - response.getLimit();
+			for(quint32 i = 0; i < padSize; i++) {
+				response.put8(0);
 			}
+		}
 
-			// write resDatagram to response (length and padding)
-			serialize(response, resDatagram);
+		// write resDatagram to response (length and padding)
+		serialize(response, resDatagram);
 
-			// calculate checksum from response
-			resDatagram.checksum = Courier::checksum(response.getData(), resDatagram.base + 2, resDatagram.length - 2);
+		// calculate checksum from response
+		resDatagram.checksum = Courier::checksum(response.getData(), resDatagram.base + 2, resDatagram.length - 2);
 
-			// write resDatagram to response
-			serialize(response, resDatagram);
+		// write resDatagram to response
+		serialize(response, resDatagram);
 
-			if (DEBUG_SHOW_PACKET) {
-				logger.debug("====  <<<<");
-				SocketManager::dumpPacket(context.resEthernet);
-				SocketManager::dumpPacket(context.resDatagram);
-			}
+		if (DEBUG_SHOW_PACKET) {
+			logger.debug("====  <<<<");
+			SocketManager::dumpPacket(context.resEthernet);
+			SocketManager::dumpPacket(context.resDatagram);
+		}
 
-			// finally output response packet using response buffer.
-			int opErrno = 0;
-			int ret = socketManager.network.transmit(response.getData(), response.getLimit(), opErrno);
-			if (opErrno) {
-				logger.fatal("send fail opErrno = %d  ret = %d  resLimit = %d", opErrno, ret, response.getLimit());
-				RUNTIME_ERROR();
-			}
+		// finally output response packet using response buffer.
+		int opErrno = 0;
+		int ret = network.transmit(response.getData(), response.getLimit(), opErrno);
+		if (opErrno) {
+			logger.fatal("send fail opErrno = %d  ret = %d  resLimit = %d", opErrno, ret, response.getLimit());
+			RUNTIME_ERROR();
 		}
 	}
 }
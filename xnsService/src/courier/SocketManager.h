@@ -71,8 +71,10 @@ public:
 		};
 
 		const char* name;
+		// true if process can be called from more than one shard at same time
+		const bool  threadSafe;
 		//
-		Socket(const char* name_) : name(name_) {}
+		Socket(const char* name_, bool threadSafe_ = false) : name(name_), threadSafe(threadSafe_) {}
 		virtual ~Socket() {}
 
 		virtual void process(Context& context, ByteBuffer& request, ByteBuffer& response) = 0;
@@ -91,7 +93,11 @@ public:
 		}
 	};
 
-	SocketManager(Network& network_, quint48 localNetworkNumber_) : network(network_), thread(0), localNetworkNumber(localNetworkNumber_) {}
+	// Received frame is dispatched to one of shardCount worker thread.
+	// Frames that have same destination socket and source host go to same shard to keep order of packet.
+	SocketManager(Network& network_, quint48 localNetworkNumber_, int shardCount_ = DEFAULT_SHARD_COUNT);
+	// Socket added to SocketManager is not deleted
+	~SocketManager();
 
 	void add   (quint16 no, Socket* socket);
 	void remove(quint16 no);
@@ -99,11 +105,38 @@ public:
 	void start();
 	void stop();
 	int  isRunning();
+
+	// output queue depth and latency of each shard
+	void logStats();
 	
 	static void dumpPacket(Courier::Ethernet::Header& ethernet);
 	static void dumpPacket(Courier::Datagram::Header& datagram);
 	static void dumpPacket(Courier::SequencedPacket::Header& sequencedPacket);
 private:
+	static const int DEFAULT_SHARD_COUNT = 4;
+	// Frame is dropped when queue of shard is full
+	static const int MAX_QUEUE_DEPTH     = 256;
+
+	class Listener {
+	public:
+		Socket* socket;
+		// serialize call of socket->process if socket is not thread safe
+		QMutex  mutex;
+
+		Listener(Socket* socket_) : socket(socket_) {}
+	};
+
+	class Frame {
+	public:
+		Socket::Context context;
+		ByteBuffer      request;
+		// time of receive in nanoseconds
+		qint64          receiveTime;
+
+		Frame(quint32 network, quint48 host) : context(network, host), receiveTime(0) {}
+	};
+
+	// Receive frame from network and dispatch to shard
 	class SocketThread : public QThread {
 	public:
 		SocketThread(SocketManager& socketManager_) : socketManager(socketManager_) {
@@ -118,10 +151,46 @@ private:
 		SocketManager&  socketManager;
 	};
 
-	QMap<quint16, Socket*> map;
-	QMutex                 mutex;
-	Network&               network;
-	SocketThread*          thread;
-	quint48                localNetworkNumber;
+	// Process frame in queue
+	class Shard : public QThread {
+	public:
+		const int index;
+
+		Shard(SocketManager& socketManager_, int index_);
+		void run();
+		void stopThread();
+		// returns false if queue is full
+		bool enqueue(Frame* frame);
+		void logStats();
+	protected:
+		QAtomicInt      stop;
+		SocketManager&  socketManager;
+		QMutex          mutex;
+		QWaitCondition  cond;
+		QQueue<Frame*>  queue;
+
+		// statistics guarded by mutex. time unit is nanoseconds
+		quint64 frameCount;
+		quint64 dropCount;
+		quint64 errorCount;
+		int     maxDepth;
+		qint64  totalWait;
+		qint64  maxWait;
+		qint64  totalProcess;
+		qint64  maxProcess;
+	};
+
+	int  getShardIndex(const Courier::Datagram::Header& datagram);
+	void process(Frame& frame);
+
+	QMap<quint16, Listener*> map;
+	// guard map. read lock is held while listener is processing frame
+	QReadWriteLock           mapLock;
+	Network&                 network;
+	SocketThread*            thread;
+	quint48                  localNetworkNumber;
+	const int                shardCount;
+	QVector<Shard*>          shards;
+	QElapsedTimer            clock;
 };
 #endif
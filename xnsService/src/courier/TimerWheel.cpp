@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// TimerWheel.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("timerWheel");
+
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(int slotSize_, qint64 tickInterval_) : slotSize(slotSize_), tickInterval(tickInterval_), wheel(slotSize_), currentTick(0) {
+	if (slotSize <= 0 || tickInterval <= 0) {
+		logger.fatal("slotSize = %d  tickInterval = %lld", slotSize, tickInterval);
+		RUNTIME_ERROR();
+	}
+}
+
+void TimerWheel::schedule(quint64 key, qint64 time) {
+	// round up to next tick
+	qint64 tick = (time + tickInterval - 1) / tickInterval;
+	if (tick <= currentTick) tick = currentTick + 1;
+
+	// old entry of key remains in slot and is ignored when slot is visited
+	active[key] = tick;
+	wheel[tick % slotSize].append(Entry(key, tick));
+}
+
+void TimerWheel::cancel(quint64 key) {
+	active.remove(key);
+}
+
+void TimerWheel::advance(qint64 time, QList<quint64>& list) {
+	qint64 targetTick = time / tickInterval;
+	if (targetTick <= currentTick) return;
+
+	// No need to visit same slot twice
+	qint64 count = qMin(targetTick - currentTick, (qint64)slotSize);
+	for(qint64 i = 1; i <= count; i++) {
+		QList<Entry>& slot = wheel[(currentTick + i) % slotSize];
+		for(int j = 0; j < slot.size();) {
+			Entry entry = slot[j];
+			if (targetTick < entry.tick) {
+				// entry for later round
+				j++;
+				continue;
+			}
+			slot.removeAt(j);
+			if (active.value(entry.key, -1) == entry.tick) {
+				active.remove(entry.key);
+				list.append(entry.key);
+			}
+		}
+	}
+	currentTick = targetTick;
+}
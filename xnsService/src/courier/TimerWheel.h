@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// TimerWheel.h
+//
+
+#ifndef TIMERWHEEL_H__
+#define TIMERWHEEL_H__
+
+#include <QtCore>
+
+// Hashed timer wheel. Each key has at most one timer.
+// Time unit is nanoseconds.
+class TimerWheel {
+public:
+	TimerWheel(int slotSize_, qint64 tickInterval_);
+
+	// schedule timer of key at time. previous timer of key is replaced.
+	void schedule(quint64 key, qint64 time);
+	void cancel  (quint64 key);
+	// advance wheel to time and append key of fired timer to list
+	void advance (qint64 time, QList<quint64>& list);
+	// true if there is no active timer
+	bool isEmpty() const {
+		return active.isEmpty();
+	}
+
+private:
+	class Entry {
+	public:
+		quint64 key;
+		qint64  tick;
+
+		Entry() : key(0), tick(0) {}
+		Entry(quint64 key_, qint64 tick_) : key(key_), tick(tick_) {}
+	};
+
+	const int              slotSize;
+	const qint64           tickInterval;
+	QVector<QList<Entry>>  wheel;
+	// key => tick of active timer
+	QHash<quint64, qint64> active;
+	qint64                 currentTick;
+};
+
+#endif
@@ -8,8 +8,8 @@ TEMPLATE = lib
 CONFIG  += staticlib
 
 # Input
-HEADERS += ByteBuffer.h   Courier.h   Network.h   SocketManager.h
-SOURCES += ByteBuffer.cpp Courier.cpp Network.cpp SocketManager.cpp
+HEADERS += ByteBuffer.h   Courier.h   Network.h   SocketManager.h   TimerWheel.h
+SOURCES += ByteBuffer.cpp Courier.cpp Network.cpp SocketManager.cpp TimerWheel.cpp
 
 HEADERS += socket/SocketBoot.h   socket/SocketEcho.h   socket/SocketPEX.h   socket/SocketRouting.h
 SOURCES += socket/SocketBoot.cpp socket/SocketEcho.cpp socket/SocketPEX.cpp socket/SocketRouting.cpp
@@ -83,9 +83,22 @@ quint16 SocketBoot::Connection::getLocalID() {
 	return nextLocalID;
 }
 SocketBoot::Connection::Connection(quint48 host_, quint48 bfn) : host(host_) {
-	this->bootFile = BootFile::getInstance(bfn);
+	this->bootFile    = BootFile::getInstance(bfn);
+	this->packetCount = (bootFile->size + DATA_SIZE - 1) / DATA_SIZE;
 
-	this->pos = 0;
+	this->ackIndex    = 0;
+	this->nextIndex   = 0;
+	this->allocIndex  = 0;
+	this->maxIndex    = 0;
+
+	this->dupAckCount    = 0;
+	this->retryCount     = 0;
+	this->rto            = RTO_INITIAL;
+	this->retransmitTime = 0;
+
+	this->startTime       = 0;
+	this->sendCount       = 0;
+	this->retransmitCount = 0;
 
 	this->header.control     = 0;
 	this->header.source      = 0;
@@ -103,7 +116,7 @@ void SocketBoot::Connection::add(quint48 host, quint48 bfn) {
 	Connection* entry = new Connection(host, bfn);
 	map[host] = entry;
 
-	logger.info("Connection::add new host = %012llX  bfn = %012llX", host, bfn);
+	logger.info("Connection::add new host = %012llX  bfn = %012llX  packetCount = %d", host, bfn, entry->packetCount);
 }
 SocketBoot::Connection* SocketBoot::Connection::getInstance(quint48 host) {
 	if (!map.contains(host)) {
@@ -112,11 +125,272 @@ SocketBoot::Connection* SocketBoot::Connection::getInstance(quint48 host) {
 	}
 	return map[host];
 }
+SocketBoot::Connection* SocketBoot::Connection::find(quint48 host) {
+	return map.value(host, 0);
+}
+void SocketBoot::Connection::remove(quint48 host) {
+	Connection* entry = map.value(host, 0);
+	if (entry) {
+		map.remove(host);
+		delete entry;
+	}
+}
+
+
+//
+// SocketBoot::TimerThread
+//
+void SocketBoot::TimerThread::run() {
+	for(;;) {
+		if (!socketBoot.waitTick()) break;
+		try {
+			socketBoot.tick();
+		} catch (RuntimeError&) {
+			// keep timer of other connection running
+		}
+	}
+}
+void SocketBoot::TimerThread::stopThread() {
+	QMutexLocker locker(&socketBoot.mutex);
+	stop.storeRelease(1);
+	socketBoot.timerCond.wakeAll();
+}
 
 
 //
 // SocketBoot
 //
+SocketBoot::SocketBoot(Network& network_, int window_) :
+	SocketManager::Socket("Boot", true), network(network_), window(window_), wheel(256, TICK_INTERVAL), thread(0) {
+	clock.start();
+	thread = new TimerThread(*this);
+	thread->start();
+}
+SocketBoot::~SocketBoot() {
+	thread->stopThread();
+	thread->wait();
+	delete thread;
+}
+
+bool SocketBoot::waitTick() {
+	QMutexLocker locker(&mutex);
+	while(wheel.isEmpty()) {
+		if (thread->isStopping()) return false;
+		timerCond.wait(&mutex);
+	}
+	if (thread->isStopping()) return false;
+	// Early wake up by schedule is harmless. Wheel is advanced only when tick is passed.
+	timerCond.wait(&mutex, TICK_INTERVAL / (1000 * 1000));
+	return !thread->isStopping();
+}
+
+void SocketBoot::tick() {
+	QMutexLocker locker(&mutex);
+	qint64 now = clock.nsecsElapsed();
+
+	QList<quint64> list;
+	wheel.advance(now, list);
+	for(quint64 host: list) {
+		Connection* connection = Connection::find(host);
+		if (connection) timeout(connection, now);
+	}
+}
+
+void SocketBoot::receive(Connection* connection, const Courier::SequencedPacket::Header& reqHeader, qint64 now) {
+	using namespace Courier;
+
+	quint32 ack   = connection->toIndex(reqHeader.acknowledge);
+	quint32 alloc = connection->toIndex(reqHeader.allocation) + 1;
+
+	if (connection->maxIndex < ack) {
+		logger.warn("acknowledge of packet not sent  host = %012llX  ack = %d  maxIndex = %d", connection->host, ack, connection->maxIndex);
+		return;
+	}
+
+	if (connection->ackIndex < ack) {
+		// progress
+		connection->ackIndex = ack;
+		if (connection->nextIndex < ack) connection->nextIndex = ack;
+		connection->dupAckCount    = 0;
+		connection->retryCount     = 0;
+		connection->rto            = RTO_INITIAL;
+		connection->retransmitTime = 0;
+	} else if (ack == connection->ackIndex && ack < connection->nextIndex && alloc <= connection->allocIndex) {
+		// Several acknowledgement of same packet means following packet is lost
+		connection->dupAckCount++;
+		if (connection->dupAckCount == DUP_ACK_RETRY) {
+			connection->dupAckCount    = 0;
+			connection->nextIndex      = connection->ackIndex;
+			connection->retransmitTime = 0;
+		}
+	}
+
+	// Allocation behind acknowledge means client doesn't use allocation. Allow one packet like stop and wait.
+	if (alloc <= ack) alloc = ack + 1;
+	if (connection->allocIndex < alloc) connection->allocIndex = alloc;
+
+	// Client sends no data until close reply. System packet doesn't consume sequence number.
+	connection->header.acknowledge = reqHeader.sequence;
+	connection->header.allocation  = reqHeader.sequence;
+
+	if (connection->startTime == 0) connection->startTime = now;
+}
+
+bool SocketBoot::canPump(Connection* connection) {
+	// close is sent after all data is acknowledged
+	if (connection->ackIndex == connection->packetCount && connection->nextIndex == connection->packetCount) return true;
+
+	quint32 limit = qMin(connection->ackIndex + window, connection->allocIndex);
+	limit = qMin(limit, connection->packetCount);
+	return connection->nextIndex < limit;
+}
+
+int SocketBoot::pump(Connection* connection, qint64 /*now*/) {
+	using namespace Courier;
+
+	if (connection->ackIndex == connection->packetCount && connection->nextIndex == connection->packetCount) {
+		logger.info("CLOSE_SST");
+		send(connection, SequencedPacket::CLOSE_SST, connection->nextIndex++);
+		return 1;
+	}
+
+	quint32 limit = qMin(connection->ackIndex + window, connection->allocIndex);
+	limit = qMin(limit, connection->packetCount);
+
+	int count = 0;
+	for(; count < BURST_SIZE && connection->nextIndex < limit; count++) {
+		quint32 index = connection->nextIndex++;
+		// Request acknowledgement once in a burst instead of every packet
+		bool requestAck = (connection->nextIndex == limit) || ((index % BURST_SIZE) == (BURST_SIZE - 1));
+		send(connection, SequencedPacket::DATA_SST | (requestAck ? SequencedPacket::MASK_SEND_ACKNOWLEDGEMENT : 0), index);
+	}
+	return count;
+}
+
+void SocketBoot::schedule(Connection* connection, qint64 now) {
+	// timer thread is blocked while wheel is empty
+	const bool idle = wheel.isEmpty();
+	bool inFlight = connection->ackIndex < connection->nextIndex;
+	if (inFlight && connection->retransmitTime == 0) connection->retransmitTime = now + connection->rto;
+
+	if (canPump(connection)) {
+		// pacing. send next burst in next tick
+		wheel.schedule(connection->host, now + TICK_INTERVAL);
+	} else if (inFlight) {
+		wheel.schedule(connection->host, connection->retransmitTime);
+	} else {
+		// wait for client
+		wheel.cancel(connection->host);
+	}
+	if (idle && !wheel.isEmpty()) timerCond.wakeAll();
+}
+
+void SocketBoot::timeout(Connection* connection, qint64 now) {
+	if (connection->ackIndex < connection->nextIndex && connection->retransmitTime <= now) {
+		connection->retryCount++;
+		if (MAX_RETRY < connection->retryCount) {
+			logger.warn("give up  host = %012llX  ackIndex = %d  packetCount = %d", connection->host, connection->ackIndex, connection->packetCount);
+			close(connection);
+			return;
+		}
+		// go back to first packet not acknowledged
+		connection->rto            = qMin(connection->rto * 2, (qint64)RTO_MAX);
+		connection->nextIndex      = connection->ackIndex;
+		connection->retransmitTime = 0;
+		connection->dupAckCount    = 0;
+	}
+	pump(connection, now);
+	schedule(connection, now);
+}
+
+void SocketBoot::close(Connection* connection) {
+	qint64 elapsed = (clock.nsecsElapsed() - connection->startTime) / (1000 * 1000);
+	logger.info("close  host = %012llX  packet = %d  send = %d  retransmit = %d  %lld ms  %.1f KB/s",
+		connection->host, connection->packetCount, connection->sendCount, connection->retransmitCount, elapsed,
+		elapsed ? (connection->bootFile->size / 1024.0) / (elapsed / 1000.0) : 0.0);
+
+	wheel.cancel(connection->host);
+	Connection::remove(connection->host);
+}
+
+void SocketBoot::send(Connection* connection, quint16 control, quint32 index) {
+	using namespace Courier;
+
+	quint8* data = buffer.getData();
+	buffer.clear();
+	serialize(buffer, connection->ethernet);
+
+	Datagram::Header& datagram = connection->datagram;
+	datagram.checksum = 0;
+	datagram.length   = 0;
+	serialize(buffer, datagram);
+
+	SequencedPacket::Header& header = connection->header;
+	header.control  = control;
+	header.sequence = (quint16)index;
+	header.base     = buffer.getPos();
+	serialize(buffer, header);
+	quint32 headLen = buffer.getPos();
+
+	// Data packet refers memory mapped boot file
+	quint8* body    = 0;
+	quint32 bodyLen = 0;
+	if ((control & SequencedPacket::MASK_SYSTEM_PACKET) == 0 && (control & SequencedPacket::MASK_DATASTREAM_TYPE) == SequencedPacket::DATA_SST && index < connection->packetCount) {
+		quint32 offset = index * DATA_SIZE;
+		body    = (quint8*)connection->bootFile->address + offset;
+		bodyLen = qMin((quint32)DATA_SIZE, connection->bootFile->size - offset);
+	}
+	datagram.length = headLen - datagram.base + bodyLen;
+
+	// Copy odd length or short data to buffer to add padding
+	if ((bodyLen & 1) || (headLen + bodyLen) < (datagram.base + Ethernet::MIN_DATA_LENGTH)) {
+		for(quint32 i = 0; i < bodyLen; i++) {
+			buffer.put8(body[i]);
+		}
+		if (datagram.length & 1) {
+			buffer.put8(0);
+		}
+		while(buffer.getPos() < (datagram.base + Ethernet::MIN_DATA_LENGTH)) {
+			buffer.put8(0);
+		}
+		headLen = buffer.getPos();
+		body    = 0;
+		bodyLen = 0;
+	}
+
+	// write length of datagram
+	serialize(buffer, datagram);
+
+	// calculate checksum of head and body
+	if (body) {
+		quint16 s = Courier::checksum(data, datagram.base + 2, headLen - datagram.base - 2);
+		datagram.checksum = Courier::checksum(body, 0, bodyLen, s);
+	} else {
+		datagram.checksum = Courier::checksum(data, datagram.base + 2, datagram.length - 2);
+	}
+	serialize(buffer, datagram);
+
+	if (DEBUG_SHOW_PACKET) {
+		logger.debug("====  <<<<");
+		SocketManager::dumpPacket(datagram);
+		SocketManager::dumpPacket(header);
+	}
+
+	int opErrno = 0;
+	int ret = network.transmit(data, headLen, body, bodyLen, opErrno);
+	if (ret < 0) {
+		logger.fatal("send fail opErrno = %d  ret = %d  headLen = %d  bodyLen = %d", opErrno, ret, headLen, bodyLen);
+		RUNTIME_ERROR();
+	}
+
+	connection->sendCount++;
+	if (index < connection->maxIndex) {
+		connection->retransmitCount++;
+	} else {
+		connection->maxIndex = index + 1;
+	}
+}
+
 void SocketBoot::process(Socket::Context& context, ByteBuffer& request, ByteBuffer& response) {
 	using namespace Courier;
 
@@ -141,9 +415,14 @@ void SocketBoot::process(Socket::Context& context, ByteBuffer& request, ByteBuff
 				quint48 host         = context.reqDatagram.source.host;
 				//quint16 connectionID = bootFileRequest.SPP_REQUEST.connectionID;
 
+				QMutexLocker locker(&mutex);
 				Connection::add(host, bfn);
 				Connection* connection = Connection::getInstance(host);
 
+				// Keep header of response to send data packet later
+				connection->ethernet = context.resEthernet;
+				connection->datagram = context.resDatagram;
+
 				// To see SPP packet, you need to set MASK_SEND_ACKNOWLEDGEMENT flag.
 				connection->header.control     = SequencedPacket::MASK_SYSTEM_PACKET | SequencedPacket::MASK_SEND_ACKNOWLEDGEMENT;
 				connection->header.source      = Connection::getLocalID();
@@ -174,6 +453,7 @@ void SocketBoot::process(Socket::Context& context, ByteBuffer& request, ByteBuff
 			SocketManager::dumpPacket(reqHeader);
 
 			// find connection
+			QMutexLocker locker(&mutex);
 			quint48     host       = context.reqDatagram.source.host;
 			Connection *connection = Connection::getInstance(host);
 
@@ -187,22 +467,23 @@ void SocketBoot::process(Socket::Context& context, ByteBuffer& request, ByteBuff
 				RUNTIME_ERROR();
 			}
 
+			qint64 now = clock.nsecsElapsed();
 			quint16 sst = reqHeader.control & SequencedPacket::MASK_DATASTREAM_TYPE;
 			switch(sst) {
 			case SequencedPacket::DATA_SST: {
-				if (connection->pos == connection->bootFile->size) {
-					// Already reached EOF
-					connection->header.control = SequencedPacket::CLOSE_SST;
-					logger.info("CLOSE_SST");
-				} else {
-					// Send data
-					connection->header.control = SequencedPacket::DATA_SST | SequencedPacket::MASK_SEND_ACKNOWLEDGEMENT;
+				receive(connection, reqHeader, now);
+				int count = pump(connection, now);
+				// Packet sent by pump carries acknowledgement. Send system packet only if nothing is sent.
+				if (count == 0 && (reqHeader.control & SequencedPacket::MASK_SEND_ACKNOWLEDGEMENT)) {
+					send(connection, SequencedPacket::MASK_SYSTEM_PACKET, connection->nextIndex);
 				}
+				schedule(connection, now);
 			}
 				break;
 			case SequencedPacket::CLOSE_REPLY_SST: {
-				connection->header.control = SequencedPacket::CLOSE_REPLY_SST;
 				logger.info("CLOSE_REPLY_SST");
+				send(connection, SequencedPacket::CLOSE_REPLY_SST, connection->packetCount);
+				close(connection);
 			}
 				break;
 			default:
@@ -210,31 +491,9 @@ void SocketBoot::process(Socket::Context& context, ByteBuffer& request, ByteBuff
 				RUNTIME_ERROR();
 				break;
 			}
-			connection->header.base = response.getPos();
-			Courier::serialize(response, connection->header);
-
-			SocketManager::dumpPacket(connection->header);
-
-			// Send data
-			if (connection->pos < connection->bootFile->size) {
-				quint32 nextPos = connection->pos + 512;
-				if (connection->bootFile->size < nextPos) {
-					nextPos = connection->bootFile->size;
-				}
-				// Send data [pos..nextPos)
-				quint8* base = (quint8*)connection->bootFile->address;
-				for(quint32 i = connection->pos; i < nextPos; i++) {
-					response.put8(base[i]);
-				}
-				logger.info("DATA %4X => %4X", connection->pos, nextPos);
-				connection->pos = nextPos;
-
-				connection->header.sequence    = connection->header.sequence    + 1;
-				connection->header.acknowledge = connection->header.acknowledge + 1;
-				connection->header.allocation  = connection->header.allocation  + 1;
-			}
 
-			// end of building  response
+			// Response is already sent. Make response empty.
+			response.setPos(0);
 			response.rewind();
 		}
 			break;
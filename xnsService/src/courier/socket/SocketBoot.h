@@ -6,22 +6,51 @@
 #define SOCKETBOOT_H__
 
 #include "../SocketManager.h"
+#include "../Network.h"
+#include "../TimerWheel.h"
 #include "../stub/StubDatagram.h"
 #include "../stub/StubSequencedPacket.h"
 
 
+// Boot file is sent with sliding window of SPP.
+// Data packet is sent directly from memory mapped boot file.
 class SocketBoot : public SocketManager::Socket {
 public:
 	static const quint48 BFN_GVWIN_NETBOOT = 0x0000AA000E60ULL;
 
-	SocketBoot() : SocketManager::Socket("Boot") {}
+	// number of data packet that can be sent without acknowledgement
+	static const int DEFAULT_WINDOW = 16;
+
+	SocketBoot(Network& network_, int window_ = DEFAULT_WINDOW);
+	~SocketBoot();
+
 	void addBootFile(quint48 bfn, QString path) {
 		BootFile::add(bfn, path);
 	}
 
 	void process(Socket::Context& context, ByteBuffer& request, ByteBuffer& response);
 
+	// convert 16 bit sequence number to index near base. Returns 0 for sequence before index 0.
+	static quint32 toIndex(quint32 base, quint16 sequence) {
+		qint32 delta = (qint16)(sequence - (quint16)base);
+		if (delta < 0 && base < (quint32)-delta) return 0;
+		return base + delta;
+	}
+
 private:
+	// size of data in one packet
+	static const quint32 DATA_SIZE      = 512;
+	// max number of packet sent in one tick to pace transmission
+	static const int     BURST_SIZE     = 4;
+	// time unit is nanoseconds
+	static const qint64  TICK_INTERVAL  =    2 * 1000 * 1000LL;
+	static const qint64  RTO_INITIAL    =  200 * 1000 * 1000LL;
+	static const qint64  RTO_MAX        = 3200 * 1000 * 1000LL;
+	// give up connection after this number of retransmission without progress
+	static const int     MAX_RETRY      = 10;
+	// retransmit after this number of duplicate acknowledgement
+	static const int     DUP_ACK_RETRY  = 3;
+
 	class BootFile {
 	public:
 		static void add(quint48 bfn, QString path);
@@ -40,23 +69,94 @@ private:
 		~BootFile();
 	};
 
+	// Packet is identified by index. Sequence number of packet is lower 16 bit of index.
+	// Data of packet index is [index * DATA_SIZE .. (index + 1) * DATA_SIZE) of boot file.
+	// Packet of index packetCount is CLOSE_SST.
 	class Connection {
 	public:
 		static void        add(quint48 host, quint48 bfn);
 		static Connection* getInstance(quint48 host);
+		static Connection* find(quint48 host);
+		static void        remove(quint48 host);
 		static quint16     getLocalID();
 
 		quint48   host;
 		BootFile* bootFile;
-		quint32   pos;
-
+		quint32   packetCount;
+
+		// first packet not acknowledged
+		quint32   ackIndex;
+		// next packet to send
+		quint32   nextIndex;
+		// packet before allocIndex can be sent
+		quint32   allocIndex;
+		// packet before maxIndex is sent at least once
+		quint32   maxIndex;
+
+		int       dupAckCount;
+		int       retryCount;
+		qint64    rto;
+		qint64    retransmitTime;
+
+		// statistics
+		qint64    startTime;
+		quint32   sendCount;
+		quint32   retransmitCount;
+
+		// template of response
+		Courier::Ethernet::Header         ethernet;
+		Courier::Datagram::Header         datagram;
 		Courier::SequencedPacket::Header  header;
+
+		// convert sequence number to index near ackIndex
+		quint32 toIndex(quint16 sequence) {
+			return SocketBoot::toIndex(ackIndex, sequence);
+		}
 	private:
 		static QMap<quint48, Connection*> map; // key is host
 		static quint16 nextLocalID;
 
 		Connection(quint48 host, quint48 bfn);
 	};
+
+	class TimerThread : public QThread {
+	public:
+		TimerThread(SocketBoot& socketBoot_) : socketBoot(socketBoot_) {
+			stop.storeRelease(0);
+		}
+		void run();
+		void stopThread();
+		bool isStopping() {
+			return stop.loadAcquire();
+		}
+	protected:
+		QAtomicInt  stop;
+		SocketBoot& socketBoot;
+	};
+
+	// update state of connection with packet from client
+	void receive   (Connection* connection, const Courier::SequencedPacket::Header& reqHeader, qint64 now);
+	// send new packet within window. returns number of sent packet
+	int  pump      (Connection* connection, qint64 now);
+	bool canPump   (Connection* connection);
+	void send      (Connection* connection, quint16 control, quint32 index);
+	void schedule  (Connection* connection, qint64 now);
+	void timeout   (Connection* connection, qint64 now);
+	void close     (Connection* connection);
+	// wait for next tick. Block while there is no active timer. Returns false if timer thread is stopping.
+	bool waitTick  ();
+	void tick      ();
+
+	Network&      network;
+	const int     window;
+	// guard connection, wheel and buffer. Process and timer thread use connection.
+	QMutex        mutex;
+	// wake timer thread when timer is armed or thread is stopping
+	QWaitCondition timerCond;
+	TimerWheel    wheel;
+	ByteBuffer    buffer;
+	QElapsedTimer clock;
+	TimerThread*  thread;
 };
 
 #endif
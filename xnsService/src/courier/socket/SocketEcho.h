@@ -9,7 +9,7 @@
 
 class SocketEcho : public SocketManager::Socket {
 public:
-	SocketEcho() : SocketManager::Socket("Echo") {}
+	SocketEcho() : SocketManager::Socket("Echo", true) {}
 	void process(Socket::Context& context, ByteBuffer& request, ByteBuffer& response);
 };
 
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// testSocketBoot.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testSocketBoot");
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "../courier/socket/SocketBoot.h"
+
+class testSocketBoot : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(testSocketBoot);
+	CPPUNIT_TEST(testToIndex);
+	CPPUNIT_TEST(testToIndexWrapAround);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void testToIndex() {
+		CPPUNIT_ASSERT_EQUAL((quint32)0,  SocketBoot::toIndex(0,  0));
+		CPPUNIT_ASSERT_EQUAL((quint32)12, SocketBoot::toIndex(10, 12));
+		CPPUNIT_ASSERT_EQUAL((quint32)8,  SocketBoot::toIndex(10, 8));
+		// sequence before index 0
+		CPPUNIT_ASSERT_EQUAL((quint32)0,  SocketBoot::toIndex(3,  0xFFFE));
+	}
+
+	void testToIndexWrapAround() {
+		// sequence wraps to 0 after 0xFFFF
+		CPPUNIT_ASSERT_EQUAL((quint32)0x10001, SocketBoot::toIndex(0x0FFFE, 0x0001));
+		CPPUNIT_ASSERT_EQUAL((quint32)0x0FFFF, SocketBoot::toIndex(0x10001, 0xFFFF));
+		// second wrap around
+		CPPUNIT_ASSERT_EQUAL((quint32)0x20003, SocketBoot::toIndex(0x1FFF0, 0x0003));
+		CPPUNIT_ASSERT_EQUAL((quint32)0x1FFF0, SocketBoot::toIndex(0x20003, 0xFFF0));
+		logger.info("testToIndexWrapAround  OK");
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testSocketBoot);
@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2014, Yasuhiro Hasegawa
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice,
+     this list of conditions and the following disclaimer.
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+  3. The name of the author may not be used to endorse or promote products derived
+     from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+
+//
+// testTimerWheel.cpp
+//
+
+#include "../util/Util.h"
+static log4cpp::Category& logger = Logger::getLogger("testTimerWheel");
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+
+#include "../courier/TimerWheel.h"
+
+class testTimerWheel : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE(testTimerWheel);
+	CPPUNIT_TEST(testSchedule);
+	CPPUNIT_TEST(testReplace);
+	CPPUNIT_TEST(testCancel);
+	CPPUNIT_TEST(testWrapAround);
+	CPPUNIT_TEST(testLateAdvance);
+	CPPUNIT_TEST_SUITE_END();
+
+	static const int    SLOT_SIZE     = 8;
+	static const qint64 TICK_INTERVAL = 10;
+
+	static QList<quint64> advance(TimerWheel& wheel, qint64 time) {
+		QList<quint64> ret;
+		wheel.advance(time, ret);
+		std::sort(ret.begin(), ret.end());
+		return ret;
+	}
+
+public:
+	void testSchedule() {
+		TimerWheel wheel(SLOT_SIZE, TICK_INTERVAL);
+		CPPUNIT_ASSERT(wheel.isEmpty());
+
+		// time is rounded up to next tick
+		wheel.schedule(1, 25);
+		CPPUNIT_ASSERT(!wheel.isEmpty());
+		CPPUNIT_ASSERT_EQUAL(0, advance(wheel, 29).size());
+		QList<quint64> list = advance(wheel, 30);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)1, list[0]);
+		CPPUNIT_ASSERT(wheel.isEmpty());
+
+		// time in past fires at next tick
+		wheel.schedule(2, 0);
+		list = advance(wheel, 40);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)2, list[0]);
+	}
+
+	void testReplace() {
+		TimerWheel wheel(SLOT_SIZE, TICK_INTERVAL);
+
+		// later schedule replaces earlier one
+		wheel.schedule(1, 20);
+		wheel.schedule(1, 50);
+		CPPUNIT_ASSERT_EQUAL(0, advance(wheel, 40).size());
+		QList<quint64> list = advance(wheel, 50);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)1, list[0]);
+
+		// earlier schedule replaces later one, and fires only once
+		wheel.schedule(1, 100);
+		wheel.schedule(1, 60);
+		list = advance(wheel, 60);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL(0, advance(wheel, 200).size());
+		CPPUNIT_ASSERT(wheel.isEmpty());
+	}
+
+	void testCancel() {
+		TimerWheel wheel(SLOT_SIZE, TICK_INTERVAL);
+
+		wheel.schedule(1, 20);
+		wheel.schedule(2, 20);
+		wheel.cancel(1);
+		QList<quint64> list = advance(wheel, 20);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)2, list[0]);
+
+		// cancel of key without timer is ignored
+		wheel.cancel(3);
+		CPPUNIT_ASSERT(wheel.isEmpty());
+	}
+
+	void testWrapAround() {
+		TimerWheel wheel(SLOT_SIZE, TICK_INTERVAL);
+
+		// tick 10 and tick 2 are in same slot
+		wheel.schedule(1, (SLOT_SIZE + 2) * TICK_INTERVAL);
+		wheel.schedule(2, 2 * TICK_INTERVAL);
+		QList<quint64> list = advance(wheel, 2 * TICK_INTERVAL);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)2, list[0]);
+
+		// entry of later round is kept
+		CPPUNIT_ASSERT_EQUAL(0, advance(wheel, (SLOT_SIZE + 2) * TICK_INTERVAL - 1).size());
+		list = advance(wheel, (SLOT_SIZE + 2) * TICK_INTERVAL);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)1, list[0]);
+	}
+
+	void testLateAdvance() {
+		TimerWheel wheel(SLOT_SIZE, TICK_INTERVAL);
+
+		// advance far beyond one round fires every expired timer
+		wheel.schedule(1, 2 * TICK_INTERVAL);
+		wheel.schedule(2, 5 * TICK_INTERVAL);
+		wheel.schedule(3, 50 * TICK_INTERVAL);
+		wheel.schedule(4, 200 * TICK_INTERVAL);
+		QList<quint64> list = advance(wheel, 100 * TICK_INTERVAL);
+		CPPUNIT_ASSERT_EQUAL(3, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)1, list[0]);
+		CPPUNIT_ASSERT_EQUAL((quint64)2, list[1]);
+		CPPUNIT_ASSERT_EQUAL((quint64)3, list[2]);
+
+		// advance to past is ignored
+		CPPUNIT_ASSERT_EQUAL(0, advance(wheel, 10 * TICK_INTERVAL).size());
+		list = advance(wheel, 200 * TICK_INTERVAL);
+		CPPUNIT_ASSERT_EQUAL(1, list.size());
+		CPPUNIT_ASSERT_EQUAL((quint64)4, list[0]);
+		logger.info("testLateAdvance  OK");
+	}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testTimerWheel);